@@ -53,6 +53,24 @@ CHECK_INCLUDE_FILE_CXX (wchar.h HAVE_WCHAR_H)
 CHECK_INCLUDE_FILE_CXX (wctype.h HAVE_WCTYPE_H)
 CHECK_INCLUDE_FILE_CXX (zlib.h HAVE_ZLIB_H)
 
+# io_uring reads of the ioManager, IORING_OP_READ came with the 5.6 kernel headers
+CHECK_INCLUDE_FILE_CXX (linux/io_uring.h HAVE_LINUX_IO_URING_H)
+
+IF (HAVE_LINUX_IO_URING_H)
+CHECK_SYMBOL_EXISTS (IORING_FEAT_SINGLE_MMAP linux/io_uring.h HAVE_IORING_FEAT_SINGLE_MMAP)
+CHECK_CXX_SOURCE_COMPILES("
+#include <linux/io_uring.h>
+int main()
+{
+  return IORING_OP_READ;
+}"
+HAVE_IORING_OP_READ)
+ENDIF()
+
+IF (HAVE_IORING_FEAT_SINGLE_MMAP AND HAVE_IORING_OP_READ)
+SET (HAVE_IO_URING 1)
+ENDIF()
+
 CHECK_FUNCTION_EXISTS (_getb67 GETB1)
 CHECK_FUNCTION_EXISTS (GETB67 GETB2)
 CHECK_FUNCTION_EXISTS (getb67 GETB3)
@@ -148,20 +148,7 @@ class ArithmeticOperator : public Operator
   virtual IDB_Decimal getDecimalVal(rowgroup::Row& row, bool& isNull, ParseTree* lop, ParseTree* rop) override
   {
     evaluate(row, isNull, lop, rop);
-
-    // @bug5736, double type with precision -1 indicates that this type is for decimal math,
-    //      the original decimal scale is stored in scale field, which is no use for double.
-    if (fResultType.colDataType == CalpontSystemCatalog::DOUBLE && fResultType.precision == -1)
-    {
-      IDB_Decimal rv;
-      rv.scale = fResultType.scale;
-      rv.precision = 15;
-      rv.value = (int64_t)(TreeNode::getDoubleVal() * IDB_pow[rv.scale]);
-
-      return rv;
-    }
-
-    return TreeNode::getDecimalVal();
+    return getDecimalResult();
   }
   using Operator::getDateIntVal;
   virtual int32_t getDateIntVal(rowgroup::Row& row, bool& isNull, ParseTree* lop, ParseTree* rop) override
@@ -194,6 +181,47 @@ class ArithmeticOperator : public Operator
     return TreeNode::getBoolVal();
   }
   void adjustResultType(const CalpontSystemCatalog::ColType& m);
+
+  /***********************************************************
+   *                 Batch F&E                               *
+   ***********************************************************/
+  /** Applies the operation to operands evaluated by the caller, see funcexp::BatchEvaluator.
+   *  The result is read back with the TreeNode getters or getDecimalResult() like the row getters do.
+   */
+  inline void compute(int64_t op1, int64_t op2, bool& isNull)
+  {
+    fResult.intVal = execute(op1, op2, isNull);
+  }
+  inline void compute(uint64_t op1, uint64_t op2, bool& isNull)
+  {
+    fResult.uintVal = execute(op1, op2, isNull);
+  }
+  inline void compute(double op1, double op2, bool& isNull)
+  {
+    fResult.doubleVal = execute(op1, op2, isNull);
+  }
+  inline void compute(const IDB_Decimal& op1, const IDB_Decimal& op2, bool& isNull)
+  {
+    execute(fResult.decimalVal, op1, op2, isNull);
+  }
+
+  inline IDB_Decimal getDecimalResult()
+  {
+    // @bug5736, double type with precision -1 indicates that this type is for decimal math,
+    //      the original decimal scale is stored in scale field, which is no use for double.
+    if (fResultType.colDataType == CalpontSystemCatalog::DOUBLE && fResultType.precision == -1)
+    {
+      IDB_Decimal rv;
+      rv.scale = fResultType.scale;
+      rv.precision = 15;
+      rv.value = (int64_t)(TreeNode::getDoubleVal() * IDB_pow[rv.scale]);
+
+      return rv;
+    }
+
+    return TreeNode::getDecimalVal();
+  }
+
   inline bool getOverflowCheck() const
   {
     return fDecimalOverflowCheck;
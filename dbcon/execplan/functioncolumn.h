@@ -320,6 +320,21 @@ class FunctionColumn : public ReturnedColumn
     return fFunctor->getTimeIntVal(row, fFunctionParms, isNull, fOperationType);
   }
 
+  /** Batch evaluation, see funcexp::BatchEvaluator.
+   *  Returns false if the functor has no batch implementation for type and the
+   *  row getters have to be used. Decimals are left to getDecimalVal() as the
+   *  result is rescaled there.
+   */
+  bool evaluateBatch(funcexp::RowBatch& batch, const funcexp::Selection& sel, funcexp::BatchType type,
+                     funcexp::BatchColumn& col)
+  {
+    if (type == funcexp::BatchType::DECIMAL)
+      return false;
+
+    fOperationType.setTimeZone(fTimeZone);
+    return fFunctor->evaluateBatch(batch, sel, fFunctionParms, fOperationType, type, col);
+  }
+
   void setFunctor(funcexp::Func* functor)
   {
     fFunctor = functor;
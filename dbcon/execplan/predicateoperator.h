@@ -110,6 +110,13 @@ class PredicateOperator : public Operator
   virtual bool getBoolVal(rowgroup::Row& row, bool& isNull, ReturnedColumn* lop, ReturnedColumn* rop) override;
   void setOpType(Type& l, Type& r) override;
 
+  /** Compares operands evaluated by the caller, see funcexp::BatchEvaluator */
+  template <typename result_t>
+  inline bool compare(const result_t op1, const result_t op2)
+  {
+    return numericCompare(op1, op2);
+  }
+
   inline virtual std::string toCppCode(IncludeSet& includes) const override
   {
     includes.insert("predicateoperator.h");
@@ -1063,6 +1063,9 @@ void BatchPrimitiveProcessorJL::createBPP(ByteStream& bs) const
   if (wideColumnsWidths)
     flags |= HAS_WIDE_COLUMNS;
 
+  if (!runtimeFilters.empty())
+    flags |= HAS_RUNTIME_FILTERS;
+
   bs << flags;
 
   if (wideColumnsWidths)
@@ -1202,6 +1205,18 @@ void BatchPrimitiveProcessorJL::createBPP(ByteStream& bs) const
     }
   }
 
+  if (flags & HAS_RUNTIME_FILTERS)
+  {
+    bs << (uint32_t)runtimeFilters.size();
+
+    for (i = 0; i < runtimeFilters.size(); i++)
+    {
+      bs << (uint8_t)runtimeFilters[i].isFilterStep;
+      bs << runtimeFilters[i].stepIndex;
+      runtimeFilters[i].filter->serialize(bs);
+    }
+  }
+
   // decide which rowgroup is received by PrimProc
   if (ot == ROW_GROUP)
   {
@@ -1403,6 +1418,41 @@ void BatchPrimitiveProcessorJL::useJoiners(const vector<std::shared_ptr<joiner::
   memset(posByJoinerNum.get(), 0, PMJoinerCount * sizeof(uint32_t));
 }
 
+void BatchPrimitiveProcessorJL::addRuntimeFilter(uint32_t OID,
+                                                 const std::shared_ptr<joiner::RuntimeFilter>& filter)
+{
+  uint32_t i;
+  ColumnCommandJL* cc;
+
+  /* Prefer a filter step, PrimProc reads its values anyway.  The OR filters are
+     independent scans, so with BOP_OR only a project step will do.  Pseudo columns
+     don't read the column, they are skipped. */
+  if (bop == BOP_AND)
+  {
+    for (i = 0; i < filterCount; i++)
+    {
+      cc = dynamic_cast<ColumnCommandJL*>(filterSteps[i].get());
+
+      if (cc && !cc->isDict() && !dynamic_cast<PseudoCCJL*>(cc) && cc->getOID() == OID)
+      {
+        runtimeFilters.push_back({true, i, filter});
+        return;
+      }
+    }
+  }
+
+  for (i = 0; i < projectCount; i++)
+  {
+    cc = dynamic_cast<ColumnCommandJL*>(projectSteps[i].get());
+
+    if (cc && !cc->isDict() && !dynamic_cast<PseudoCCJL*>(cc) && cc->getOID() == OID)
+    {
+      runtimeFilters.push_back({false, i, filter});
+      return;
+    }
+  }
+}
+
 // helper fcn to interleave small side data by joinernum
 bool BatchPrimitiveProcessorJL::pickNextJoinerNum()
 {
@@ -43,6 +43,7 @@
 #include "brm.h"
 #include "command-jl.h"
 #include "resourcemanager.h"
+#include "runtimefilter.h"
 //#include "tableband.h"
 
 namespace joblist
@@ -213,6 +214,9 @@ class BatchPrimitiveProcessorJL
   bool nextTupleJoinerMsg(messageqcpp::ByteStream&);
   // 	void setSmallSideKeyColumn(uint32_t col);
 
+  /* Runtime join filters, attached to the ColumnCommand that reads column OID */
+  void addRuntimeFilter(uint32_t OID, const std::shared_ptr<joiner::RuntimeFilter>& filter);
+
   /* OR hacks */
   void setBOP(uint32_t op);  // BOP_AND or BOP_OR, default is BOP_AND
   void setForHJ(bool b);     // default is false
@@ -356,6 +360,15 @@ class BatchPrimitiveProcessorJL
   bool sendTupleJoinRowGroupData;
   uint32_t PMJoinerCount;
 
+  /* Runtime join filters */
+  struct RuntimeFilterStep
+  {
+    bool isFilterStep;  // else it is one of the project steps
+    uint32_t stepIndex;
+    std::shared_ptr<joiner::RuntimeFilter> filter;
+  };
+  std::vector<RuntimeFilterStep> runtimeFilters;
+
   /* OR hack */
   uint8_t bop;  // BOP_AND or BOP_OR
   bool forHJ;   // indicate if feeding a hashjoin, doJoin does not cover smallside
@@ -89,6 +89,12 @@ DiskJoinStep::DiskJoinStep(TupleHashJoinStep* t, int djsIndex, int joinIndex, bo
     largeLimit = numeric_limits<int64_t>::max();
 
   uint64_t totalUMMemory = thjs->resourceManager->getConfiguredUMMemLimit();
+
+  /* Every worker holds one partition in memory, don't let them take more than half of it */
+  workerCount = thjs->resourceManager->getHjDiskJoinThreads();
+  workerCount = std::min<uint64_t>(workerCount, totalUMMemory / 2 / std::max<uint64_t>(partitionSize, 1));
+  workerCount = std::max<uint32_t>(workerCount, 1);
+
   jp.reset(new JoinPartition(largeRG, smallRG, smallKeyCols, largeKeyCols, typeless,
                              (joinType & ANTI) && (joinType & MATCHNULLS), (bool)fe, totalUMMemory,
                              partitionSize));
@@ -265,93 +271,21 @@ void DiskJoinStep::largeReader()
       more = largeDL->next(largeIt, &rgData);
 }
 
-void DiskJoinStep::loadFcn()
+JoinPartition* DiskJoinStep::getNextPartition()
 {
-  boost::shared_ptr<LoaderOutput> out;
-  bool ret;
-
-  try
-  {
-    do
-    {
-      out.reset(new LoaderOutput());
-      ret = jp->getNextPartition(&out->smallData, &out->partitionID, &out->jp);
-
-      if (ret)
-      {
-        // cout << "loaded partition " << out->partitionID << " smallData = " << out->smallData.size() <<
-        // endl;
-        loadFIFO->insert(out);
-      }
-    } while (ret && !cancelled());
-  }
-  catch (...)
-  {
-    handleException(std::current_exception(), logging::ERR_EXEMGR_MALFUNCTION, logging::ERR_ALWAYS_CRITICAL,
-                    "DiskJoinStep::loadFcn()");
-    status(logging::ERR_EXEMGR_MALFUNCTION);
-    abort();
-  }
+  boost::mutex::scoped_lock lk(partitionLock);
 
-  loadFIFO->endOfInput();
+  return jp->getNextPartition();
 }
 
-void DiskJoinStep::buildFcn()
-{
-  boost::shared_ptr<LoaderOutput> in;
-  boost::shared_ptr<BuilderOutput> out;
-  bool more = true;
-  int it = loadFIFO->getIterator();
-  int i, j;
-  Row smallRow;
-  RowGroup l_smallRG = smallRG;
-
-  l_smallRG.initRow(&smallRow);
-
-  while (1)
-  {
-    // cout << "getting a partition from the loader" << endl;
-    more = loadFIFO->next(it, &in);
-
-    if (!more || cancelled())
-      goto out;
-
-    out.reset(new BuilderOutput());
-    out->smallData = in->smallData;
-    out->partitionID = in->partitionID;
-    out->jp = in->jp;
-    out->tupleJoiner = joiner->copyForDiskJoin();
-
-    // cout << "building a tuplejoiner" << endl;
-    for (i = 0; i < (int)in->smallData.size(); i++)
-    {
-      l_smallRG.setData(&in->smallData[i]);
-      l_smallRG.getRow(0, &smallRow);
-
-      for (j = 0; j < (int)l_smallRG.getRowCount(); j++, smallRow.nextRow())
-        out->tupleJoiner->insert(smallRow, (largeIterationCount == 1));
-    }
-
-    out->tupleJoiner->doneInserting();
-    buildFIFO->insert(out);
-  }
-
-out:
-
-  while (more)
-    more = loadFIFO->next(it, &in);
-
-  buildFIFO->endOfInput();
-}
-
-void DiskJoinStep::joinFcn()
+void DiskJoinStep::workerFcn()
 {
   /* This function mostly serves as an adapter between the
   input data and the joinOneRG() fcn in THJS.  */
 
-  boost::shared_ptr<BuilderOutput> in;
-  bool more = true;
-  int it = buildFIFO->getIterator();
+  JoinPartition* partition;
+  vector<RGData> smallData;
+  std::shared_ptr<TupleJoiner> tupleJoiner;
   int i, j;
   vector<RGData> joinResults;
   RowGroup l_largeRG = largeRG, l_smallRG = smallRG;
@@ -364,7 +298,7 @@ void DiskJoinStep::joinFcn()
   boost::shared_array<boost::shared_array<int> > colMappings, fergMappings;
   boost::scoped_array<boost::scoped_array<uint8_t> > smallNullMem;
   boost::scoped_array<uint8_t> joinFEMem;
-  Row smallNullRow;
+  Row smallNullRow, smallRow;
 
   boost::scoped_array<uint8_t> baseRowMem;
 
@@ -402,19 +336,35 @@ void DiskJoinStep::joinFcn()
   smallNullMem[0].reset(new uint8_t[smallNullRow.getSize()]);
   smallNullRow.setData(smallNullMem[0].get());
   smallNullRow.initToNull();
+  l_smallRG.initRow(&smallRow);
 
   try
   {
-    while (1)
+    while (!cancelled() && (partition = getNextPartition()) != NULL)
     {
-      more = buildFIFO->next(it, &in);
+      /* Load the small side & build the joiner */
+      smallData.clear();
+      partition->readSmallSidePartition(&smallData);
+      tupleJoiner = joiner->copyForDiskJoin();
+
+      for (i = 0; i < (int)smallData.size(); i++)
+      {
+        l_smallRG.setData(&smallData[i]);
+        l_smallRG.getRow(0, &smallRow);
 
-      if (!more || cancelled())
-        goto out;
+        for (j = 0; j < (int)l_smallRG.getRowCount(); j++, smallRow.nextRow())
+          tupleJoiner->insert(smallRow, (largeIterationCount == 1));
+      }
+
+      tupleJoiner->doneInserting();
+
+      if (cancelled())
+        break;
 
-      joiners[0] = in->tupleJoiner;
+      /* Join the large side */
+      joiners[0] = tupleJoiner;
       boost::shared_ptr<RGData> largeData;
-      largeData = in->jp->getNextLargeRGData();
+      largeData = partition->getNextLargeRGData();
 
       while (largeData)
       {
@@ -431,7 +381,7 @@ void DiskJoinStep::joinFcn()
         }
         thjs->returnMemory();
         joinResults.clear();
-        largeData = in->jp->getNextLargeRGData();
+        largeData = partition->getNextLargeRGData();
       }
 
       if (joinType & SMALLOUTER)
@@ -441,11 +391,13 @@ void DiskJoinStep::joinFcn()
           /* TODO: an optimization would be to detect whether any new rows were marked and if not
              suppress the save operation */
           vector<Row::Pointer> unmatched;
-          in->tupleJoiner->getUnmarkedRows(&unmatched);
-          // cout << "***** saving partition " << in->partitionID << " unmarked count=" << unmatched.size() <<
-          // " total count="
-          //	<< in->tupleJoiner->size() << " vector size=" << in->smallData.size() <<  endl;
-          in->jp->saveSmallSidePartition(in->smallData);
+          tupleJoiner->getUnmarkedRows(&unmatched);
+          // cout << "***** saving partition " << partition->getUniqueID() << " unmarked count=" <<
+          // unmatched.size() << " total count="
+          //	<< tupleJoiner->size() << " vector size=" << smallData.size() <<  endl;
+          // saving can split the partition, which changes the tree getNextPartition() walks
+          boost::mutex::scoped_lock lk(partitionLock);
+          partition->saveSmallSidePartition(smallData);
         }
         else
         {
@@ -464,7 +416,7 @@ void DiskJoinStep::joinFcn()
           l_largeRow.setData(largeNullMem.get());
           l_largeRow.initToNull();
 
-          in->tupleJoiner->getUnmarkedRows(&unmatched);
+          tupleJoiner->getUnmarkedRows(&unmatched);
 
           // cout << " small-outer count=" << unmatched.size() << endl;
           for (i = 0; i < (int)unmatched.size(); i++)
@@ -519,22 +471,10 @@ void DiskJoinStep::joinFcn()
   catch (...)
   {
     handleException(std::current_exception(), logging::ERR_EXEMGR_MALFUNCTION, logging::ERR_ALWAYS_CRITICAL,
-                    "DiskJoinStep::joinFcn()");
+                    "DiskJoinStep::workerFcn()");
     status(logging::ERR_EXEMGR_MALFUNCTION);
     abort();
   }
-
-out:
-
-  while (more)
-    more = buildFIFO->next(it, &in);
-
-  if (lastLargeIteration || cancelled())
-  {
-    reportStats();
-    outputDL->endOfInput();
-    closedOutput = true;
-  }
 }
 
 void DiskJoinStep::mainRunner()
@@ -560,16 +500,20 @@ void DiskJoinStep::mainRunner()
       if (cancelled())
         break;
 
-      loadFIFO.reset(
-          new FIFO<boost::shared_ptr<LoaderOutput> >(1, 1));  // double buffering should be good enough
-      buildFIFO.reset(new FIFO<boost::shared_ptr<BuilderOutput> >(1, 1));
-
       std::vector<uint64_t> thrds;
-      thrds.reserve(3);
-      thrds.push_back(jobstepThreadPool.invoke(Loader(this)));
-      thrds.push_back(jobstepThreadPool.invoke(Builder(this)));
-      thrds.push_back(jobstepThreadPool.invoke(Joiner(this)));
+      thrds.reserve(workerCount);
+
+      for (uint32_t i = 0; i < workerCount; i++)
+        thrds.push_back(jobstepThreadPool.invoke(Worker(this)));
+
       jobstepThreadPool.join(thrds);
+
+      if (lastLargeIteration || cancelled())
+      {
+        reportStats();
+        outputDL->endOfInput();
+        closedOutput = true;
+      }
     }
   }
   catch (...)
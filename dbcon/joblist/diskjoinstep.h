@@ -80,68 +80,26 @@ class DiskJoinStep : public JobStep
 
   uint64_t mainThread;  // thread handle from thread pool
 
-  /* Loader structs */
-  struct LoaderOutput
+  /* Partition workers.  Each one takes a leaf partition at a time, loads its small side,
+     builds a TupleJoiner for it and joins its large side, so the partitions are processed
+     in parallel rather than through a single load -> build -> join pipeline. */
+  struct Worker
   {
-    std::vector<rowgroup::RGData> smallData;
-    uint64_t partitionID;
-    joiner::JoinPartition* jp;
-  };
-  boost::shared_ptr<joblist::FIFO<boost::shared_ptr<LoaderOutput> > > loadFIFO;
-
-  struct Loader
-  {
-    Loader(DiskJoinStep* d) : djs(d)
-    {
-    }
-    void operator()()
-    {
-      utils::setThreadName("DJSLoader");
-      djs->loadFcn();
-    }
-    DiskJoinStep* djs;
-  };
-  void loadFcn();
-
-  /* Builder structs */
-  struct BuilderOutput
-  {
-    std::shared_ptr<joiner::TupleJoiner> tupleJoiner;
-    std::vector<rowgroup::RGData> smallData;
-    uint64_t partitionID;
-    joiner::JoinPartition* jp;
-  };
-
-  boost::shared_ptr<joblist::FIFO<boost::shared_ptr<BuilderOutput> > > buildFIFO;
-
-  struct Builder
-  {
-    Builder(DiskJoinStep* d) : djs(d)
+    Worker(DiskJoinStep* d) : djs(d)
     {
     }
     void operator()()
     {
-      utils::setThreadName("DJSBuilder");
-      djs->buildFcn();
+      utils::setThreadName("DJSWorker");
+      djs->workerFcn();
     }
     DiskJoinStep* djs;
   };
-  void buildFcn();
+  void workerFcn();
+  joiner::JoinPartition* getNextPartition();
 
-  /* Joining structs */
-  struct Joiner
-  {
-    Joiner(DiskJoinStep* d) : djs(d)
-    {
-    }
-    void operator()()
-    {
-      utils::setThreadName("DJSJoiner");
-      djs->joinFcn();
-    }
-    DiskJoinStep* djs;
-  };
-  void joinFcn();
+  boost::mutex partitionLock;
+  uint32_t workerCount;
 
   // limits & usage
   boost::shared_ptr<int64_t> smallUsage;
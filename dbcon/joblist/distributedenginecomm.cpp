@@ -33,12 +33,17 @@
 #include <sstream>
 #include <stdexcept>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
 #include <ctime>
 #include <algorithm>
 #include <unistd.h>
 #include <chrono>
 #include <thread>
 #include <ifaddrs.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
 using namespace std;
 
 #include <boost/scoped_array.hpp>
@@ -158,6 +163,67 @@ struct EngineCommRunner
   }
 };
 
+struct ReaderPoolRunner
+{
+  explicit ReaderPoolRunner(joblist::DistributedEngineComm* jl) : jbl(jl)
+  {
+  }
+  joblist::DistributedEngineComm* jbl;
+  void operator()()
+  {
+    try
+    {
+      jbl->ReadConnections();
+    }
+    catch (std::exception& ex)
+    {
+      string what(ex.what());
+      cerr << "exception caught in ReaderPoolRunner: " << what << endl;
+      writeToLog(__FILE__, __LINE__, what, LOG_TYPE_CRITICAL);
+    }
+    catch (...)
+    {
+      string msg("exception caught in ReaderPoolRunner.");
+      writeToLog(__FILE__, __LINE__, msg, LOG_TYPE_CRITICAL);
+      cerr << msg << endl;
+    }
+  }
+};
+
+struct ReconnectRunner
+{
+  explicit ReconnectRunner(joblist::DistributedEngineComm* jl) : jbl(jl)
+  {
+  }
+  joblist::DistributedEngineComm* jbl;
+  void operator()()
+  {
+    try
+    {
+      jbl->Reconnect();
+    }
+    catch (std::exception& ex)
+    {
+      string what(ex.what());
+      cerr << "exception caught in ReconnectRunner: " << what << endl;
+      writeToLog(__FILE__, __LINE__, what, LOG_TYPE_CRITICAL);
+    }
+    catch (...)
+    {
+      string msg("exception caught in ReconnectRunner.");
+      writeToLog(__FILE__, __LINE__, msg, LOG_TYPE_CRITICAL);
+      cerr << msg << endl;
+    }
+  }
+};
+
+uint64_t nowNanos()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 template <typename T>
 struct QueueShutdown
 {
@@ -181,6 +247,100 @@ struct QueueShutdown
 
 namespace joblist
 {
+StepCredit::StepCredit(uint32_t pmCount, uint64_t creditPerPM)
+ : fCreditPerPM(creditPerPM), fUsed(pmCount), fToReturn(pmCount), fStallStart(pmCount), fStallNanos(0)
+{
+}
+
+void StepCredit::sent(uint32_t pmIndex, const SBS& msg)
+{
+  uint64_t bytes = msg->lengthWithHdrOverhead();
+  std::lock_guard lk(fLock);
+
+  fUsed[pmIndex] += bytes;
+  fUnread[msg.get()] = make_pair(pmIndex, bytes);
+
+  // the PM waits for credit from here on
+  if (fUsed[pmIndex] >= fCreditPerPM && fStallStart[pmIndex] == 0)
+    fStallStart[pmIndex] = nowNanos();
+}
+
+bool StepCredit::read(const vector<SBS>& msgs, bool queueEmpty, vector<uint64_t>& credit)
+{
+  std::lock_guard lk(fLock);
+  bool toReturn = false;
+  uint64_t now = 0;
+
+  for (const SBS& msg : msgs)
+  {
+    auto it = (msg ? fUnread.find(msg.get()) : fUnread.end());
+
+    if (it == fUnread.end())
+      continue;
+
+    fToReturn[it->second.first] += it->second.second;
+    fUnread.erase(it);
+  }
+
+  credit.assign(fUsed.size(), 0);
+
+  for (uint32_t i = 0; i < fUsed.size(); i++)
+  {
+    // ACK in chunks, unless the step caught up with the PMs
+    if (fToReturn[i] == 0 || (!queueEmpty && fToReturn[i] < fCreditPerPM / 4))
+      continue;
+
+    credit[i] = fToReturn[i];
+    fUsed[i] -= fToReturn[i];
+    fToReturn[i] = 0;
+    toReturn = true;
+
+    if (fStallStart[i] != 0 && fUsed[i] < fCreditPerPM)
+    {
+      now = (now == 0 ? nowNanos() : now);
+      fStallNanos += now - fStallStart[i];
+      fStallStart[i] = 0;
+    }
+  }
+
+  return toReturn;
+}
+
+uint64_t StepCredit::getCreditUsed(uint32_t pmIndex)
+{
+  std::lock_guard lk(fLock);
+  return fUsed[pmIndex];
+}
+
+bool StepCredit::outOfCredit()
+{
+  std::lock_guard lk(fLock);
+
+  for (uint64_t start : fStallStart)
+  {
+    if (start != 0)
+      return true;
+  }
+
+  return false;
+}
+
+uint64_t StepCredit::getStallTime()
+{
+  std::lock_guard lk(fLock);
+  uint64_t stallNanos = fStallNanos;
+  uint64_t now = nowNanos();
+
+  // the stalls that haven't ended yet count so far
+  for (uint64_t start : fStallStart)
+  {
+    if (start != 0)
+      stallNanos += now - start;
+  }
+
+  return stallNanos;
+}
+
 DistributedEngineComm* DistributedEngineComm::fInstance = 0;
 
 /*static*/
@@ -206,13 +366,22 @@ void DistributedEngineComm::reset()
 }
 
 DistributedEngineComm::DistributedEngineComm(ResourceManager* rm, bool isExeMgr)
- : fRm(rm), pmCount(0), fIsExeMgr(isExeMgr)
+ : fRm(rm), fEpollFd(-1), fNextReaderId(0), fReconnector(0), pmCount(0), fIsExeMgr(isExeMgr)
 {
   if (fIsExeMgr)
   {
     getLocalNetIfacesSins();
   }
+
+  fEpollFd = epoll_create1(EPOLL_CLOEXEC);
+
+  if (fEpollFd < 0)
+    writeToLog(__FILE__, __LINE__,
+               string("DEC: epoll_create1() failed, reading with a thread per connection: ") + strerror(errno),
+               LOG_TYPE_WARNING);
+
   Setup();
+  startReaderPool();
 }
 
 DistributedEngineComm::~DistributedEngineComm()
@@ -234,6 +403,7 @@ int32_t DistributedEngineComm::Setup()
 
   for (iter = newClients.begin(); iter != newClients.end(); ++iter)
   {
+    StopClientListener(*iter);
     (*iter)->shutdown();
   }
 
@@ -241,7 +411,7 @@ int32_t DistributedEngineComm::Setup()
   newLocks.clear();
 
   uint32_t newPmCount = fRm->getPsCount();
-  throttleThreshold = fRm->getDECThrottleThreshold();
+  fCreditWindow = fRm->getDECCreditWindow();
   tbpsThreadCount = fRm->getJlNumScanReceiveThreads();
   fDECConnectionsPerQuery = fRm->getDECConnectionsPerQuery();
   unsigned numConnections = getNumConnections();
@@ -369,6 +539,7 @@ int DistributedEngineComm::Close()
   makeBusy(false);
   // for each MessageQueueClient in pmConnections delete the MessageQueueClient;
   fPmConnections.clear();
+  stopReaderPool();
   fPmReader.clear();
   return 0;
 }
@@ -407,33 +578,162 @@ void DistributedEngineComm::Listen(boost::shared_ptr<MessageQueueClient> client,
   }
 
 Error:
-  // @bug 488 - error condition! push 0 length bs to messagequeuemap and
-  // eventually let jobstep error out.
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok;
-  sbs.reset(new ByteStream(0));
+  connectionLost(client);
+}
+
+void DistributedEngineComm::ReadConnections()
+{
+  struct epoll_event ev;
 
-  for (map_tok = fSessionMessages.begin(); map_tok != fSessionMessages.end(); ++map_tok)
+  while (Busy())
   {
-    map_tok->second->queue.clear();
-    (void)atomicops::atomicInc(&map_tok->second->unackedWork[0]);
-    map_tok->second->queue.push(sbs);
+    int n = epoll_wait(fEpollFd, &ev, 1, readerWaitMSecs);
+
+    if (n < 0 && errno != EINTR)
+    {
+      writeToLog(__FILE__, __LINE__, string("DEC: epoll_wait() failed: ") + strerror(errno), LOG_TYPE_CRITICAL);
+      return;
+    }
+
+    if (n <= 0)
+      continue;
+
+    uint64_t id = ev.data.u64;
+    boost::shared_ptr<PMReader> reader;
+    std::unique_lock lk(fReaderLock);
+    PMReaderMap::iterator it = fReaders.find(id);
+
+    if (it == fReaders.end())
+      continue;
+
+    reader = it->second;
+    lk.unlock();
+
+    // the event is one shot, no other thread reads the connection until it is armed again
+    bool ok = readMessages(*reader);
+
+    lk.lock();
+    it = fReaders.find(id);
+
+    // stopped while it was read, it's not an error
+    if (it == fReaders.end())
+      continue;
+
+    if (ok)
+    {
+      ev.events = EPOLLIN | EPOLLONESHOT;
+
+      if (epoll_ctl(fEpollFd, EPOLL_CTL_MOD, reader->sd, &ev) == 0)
+        continue;
+    }
+
+    fReaders.erase(it);
+    epoll_ctl(fEpollFd, EPOLL_CTL_DEL, reader->sd, NULL);
+    lk.unlock();
+
+    connectionLostInPool(reader->client);
   }
-  lk.unlock();
+}
 
-  if (fIsExeMgr)
+void DistributedEngineComm::Reconnect()
+{
+  std::unique_lock lk(fReconnectLock);
+
+  while (Busy())
   {
-    decltype(pmCount) originalPMCount = pmCount;
-    // Re-establish if a remote PM restarted.
-    std::this_thread::sleep_for(std::chrono::seconds(3));
-    auto rc = Setup();
-    if (rc || originalPMCount != pmCount)
+    if (fLostClients.empty())
     {
-      ostringstream os;
-      os << "DEC: lost connection to " << client->addr2String();
-      writeToLog(__FILE__, __LINE__, os.str(), LOG_TYPE_ERROR);
+      fReconnectCond.wait_for(lk, std::chrono::milliseconds(readerWaitMSecs));
+      continue;
     }
 
+    // Give a restarted PM time to come back, the connections it drops meanwhile go with this Setup()
+    if (fReconnectCond.wait_for(lk, std::chrono::seconds(3), [this] { return !Busy(); }))
+      break;
+
+    ClientList lost;
+    lost.swap(fLostClients);
+    lk.unlock();
+
+    try
+    {
+      reconnect(lost);
+    }
+    catch (std::exception& ex)
+    {
+      writeToLog(__FILE__, __LINE__, string("DEC: reconnect failed: ") + ex.what(), LOG_TYPE_ERROR);
+    }
+
+    lk.lock();
+  }
+}
+
+bool DistributedEngineComm::readMessages(PMReader& reader)
+{
+  try
+  {
+    for (uint32_t i = 0; i < readerBatchSize; i++)
+    {
+      Stats stats;
+      SBS sbs = reader.client->read(0, NULL, &stats);
+
+      if (sbs->length() == 0)  // got zero bytes on read, nothing more will come
+        return false;
+
+      addDataToOutput(sbs, reader.connIndex, &stats);
+
+      // the rest waits for the next event
+      int avail = 0;
+
+      if (ioctl(reader.sd, FIONREAD, &avail) < 0 || avail == 0)
+        break;
+    }
+
+    return true;
+  }
+  catch (std::exception& e)
+  {
+    cerr << "DEC Caught EXCEPTION: " << e.what() << endl;
+  }
+  catch (...)
+  {
+    cerr << "DEC Caught UNKNOWN EXCEPT" << endl;
+  }
+
+  return false;
+}
+
+void DistributedEngineComm::errorAllSessions()
+{
+  SBS sbs(new ByteStream(0));
+
+  for (uint32_t i = 0; i < sessionShardCount; i++)
+  {
+    std::lock_guard lk(fSessionMessages[i].lock);
+    MessageQueueMap::iterator map_tok;
+
+    for (map_tok = fSessionMessages[i].sessions.begin(); map_tok != fSessionMessages[i].sessions.end();
+         ++map_tok)
+    {
+      map_tok->second->queue.clear();
+      map_tok->second->queue.push(sbs);
+    }
+  }
+}
+
+void DistributedEngineComm::connectionLost(boost::shared_ptr<MessageQueueClient> client)
+{
+  // @bug 488 - error condition! push 0 length bs to messagequeuemap and
+  // eventually let jobstep error out.
+  errorAllSessions();
+
+  // not when Close() stopped the readers
+  if (fIsExeMgr && Busy())
+  {
+    // Re-establish if a remote PM restarted.
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+    reconnect(ClientList(1, client));
+
     /*
             // reset the pmconnection vector
             ClientList tempConns;
@@ -464,6 +764,35 @@ Error:
   return;
 }
 
+void DistributedEngineComm::connectionLostInPool(boost::shared_ptr<MessageQueueClient> client)
+{
+  errorAllSessions();
+
+  if (!fIsExeMgr)
+    return;
+
+  // a pool thread doesn't wait for the PM, the other connections still have to be read
+  std::lock_guard lk(fReconnectLock);
+  fLostClients.push_back(client);
+  fReconnectCond.notify_one();
+}
+
+void DistributedEngineComm::reconnect(const ClientList& lost)
+{
+  decltype(pmCount) originalPMCount = pmCount;
+  auto rc = Setup();
+
+  if (rc || originalPMCount != pmCount)
+  {
+    for (uint32_t i = 0; i < lost.size(); i++)
+    {
+      ostringstream os;
+      os << "DEC: lost connection to " << lost[i]->addr2String();
+      writeToLog(__FILE__, __LINE__, os.str(), LOG_TYPE_ERROR);
+    }
+  }
+}
+
 void DistributedEngineComm::addQueue(uint32_t key, bool sendACKs)
 {
   bool b;
@@ -476,10 +805,13 @@ void DistributedEngineComm::addQueue(uint32_t key, bool sendACKs)
 
   mqe->queue = StepMsgQueue(lock, cond);
   mqe->sendACKs = sendACKs;
-  mqe->throttled = false;
 
-  std::lock_guard lk(fMlock);
-  b = fSessionMessages.insert(pair<uint32_t, boost::shared_ptr<MQE> >(key, mqe)).second;
+  if (sendACKs && pmCount > 0)
+    mqe->credit.reset(new StepCredit(pmCount, max<uint64_t>(fCreditWindow / pmCount, 1)));
+
+  SessionShard& shard = shardOf(key);
+  std::lock_guard lk(shard.lock);
+  b = shard.sessions.insert(pair<uint32_t, boost::shared_ptr<MQE> >(key, mqe)).second;
 
   if (!b)
   {
@@ -491,38 +823,47 @@ void DistributedEngineComm::addQueue(uint32_t key, bool sendACKs)
 
 void DistributedEngineComm::removeQueue(uint32_t key)
 {
-  std::lock_guard lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
+  SessionShard& shard = shardOf(key);
+  std::lock_guard lk(shard.lock);
+  MessageQueueMap::iterator map_tok = shard.sessions.find(key);
 
-  if (map_tok == fSessionMessages.end())
+  if (map_tok == shard.sessions.end())
     return;
 
   map_tok->second->queue.shutdown();
   map_tok->second->queue.clear();
-  fSessionMessages.erase(map_tok);
+  shard.sessions.erase(map_tok);
 }
 
 void DistributedEngineComm::shutdownQueue(uint32_t key)
 {
-  std::lock_guard lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
+  boost::shared_ptr<MQE> mqe = findQueue(key);
 
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
     return;
 
-  map_tok->second->queue.shutdown();
-  map_tok->second->queue.clear();
+  mqe->queue.shutdown();
+  mqe->queue.clear();
 }
 
-void DistributedEngineComm::read(uint32_t key, SBS& bs)
+boost::shared_ptr<DistributedEngineComm::MQE> DistributedEngineComm::findQueue(uint32_t key)
 {
-  boost::shared_ptr<MQE> mqe;
+  SessionShard& shard = shardOf(key);
+  std::lock_guard lk(shard.lock);
+  MessageQueueMap::iterator map_tok = shard.sessions.find(key);
+
+  if (map_tok == shard.sessions.end())
+    return boost::shared_ptr<MQE>();
+
+  return map_tok->second;
+}
 
+void DistributedEngineComm::read(uint32_t key, SBS& bs)
+{
   // Find the StepMsgQueueList for this session
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
+  boost::shared_ptr<MQE> mqe = findQueue(key);
 
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
   {
     ostringstream os;
 
@@ -530,22 +871,14 @@ void DistributedEngineComm::read(uint32_t key, SBS& bs)
     throw runtime_error(os.str());
   }
 
-  mqe = map_tok->second;
-  lk.unlock();
-
   // this method can block: you can't hold any locks here...
   TSQSize_t queueSize = mqe->queue.pop(&bs);
 
-  if (bs && mqe->sendACKs)
+  if (bs && mqe->credit)
   {
-    std::unique_lock lk(ackLock);
-
-    if (mqe->throttled && !mqe->hasBigMsgs && queueSize.size <= disableThreshold)
-      setFlowControl(false, key, mqe);
-
     vector<SBS> v;
     v.push_back(bs);
-    sendAcks(key, v, mqe, queueSize.size);
+    returnCredit(key, mqe, v, queueSize.size == 0);
   }
 
   if (!bs)
@@ -555,13 +888,11 @@ void DistributedEngineComm::read(uint32_t key, SBS& bs)
 const ByteStream DistributedEngineComm::read(uint32_t key)
 {
   SBS sbs;
-  boost::shared_ptr<MQE> mqe;
 
   // Find the StepMsgQueueList for this session
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
+  boost::shared_ptr<MQE> mqe = findQueue(key);
 
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
   {
     ostringstream os;
 
@@ -569,21 +900,13 @@ const ByteStream DistributedEngineComm::read(uint32_t key)
     throw runtime_error(os.str());
   }
 
-  mqe = map_tok->second;
-  lk.unlock();
-
   TSQSize_t queueSize = mqe->queue.pop(&sbs);
 
-  if (sbs && mqe->sendACKs)
+  if (sbs && mqe->credit)
   {
-    std::unique_lock lk(ackLock);
-
-    if (mqe->throttled && !mqe->hasBigMsgs && queueSize.size <= disableThreshold)
-      setFlowControl(false, key, mqe);
-
     vector<SBS> v;
     v.push_back(sbs);
-    sendAcks(key, v, mqe, queueSize.size);
+    returnCredit(key, mqe, v, queueSize.size == 0);
   }
 
   if (!sbs)
@@ -594,38 +917,26 @@ const ByteStream DistributedEngineComm::read(uint32_t key)
 
 void DistributedEngineComm::read_all(uint32_t key, vector<SBS>& v)
 {
-  boost::shared_ptr<MQE> mqe;
+  boost::shared_ptr<MQE> mqe = findQueue(key);
 
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
-
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
   {
     ostringstream os;
     os << "DEC: read_all(): attempt to read from a nonexistent queue\n";
     throw runtime_error(os.str());
   }
 
-  mqe = map_tok->second;
-  lk.unlock();
-
   mqe->queue.pop_all(v);
 
-  if (mqe->sendACKs)
-  {
-    std::unique_lock lk(ackLock);
-    sendAcks(key, v, mqe, 0);
-  }
+  if (mqe->credit)
+    returnCredit(key, mqe, v, true);
 }
 
 void DistributedEngineComm::read_some(uint32_t key, uint32_t divisor, vector<SBS>& v, bool* flowControlOn)
 {
-  boost::shared_ptr<MQE> mqe;
-
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
+  boost::shared_ptr<MQE> mqe = findQueue(key);
 
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
   {
     ostringstream os;
 
@@ -633,258 +944,47 @@ void DistributedEngineComm::read_some(uint32_t key, uint32_t divisor, vector<SBS
     throw runtime_error(os.str());
   }
 
-  mqe = map_tok->second;
-  lk.unlock();
-
   TSQSize_t queueSize = mqe->queue.pop_some(divisor, v, 1);  // need to play with the min #
 
   if (flowControlOn)
     *flowControlOn = false;
 
-  if (mqe->sendACKs)
+  if (mqe->credit)
   {
-    std::unique_lock lk(ackLock);
-
-    if (mqe->throttled && !mqe->hasBigMsgs && queueSize.size <= disableThreshold)
-      setFlowControl(false, key, mqe);
-
-    sendAcks(key, v, mqe, queueSize.size);
+    returnCredit(key, mqe, v, queueSize.size == 0);
 
     if (flowControlOn)
-      *flowControlOn = mqe->throttled;
+      *flowControlOn = mqe->credit->outOfCredit();
   }
 }
 
-void DistributedEngineComm::sendAcks(uint32_t uniqueID, const vector<SBS>& msgs, boost::shared_ptr<MQE> mqe,
-                                     size_t queueSize)
+void DistributedEngineComm::returnCredit(uint32_t uniqueID, boost::shared_ptr<MQE> mqe, const vector<SBS>& msgs,
+                                         bool queueEmpty)
 {
-  ISMPacketHeader* ism;
-  uint32_t l_msgCount = msgs.size();
-
-  /* If the current queue size > target, do nothing.
-   * If the original queue size > target, ACK the msgs below the target.
-   */
-  if (!mqe->throttled || queueSize >= mqe->targetQueueSize)
-  {
-    /* no acks will be sent, but update unackedwork to keep the #s accurate */
-    uint16_t numack = 0;
-    uint32_t sockidx = 0;
-
-    while (l_msgCount > 0)
-    {
-      nextPMToACK(mqe, l_msgCount, &sockidx, &numack);
-      idbassert(numack <= l_msgCount);
-      l_msgCount -= numack;
-    }
+  vector<uint64_t> credit;
 
+  if (!mqe->credit->read(msgs, queueEmpty, credit))
     return;
-  }
-
-  size_t totalMsgSize = 0;
-
-  for (uint32_t i = 0; i < msgs.size(); i++)
-    totalMsgSize += msgs[i]->lengthWithHdrOverhead();
-
-  if (queueSize + totalMsgSize > mqe->targetQueueSize)
-  {
-    /* update unackedwork for the overage that will never be acked */
-    int64_t overage = queueSize + totalMsgSize - mqe->targetQueueSize;
-    uint16_t numack = 0;
-    uint32_t sockidx = 0;
-    uint32_t msgsToIgnore;
-
-    for (msgsToIgnore = 0; overage >= 0; msgsToIgnore++)
-      overage -= msgs[msgsToIgnore]->lengthWithHdrOverhead();
-
-    if (overage < 0)
-      msgsToIgnore--;
-
-    l_msgCount = msgs.size() - msgsToIgnore;  // this num gets acked
-
-    while (msgsToIgnore > 0)
-    {
-      nextPMToACK(mqe, msgsToIgnore, &sockidx, &numack);
-      idbassert(numack <= msgsToIgnore);
-      msgsToIgnore -= numack;
-    }
-  }
 
-  if (l_msgCount > 0)
+  for (uint32_t i = 0; i < credit.size(); i++)
   {
-    SBS msg(new ByteStream(sizeof(ISMPacketHeader)));
-    uint16_t* toAck;
-    vector<bool> pmAcked(pmCount, false);
-
-    ism = (ISMPacketHeader*)msg->getInputPtr();
-    // The only var checked by ReadThread is the Command var.  The others
-    // are wasted space.  We hijack the Size, & Flags fields for the
-    // params to the ACK msg.
-
-    ism->Interleave = uniqueID;
-    ism->Command = BATCH_PRIMITIVE_ACK;
-    toAck = &ism->Size;
-
-    msg->advanceInputPtr(sizeof(ISMPacketHeader));
-    // There must be only one local connection here.
-    uint32_t localConnectionId = std::numeric_limits<uint32_t>::max();
-    for (uint32_t i = 0; i < pmCount; ++i)
-    {
-      if (fPmConnections[i]->atTheSameHost() && fIsExeMgr)
-        localConnectionId = i;
-    }
-    bool sendToLocal = false;
-    while (l_msgCount > 0)
-    {
-      /* could have to send up to pmCount ACKs */
-      uint32_t sockIndex = 0;
-
-      /* This will reset the ACK field in the Bytestream directly, and nothing
-       * else needs to change if multiple msgs are sent. */
-      nextPMToACK(mqe, l_msgCount, &sockIndex, toAck);
-      idbassert(*toAck <= l_msgCount);
-      l_msgCount -= *toAck;
-      if (sockIndex == localConnectionId)
-      {
-        sendToLocal = true;
-        continue;
-      }
-      pmAcked[sockIndex] = true;
-      writeToClient(sockIndex, msg);
-    }
-    if (sendToLocal && localConnectionId < fPmConnections.size())
-    {
-      pmAcked[localConnectionId] = true;
-      writeToClient(localConnectionId, msg);
-    }
-
-    // @bug4436, when no more unacked work, send an ack to all PMs that haven't been acked.
-    // This is apply to the big message case only.  For small messages, the flow control is
-    // disabled when the queue size is below the disableThreshold.
-    if (mqe->hasBigMsgs)
-    {
-      uint64_t totalUnackedWork = 0;
-
-      for (uint32_t i = 0; i < pmCount; ++i)
-        totalUnackedWork += mqe->unackedWork[i];
-
-      if (totalUnackedWork == 0)
-      {
-        *toAck = 1;
-
-        for (uint32_t i = 0; i < pmCount; ++i)
-        {
-          if (!pmAcked[i])
-          {
-            if (i == localConnectionId)
-            {
-              continue;
-            }
-            writeToClient(i, msg);
-          }
-        }
-        if (!pmAcked[localConnectionId])
-        {
-          writeToClient(localConnectionId, msg);
-        }
-      }
-    }
+    if (credit[i] > 0)
+      sendCredit(uniqueID, i, credit[i]);
   }
 }
 
-void DistributedEngineComm::nextPMToACK(boost::shared_ptr<MQE> mqe, uint32_t maxAck, uint32_t* sockIndex,
-                                        uint16_t* numToAck)
+void DistributedEngineComm::sendCredit(uint32_t uniqueID, uint32_t pmIndex, uint64_t bytes)
 {
-  uint32_t& nextIndex = mqe->ackSocketIndex;
-
-  /* Other threads can be touching mqe->unackedWork at the same time, but because of
-   * the locking env, mqe->unackedWork can only grow; whatever gets latched in this fcn
-   * is a safe minimum at the point of use. */
-
-  if (mqe->unackedWork[nextIndex] >= maxAck)
-  {
-    (void)atomicops::atomicSub(&mqe->unackedWork[nextIndex], maxAck);
-    *sockIndex = nextIndex;
-    // FIXME: we're going to truncate here from 32 to 16 bits. Hopefully this will always fit...
-    *numToAck = maxAck;
-
-    if (pmCount > 0)
-      nextIndex = (nextIndex + 1) % pmCount;
-
-    return;
-  }
-  else
-  {
-    for (int i = pmCount - 1; i >= 0; --i)
-    {
-      uint32_t curVal = mqe->unackedWork[nextIndex];
-      uint32_t unackedWork = (curVal > maxAck ? maxAck : curVal);
-
-      if (unackedWork > 0)
-      {
-        (void)atomicops::atomicSub(&mqe->unackedWork[nextIndex], unackedWork);
-        *sockIndex = nextIndex;
-        *numToAck = unackedWork;
-
-        if (pmCount > 0)
-          nextIndex = (nextIndex + 1) % pmCount;
-
-        return;
-      }
-
-      if (pmCount > 0)
-        nextIndex = (nextIndex + 1) % pmCount;
-    }
-
-    cerr << "DEC::nextPMToACK(): Couldn't find a PM to ACK! ";
-
-    for (int i = pmCount - 1; i >= 0; --i)
-      cerr << mqe->unackedWork[i] << " ";
-
-    cerr << " max: " << maxAck;
-    cerr << endl;
-    // make sure the returned vars are legitimate
-    *sockIndex = nextIndex;
-    *numToAck = maxAck / pmCount;
-
-    if (pmCount > 0)
-      nextIndex = (nextIndex + 1) % pmCount;
-
-    return;
-  }
-}
-
-void DistributedEngineComm::setFlowControl(bool enabled, uint32_t uniqueID, boost::shared_ptr<MQE> mqe)
-{
-  mqe->throttled = enabled;
-  SBS msg(new ByteStream(sizeof(ISMPacketHeader)));
+  SBS msg(new ByteStream(sizeof(ISMPacketHeader) + sizeof(bytes)));
   ISMPacketHeader* ism = (ISMPacketHeader*)msg->getInputPtr();
 
+  // The only vars checked by the PM are Command & Interleave, the credit follows the header
   ism->Interleave = uniqueID;
   ism->Command = BATCH_PRIMITIVE_ACK;
-  ism->Size = (enabled ? 0 : -1);
-
-#ifdef VALGRIND
-  /* XXXPAT: For testing in valgrind, init the vars that don't get used */
-  ism->Flags = 0;
-  ism->Type = 0;
-  ism->MsgCount = 0;
-  ism->Status = 0;
-#endif
-
   msg->advanceInputPtr(sizeof(ISMPacketHeader));
-  uint32_t localConnectionId = std::numeric_limits<uint32_t>::max();
+  *msg << bytes;
 
-  for (uint32_t i = 0; i < mqe->pmCount; ++i)
-  {
-    if (fPmConnections[i]->atTheSameHost() && fIsExeMgr)
-    {
-      localConnectionId = i;
-      continue;
-    }
-    writeToClient(i, msg);
-  }
-  if (localConnectionId < fPmConnections.size())
-    writeToClient(localConnectionId, msg);
+  writeToClient(pmIndex, msg);
 }
 
 int32_t DistributedEngineComm::write(uint32_t senderID, const SBS& msg)
@@ -898,8 +998,11 @@ int32_t DistributedEngineComm::write(uint32_t senderID, const SBS& msg)
     switch (ism->Command)
     {
       case BATCH_PRIMITIVE_CREATE:
-        /* Disable flow control initially */
-        *msg << (uint32_t)-1;
+      {
+        /* The credit of every PM, -1 disables flow control */
+        boost::shared_ptr<MQE> mqe = findQueue(senderID);
+        *msg << ((mqe && mqe->credit) ? mqe->credit->getCreditPerPM() : (uint64_t)-1);
+      }
         /* FALLTHRU */
 
       case BATCH_PRIMITIVE_DESTROY:
@@ -958,29 +1061,107 @@ void DistributedEngineComm::write(messageqcpp::ByteStream& msg, uint32_t connect
   PrimitiveHeader* pm = (PrimitiveHeader*)(ism + 1);
   uint32_t senderID = pm->UniqueID;
 
-  MessageQueueMap::iterator it;
   // This keeps mqe's stats from being freed until end of function
-  boost::shared_ptr<MQE> mqe;
+  boost::shared_ptr<MQE> mqe = findQueue(senderID);
   Stats* senderStats = NULL;
 
-  std::unique_lock lk(fMlock);
-  it = fSessionMessages.find(senderID);
+  if (mqe)
+    senderStats = &(mqe->stats);
+
+  newClients[connection]->write(msg, NULL, senderStats);
+}
 
-  if (it != fSessionMessages.end())
+void DistributedEngineComm::StartClientListener(boost::shared_ptr<MessageQueueClient> cl, uint32_t connIndex)
+{
+  if (fEpollFd < 0)
   {
-    mqe = it->second;
-    senderStats = &(mqe->stats);
+    boost::thread* thrd = new boost::thread(EngineCommRunner(this, cl, connIndex));
+    fPmReader.push_back(thrd);
+    return;
   }
 
-  lk.unlock();
+  boost::shared_ptr<PMReader> reader(new PMReader());
+  reader->client = cl;
+  reader->connIndex = connIndex;
+  reader->sd = cl->sd();
 
-  newClients[connection]->write(msg, NULL, senderStats);
+  std::lock_guard lk(fReaderLock);
+  struct epoll_event ev;
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.u64 = fNextReaderId;
+
+  if (epoll_ctl(fEpollFd, EPOLL_CTL_ADD, reader->sd, &ev) < 0)
+    throw runtime_error(string("DEC: epoll_ctl() failed: ") + strerror(errno));
+
+  fReaders[fNextReaderId++] = reader;
 }
 
-void DistributedEngineComm::StartClientListener(boost::shared_ptr<MessageQueueClient> cl, uint32_t connIndex)
+void DistributedEngineComm::StopClientListener(boost::shared_ptr<MessageQueueClient> cl)
 {
-  boost::thread* thrd = new boost::thread(EngineCommRunner(this, cl, connIndex));
-  fPmReader.push_back(thrd);
+  std::lock_guard lk(fReaderLock);
+
+  for (PMReaderMap::iterator it = fReaders.begin(); it != fReaders.end(); ++it)
+  {
+    if (it->second->client == cl)
+    {
+      epoll_ctl(fEpollFd, EPOLL_CTL_DEL, it->second->sd, NULL);
+      fReaders.erase(it);
+      return;
+    }
+  }
+}
+
+void DistributedEngineComm::startReaderPool()
+{
+  if (fEpollFd < 0)
+    return;
+
+  uint32_t threads = std::max(fRm->getDECReaderThreads(), 1U);
+
+  for (uint32_t i = 0; i < threads; i++)
+    fPmReader.push_back(new boost::thread(ReaderPoolRunner(this)));
+
+  if (fIsExeMgr)
+    fReconnector = new boost::thread(ReconnectRunner(this));
+}
+
+void DistributedEngineComm::stopReaderPool()
+{
+  if (fEpollFd < 0)
+    return;
+
+  // Busy() is false, a reconnect in progress finishes first so it doesn't add readers after this
+  if (fReconnector)
+  {
+    {
+      std::lock_guard rlk(fReconnectLock);
+      fReconnectCond.notify_all();
+    }
+
+    fReconnector->join();
+    delete fReconnector;
+    fReconnector = 0;
+  }
+
+  std::unique_lock lk(fReaderLock);
+
+  // wakes up the threads waiting for the rest of a message
+  for (PMReaderMap::iterator it = fReaders.begin(); it != fReaders.end(); ++it)
+    ::shutdown(it->second->sd, SHUT_RDWR);
+
+  fReaders.clear();
+  lk.unlock();
+
+  // Busy() is false, they return within readerWaitMSecs
+  for (uint32_t i = 0; i < fPmReader.size(); i++)
+  {
+    fPmReader[i]->join();
+    delete fPmReader[i];
+  }
+
+  fPmReader.clear();
+  ::close(fEpollFd);
+  fEpollFd = -1;
 }
 
 void DistributedEngineComm::addDataToOutput(SBS sbs)
@@ -988,31 +1169,19 @@ void DistributedEngineComm::addDataToOutput(SBS sbs)
   ISMPacketHeader* hdr = (ISMPacketHeader*)(sbs->buf());
   PrimitiveHeader* p = (PrimitiveHeader*)(hdr + 1);
   uint32_t uniqueId = p->UniqueID;
-  boost::shared_ptr<MQE> mqe;
-
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(uniqueId);
+  boost::shared_ptr<MQE> mqe = findQueue(uniqueId);
 
   // The message for a session that doesn't exist.
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
   {
     // Here gets the dead session ByteStream that is already removed
     // from DEC queue.
     return;
   }
 
-  mqe = map_tok->second;
-  lk.unlock();
-
-  if (pmCount > 0)
-  {
-    // I hardcoded the unacked Worker id here. ACK isn't important
-    // for the local exchange b/c there is no need to
-    // enable flowcontrol localy on PM.
-    (void)atomicops::atomicInc(&mqe->unackedWork[0]);
-  }
-
-  [[maybe_unused]] TSQSize_t queueSize = mqe->queue.push(sbs);
+  // The local exchange doesn't use credit, the PM doesn't send these
+  // through its send thread, and they aren't sent() to mqe->credit.
+  mqe->queue.push(sbs);
   // There will be no statistics about data transfered
   // over the memory.
 }
@@ -1022,11 +1191,9 @@ void DistributedEngineComm::addDataToOutput(SBS sbs, uint32_t connIndex, Stats*
   ISMPacketHeader* hdr = (ISMPacketHeader*)(sbs->buf());
   PrimitiveHeader* p = (PrimitiveHeader*)(hdr + 1);
   uint32_t uniqueId = p->UniqueID;
-  boost::shared_ptr<MQE> mqe;
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(uniqueId);
+  boost::shared_ptr<MQE> mqe = findQueue(uniqueId);
 
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
   {
     // For debugging...
     // cerr << "DistributedEngineComm::AddDataToOutput: tried to add a message to a dead session: " <<
@@ -1034,41 +1201,16 @@ void DistributedEngineComm::addDataToOutput(SBS sbs, uint32_t connIndex, Stats*
     return;
   }
 
-  mqe = map_tok->second;
-  lk.unlock();
-
-  if (pmCount > 0)
-  {
-    (void)atomicops::atomicInc(&mqe->unackedWork[connIndex % pmCount]);
-  }
+  // before the push, the reader returns the credit once it has the msg
+  if (mqe->credit && mqe->pmCount > 0)
+    mqe->credit->sent(connIndex % mqe->pmCount, sbs);
 
-  TSQSize_t queueSize = mqe->queue.push(sbs);
-
-  if (mqe->sendACKs)
-  {
-    std::lock_guard lk(ackLock);
-    uint64_t msgSize = sbs->lengthWithHdrOverhead();
-
-    if (!mqe->throttled && msgSize > (targetRecvQueueSize / 2))
-      doHasBigMsgs(mqe, (300 * 1024 * 1024 > 3 * msgSize ? 300 * 1024 * 1024
-                                                         : 3 * msgSize));  // buffer at least 3 big msgs
-
-    if (!mqe->throttled && queueSize.size >= mqe->targetQueueSize)
-      setFlowControl(true, uniqueId, mqe);
-  }
+  mqe->queue.push(sbs);
 
   if (stats)
     mqe->stats.dataRecvd(stats->dataRecvd());
 }
 
-void DistributedEngineComm::doHasBigMsgs(boost::shared_ptr<MQE> mqe, uint64_t targetSize)
-{
-  mqe->hasBigMsgs = true;
-
-  if (mqe->targetQueueSize < targetSize)
-    mqe->targetQueueSize = targetSize;
-}
-
 DistributedEngineComm::SBSVector& DistributedEngineComm::readLocalQueueMessagesOrWait(
     SBSVector& receivedMessages)
 {
@@ -1108,7 +1250,6 @@ void DistributedEngineComm::pushToTheLocalQueueAndNotifyRecv(const messageqcpp::
 int DistributedEngineComm::writeToClient(size_t aPMIndex, const SBS& bs, uint32_t senderUniqueID,
                                          bool doInterleaving)
 {
-  MessageQueueMap::iterator it;
   // Keep mqe's stats from being freed early
   boost::shared_ptr<MQE> mqe;
   Stats* senderStats = NULL;
@@ -1127,10 +1268,12 @@ int DistributedEngineComm::writeToClient(size_t aPMIndex, const SBS& bs, uint32_
 
   if (senderUniqueID != numeric_limits<uint32_t>::max())
   {
-    std::lock_guard lk(fMlock);
-    it = fSessionMessages.find(senderUniqueID);
+    // the shard lock also guards the interleaver
+    SessionShard& shard = shardOf(senderUniqueID);
+    std::lock_guard lk(shard.lock);
+    MessageQueueMap::iterator it = shard.sessions.find(senderUniqueID);
 
-    if (it != fSessionMessages.end())
+    if (it != shard.sessions.end())
     {
       mqe = it->second;
       senderStats = &(mqe->stats);
@@ -1152,18 +1295,8 @@ int DistributedEngineComm::writeToClient(size_t aPMIndex, const SBS& bs, uint32_
   {
     // @bug 488. error out under such condition instead of re-trying other connection,
     // by pushing 0 size bytestream to messagequeue and throw exception
-    SBS sbs;
-    std::unique_lock lk(fMlock);
     // std::cout << "WARNING: DEC WRITE BROKEN PIPE. PMS index = " << index << std::endl;
-    MessageQueueMap::iterator map_tok;
-    sbs.reset(new ByteStream(0));
-
-    for (map_tok = fSessionMessages.begin(); map_tok != fSessionMessages.end(); ++map_tok)
-    {
-      map_tok->second->queue.clear();
-      (void)atomicops::atomicInc(&map_tok->second->unackedWork[0]);
-      map_tok->second->queue.push(sbs);
-    }
+    errorAllSessions();
 
     int tries = 0;
     // Try to setup connection with PS, it could be a situation that PS is starting.
@@ -1174,8 +1307,6 @@ int DistributedEngineComm::writeToClient(size_t aPMIndex, const SBS& bs, uint32_
       std::this_thread::sleep_for(std::chrono::seconds(3));
     }
 
-    lk.unlock();
-
     if (tries == 10)
     {
       ostringstream os;
@@ -1226,15 +1357,11 @@ int DistributedEngineComm::writeToClient(size_t aPMIndex, const SBS& bs, uint32_
 
 uint32_t DistributedEngineComm::size(uint32_t key)
 {
-  std::unique_lock lk(fMlock);
-  MessageQueueMap::iterator map_tok = fSessionMessages.find(key);
+  boost::shared_ptr<MQE> mqe = findQueue(key);
 
-  if (map_tok == fSessionMessages.end())
+  if (!mqe)
     throw runtime_error("DEC::size() attempt to get the size of a nonexistant queue!");
 
-  boost::shared_ptr<MQE> mqe = map_tok->second;
-  // TODO: should probably check that this is a valid iter...
-  lk.unlock();
   return mqe->queue.size().count;
 }
 
@@ -1259,24 +1386,33 @@ void DistributedEngineComm::removeDECEventListener(DECEventListener* l)
 
 Stats DistributedEngineComm::getNetworkStats(uint32_t uniqueID)
 {
-  std::lock_guard lk(fMlock);
+  SessionShard& shard = shardOf(uniqueID);
+  std::lock_guard lk(shard.lock);
   MessageQueueMap::iterator it;
   Stats empty;
 
-  it = fSessionMessages.find(uniqueID);
+  it = shard.sessions.find(uniqueID);
 
-  if (it != fSessionMessages.end())
+  if (it != shard.sessions.end())
     return it->second->stats;
 
   return empty;
 }
 
+uint64_t DistributedEngineComm::getCreditStallTime(uint32_t uniqueID)
+{
+  boost::shared_ptr<MQE> mqe = findQueue(uniqueID);
+
+  if (!mqe || !mqe->credit)
+    return 0;
+
+  return mqe->credit->getStallTime();
+}
+
 DistributedEngineComm::MQE::MQE(const uint32_t pCount, const uint32_t initialInterleaverValue)
- : ackSocketIndex(0), pmCount(pCount), hasBigMsgs(false), targetQueueSize(targetRecvQueueSize)
+ : pmCount(pCount), sendACKs(false)
 {
-  unackedWork.reset(new volatile uint32_t[pmCount]);
   interleaver.reset(new uint32_t[pmCount]);
-  memset((void*)unackedWork.get(), 0, pmCount * sizeof(uint32_t));
   uint32_t interleaverValue = initialInterleaverValue;
   initialConnectionId = initialInterleaverValue;
   for (size_t pmId = 0; pmId < pmCount; ++pmId)
@@ -39,9 +39,11 @@
 #include <ifaddrs.h>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 #include "bytestream.h"
@@ -78,6 +80,54 @@ class DECEventListener
   virtual void newPMOnline(uint32_t newConnectionNumber) = 0;
 };
 
+/** @brief The byte credit of the PMs that send to a step, the UM side of the flow control
+ *
+ * Every PM may send creditPerPM bytes that the step hasn't read.  sent() records
+ * a message a PM sent, read() gives the bytes of the messages the step read back
+ * to the PMs that sent them, once a PM has a quarter of its credit to get back or
+ * the step caught up.  Messages that weren't sent(), like the ones of the local
+ * exchange, don't use credit.
+ */
+class StepCredit
+{
+ public:
+  EXPORT StepCredit(uint32_t pmCount, uint64_t creditPerPM);
+
+  uint64_t getCreditPerPM() const
+  {
+    return fCreditPerPM;
+  }
+
+  /** @brief pmIndex sent msg, before the step can read it */
+  EXPORT void sent(uint32_t pmIndex, const messageqcpp::SBS& msg);
+
+  /** @brief The step read msgs, queueEmpty if that was all there was.  Sets credit to
+   *  the bytes to return to each PM, returns false if there are none to return yet.
+   */
+  EXPORT bool read(const std::vector<messageqcpp::SBS>& msgs, bool queueEmpty,
+                   std::vector<uint64_t>& credit);
+
+  /** @brief The bytes pmIndex sent and didn't get back */
+  EXPORT uint64_t getCreditUsed(uint32_t pmIndex);
+
+  /** @brief Whether a PM waits for credit */
+  EXPORT bool outOfCredit();
+
+  /** @brief The time the PMs spent out of credit so far, in ns */
+  EXPORT uint64_t getStallTime();
+
+ private:
+  std::mutex fLock;
+  uint64_t fCreditPerPM;
+  std::vector<uint64_t> fUsed;      // sent and not returned
+  std::vector<uint64_t> fToReturn;  // read and not returned yet
+  // when a PM ran out of credit, 0 if it has some, and the total time out of it
+  std::vector<uint64_t> fStallStart;
+  uint64_t fStallNanos;
+  // the PM and the size of the messages sent and not read
+  std::unordered_map<const messageqcpp::ByteStream*, std::pair<uint32_t, uint64_t>> fUnread;
+};
+
 /**
  * class DistributedEngineComm
  */
@@ -133,7 +183,7 @@ class DistributedEngineComm
    */
   EXPORT void read_all(uint32_t key, std::vector<messageqcpp::SBS>& v);
 
-  /** reads queuesize/divisor msgs */
+  /** reads queuesize/divisor msgs, flowControlOn says if a PM is out of credit */
   EXPORT void read_some(uint32_t key, uint32_t divisor, std::vector<messageqcpp::SBS>& v,
                         bool* flowControlOn = NULL);
 
@@ -159,10 +209,25 @@ class DistributedEngineComm
   /** @brief Start listening for primitive responses
    *
    * Starts the current thread listening on the client socket for primitive response messages. Will not return
-   * until busy() returns false or a zero-length response is received.
+   * until busy() returns false or a zero-length response is received.  Only used if epoll isn't available,
+   * the reader pool reads the connections otherwise.
    */
   EXPORT void Listen(boost::shared_ptr<messageqcpp::MessageQueueClient> client, uint32_t connIndex);
 
+  /** @brief A thread of the reader pool
+   *
+   * Waits for a connection to have data, then reads the messages that are there.  Returns when busy()
+   * returns false.
+   */
+  void ReadConnections();
+
+  /** @brief The reconnect thread of the reader pool
+   *
+   * Reconnects in ExeMgr after the pool lost connections, so the pool threads go back to reading the
+   * other connections at once.  Returns when busy() returns false.
+   */
+  void Reconnect();
+
   /** @brief set/unset busy flag
    *
    * Set or unset the busy flag so Listen() can return.
@@ -214,6 +279,8 @@ class DistributedEngineComm
   void getLocalNetIfacesSins();
 
   messageqcpp::Stats getNetworkStats(uint32_t uniqueID);
+  // The time the PMs spent out of credit for uniqueID, in ns
+  uint64_t getCreditStallTime(uint32_t uniqueID);
   void addDataToOutput(messageqcpp::SBS sbs);
   SBSVector& readLocalQueueMessagesOrWait(SBSVector&);
 
@@ -234,32 +301,71 @@ class DistributedEngineComm
                                  const uint32_t DECConnectionsPerQuery);
     messageqcpp::Stats stats;
     StepMsgQueue queue;
-    uint32_t ackSocketIndex;
-    boost::scoped_array<volatile uint32_t> unackedWork;
     boost::scoped_array<uint32_t> interleaver;
     uint32_t initialConnectionId;
     uint32_t pmCount;
-    // non-BPP primitives don't do ACKs
+    // non-BPP primitives don't do flow control
     bool sendACKs;
+    // the credit of the PMs, if sendACKs
+    std::unique_ptr<StepCredit> credit;
+  };
 
-    // This var will allow us to toggle flow control for BPP instances when
-    // the UM is keeping up.  Send -1 as the ACK value to disable flow control
-    // on the PM side, positive value to reenable it.  Not yet impl'd on the UM side.
-    bool throttled;
+  // The mapping of session ids to StepMsgQueueLists
+  typedef std::map<unsigned, boost::shared_ptr<MQE>> MessageQueueMap;
 
-    // This var signifies that the PM can return msgs big enough to keep toggling
-    // FC on and off.  We force FC on in that case and maintain a larger buffer.
-    bool hasBigMsgs;
+  // The sessions are spread over shards by id, the steps of different queries don't share a lock
+  struct SessionShard
+  {
+    std::mutex lock;
+    MessageQueueMap sessions;
+  };
+  static const uint32_t sessionShardCount = 64;
 
-    uint64_t targetQueueSize;
+  SessionShard& shardOf(uint32_t key)
+  {
+    return fSessionMessages[key % sessionShardCount];
+  }
+
+  // The queue of a session, NULL if there isn't one
+  boost::shared_ptr<MQE> findQueue(uint32_t key);
+
+  // A PrimProc connection the reader pool reads
+  struct PMReader
+  {
+    boost::shared_ptr<messageqcpp::MessageQueueClient> client;
+    uint32_t connIndex;
+    int sd;
   };
+  typedef std::map<uint64_t, boost::shared_ptr<PMReader>> PMReaderMap;
 
-  // The mapping of session ids to StepMsgQueueLists
-  typedef std::map<unsigned, boost::shared_ptr<MQE>> MessageQueueMap;
+  // the most messages read from a connection before the other connections get a turn
+  static const uint32_t readerBatchSize = 16;
+  static const int readerWaitMSecs = 1000;  // how often the pool threads check busy()
 
   explicit DistributedEngineComm(ResourceManager* rm, bool isExeMgr);
 
   void StartClientListener(boost::shared_ptr<messageqcpp::MessageQueueClient> cl, uint32_t connIndex);
+  void StopClientListener(boost::shared_ptr<messageqcpp::MessageQueueClient> cl);
+  void startReaderPool();
+  void stopReaderPool();
+
+  /** @brief Reads up to readerBatchSize messages from the connection
+   *
+   * Returns false if the connection is gone.
+   */
+  bool readMessages(PMReader& reader);
+
+  /** @brief Errors out the sessions and, in ExeMgr, reconnects */
+  void connectionLost(boost::shared_ptr<messageqcpp::MessageQueueClient> client);
+
+  /** @brief Errors out the sessions and, in ExeMgr, leaves the reconnect to the reconnect thread */
+  void connectionLostInPool(boost::shared_ptr<messageqcpp::MessageQueueClient> client);
+
+  /** @brief Connects to the PMs again after the lost connections, logs them if that fails */
+  void reconnect(const ClientList& lost);
+
+  /** @brief Pushes a 0 length message, an error, to every session */
+  void errorAllSessions();
 
   /** @brief Add a message to the queue
    *
@@ -277,10 +383,17 @@ class DistributedEngineComm
   ResourceManager* fRm;
 
   ClientList fPmConnections;  // all the pm servers
-  ReaderList fPmReader;       // all the reader threads for the pm servers
-  MessageQueueMap
-      fSessionMessages;  // place to put messages from the pm server to be returned by the Read method
-  std::mutex fMlock;     // sessionMessages mutex
+  ReaderList fPmReader;       // the reader pool, or a thread per pm connection without epoll
+  // place to put messages from the pm server to be returned by the Read method
+  SessionShard fSessionMessages[sessionShardCount];
+  int fEpollFd;               // the connections the reader pool waits on, -1 without epoll
+  PMReaderMap fReaders;       // by the id in their epoll event
+  uint64_t fNextReaderId;
+  std::mutex fReaderLock;     // fReaders & fNextReaderId
+  boost::thread* fReconnector;  // reconnects for the reader pool, ExeMgr only
+  ClientList fLostClients;      // the connections the pool lost and fReconnector hasn't seen
+  std::mutex fReconnectLock;    // fLostClients
+  std::condition_variable fReconnectCond;
   std::vector<std::shared_ptr<std::mutex>> fWlock;  // PrimProc socket write mutexes
   bool fBusy;
   volatile uint32_t pmCount;
@@ -296,19 +409,15 @@ class DistributedEngineComm
 
   bool fIsExeMgr;
 
-  // send-side throttling vars
-  uint64_t throttleThreshold;
-  static const uint32_t targetRecvQueueSize = 50000000;
-  static const uint32_t disableThreshold = 10000000;
   uint32_t tbpsThreadCount;
   uint32_t fDECConnectionsPerQuery;
 
-  void sendAcks(uint32_t uniqueID, const std::vector<messageqcpp::SBS>& msgs, boost::shared_ptr<MQE> mqe,
-                size_t qSize);
-  void nextPMToACK(boost::shared_ptr<MQE> mqe, uint32_t maxAck, uint32_t* sockIndex, uint16_t* numToAck);
-  void setFlowControl(bool enable, uint32_t uniqueID, boost::shared_ptr<MQE> mqe);
-  void doHasBigMsgs(boost::shared_ptr<MQE> mqe, uint64_t targetSize);
-  boost::mutex ackLock;
+  // receive-side flow control, the credit of a step over all the PMs
+  uint64_t fCreditWindow;
+
+  void returnCredit(uint32_t uniqueID, boost::shared_ptr<MQE> mqe, const std::vector<messageqcpp::SBS>& msgs,
+                    bool queueEmpty);
+  void sendCredit(uint32_t uniqueID, uint32_t pmIndex, uint64_t bytes);
 
   std::vector<struct in_addr> localNetIfaceSins_;
   std::mutex inMemoryEM2PPExchMutex_;
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <set>
 #include <stack>
 #include <string>
@@ -45,6 +46,7 @@
 #include "groupconcat.h"
 #include "jsonarrayagg.h"
 #include "jl_logger.h"
+#include "topnthreshold.h"
 
 #include "resourcemanager.h"
 #include "rowgroup.h"
@@ -248,6 +250,8 @@ struct JobInfo
   uint64_t limitStart;
   uint64_t limitCount;
   uint32_t orderByThreads;
+  // the ORDER BY ... LIMIT cutoff the scan of the first ORDER BY column uses
+  std::shared_ptr<TopNThreshold> topNThreshold;
 
   // tupleInfo
   boost::shared_ptr<TupleKeyInfo> keyInfo;
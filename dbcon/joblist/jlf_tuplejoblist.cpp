@@ -512,6 +512,18 @@ void adjustLastStep(JobStepVector& querySteps, DeliveredTableMap& deliverySteps,
     if (jobInfo.orderByThreads > 1)
       tas->setParallelOp();
     tas->setMaxThreads(jobInfo.orderByThreads);
+
+    // A single table scan feeding the ORDER BY ... LIMIT directly can skip the
+    // extents that can't make it past the LIMIT
+    TupleBPS* tbps = dynamic_cast<TupleBPS*>(deliverySteps[CNX_VTABLE_ID].get());
+
+    if (tbps && jobInfo.limitCount != (uint64_t)-1)
+    {
+      const UniqId& id = jobInfo.keyInfo->tupleKeyVec[jobInfo.orderByColVec[0].first];
+
+      if (id.fPseudo == 0 && id.fSubId == (uint64_t)-1 && id.fId >= 3000)
+        jobInfo.topNThreshold = tbps->makeTopNThreshold(id.fId, jobInfo.orderByColVec[0].second);
+    }
   }
 
   if (jobInfo.constantCol == CONST_COL_EXIST)
@@ -864,6 +864,91 @@ bool LBIDList::CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
   return scan;
 }  // CasualPartitioningPredicate
 
+// The extent filters hold the values of the integer types, as the int64 they
+// are kept in for the CP min/max.
+static inline bool extentFilterColumn(const execplan::CalpontSystemCatalog::ColType& ct, bool isDict)
+{
+  return !isDict && ct.colWidth <= 8 && !datatypes::isCharType(ct.colDataType) &&
+         ct.colDataType != CalpontSystemCatalog::FLOAT && ct.colDataType != CalpontSystemCatalog::UFLOAT &&
+         ct.colDataType != CalpontSystemCatalog::DOUBLE && ct.colDataType != CalpontSystemCatalog::UDOUBLE;
+}
+
+// The value of a filter entry the way the extent filters store it
+static inline int64_t extentFilterValue(const char* MsgDataPtr, const execplan::CalpontSystemCatalog::ColType& ct)
+{
+  bool bIsUnsigned = datatypes::isUnsigned(ct.colDataType);
+
+  switch (ct.colWidth)
+  {
+    case 1: return (bIsUnsigned ? (int64_t) * (uint8_t*)MsgDataPtr : (int64_t) * (int8_t*)MsgDataPtr);
+
+    case 2: return (bIsUnsigned ? (int64_t) * (uint16_t*)MsgDataPtr : (int64_t) * (int16_t*)MsgDataPtr);
+
+    case 4: return (bIsUnsigned ? (int64_t) * (uint32_t*)MsgDataPtr : (int64_t) * (int32_t*)MsgDataPtr);
+
+    default: return *(int64_t*)MsgDataPtr;
+  }
+}
+
+void LBIDList::initExtentFilters(execplan::CalpontSystemCatalog::OID oid, const vector<EMEntry>& extents,
+                                 const messageqcpp::ByteStream* bs, const uint16_t NOPS,
+                                 const execplan::CalpontSystemCatalog::ColType& ct, bool isDict)
+{
+  const char* MsgDataPtr = (const char*)bs->buf();
+  bool hasEquality = false;
+  vector<uint16_t> dbRoots;
+
+  if (!extentFilterColumn(ct, isDict) || bs->length() < NOPS * (ct.colWidth + 2U))
+    return;
+
+  for (uint16_t i = 0; i < NOPS && !hasEquality; i++, MsgDataPtr += ct.colWidth + 2)
+    hasEquality = (MsgDataPtr[0] == COMPARE_EQ);
+
+  if (!hasEquality)
+    return;
+
+  for (const EMEntry& extent : extents)
+    if (find(dbRoots.begin(), dbRoots.end(), extent.dbRoot) == dbRoots.end())
+      dbRoots.push_back(extent.dbRoot);
+
+  ExtentFilterStore::load(oid, dbRoots, fExtentFilters);
+}
+
+bool LBIDList::ExtentFilterPredicate(const EMEntry& extent, const messageqcpp::ByteStream* bs,
+                                     const uint16_t NOPS, const execplan::CalpontSystemCatalog::ColType& ct,
+                                     const uint8_t BOP)
+{
+  if (fExtentFilters.empty())
+    return true;
+
+  ExtentFilterStore::FilterMap::const_iterator it = fExtentFilters.find(extent.range.start);
+
+  if (it == fExtentFilters.end() || !it->second.hasBloomFilter() || !it->second.isCurrent(extent))
+    return true;
+
+  const ExtentFilter& filter = it->second;
+  const char* MsgDataPtr = (const char*)bs->buf();
+
+  // With OR the extent can be skipped only if every term is an equality the
+  // filter rules out, with AND one of them is enough.
+  for (uint16_t i = 0; i < NOPS; i++, MsgDataPtr += ct.colWidth + 2)
+  {
+    char op = MsgDataPtr[0];
+    uint8_t lcf = MsgDataPtr[1];
+    int64_t value = extentFilterValue(MsgDataPtr + 2, ct);
+    bool ruledOut = (op == COMPARE_EQ && lcf == 0 && !execplan::isNull(value, ct) && !filter.mayContain(value));
+
+    if (BOP == BOP_OR && !ruledOut)
+      return true;
+
+    if (BOP != BOP_OR && ruledOut)
+      return false;
+  }
+
+  // every OR term was ruled out, or no AND term was
+  return !(BOP == BOP_OR && NOPS > 0);
+}
+
 void LBIDList::copyLbidList(const LBIDList& rhs)
 {
   em = rhs.em;
@@ -890,6 +975,7 @@ void LBIDList::copyLbidList(const LBIDList& rhs)
 
   LBIDRanges = rhs.LBIDRanges;
   fDebug = rhs.fDebug;
+  fExtentFilters = rhs.fExtentFilters;
 }
 
 template bool LBIDList::GetMinMax<int128_t>(int128_t& min, int128_t& max, int64_t& seq, int64_t lbid,
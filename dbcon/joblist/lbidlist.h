@@ -31,6 +31,7 @@
 #include "bytestream.h"
 #include <iostream>
 #include "brm.h"
+#include "extentfilter.h"
 #include <tr1/unordered_map>
 
 namespace joblist
@@ -106,6 +107,27 @@ class LBIDList
                                 const execplan::CalpontSystemCatalog::ColType& ct, const uint8_t BOP,
                                 bool isDict);
 
+  /** @brief Load the extent filters cpimport saved for the column, if the
+   *  filter string has an equality predicate they could be used for.
+   */
+  void initExtentFilters(execplan::CalpontSystemCatalog::OID oid, const std::vector<BRM::EMEntry>& extents,
+                         const messageqcpp::ByteStream* MsgDataPtr, const uint16_t NOPS,
+                         const execplan::CalpontSystemCatalog::ColType& ct, bool isDict);
+
+  /** @brief Use these filters instead of loading them from the store */
+  void setExtentFilters(const BRM::ExtentFilterStore::FilterMap& filters)
+  {
+    fExtentFilters = filters;
+  }
+
+  /** @brief False if the extent's Bloom filter shows that none of its values
+   *  satisfies the equality predicates.  Call after CasualPartitionPredicate()
+   *  accepts the extent.
+   */
+  bool ExtentFilterPredicate(const BRM::EMEntry& extent, const messageqcpp::ByteStream* MsgDataPtr,
+                             const uint16_t NOPS, const execplan::CalpontSystemCatalog::ColType& ct,
+                             const uint8_t BOP);
+
   template <typename T>
   bool checkSingleValue(T min, T max, T value, const execplan::CalpontSystemCatalog::ColType& type);
 
@@ -141,6 +163,7 @@ class LBIDList
                            const std::vector<struct BRM::EMEntry>& EMEntries);
 
   boost::shared_ptr<BRM::DBRM> em;
+  BRM::ExtentFilterStore::FilterMap fExtentFilters;
   std::vector<MinMaxPartition*> lbidPartitionVector;
   LBIDRangeVector LBIDRanges;
   int fDebug;
@@ -78,6 +78,9 @@ void LimitedOrderBy::initialize(const RowGroup& rg, const JobInfo& jobInfo, bool
     fOrderByCond.push_back(IdbSortSpec(j->second, i->second ^ invertRules));
   }
 
+  if (!invertRules && fOrderByCond.size() > 0)
+    fThreshold = jobInfo.topNThreshold;
+
   // limit row count info
   if (isMultiThreaded)
   {
@@ -156,6 +159,9 @@ void LimitedOrderBy::processRow(const rowgroup::Row& row)
       fRowGroup.resetRowGroup(0);
       fRowGroup.getRow(0, &fRow0);
     }
+
+    if (fThreshold && fOrderByQueue.size() == fStart + fCount)
+      updateThreshold();
   }
 
   else if (fOrderByCond.size() > 0 && fRule.less(row.getPointer(), fOrderByQueue.top().fData))
@@ -172,9 +178,25 @@ void LimitedOrderBy::processRow(const rowgroup::Row& row)
 
     fOrderByQueue.pop();
     fOrderByQueue.push(swapRow);
+
+    if (fThreshold)
+      updateThreshold();
   }
 }
 
+// The top of the queue is the worst row kept, nothing worse gets in any more
+void LimitedOrderBy::updateThreshold()
+{
+  const int index = fOrderByCond[0].fIndex;
+
+  row1.setData(fOrderByQueue.top().fData);
+
+  if (row1.isNullValue(index))
+    return;
+
+  fThreshold->update(fThreshold->isUnsigned() ? (int64_t)row1.getUintField(index) : row1.getIntField(index));
+}
+
 /*
  * The f() copies top element from an ordered queue into a row group. It
  * does this backwards to syncronise sorting orientation with the server.
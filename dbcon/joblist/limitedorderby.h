@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include "rowgroup.h"
 #include "../../utils/windowfunction/idborderby.h"
@@ -29,6 +30,7 @@ namespace joblist
 {
 // forward reference
 struct JobInfo;
+class TopNThreshold;
 
 // ORDER BY with LIMIT class
 // This version is for subqueries, limit the result set to fit in memory,
@@ -53,9 +55,12 @@ class LimitedOrderBy : public ordering::IdbOrderBy
   void finalize();
 
  protected:
+  void updateThreshold();
+
   uint64_t fStart;
   uint64_t fCount;
   uint64_t fUncommitedMemory;
+  std::shared_ptr<TopNThreshold> fThreshold;
   static const uint64_t fMaxUncommited;
 };
 
@@ -234,6 +234,7 @@ const uint16_t SEND_RIDS_AT_DELIVERY = 0x20;  // 32;
 const uint16_t HAS_ROWGROUP = 0x40;           // 64;
 const uint16_t JOIN_ROWGROUP_DATA = 0x80;     // 128
 const uint16_t HAS_WIDE_COLUMNS = 0x100;      // 256;
+const uint16_t HAS_RUNTIME_FILTERS = 0x200;   // 512;
 
 // TODO: put this in a namespace to stop global ns pollution
 enum PrimFlags
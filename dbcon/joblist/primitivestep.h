@@ -58,6 +58,8 @@
 #include "resourcemanager.h"
 #include "joiner.h"
 #include "tuplejoiner.h"
+#include "runtimefilter.h"
+#include "topnthreshold.h"
 #include "rowgroup.h"
 #include "rowaggregation.h"
 #include "funcexpwrapper.h"
@@ -1181,6 +1183,17 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   void addCPPredicates(uint32_t OID, const std::vector<int128_t>& vals, bool isRange,
                        bool isSmallSideWideDecimal);
 
+  /* Runtime join filters.  PrimProc drops the rows whose value of column OID
+   * doesn't pass the filter, before it projects the other columns.
+   */
+  void addRuntimeFilter(uint32_t OID, const std::shared_ptr<joiner::RuntimeFilter>& filter);
+
+  /* ORDER BY ... LIMIT on column OID.  If the step scans OID and the type has
+   * a usable CP range, the extents are sent in ORDER BY order, and the ones
+   * the returned threshold rules out aren't sent.  Returns null otherwise.
+   */
+  std::shared_ptr<TopNThreshold> makeTopNThreshold(uint32_t OID, bool asc);
+
   /* semijoin adds */
   void setJoinFERG(const rowgroup::RowGroup& rg);
 
@@ -1274,6 +1287,8 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   uint64_t fNumBlksSkipped;          // total number of block scans skipped due to CP
   uint64_t fMsgBytesIn;              // total byte count for incoming messages
   uint64_t fMsgBytesOut;             // total byte count for outcoming messages
+  uint64_t fRecvWaitTime;            // us the receive threads waited for messages
+  uint64_t fCreditStallTime;         // ns the PMs waited for flow control credit
   uint64_t fBlockTouched;            // total blocks touched
   uint32_t fExtentsPerSegFile;       // config num of Extents Per Segment File
   // uint64_t cThread;  //consumer thread. thread handle from thread pool
@@ -1285,6 +1300,8 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   boost::condition condvarWakeupProducer, condvar;
 
   std::vector<bool> scanFlags;  // use to keep track of which extents to eliminate from this step
+  std::shared_ptr<TopNThreshold> fTopNThreshold;
+  ColumnCommandJL* fTopNCol;  // the first ORDER BY column
   bool BPPIsAllocated;
   uint32_t uniqueID;
   ResourceManager* fRm;
@@ -1442,13 +1459,14 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   /* shared nothing support */
   struct Job
   {
-    Job(uint32_t d, uint32_t n, uint32_t b, boost::shared_ptr<messageqcpp::ByteStream>& bs)
-     : dbroot(d), connectionNum(n), expectedResponses(b), msg(bs)
+    Job(uint32_t d, uint32_t n, uint32_t b, boost::shared_ptr<messageqcpp::ByteStream>& bs, uint32_t e)
+     : dbroot(d), connectionNum(n), expectedResponses(b), extentIndex(e), msg(bs)
     {
     }
     uint32_t dbroot;
     uint32_t connectionNum;
     uint32_t expectedResponses;
+    uint32_t extentIndex;
     boost::shared_ptr<messageqcpp::ByteStream> msg;
   };
 
@@ -1456,6 +1474,7 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
   void makeJobs(std::vector<Job>* jobs);
   void interleaveJobs(std::vector<Job>* jobs) const;
   void sendJobs(const std::vector<Job>& jobs);
+  bool topNExcludes(uint32_t extentIndex);
   uint32_t numDBRoots;
 
   /* Pseudo column filter processing.  Think about refactoring into a separate class. */
@@ -25,6 +25,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <boost/thread.hpp>
@@ -102,7 +103,23 @@ const uint64_t defaultRowsPerBatch = 10000;
 /* HJ CP feedback, see bug #1465 */
 const uint32_t defaultHjCPUniqueLimit = 100;
 
-const uint64_t defaultDECThrottleThreshold = 200000000;  // ~200 MB
+/* HJ runtime filters pushed to PrimProc */
+const bool defaultHjUseRuntimeFilters = true;
+const uint64_t defaultHjRuntimeFilterMaxSize = 4 * 1024 * 1024;
+
+/* HJ radix partitioned UM joins, 0 picks the L3 cache size */
+const uint64_t defaultHjRadixJoinThreshold = 0;
+
+/* HJ disk join partitions processed in parallel */
+const uint32_t defaultHjDiskJoinThreads = 4;
+
+/* threads reading the PrimProc connections of DEC */
+const uint32_t defaultDECReaderThreads = 4;
+
+/* the bytes the PMs may send a step that it hasn't read, 0 sizes it from the UM memory */
+const uint64_t defaultDECCreditWindow = 0;
+const uint64_t minDECCreditWindow = 16 * 1024 * 1024;
+const uint64_t maxDECCreditWindow = 256 * 1024 * 1024;
 
 const bool defaultAllowDiskAggregation = false;
 
@@ -181,6 +198,22 @@ class ResourceManager
   {
     return getUintVal(fHashJoinStr, "CPUniqueLimit", defaultHjCPUniqueLimit);
   }
+  bool getHjUseRuntimeFilters() const
+  {
+    return getBoolVal(fHashJoinStr, "RuntimeFilters", defaultHjUseRuntimeFilters);
+  }
+  uint64_t getHjRuntimeFilterMaxSize() const
+  {
+    return getUintVal(fHashJoinStr, "RuntimeFilterMaxSize", defaultHjRuntimeFilterMaxSize);
+  }
+  uint64_t getHjRadixJoinThreshold() const
+  {
+    return getUintVal(fHashJoinStr, "RadixJoinThreshold", defaultHjRadixJoinThreshold);
+  }
+  uint32_t getHjDiskJoinThreads() const
+  {
+    return getUintVal(fHashJoinStr, "DiskJoinThreads", defaultHjDiskJoinThreads);
+  }
   uint64_t getPMJoinMemLimit() const
   {
     return pmJoinMemLimit;
@@ -284,9 +317,19 @@ class ResourceManager
     return getUintVal(fBatchInsertStr, "RowsPerBatch", defaultRowsPerBatch);
   }
 
-  uint64_t getDECThrottleThreshold() const
+  uint32_t getDECReaderThreads() const
+  {
+    return getUintVal(fJobListStr, "DECReaderThreads", defaultDECReaderThreads);
+  }
+
+  uint64_t getDECCreditWindow() const
   {
-    return getUintVal(fJobListStr, "DECThrottleThreshold", defaultDECThrottleThreshold);
+    uint64_t window = getUintVal(fJobListStr, "DECCreditWindow", defaultDECCreditWindow);
+
+    if (window == 0)
+      window = std::min(std::max(getConfiguredUMMemLimit() / 128, minDECCreditWindow), maxDECCreditWindow);
+
+    return window;
   }
 
   uint64_t getMaxBPPSendQueue() const
@@ -0,0 +1,104 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace joblist
+{
+/** @brief The cutoff of an ORDER BY ... LIMIT query on the first ORDER BY column
+ *
+ * LimitedOrderBy keeps the best LIMIT rows.  Once it has them, a row whose
+ * first ORDER BY value is worse than the one of the worst row kept can't
+ * make it into the result.  LimitedOrderBy publishes that value here and the
+ * TupleBPS scanning the column doesn't send the extents whose casual
+ * partitioning range only holds such values.
+ *
+ * The values are the int64s of the CP min/max, compared as unsigned for the
+ * unsigned types.
+ */
+class TopNThreshold
+{
+ public:
+  TopNThreshold(bool asc, bool isUnsigned)
+   : fAsc(asc)
+   , fUnsigned(isUnsigned)
+   , fCutoff(asc ? (isUnsigned ? (int64_t)std::numeric_limits<uint64_t>::max()
+                               : std::numeric_limits<int64_t>::max())
+                 : (isUnsigned ? 0 : std::numeric_limits<int64_t>::min()))
+  {
+  }
+
+  bool isAsc() const
+  {
+    return fAsc;
+  }
+  bool isUnsigned() const
+  {
+    return fUnsigned;
+  }
+
+  /** @brief True if a sorts before b */
+  inline bool better(int64_t a, int64_t b) const
+  {
+    if (fUnsigned)
+      return (fAsc ? (uint64_t)a < (uint64_t)b : (uint64_t)a > (uint64_t)b);
+
+    return (fAsc ? a < b : a > b);
+  }
+
+  /** @brief The value of the range the ORDER BY reaches first */
+  inline int64_t bestOf(int64_t lo, int64_t hi) const
+  {
+    return (fAsc ? lo : hi);
+  }
+
+  /** @brief Called with the value of the worst row kept.  The cutoff only
+   *  ever gets tighter, every LimitedOrderBy thread can call it.
+   */
+  void update(int64_t value)
+  {
+    int64_t cutoff = fCutoff.load(std::memory_order_relaxed);
+
+    while (better(value, cutoff) &&
+           !fCutoff.compare_exchange_weak(cutoff, value, std::memory_order_relaxed))
+      ;
+  }
+
+  int64_t getCutoff() const
+  {
+    return fCutoff.load(std::memory_order_relaxed);
+  }
+
+  /** @brief True if no value in [lo, hi] can make it into the result */
+  inline bool excludes(int64_t lo, int64_t hi) const
+  {
+    return better(getCutoff(), bestOf(lo, hi));
+  }
+
+ private:
+  bool fAsc;
+  bool fUnsigned;
+  std::atomic<int64_t> fCutoff;
+};
+
+}  // namespace joblist
@@ -466,6 +466,8 @@ TupleBPS::TupleBPS(const pColStep& rhs, const JobInfo& jobInfo)
   msgsRecvd = 0;
   fMsgBytesIn = 0;
   fMsgBytesOut = 0;
+  fRecvWaitTime = 0;
+  fCreditStallTime = 0;
   fBlockTouched = 0;
   fExtentsPerSegFile = DEFAULT_EXTENTS_PER_SEG_FILE;
   recvWaiting = 0;
@@ -488,6 +490,7 @@ TupleBPS::TupleBPS(const pColStep& rhs, const JobInfo& jobInfo)
   fBPP->setOutputType(ROW_GROUP);
   finishedSending = sendWaiting = false;
   fNumBlksSkipped = 0;
+  fTopNCol = NULL;
   fPhysicalIO = 0;
   fCacheIO = 0;
   BPPIsAllocated = false;
@@ -600,8 +603,11 @@ TupleBPS::TupleBPS(const pColScanStep& rhs, const JobInfo& jobInfo) : BatchPrimi
   ridsReturned = 0;
   ridsRequested = 0;
   fNumBlksSkipped = 0;
+  fTopNCol = NULL;
   fMsgBytesIn = 0;
   fMsgBytesOut = 0;
+  fRecvWaitTime = 0;
+  fCreditStallTime = 0;
   fBlockTouched = 0;
   fExtentsPerSegFile = DEFAULT_EXTENTS_PER_SEG_FILE;
   recvWaiting = 0;
@@ -667,6 +673,8 @@ TupleBPS::TupleBPS(const PassThruStep& rhs, const JobInfo& jobInfo) : BatchPrimi
   ridsRequested = 0;
   fMsgBytesIn = 0;
   fMsgBytesOut = 0;
+  fRecvWaitTime = 0;
+  fCreditStallTime = 0;
   fBlockTouched = 0;
   fExtentsPerSegFile = DEFAULT_EXTENTS_PER_SEG_FILE;
   recvExited = 0;
@@ -694,6 +702,7 @@ TupleBPS::TupleBPS(const PassThruStep& rhs, const JobInfo& jobInfo) : BatchPrimi
   finishedSending = sendWaiting = false;
   fSwallowRows = false;
   fNumBlksSkipped = 0;
+  fTopNCol = NULL;
   fPhysicalIO = 0;
   fCacheIO = 0;
   BPPIsAllocated = false;
@@ -736,9 +745,12 @@ TupleBPS::TupleBPS(const pDictionaryStep& rhs, const JobInfo& jobInfo)
   ridsReturned = 0;
   ridsRequested = 0;
   fNumBlksSkipped = 0;
+  fTopNCol = NULL;
   fBlockTouched = 0;
   fMsgBytesIn = 0;
   fMsgBytesOut = 0;
+  fRecvWaitTime = 0;
+  fCreditStallTime = 0;
   fExtentsPerSegFile = DEFAULT_EXTENTS_PER_SEG_FILE;
   recvWaiting = 0;
   fSwallowRows = false;
@@ -1076,6 +1088,8 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
 
     if (tmplbidList->CasualPartitionDataType(colCmd->getColType().colDataType, colCmd->getColType().colWidth))
     {
+      tmplbidList->initExtentFilters(colCmd->getOID(), colCmd->getExtents(), &(colCmd->getFilterString()),
+                                     colCmd->getFilterCount(), colCmd->getColType(), colCmd->getIsDict());
       lbidListVec.push_back(tmplbidList);
       cpColVec.push_back(colCmd);
     }
@@ -1109,9 +1123,12 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
           scanFlags[idx] && (extent.colWid <= utils::MAXCOLUMNWIDTH) &&  // XXX: change to named constant.
           (ignoreCP || extent.partition.cprange.isValid != BRM::CP_VALID ||
            colCmd->getColType().colWidth != extent.colWid ||
-           lbidListVec[i]->CasualPartitionPredicate(extent.partition.cprange, &(colCmd->getFilterString()),
-                                                    colCmd->getFilterCount(), colCmd->getColType(),
-                                                    colCmd->getBOP(), colCmd->getIsDict()));
+           (lbidListVec[i]->CasualPartitionPredicate(extent.partition.cprange, &(colCmd->getFilterString()),
+                                                     colCmd->getFilterCount(), colCmd->getColType(),
+                                                     colCmd->getBOP(), colCmd->getIsDict()) &&
+            lbidListVec[i]->ExtentFilterPredicate(extent, &(colCmd->getFilterString()),
+                                                  colCmd->getFilterCount(), colCmd->getColType(),
+                                                  colCmd->getBOP())));
     }
   }
 
@@ -1673,6 +1690,15 @@ void TupleBPS::sendJobs(const vector<Job>& jobs)
 
   for (i = 0; i < jobs.size() && !cancelled(); i++)
   {
+    if (fTopNThreshold && topNExcludes(jobs[i].extentIndex))
+    {
+      tplLock.lock();
+      totalMsgs -= jobs[i].expectedResponses;
+      fNumBlksSkipped += jobs[i].expectedResponses * fColType.colWidth;
+      tplLock.unlock();
+      continue;
+    }
+
     fDec->write(uniqueID, jobs[i].msg);
     tplLock.lock();
     msgsSent += jobs[i].expectedResponses;
@@ -1691,6 +1717,16 @@ void TupleBPS::sendJobs(const vector<Job>& jobs)
   }
 }
 
+// True if the ORDER BY column of the extent only has values past the LIMIT cutoff
+bool TupleBPS::topNExcludes(uint32_t extentIndex)
+{
+  const EMEntry& extent = fTopNCol->getExtents()[extentIndex];
+  const EMCasualPartition_t& cp = extent.partition.cprange;
+
+  return (cp.isValid == BRM::CP_VALID && extent.colWid == fTopNCol->getColType().colWidth &&
+          fTopNThreshold->excludes(cp.loVal, cp.hiVal));
+}
+
 template <typename T>
 bool TupleBPS::compareSingleValue(uint8_t COP, T val1, T val2) const
 {
@@ -2017,8 +2053,43 @@ void TupleBPS::makeJobs(vector<Job>* jobs)
 
   totalMsgs = 0;
 
-  for (i = 0; i < scannedExtents.size(); i++)
+  // ORDER BY ... LIMIT, scan the extents that can hold the first rows first so
+  // the threshold is found early.  Extents without a CP range go in front.
+  vector<uint32_t> extentOrder(scannedExtents.size());
+
+  for (i = 0; i < extentOrder.size(); i++)
+    extentOrder[i] = i;
+
+  if (fTopNThreshold && (doJoin || (fTraceFlags & CalpontSelectExecutionPlan::IGNORE_CP) ||
+                         fTopNCol->getExtents().size() != scannedExtents.size()))
+    fTopNThreshold.reset();
+
+  if (fTopNThreshold)
   {
+    const vector<EMEntry>& extents = fTopNCol->getExtents();
+    const TopNThreshold& threshold = *fTopNThreshold;
+    const uint32_t colWidth = fTopNCol->getColType().colWidth;
+
+    stable_sort(extentOrder.begin(), extentOrder.end(),
+                [&](uint32_t a, uint32_t b)
+                {
+                  const EMCasualPartition_t& cpA = extents[a].partition.cprange;
+                  const EMCasualPartition_t& cpB = extents[b].partition.cprange;
+                  bool validA = (cpA.isValid == BRM::CP_VALID && extents[a].colWid == colWidth);
+                  bool validB = (cpB.isValid == BRM::CP_VALID && extents[b].colWid == colWidth);
+
+                  if (validA != validB)
+                    return validB;
+
+                  return validA && threshold.better(threshold.bestOf(cpA.loVal, cpA.hiVal),
+                                                    threshold.bestOf(cpB.loVal, cpB.hiVal));
+                });
+  }
+
+  for (uint32_t k = 0; k < extentOrder.size(); k++)
+  {
+    i = extentOrder[k];
+
     // the # of LBIDs to scan in this extent, if it will be scanned.
     //@bug 5322: status EXTENTSTATUSMAX+1 means single block extent.
     if ((scannedExtents[i].HWM == 0) && ((int)i < lastExtent[scannedExtents[i].dbRoot - 1]) &&
@@ -2110,7 +2181,7 @@ void TupleBPS::makeJobs(vector<Job>* jobs)
       bs.reset(new ByteStream());
       fBPP->runBPP(*bs, (*dbRootConnectionMap)[scannedExtents[i].dbRoot], isExeMgrDEC);
       jobs->push_back(
-          Job(scannedExtents[i].dbRoot, (*dbRootConnectionMap)[scannedExtents[i].dbRoot], blocksThisJob, bs));
+          Job(scannedExtents[i].dbRoot, (*dbRootConnectionMap)[scannedExtents[i].dbRoot], blocksThisJob, bs, i));
       blocksToScan -= blocksThisJob;
       startingLBID += fColType.colWidth * blocksThisJob;
       fBPP->reset();
@@ -2470,6 +2541,7 @@ void TupleBPS::receiveMultiPrimitiveMessages()
         tplLock.unlock();
         usleep(2000 * fNumThreads);
         tplLock.lock();
+        fRecvWaitTime += 2000 * fNumThreads;
         continue;
       }
 
@@ -2705,6 +2777,7 @@ void TupleBPS::receiveMultiPrimitiveMessages()
     Stats stats = fDec->getNetworkStats(uniqueID);
     fMsgBytesIn = stats.dataRecvd();
     fMsgBytesOut = stats.dataSent();
+    fCreditStallTime = fDec->getCreditStallTime(uniqueID);
     fDec->removeQueue(uniqueID);
     tjoiners.clear();
   }
@@ -2774,7 +2847,8 @@ void TupleBPS::receiveMultiPrimitiveMessages()
              << endl
              << "\tPartitionBlocksEliminated-" << fNumBlksSkipped << "; MsgBytesIn-" << msgBytesInKB << "KB"
              << "; MsgBytesOut-" << msgBytesOutKB << "KB"
-             << "; TotalMsgs-" << totalMsgs << endl
+             << "; TotalMsgs-" << totalMsgs << "; RecvWait-" << fRecvWaitTime / 1000 << "ms"
+             << "; PMCreditStall-" << fCreditStallTime / 1000000 << "ms" << endl
              << "\t1st read " << dlTimes.FirstReadTimeString() << "; EOI " << dlTimes.EndOfInputTimeString()
              << "; runtime-" << JSTimeStamp::tsdiffstr(dlTimes.EndOfInputTime(), dlTimes.FirstReadTime())
              << "s\n\tUUID " << uuids::to_string(fStepUuid) << "\n\tQuery UUID "
@@ -3349,6 +3423,51 @@ void TupleBPS::addCPPredicates(uint32_t OID, const vector<int128_t>& vals, bool
   }
 }
 
+std::shared_ptr<TopNThreshold> TupleBPS::makeTopNThreshold(uint32_t OID, bool asc)
+{
+  vector<SCommand> cmds = fBPP->getFilterSteps();
+
+  cmds.insert(cmds.end(), fBPP->getProjectSteps().begin(), fBPP->getProjectSteps().end());
+
+  if (fOid < 3000 || doJoin)
+    return fTopNThreshold;
+
+  for (uint32_t i = 0; i < cmds.size(); i++)
+  {
+    ColumnCommandJL* cc = dynamic_cast<ColumnCommandJL*>(cmds[i].get());
+
+    if (!cc || dynamic_cast<PseudoCCJL*>(cc) || cc->getOID() != (execplan::CalpontSystemCatalog::OID)OID)
+      continue;
+
+    const CalpontSystemCatalog::ColType& ct = cc->getColType();
+
+    if (ct.colWidth > 8 || !(datatypes::isSignedInteger(ct.colDataType) ||
+                             datatypes::isUnsignedInteger(ct.colDataType) ||
+                             ct.colDataType == CalpontSystemCatalog::DATE ||
+                             ct.colDataType == CalpontSystemCatalog::DATETIME ||
+                             ct.colDataType == CalpontSystemCatalog::TIMESTAMP))
+      break;
+
+    // NULLs sort first with ASC, and the CP range doesn't say if an extent has any
+    if (asc && ct.constraintType != CalpontSystemCatalog::NOTNULL_CONSTRAINT)
+      break;
+
+    fTopNCol = cc;
+    fTopNThreshold.reset(new TopNThreshold(asc, datatypes::isUnsigned(ct.colDataType)));
+    break;
+  }
+
+  return fTopNThreshold;
+}
+
+void TupleBPS::addRuntimeFilter(uint32_t OID, const std::shared_ptr<joiner::RuntimeFilter>& filter)
+{
+  if (fOid < 3000)
+    return;
+
+  fBPP->addRuntimeFilter(OID, filter);
+}
+
 void TupleBPS::dec(DistributedEngineComm* dec)
 {
   if (fDec)
@@ -327,6 +327,7 @@ TupleAggregateStep::TupleAggregateStep(const SP_ROWAGG_UM_t& agg, const RowGroup
  , fUmOnly(false)
  , fRm(jobInfo.rm)
  , fBucketNum(0)
+ , fNextDeliveredBucket(0)
  , fInputIter(-1)
  , fSessionMemLimit(jobInfo.umMemLimit)
 {
@@ -5293,6 +5294,45 @@ void TupleAggregateStep::threadedAggregateFinalize(uint32_t threadID)
   }
 }
 
+void TupleAggregateStep::threadedDeliverBuckets(uint32_t threadID, RowGroupDL* dlp)
+{
+  RowGroup rgOut, rgDelivered = fRowGroupDelivered;
+  RGData rgData;
+  uint32_t bucket;
+  uint64_t rowCount;
+
+  try
+  {
+    while (!cancelled() && (bucket = atomicops::atomicInc(&fNextDeliveredBucket) - 1) < fNumOfBuckets)
+    {
+      while (!cancelled() && fAggregators[bucket]->nextRowGroup())
+      {
+        fAggregators[bucket]->finalize();
+        rgOut = *fAggregators[bucket]->getOutputRowGroup();
+        rowCount = rgOut.getRowCount();
+
+        if (rowCount == 0)
+          continue;
+
+        atomicops::atomicAdd<uint64_t>(&fRowsReturned, rowCount);
+        rgDelivered.setData(rgOut.getRGData());
+
+        if (rgOut.getColumnCount() != rgDelivered.getColumnCount())
+          pruneAuxColumns(rgOut, rgDelivered);
+
+        rgData = rgDelivered.duplicate();
+        dlp->insert(rgData);
+      }
+    }
+  }
+  catch (...)
+  {
+    handleException(std::current_exception(), logging::tupleAggregateStepErr,
+                    logging::ERR_AGGREGATION_TOO_BIG,
+                    "TupleAggregateStep::threadedDeliverBuckets()[" + std::to_string(threadID) + "]");
+  }
+}
+
 void TupleAggregateStep::threadedAggregateRowGroups(uint32_t threadID)
 {
   RGData rgData;
@@ -5754,6 +5794,65 @@ uint64_t TupleAggregateStep::doThreadedAggregate(ByteStream& bs, RowGroupDL* dlp
           fEndOfResult = true;
       }
     }
+    else if (!dynamic_cast<RowAggregationDistinct*>(fAggregator.get()) && !fAggregators.empty())
+    {
+      /* The rows were hashed to the buckets by their group by key, so every bucket has its own
+         set of groups and there's nothing to merge.  Finalize & deliver them bucket by bucket
+         instead of appending them all to fAggregator first.  When the output goes to a datalist
+         the buckets are delivered in parallel; the expressions on the aggregates can't be
+         evaluated concurrently though, they keep their results in the shared column objects. */
+      if (!fEndOfResult)
+      {
+        if (dlp && fAggregator->expression().empty())
+        {
+          vector<uint64_t> runners;
+          fDoneAggregate = true;
+          fNextDeliveredBucket = 0;
+          runners.reserve(fNumOfThreads);
+
+          for (i = 0; i < fNumOfThreads; i++)
+            runners.push_back(jobstepThreadPool.invoke(ThreadedBucketDeliverer(this, i, dlp)));
+
+          jobstepThreadPool.join(runners);
+          fEndOfResult = true;
+        }
+        else
+        {
+          fDoneAggregate = true;
+          bool done = true;
+
+          while (nextDeliveredRowGroup() && !cancelled())
+          {
+            done = false;
+            rowCount = fRowGroupOut.getRowCount();
+            fRowsReturned += rowCount;
+
+            if (rowCount != 0)
+            {
+              if (fRowGroupOut.getColumnCount() != fRowGroupDelivered.getColumnCount())
+                pruneAuxColumns();
+
+              if (dlp)
+              {
+                rgData = fRowGroupDelivered.duplicate();
+                dlp->insert(rgData);
+              }
+              else
+              {
+                bs.restart();
+                fRowGroupDelivered.serializeRGData(bs);
+                break;
+              }
+            }
+
+            done = true;
+          }
+
+          if (done)
+            fEndOfResult = true;
+        }
+      }
+    }
     else
     {
       auto* agg = dynamic_cast<RowAggregationDistinct*>(fAggregator.get());
@@ -5874,12 +5973,17 @@ uint64_t TupleAggregateStep::doThreadedAggregate(ByteStream& bs, RowGroupDL* dlp
 
 void TupleAggregateStep::pruneAuxColumns()
 {
-  uint64_t rowCount = fRowGroupOut.getRowCount();
+  pruneAuxColumns(fRowGroupOut, fRowGroupDelivered);
+}
+
+void TupleAggregateStep::pruneAuxColumns(RowGroup& rgOut, RowGroup& rgDelivered)
+{
+  uint64_t rowCount = rgOut.getRowCount();
   Row row1, row2;
-  fRowGroupOut.initRow(&row1);
-  fRowGroupOut.getRow(0, &row1);
-  fRowGroupDelivered.initRow(&row2);
-  fRowGroupDelivered.getRow(0, &row2);
+  rgOut.initRow(&row1);
+  rgOut.getRow(0, &row1);
+  rgDelivered.initRow(&row2);
+  rgDelivered.getRow(0, &row2);
 
   for (uint64_t i = 1; i < rowCount; i++)
   {
@@ -101,8 +101,10 @@ class TupleAggregateStep : public JobStep, public TupleDeliveryStep
   void threadedAggregateRowGroups(uint32_t threadID);
   void threadedAggregateFinalize(uint32_t threadID);
   void doThreadedSecondPhaseAggregate(uint32_t threadID);
+  void threadedDeliverBuckets(uint32_t threadID, RowGroupDL* dlp);
   bool nextDeliveredRowGroup();
   void pruneAuxColumns();
+  static void pruneAuxColumns(rowgroup::RowGroup& rgOut, rowgroup::RowGroup& rgDelivered);
   void formatMiniStats();
   void printCalTrace();
 
@@ -199,6 +201,25 @@ class TupleAggregateStep : public JobStep, public TupleDeliveryStep
     uint32_t bucketCount;
   };
 
+  class ThreadedBucketDeliverer
+  {
+   public:
+    ThreadedBucketDeliverer(TupleAggregateStep* step, uint32_t threadID, RowGroupDL* dlp)
+     : fStep(step), fThreadID(threadID), fDlp(dlp)
+    {
+    }
+    void operator()()
+    {
+      std::string t{"TASThrDlvr"};
+      t.append(std::to_string(fThreadID));
+      utils::setThreadName(t.c_str());
+      fStep->threadedDeliverBuckets(fThreadID, fDlp);
+    }
+    TupleAggregateStep* fStep;
+    uint32_t fThreadID;
+    RowGroupDL* fDlp;
+  };
+
   uint64_t fRunner;  // thread pool handle
   bool fUmOnly;
   ResourceManager* fRm;
@@ -208,6 +229,7 @@ class TupleAggregateStep : public JobStep, public TupleDeliveryStep
   uint32_t fNumOfBuckets;
   uint32_t fNumOfRowGroups;
   uint32_t fBucketNum;
+  uint32_t fNextDeliveredBucket;  // for threadedDeliverBuckets()
 
   boost::mutex fMutex;
   std::vector<boost::mutex*> fAgg_mutex;
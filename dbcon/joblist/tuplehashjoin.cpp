@@ -32,6 +32,7 @@
 //#define NDEBUG
 #include <cassert>
 #include <algorithm>
+#include <limits>
 using namespace std;
 
 #include "jlf_common.h"
@@ -93,6 +94,9 @@ TupleHashJoinStep::TupleHashJoinStep(const JobInfo& jobInfo)
 
   pmMemLimit = resourceManager->getHjPmMaxMemorySmallSide(fSessionId);
   uniqueLimit = resourceManager->getHjCPUniqueLimit();
+  useRuntimeFilters = resourceManager->getHjUseRuntimeFilters();
+  runtimeFilterMaxSize = resourceManager->getHjRuntimeFilterMaxSize();
+  radixJoinThreshold = resourceManager->getHjRadixJoinThreshold();
 
   fExtendedInfo = "THJS: ";
   joinType = INIT;
@@ -285,6 +289,10 @@ void TupleHashJoinStep::startSmallRunners(uint index)
   }
 
   joiner->setUniqueLimit(uniqueLimit);
+
+  if (radixJoinThreshold > 0)
+    joiner->setRadixJoinThreshold(radixJoinThreshold);
+
   joiner->setTableName(smallTableNames[index]);
   joiners[index] = joiner;
 
@@ -373,7 +381,7 @@ void TupleHashJoinStep::startSmallRunners(uint index)
       extendedInfo += oss.str();
     }
     if (!cancelled())
-      joiner->doneInserting();
+      finishInserting(index);
   }
 
   boost::mutex::scoped_lock lk(*fStatsMutexPtr);
@@ -381,6 +389,34 @@ void TupleHashJoinStep::startSmallRunners(uint index)
   formatMiniStats(index);
 }
 
+/* doneInserting() runs after the memory tracking stopped and may replace the
+   hash tables by radix tables.  Reserve what that build takes, or keep the hash
+   tables if it isn't there, then account for the change of the joiner's usage. */
+void TupleHashJoinStep::finishInserting(uint index)
+{
+  auto joiner = joiners[index];
+  int64_t memBefore = joiner->getMemUsage();
+  int64_t reserved = joiner->getRadixBuildMemUsage();
+  int64_t delta;
+
+  if (reserved > 0 && !resourceManager->getMemory(reserved, sessionMemLimit, false))
+  {
+    joiner->setRadixJoinThreshold(std::numeric_limits<uint64_t>::max());
+    reserved = 0;
+  }
+
+  joiner->doneInserting();
+  delta = (int64_t)joiner->getMemUsage() - memBefore;
+
+  // keep what the joiner grew by out of the reservation, return the rest
+  if (delta > reserved && !resourceManager->getMemory(delta - reserved, sessionMemLimit, false))
+    delta = reserved;
+  else if (delta < reserved)
+    resourceManager->returnMemory(reserved - delta, sessionMemLimit);
+
+  atomicops::atomicAdd(&memUsedByEachJoin[index], delta);
+}
+
 /* Index is which small input to read. */
 void TupleHashJoinStep::smallRunnerFcn(uint32_t index, uint threadID, uint64_t* jobs)
 {
@@ -505,6 +541,55 @@ void TupleHashJoinStep::forwardCPData()
   }
 }
 
+/* Build a filter from the small side keys of each UM join, PrimProc uses it to drop
+   the large side rows that can't match before it projects the rest of the columns.
+   The PM joins don't need one, PrimProc joins those rows itself. */
+void TupleHashJoinStep::forwardRuntimeFilters()
+{
+  uint32_t i, col;
+
+  if (largeBPS == NULL || !useRuntimeFilters)
+    return;
+
+  for (i = 0; i < joiners.size() && !cancelled(); i++)
+  {
+    if (!joiners[i]->inUM() || (joiners[i]->getJoinType() & (ANTI | LARGEOUTER | MATCHNULLS | SCALAR)))
+      continue;
+
+    for (col = 0; col < joiners[i]->getSmallKeyColumns().size(); col++)
+    {
+      uint32_t smallIdx = joiners[i]->getSmallKeyColumns()[col];
+      uint32_t largeIdx = joiners[i]->getLargeKeyColumns()[col];
+
+      // same as @bug3683, the large side has to be a simple column
+      if (fFunctionJoinKeys.find(largeRG.getKeys()[largeIdx]) != fFunctionJoinKeys.end())
+        continue;
+
+      if (!joiner::RuntimeFilter::canFilter(smallRGs[i], smallIdx, largeRG, largeIdx))
+        continue;
+
+      std::shared_ptr<joiner::RuntimeFilter> filter(
+          new joiner::RuntimeFilter(joiners[i]->size(), runtimeFilterMaxSize));
+      RowGroup smallRG = smallRGs[i];
+      Row r;
+
+      smallRG.initRow(&r);
+
+      for (auto& rgd : rgData[i])
+      {
+        smallRG.setData(&rgd);
+        smallRG.getRow(0, &r);
+
+        for (uint32_t j = 0; j < smallRG.getRowCount(); j++, r.nextRow())
+          if (!r.isNullValue(smallIdx))
+            filter->insert(joiner::RuntimeFilter::getKey(r, smallIdx));
+      }
+
+      largeBPS->addRuntimeFilter(largeRG.getOIDs()[largeIdx], filter);
+    }
+  }
+}
+
 void TupleHashJoinStep::djsRelayFcn()
 {
   /*
@@ -914,6 +999,9 @@ void TupleHashJoinStep::hjRunner()
   // there is an in-mem UM or PM join
   if (largeBPS && !tbpsJoiners.empty())
   {
+    if (!djs)
+      forwardRuntimeFilters();
+
     largeBPS->useJoiners(tbpsJoiners);
 
     if (djs)
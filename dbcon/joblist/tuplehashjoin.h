@@ -518,6 +518,14 @@ class TupleHashJoinStep : public JobStep, public TupleDeliveryStep
   void forwardCPData();
   uint32_t uniqueLimit;
 
+  /* Runtime join filters for the large side scan */
+  void forwardRuntimeFilters();
+  bool useRuntimeFilters;
+  uint64_t runtimeFilterMaxSize;
+
+  /* UM joins with larger small side tables are radix partitioned, 0 means the L3 cache size */
+  uint64_t radixJoinThreshold;
+
   /* UM Join support.  Most of this code is ported from the UM join code in tuple-bps.cpp.
    * They should be kept in sync as much as possible. */
   struct JoinRunner
@@ -646,6 +654,7 @@ class TupleHashJoinStep : public JobStep, public TupleDeliveryStep
   bool stopMemTracking;
   void trackMem(uint index);
   void startSmallRunners(uint index);
+  void finishInserting(uint index);
 
   friend class DiskJoinStep;
 };
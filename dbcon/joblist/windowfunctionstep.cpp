@@ -1104,15 +1104,15 @@ void WindowFunctionStep::doPostProcessForDml()
     fRowGroupOut.setDBRoot(fRowGroupIn.getDBRoot());
     fRowGroupOut.setRowCount(fRowGroupIn.getRowCount());
 
+    // evaluate the window function expressions before apply mapping
+    if (fExpression.size() > 0)
+      fe->evaluate(fRowGroupIn, fExpression);
+
     fRowGroupIn.getRow(0, &rowIn);
     fRowGroupOut.getRow(0, &rowOut);
 
     for (uint64_t i = 0; i < fRowGroupIn.getRowCount(); ++i)
     {
-      // evaluate the window function expressions before apply mapping
-      if (fExpression.size() > 0)
-        fe->evaluate(rowIn, fExpression);
-
       applyMapping(mapping, rowIn, &rowOut);
       rowIn.nextRow();
       rowOut.nextRow();
@@ -26,6 +26,11 @@ const char* mcs_compression_type_names[] = {"SNAPPY",  // 0
                                             "SNAPPY",  // 2
 #ifdef HAVE_LZ4
                                             "LZ4",  // 3
+#elif defined(HAVE_ZSTD)
+                                            "SNAPPY",  // 3, keeps ZSTD at 4 without LZ4
+#endif
+#ifdef HAVE_ZSTD
+                                            "ZSTD",  // 4
 #endif
                                             NullS};
 
@@ -38,10 +43,12 @@ static MYSQL_THDVAR_ENUM(compression_type, PLUGIN_VAR_RQCMDARG,
                          "Controls compression algorithm for create tables. Possible values are: "
                          "SNAPPY segment files are Snappy compressed (default);"
 #ifdef HAVE_LZ4
-                         "LZ4 segment files are LZ4 compressed;",
-# else
-			 ,
+                         "LZ4 segment files are LZ4 compressed;"
+#endif
+#ifdef HAVE_ZSTD
+                         "ZSTD segment files are Zstd compressed;"
 #endif
+                         ,
                          NULL,                              // check
                          NULL,                              // update
                          1,                                 // default
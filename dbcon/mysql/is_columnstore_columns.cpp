@@ -178,6 +178,8 @@ static int is_columnstore_columns_fill(THD* thd, TABLE_LIST* tables, COND* cond)
 
         case 3: compression_type = "LZ4"; break;
 
+        case 4: compression_type = "Zstd"; break;
+
         default: compression_type = "Unknown"; break;
       }
 
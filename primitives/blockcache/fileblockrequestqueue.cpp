@@ -92,4 +92,18 @@ fileRequest* fileBlockRequestQueue::pop(void)
   return blk;
 }
 
+fileRequest* fileBlockRequestQueue::tryPop(void)
+{
+  boost::mutex::scoped_lock lk(mutex);
+
+  // leave the request to the idle reader
+  if (queueSize == 0 || readersWaiting > 0)
+    return 0;
+
+  fileRequest* blk = fbQueue.front();
+  fbQueue.pop_front();
+  --queueSize;
+  return blk;
+}
+
 }  // namespace dbbc
@@ -69,6 +69,12 @@ class fileBlockRequestQueue
    **/
   fileRequest* pop(void);
 
+  /**
+   * @brief get the next request without waiting, null if the queue is empty
+   * or another reader is waiting for a request
+   **/
+  fileRequest* tryPop(void);
+
   /**
    * @brief true if no reuquests are in the queue. false if there are requests in the queue
    **/
@@ -49,7 +49,9 @@ typedef struct FBData
 {
   BRM::LBID_t lbid;
   BRM::VER_t ver;
-  uint8_t hits;
+  uint8_t hits;        // non-zero once the block was hit and given a second chance
+  bool probation;      // 2Q: the block is on the probation list, not the LRU list
+  uint8_t referenced;  // clock bit, set by hits under the shared shard lock
 } FBData_t;
 
 //@bug 669 Change to list for least recently used cache
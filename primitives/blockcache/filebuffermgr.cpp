@@ -32,6 +32,8 @@
 //#define NDEBUG
 #include <cassert>
 #include <limits>
+#include <algorithm>
+#include <sstream>
 #include <boost/thread.hpp>
 
 #include <pthread.h>
@@ -39,6 +41,7 @@
 #include "stats.h"
 #include "configcpp.h"
 #include "filebuffermgr.h"
+#include "atomicops.h"
 #include "mcsconfig.h"
 
 using namespace config;
@@ -54,20 +57,46 @@ namespace dbbc
 {
 const uint32_t gReportingFrequencyMin(32768);
 
+// Shards are split further only while each keeps at least this many blocks
+const uint32_t gMinBlocksPerShard(1024);
+
 FileBufferMgr::FileBufferMgr(const uint32_t numBlcks, const uint32_t blkSz, const uint32_t deleteBlocks)
  : fMaxNumBlocks(numBlcks)
  , fBlockSz(blkSz)
- , fWLock()
- , fbSet()
- , fbList()
- , fCacheSize(0)
- , fFBPool()
- , fDeleteBlocks(deleteBlocks)
- , fEmptyPoolSlots()
+ , fPolicy(TWO_Q)
+ , fShardCount(16)
+ , fDeleteBlocks(0)
+ , fBlksLoaded(0)
+ , fBlksNotUsed(0)
  , fReportFrequency(0)
 {
-  fFBPool.reserve(numBlcks);
   fConfig = Config::makeConfig();
+
+  string val = fConfig->getConfig("DBBC", "ReplacementPolicy");
+
+  // 2Q unless LRU is asked for
+  if (val == "LRU" || val == "lru")
+    fPolicy = LRU;
+
+  val = fConfig->getConfig("DBBC", "NumShards");
+
+  if (val.length() > 0 && Config::fromText(val) > 0)
+    fShardCount = Config::fromText(val);
+
+  while (fShardCount > 1 && numBlcks / fShardCount < gMinBlocksPerShard)
+    fShardCount >>= 1;
+
+  fShards.reset(new Shard[fShardCount]);
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+  {
+    fShards[i].maxBlocks = numBlcks / fShardCount + (i < numBlcks % fShardCount ? 1 : 0);
+    fShards[i].fbPool.reserve(fShards[i].maxBlocks);
+  }
+
+  if (deleteBlocks > 0)
+    fDeleteBlocks = (deleteBlocks + fShardCount - 1) / fShardCount;
+
   setReportingFrequency(0);
   fLog.open(string(MCSLOGDIR) + "/trace/bc", ios_base::app | ios_base::ate);
 }
@@ -98,61 +127,80 @@ void FileBufferMgr::setReportingFrequency(const uint32_t d)
     fReportFrequency = temp;
 }
 
+uint32_t FileBufferMgr::size() const
+{
+  uint32_t ret = 0;
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+    ret += fShards[i].fbSet.size();
+
+  return ret;
+}
+
+uint32_t FileBufferMgr::listSize() const
+{
+  uint32_t ret = 0;
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+    ret += fShards[i].fbList.size() + fShards[i].probation.size();
+
+  return ret;
+}
+
 void FileBufferMgr::flushCache()
 {
-  boost::mutex::scoped_lock lk(fWLock);
+  for (uint32_t i = 0; i < fShardCount; i++)
   {
-    filebuffer_uset_t sEmpty;
-    filebuffer_list_t lEmpty;
-    emptylist_t vEmpty;
+    Shard& s = fShards[i];
+    std::unique_lock<std::shared_mutex> lk(s.lock);
+    {
+      filebuffer_uset_t sEmpty, gEmpty;
+      filebuffer_list_t lEmpty, pEmpty;
+      deque<HashObject_t> glEmpty;
+      emptylist_t vEmpty;
+
+      s.fbList.swap(lEmpty);
+      s.probation.swap(pEmpty);
+      s.fbSet.swap(sEmpty);
+      s.ghosts.swap(gEmpty);
+      s.ghostList.swap(glEmpty);
+      s.emptyPoolSlots.swap(vEmpty);
+    }
+    s.cacheSize = 0;
 
-    fbList.swap(lEmpty);
-    fbSet.swap(sEmpty);
-    fEmptyPoolSlots.swap(vEmpty);
+    // the block pool should not be freed in the above block to allow us
+    // to continue doing concurrent unprotected-but-"safe" memcpys
+    // from that memory
+    s.fbPool.clear();
   }
-  fCacheSize = 0;
 
-  // the block pool should not be freed in the above block to allow us
-  // to continue doing concurrent unprotected-but-"safe" memcpys
-  // from that memory
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "Clearing entire cache" << endl;
   }
-  fFBPool.clear();
-  //	fFBPool.reserve(fMaxNumBlocks);
 }
 
 void FileBufferMgr::flushOne(const BRM::LBID_t lbid, const BRM::VER_t ver)
 {
   // similar in function to depleteCache()
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& s = shardOf(lbid);
+  std::unique_lock<std::shared_mutex> lk(s.lock);
 
-  filebuffer_uset_iter_t iter = fbSet.find(HashObject_t(lbid, ver, 0));
+  filebuffer_uset_iter_t iter = s.fbSet.find(HashObject_t(lbid, ver, 0));
 
-  if (iter != fbSet.end())
-  {
-    // remove it from fbList
-    uint32_t idx = iter->poolIdx;
-    fbList.erase(fFBPool[idx].listLoc());
-    // add to fEmptyPoolSlots
-    fEmptyPoolSlots.push_back(idx);
-    // remove it from fbSet
-    fbSet.erase(iter);
-    // adjust fCacheSize
-    fCacheSize--;
-  }
+  if (iter != s.fbSet.end())
+    remove(s, iter);
 }
 
 void FileBufferMgr::flushMany(const LbidAtVer* laVptr, uint32_t cnt)
 {
-  boost::mutex::scoped_lock lk(fWLock);
-
   BRM::LBID_t lbid;
   BRM::VER_t ver;
   filebuffer_uset_iter_t iter;
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "flushMany " << cnt << " items: ";
     for (uint32_t j = 0; j < cnt; j++)
     {
@@ -164,23 +212,18 @@ void FileBufferMgr::flushMany(const LbidAtVer* laVptr, uint32_t cnt)
   {
     lbid = static_cast<BRM::LBID_t>(laVptr->LBID);
     ver = static_cast<BRM::VER_t>(laVptr->Ver);
-    iter = fbSet.find(HashObject_t(lbid, ver, 0));
+    Shard& s = shardOf(lbid);
+    std::unique_lock<std::shared_mutex> lk(s.lock);
+    iter = s.fbSet.find(HashObject_t(lbid, ver, 0));
 
-    if (iter != fbSet.end())
+    if (iter != s.fbSet.end())
     {
       if (fReportFrequency)
       {
+        boost::mutex::scoped_lock lk(fLogLock);
         fLog << "flushMany hit, lbid: " << lbid << " index: " << iter->poolIdx << endl;
       }
-      // remove it from fbList
-      uint32_t idx = iter->poolIdx;
-      fbList.erase(fFBPool[idx].listLoc());
-      // add to fEmptyPoolSlots
-      fEmptyPoolSlots.push_back(idx);
-      // remove it from fbSet
-      fbSet.erase(iter);
-      // adjust fCacheSize
-      fCacheSize--;
+      remove(s, iter);
     }
 
     ++laVptr;
@@ -191,12 +234,10 @@ void FileBufferMgr::flushManyAllversion(const LBID_t* laVptr, uint32_t cnt)
 {
   filebuffer_uset_t::iterator it, tmpIt;
   tr1::unordered_set<LBID_t> uniquer;
-  tr1::unordered_set<LBID_t>::iterator uit;
-
-  boost::mutex::scoped_lock lk(fWLock);
 
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "flushManyAllversion " << cnt << " items: ";
     for (uint32_t i = 0; i < cnt; i++)
     {
@@ -205,30 +246,33 @@ void FileBufferMgr::flushManyAllversion(const LBID_t* laVptr, uint32_t cnt)
     fLog << endl;
   }
 
-  if (fCacheSize == 0 || cnt == 0)
+  if (cnt == 0)
     return;
 
   for (uint32_t i = 0; i < cnt; i++)
     uniquer.insert(laVptr[i]);
 
-  for (it = fbSet.begin(); it != fbSet.end();)
+  for (uint32_t i = 0; i < fShardCount; i++)
   {
-    if (uniquer.find(it->lbid) != uniquer.end())
+    Shard& s = fShards[i];
+    std::unique_lock<std::shared_mutex> lk(s.lock);
+
+    for (it = s.fbSet.begin(); it != s.fbSet.end();)
     {
-      if (fReportFrequency)
+      if (uniquer.find(it->lbid) != uniquer.end())
       {
-        fLog << "flushManyAllversion hit: " << it->lbid << " index: " << it->poolIdx << endl;
+        if (fReportFrequency)
+        {
+          boost::mutex::scoped_lock lk(fLogLock);
+          fLog << "flushManyAllversion hit: " << it->lbid << " index: " << it->poolIdx << endl;
+        }
+        tmpIt = it;
+        ++it;
+        remove(s, tmpIt);
       }
-      const uint32_t idx = it->poolIdx;
-      fbList.erase(fFBPool[idx].listLoc());
-      fEmptyPoolSlots.push_back(idx);
-      tmpIt = it;
-      ++it;
-      fbSet.erase(tmpIt);
-      fCacheSize--;
+      else
+        ++it;
     }
-    else
-      ++it;
   }
 }
 
@@ -237,16 +281,13 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
   DBRM dbrm;
   uint32_t i;
   vector<EMEntry> extents;
+  vector<pair<LBID_t, LBID_t> > ranges;
   int err;
   uint32_t currentExtent;
-  LBID_t currentLBID;
-  typedef tr1::unordered_multimap<LBID_t, filebuffer_uset_t::iterator> byLBID_t;
-  byLBID_t byLBID;
-  pair<byLBID_t::iterator, byLBID_t::iterator> itList;
-  filebuffer_uset_t::iterator it;
 
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     fLog << "flushOIDs " << count << " items: ";
     for (uint32_t i = 0; i < count; i++)
     {
@@ -258,15 +299,9 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
   // If there are more than this # of extents to drop, the whole cache will be cleared
   const uint32_t clearThreshold = 50000;
 
-  boost::mutex::scoped_lock lk(fWLock);
-
-  if (fCacheSize == 0 || count == 0)
+  if (size() == 0 || count == 0)
     return;
 
-  /* Index the cache by LBID */
-  for (it = fbSet.begin(); it != fbSet.end(); it++)
-    byLBID.insert(pair<LBID_t, filebuffer_uset_t::iterator>(it->lbid, it));
-
   for (i = 0; i < count; i++)
   {
     extents.clear();
@@ -275,7 +310,6 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
     if (err < 0 || (i == 0 && (extents.size() * count) > clearThreshold))
     {
       // (The i == 0 should ensure it's not a dictionary column)
-      lk.unlock();
       flushCache();
       return;
     }
@@ -283,22 +317,11 @@ void FileBufferMgr::flushOIDs(const uint32_t* oids, uint32_t count)
     for (currentExtent = 0; currentExtent < extents.size(); currentExtent++)
     {
       EMEntry& range = extents[currentExtent];
-      LBID_t lastLBID = range.range.start + (range.range.size * 1024);
-
-      for (currentLBID = range.range.start; currentLBID < lastLBID; currentLBID++)
-      {
-        itList = byLBID.equal_range(currentLBID);
-
-        for (byLBID_t::iterator tmpIt = itList.first; tmpIt != itList.second; tmpIt++)
-        {
-          fbList.erase(fFBPool[tmpIt->second->poolIdx].listLoc());
-          fEmptyPoolSlots.push_back(tmpIt->second->poolIdx);
-          fbSet.erase(tmpIt->second);
-          fCacheSize--;
-        }
-      }
+      ranges.push_back(make_pair(range.range.start, range.range.start + (range.range.size * 1024)));
     }
   }
+
+  flushRanges(ranges);
 }
 
 void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::LogicalPartition>& partitions)
@@ -306,19 +329,14 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
   DBRM dbrm;
   uint32_t i;
   vector<EMEntry> extents;
+  vector<pair<LBID_t, LBID_t> > ranges;
   int err;
   uint32_t currentExtent;
-  LBID_t currentLBID;
-  typedef tr1::unordered_multimap<LBID_t, filebuffer_uset_t::iterator> byLBID_t;
-  byLBID_t byLBID;
-  pair<byLBID_t::iterator, byLBID_t::iterator> itList;
-  filebuffer_uset_t::iterator it;
   uint32_t count = oids.size();
 
-  boost::mutex::scoped_lock lk(fWLock);
-
   if (fReportFrequency)
   {
+    boost::mutex::scoped_lock lk(fLogLock);
     std::set<BRM::LogicalPartition>::iterator sit;
     fLog << "flushPartition oids: ";
     for (uint32_t i = 0; i < count; i++)
@@ -333,13 +351,9 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
     fLog << endl;
   }
 
-  if (fCacheSize == 0 || oids.size() == 0 || partitions.size() == 0)
+  if (size() == 0 || oids.size() == 0 || partitions.size() == 0)
     return;
 
-  /* Index the cache by LBID */
-  for (it = fbSet.begin(); it != fbSet.end(); it++)
-    byLBID.insert(pair<LBID_t, filebuffer_uset_t::iterator>(it->lbid, it));
-
   for (i = 0; i < count; i++)
   {
     extents.clear();
@@ -347,7 +361,6 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
 
     if (err < 0)
     {
-      lk.unlock();
       flushCache();  // better than returning an error code to the user
       return;
     }
@@ -361,20 +374,42 @@ void FileBufferMgr::flushPartition(const vector<OID_t>& oids, const set<BRM::Log
       if (partitions.find(logicalPartNum) == partitions.end())
         continue;
 
-      LBID_t lastLBID = range.range.start + (range.range.size * 1024);
+      ranges.push_back(make_pair(range.range.start, range.range.start + (range.range.size * 1024)));
+    }
+  }
 
-      for (currentLBID = range.range.start; currentLBID < lastLBID; currentLBID++)
-      {
-        itList = byLBID.equal_range(currentLBID);
+  flushRanges(ranges);
+}
 
-        for (byLBID_t::iterator tmpIt = itList.first; tmpIt != itList.second; tmpIt++)
-        {
-          fbList.erase(fFBPool[tmpIt->second->poolIdx].listLoc());
-          fEmptyPoolSlots.push_back(tmpIt->second->poolIdx);
-          fbSet.erase(tmpIt->second);
-          fCacheSize--;
-        }
+// drops every block in the [first, second) LBID ranges
+void FileBufferMgr::flushRanges(vector<pair<LBID_t, LBID_t> >& ranges)
+{
+  filebuffer_uset_t::iterator it, tmpIt;
+  vector<pair<LBID_t, LBID_t> >::iterator range;
+
+  if (ranges.empty())
+    return;
+
+  sort(ranges.begin(), ranges.end());
+
+  for (uint32_t i = 0; i < fShardCount; i++)
+  {
+    Shard& s = fShards[i];
+    std::unique_lock<std::shared_mutex> lk(s.lock);
+
+    for (it = s.fbSet.begin(); it != s.fbSet.end();)
+    {
+      // the last range that starts at or before the lbid
+      range = upper_bound(ranges.begin(), ranges.end(), make_pair(it->lbid, numeric_limits<LBID_t>::max()));
+
+      if (range != ranges.begin() && it->lbid < (--range)->second)
+      {
+        tmpIt = it;
+        ++it;
+        remove(s, tmpIt);
       }
+      else
+        ++it;
     }
   }
 }
@@ -388,16 +423,15 @@ bool FileBufferMgr::exists(const BRM::LBID_t& lbid, const BRM::VER_t& ver) const
 
 FileBuffer* FileBufferMgr::findPtr(const HashObject_t& keyFb)
 {
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& s = shardOf(keyFb.lbid);
+  std::shared_lock<std::shared_mutex> lk(s.lock);
 
-  filebuffer_uset_iter_t it = fbSet.find(keyFb);
+  filebuffer_uset_iter_t it = s.fbSet.find(keyFb);
 
-  if (fbSet.end() != it)
+  if (s.fbSet.end() != it)
   {
-    FileBuffer* fb = &(fFBPool[it->poolIdx]);
-    fFBPool[it->poolIdx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[it->poolIdx]).listLoc());
-    return fb;
+    touch(s, it->poolIdx);
+    return &(s.fbPool[it->poolIdx]);
   }
 
   return NULL;
@@ -407,15 +441,15 @@ bool FileBufferMgr::find(const HashObject_t& keyFb, FileBuffer& fb)
 {
   bool ret = false;
 
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& s = shardOf(keyFb.lbid);
+  std::shared_lock<std::shared_mutex> lk(s.lock);
 
-  filebuffer_uset_iter_t it = fbSet.find(keyFb);
+  filebuffer_uset_iter_t it = s.fbSet.find(keyFb);
 
-  if (fbSet.end() != it)
+  if (s.fbSet.end() != it)
   {
-    fFBPool[it->poolIdx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[it->poolIdx]).listLoc());
-    fb = fFBPool[it->poolIdx];
+    touch(s, it->poolIdx);
+    fb = s.fbPool[it->poolIdx];
     ret = true;
   }
 
@@ -428,21 +462,21 @@ bool FileBufferMgr::find(const HashObject_t& keyFb, void* bufferPtr)
 
   if (gPMProfOn && gPMStatsPtr)
     gPMStatsPtr->markEvent(keyFb.lbid, pthread_self(), gSession, 'L');
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& s = shardOf(keyFb.lbid);
+  std::shared_lock<std::shared_mutex> lk(s.lock);
 
   if (gPMProfOn && gPMStatsPtr)
     gPMStatsPtr->markEvent(keyFb.lbid, pthread_self(), gSession, 'M');
-  filebuffer_uset_iter_t it = fbSet.find(keyFb);
+  filebuffer_uset_iter_t it = s.fbSet.find(keyFb);
 
-  if (fbSet.end() != it)
+  if (s.fbSet.end() != it)
   {
     uint32_t idx = it->poolIdx;
 
-    //@bug 669 LRU cache, move block to front of list as last recently used.
-    fFBPool[idx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[idx]).listLoc());
+    //@bug 669 LRU cache, mark the block as recently used.
+    touch(s, idx);
     lk.unlock();
-    memcpy(bufferPtr, (fFBPool[idx]).getData(), 8192);
+    memcpy(bufferPtr, (s.fbPool[idx]).getData(), 8192);
 
     if (gPMProfOn && gPMStatsPtr)
       gPMStatsPtr->markEvent(keyFb.lbid, pthread_self(), gSession, 'U');
@@ -456,8 +490,9 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
                                  bool* wasCached, uint32_t count)
 {
   uint32_t i, ret = 0;
-  filebuffer_uset_iter_t* it = (filebuffer_uset_iter_t*)alloca(count * sizeof(filebuffer_uset_iter_t));
-  uint32_t* indexes = (uint32_t*)alloca(count * 4);
+  const uint8_t** blocks = (const uint8_t**)alloca(count * sizeof(uint8_t*));
+  Shard* s = NULL;
+  std::shared_lock<std::shared_mutex> lk;
 
   if (gPMProfOn && gPMStatsPtr)
   {
@@ -467,42 +502,44 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
     }
   }
 
-  boost::mutex::scoped_lock lk(fWLock);
-
-  if (gPMProfOn && gPMStatsPtr)
+  for (i = 0; i < count; i++)
   {
-    for (i = 0; i < count; i++)
+    // consecutive LBIDs are usually in the same shard, keep its lock until that changes
+    if (s != &shardOf(lbids[i]))
     {
-      gPMStatsPtr->markEvent(lbids[i], pthread_self(), gSession, 'M');
+      if (s)
+        lk.unlock();
+
+      s = &shardOf(lbids[i]);
+      lk = std::shared_lock<std::shared_mutex>(s->lock);
+
+      if (gPMProfOn && gPMStatsPtr)
+        gPMStatsPtr->markEvent(lbids[i], pthread_self(), gSession, 'M');
     }
-  }
 
-  for (i = 0; i < count; i++)
-  {
-    new ((void*)&it[i]) filebuffer_uset_iter_t();
-    it[i] = fbSet.find(HashObject_t(lbids[i], vers[i], 0));
+    filebuffer_uset_iter_t it = s->fbSet.find(HashObject_t(lbids[i], vers[i], 0));
 
-    if (it[i] != fbSet.end())
+    if (it != s->fbSet.end())
     {
-      indexes[i] = it[i]->poolIdx;
+      blocks[i] = s->fbPool[it->poolIdx].getData();
       wasCached[i] = true;
-      fFBPool[it[i]->poolIdx].listLoc()->hits++;
-      fbList.splice(fbList.begin(), fbList, (fFBPool[it[i]->poolIdx]).listLoc());
+      touch(*s, it->poolIdx);
     }
     else
     {
       wasCached[i] = false;
-      indexes[i] = 0;
+      blocks[i] = NULL;
     }
   }
 
-  lk.unlock();
+  if (s)
+    lk.unlock();
 
   for (i = 0; i < count; i++)
   {
     if (wasCached[i])
     {
-      memcpy(buffers[i], fFBPool[indexes[i]].getData(), 8192);
+      memcpy(buffers[i], blocks[i], 8192);
       ret++;
 
       if (gPMProfOn && gPMStatsPtr)
@@ -510,8 +547,6 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
         gPMStatsPtr->markEvent(lbids[i], pthread_self(), gSession, 'U');
       }
     }
-
-    it[i].filebuffer_uset_iter_t::~filebuffer_uset_iter_t();
   }
 
   return ret;
@@ -520,20 +555,30 @@ uint32_t FileBufferMgr::bulkFind(const BRM::LBID_t* lbids, const BRM::VER_t* ver
 bool FileBufferMgr::exists(const HashObject_t& fb) const
 {
   bool find_bool = false;
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& s = shardOf(fb.lbid);
+  std::shared_lock<std::shared_mutex> lk(s.lock);
 
-  filebuffer_uset_iter_t it = fbSet.find(fb);
+  filebuffer_uset_iter_t it = s.fbSet.find(fb);
 
-  if (it != fbSet.end())
+  if (it != s.fbSet.end())
   {
     find_bool = true;
-    fFBPool[it->poolIdx].listLoc()->hits++;
-    fbList.splice(fbList.begin(), fbList, (fFBPool[it->poolIdx]).listLoc());
+    touch(s, it->poolIdx);
   }
 
   return find_bool;
 }
 
+// A hit only sets the clock bit, evict() does the reordering.  Checking the bit first keeps
+// the hot blocks' cache lines from bouncing between the threads reading them.
+void FileBufferMgr::touch(Shard& s, uint32_t poolIdx) const
+{
+  FBData_t& fbdata = *s.fbPool[poolIdx].listLoc();
+
+  if (!fbdata.referenced)
+    atomicops::atomicCAS<uint8_t>(&fbdata.referenced, 0, 1);
+}
+
 // default insert operation.
 // add a new fb into fbMgr and to fbList
 // add to the front and age out from the back
@@ -542,253 +587,225 @@ bool FileBufferMgr::exists(const HashObject_t& fb) const
 
 int FileBufferMgr::insert(const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data)
 {
-  int ret = 0;
-
   if (gPMProfOn && gPMStatsPtr)
     gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'I');
 
-  boost::mutex::scoped_lock lk(fWLock);
+  Shard& s = shardOf(lbid);
+  std::unique_lock<std::shared_mutex> lk(s.lock);
 
-  HashObject_t fbIndex(lbid, ver, 0);
-  filebuffer_pair_t pr = fbSet.insert(fbIndex);
+  return (insertBlock(s, lbid, ver, data, true) ? 1 : 0);
+}
 
-  if (pr.second)
+int FileBufferMgr::bulkInsert(const vector<CacheInsert_t>& ops)
+{
+  uint32_t i;
+  int ret = 0;
+  ostringstream os;
+
+  for (i = 0; i < ops.size(); i++)
   {
-    // It was inserted (it wasn't there before)
-    // Right now we have an invalid cache: we have inserted an entry with a -1 index.
-    // We need to fix this quickly...
-    fCacheSize++;
-    FBData_t fbdata = {lbid, ver, 0};
-    fbList.push_front(fbdata);
-    fBlksLoaded++;
+    const CacheInsert_t& op = ops[i];
+
+    if (gPMProfOn && gPMStatsPtr)
+      gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'I');
+
+    Shard& s = shardOf(op.lbid);
+    std::unique_lock<std::shared_mutex> lk(s.lock);
 
-    if (fReportFrequency && (fBlksLoaded % fReportFrequency) == 0)
+    if (insertBlock(s, op.lbid, op.ver, op.data, false))
     {
-      struct timespec tm;
-      clock_gettime(CLOCK_MONOTONIC, &tm);
-      fLog << "insert: " << left << fixed << ((double)(tm.tv_sec + (1.e-9 * tm.tv_nsec))) << " " << right
-           << setw(12) << fBlksLoaded << " " << right << setw(12) << fBlksNotUsed << endl;
+      if (fReportFrequency)
+        os << op.lbid << " " << op.ver << ", ";
+
+      ret++;
     }
   }
-  else
+
+  if (fReportFrequency)
+  {
+    boost::mutex::scoped_lock lk(fLogLock);
+    fLog << "bulkInsert: " << os.str() << endl;
+  }
+
+  return ret;
+}
+
+// returns false if the block was already cached
+bool FileBufferMgr::insertBlock(Shard& s, const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data,
+                                bool deplete)
+{
+  HashObject_t fbIndex(lbid, ver, 0);
+  filebuffer_pair_t pr = s.fbSet.insert(fbIndex);
+
+  if (!pr.second)
   {
     // if it's a duplicate there's nothing to do
     if (gPMProfOn && gPMStatsPtr)
       gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'D');
-    return ret;
+    return false;
   }
 
-  uint32_t pi = numeric_limits<int>::max();
+  // It was inserted (it wasn't there before)
+  // Right now we have an invalid cache: we have inserted an entry with a -1 index.
+  // We need to fix this quickly...
+  uint64_t blksLoaded = atomicops::atomicInc(&fBlksLoaded);
 
-  if (fCacheSize > maxCacheSize())
+  if (fReportFrequency && (blksLoaded % fReportFrequency) == 0)
   {
-    // If the insert above caused the cache to exceed its max size, find the lru block in
-    // the cache and use its pool index to store the block data.
-    FBData_t& fbdata = fbList.back();  // the lru block
-    HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
-    filebuffer_uset_iter_t iter = fbSet.find(lastFB);  // should be there
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    boost::mutex::scoped_lock lk(fLogLock);
+    fLog << "insert: " << left << fixed << ((double)(tm.tv_sec + (1.e-9 * tm.tv_nsec))) << " " << right
+         << setw(12) << blksLoaded << " " << right << setw(12) << fBlksNotUsed << endl;
+  }
+
+  // 2Q: a block goes straight to the LRU list only if it was evicted from probation recently
+  bool hot = true;
 
-    idbassert(iter != fbSet.end());
-    pi = iter->poolIdx;
-    idbassert(pi < maxCacheSize());
-    idbassert(pi < fFBPool.size());
+  if (fPolicy == TWO_Q)
+  {
+    filebuffer_uset_iter_t ghost = s.ghosts.find(fbIndex);
 
-    // set iters are always const. We are not changing the hash here, and this gets us
-    // the pointer we need cheaply...
-    HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
-    ref.poolIdx = pi;
+    hot = (ghost != s.ghosts.end());
+
+    if (hot)
+      s.ghosts.erase(ghost);
+  }
 
-    // replace the lru block with this block
-    FileBuffer fb(lbid, ver, NULL, 0);
-    fFBPool[pi] = fb;
-    fFBPool[pi].setData(data, 8192);
-    fbSet.erase(iter);
+  uint32_t pi;
 
-    if (fbList.back().hits == 0)
-      fBlksNotUsed++;
+  if (s.cacheSize >= s.maxBlocks)
+  {
+    // The cache is full, evict a block and use its pool index to store the block data.  The
+    // new block isn't on a list yet, so the CLOCK hand can't come around to it.
+    pi = evict(s);
 
-    fbList.pop_back();
-    fCacheSize--;
-    depleteCache();
-    ret = 1;
+    if (deplete)
+      depleteCache(s);
+  }
+  else if (!s.emptyPoolSlots.empty())
+  {
+    pi = s.emptyPoolSlots.front();
+    s.emptyPoolSlots.pop_front();
   }
   else
   {
-    if (!fEmptyPoolSlots.empty())
-    {
-      pi = fEmptyPoolSlots.front();
-      fEmptyPoolSlots.pop_front();
-      FileBuffer fb(lbid, ver, NULL, 0);
-      fFBPool[pi] = fb;
-      fFBPool[pi].setData(data, 8192);
-    }
-    else
-    {
-      pi = fFBPool.size();
-      FileBuffer fb(lbid, ver, NULL, 0);
-      fFBPool.push_back(fb);
-      fFBPool[pi].setData(data, 8192);
-    }
-
-    // See comment above
-    HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
-    ref.poolIdx = pi;
-    ret = 1;
+    pi = s.fbPool.size();
+    s.fbPool.resize(pi + 1);  // shouldn't trigger a 'real' resize b/c of the reserve call
   }
 
-  idbassert(pi < fFBPool.size());
-  fFBPool[pi].listLoc(fbList.begin());
+  FBData_t fbdata = {lbid, ver, 0, !hot, 0};
+  filebuffer_list_t& list = (hot ? s.fbList : s.probation);
+  list.push_front(fbdata);
+  s.cacheSize++;
+
+  idbassert(pi < s.fbPool.size());
+  s.fbPool[pi].Lbid(lbid);
+  s.fbPool[pi].Verid(ver);
+  s.fbPool[pi].setData(data);
+  s.fbPool[pi].listLoc(list.begin());
+
+  // set iters are always const. We are not changing the hash here, and this gets us
+  // the pointer we need cheaply...
+  HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
+  ref.poolIdx = pi;
 
   if (gPMProfOn && gPMStatsPtr)
     gPMStatsPtr->markEvent(lbid, pthread_self(), gSession, 'J');
 
-  idbassert(fCacheSize <= maxCacheSize());
-  // 	idbassert(fCacheSize == fbSet.size());
-  // 	idbassert(fCacheSize == fbList.size());
-  return ret;
+  idbassert(s.cacheSize <= s.maxBlocks);
+  return true;
 }
 
-void FileBufferMgr::depleteCache()
+// Drops the block the replacement policy picks and returns its pool index.  2Q evicts from
+// probation while it's over its share of the cache, remembering what it evicted.  Blocks on
+// probation leave in FIFO order whether they were hit or not.
+uint32_t FileBufferMgr::evict(Shard& s)
 {
-  for (uint32_t i = 0; i < fDeleteBlocks && !fbList.empty(); ++i)
+  const size_t maxProbation = s.maxBlocks / 4;
+  const size_t maxGhosts = s.maxBlocks / 2;
+  bool fromProbation = !s.probation.empty() && (s.probation.size() > maxProbation || s.fbList.empty());
+  filebuffer_list_t& list = (fromProbation ? s.probation : s.fbList);
+
+  // CLOCK: a block hit since the hand last passed it goes back to the front.  Every pass clears
+  // a bit, so this ends within one trip around the list.
+  if (!fromProbation)
   {
-    FBData_t fbdata(fbList.back());  // the lru block
-    HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
-    filebuffer_uset_iter_t iter = fbSet.find(lastFB);
+    while (list.back().referenced)
+    {
+      list.back().referenced = 0;
+      list.back().hits = 1;
+      list.splice(list.begin(), list, --list.end());
+    }
+  }
 
-    idbassert(iter != fbSet.end());
-    uint32_t idx = iter->poolIdx;
-    idbassert(idx < fFBPool.size());
-    // Save position in FileBuffer pool for reuse.
-    fEmptyPoolSlots.push_back(idx);
-    fbSet.erase(iter);
+  FBData_t& fbdata = list.back();
+  HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
+  filebuffer_uset_iter_t iter = s.fbSet.find(lastFB);  // should be there
 
-    if (fbList.back().hits == 0)
-      fBlksNotUsed++;
+  idbassert(iter != s.fbSet.end());
+  uint32_t pi = iter->poolIdx;
+  idbassert(pi < s.fbPool.size());
 
-    fbList.pop_back();
-    fCacheSize--;
-  }
-}
+  if (fbdata.hits == 0 && !fbdata.referenced)
+    atomicops::atomicInc(&fBlksNotUsed);
 
-ostream& FileBufferMgr::formatLRUList(ostream& os) const
-{
-  filebuffer_list_t::const_iterator iter = fbList.begin();
-  filebuffer_list_t::const_iterator end = fbList.end();
-
-  while (iter != end)
+  if (fromProbation)
   {
-    os << iter->lbid << '\t' << iter->ver << endl;
-    ++iter;
+    if (s.ghosts.insert(lastFB).second)
+      s.ghostList.push_back(lastFB);
+
+    while (s.ghostList.size() > maxGhosts)
+    {
+      s.ghosts.erase(s.ghostList.front());
+      s.ghostList.pop_front();
+    }
   }
 
-  return os;
+  s.fbSet.erase(iter);
+  list.pop_back();
+  s.cacheSize--;
+  return pi;
 }
 
-// puts the new entry at the front of the list
-void FileBufferMgr::updateLRU(const FBData_t& f)
+void FileBufferMgr::remove(Shard& s, filebuffer_uset_iter_t iter)
 {
-  if (fCacheSize > maxCacheSize())
-  {
-    list<FBData_t>::iterator last = fbList.end();
-    last--;
-    FBData_t& fbdata = *last;
-    HashObject_t lastFB(fbdata.lbid, fbdata.ver, 0);
-    filebuffer_uset_iter_t iter = fbSet.find(lastFB);
-    fEmptyPoolSlots.push_back(iter->poolIdx);
-
-    if (fbdata.hits == 0)
-      fBlksNotUsed++;
-
-    fbSet.erase(iter);
-    fbList.splice(fbList.begin(), fbList, last);
-    fbdata = f;
-    fCacheSize--;
-    // cout << "booted an entry\n";
-  }
-  else
-  {
-    // cout << "new entry\n";
-    fbList.push_front(f);
-  }
+  uint32_t idx = iter->poolIdx;
+  const filebuffer_list_iter_t loc = s.fbPool[idx].listLoc();
+
+  (loc->probation ? s.probation : s.fbList).erase(loc);
+  // add to emptyPoolSlots
+  s.emptyPoolSlots.push_back(idx);
+  s.fbSet.erase(iter);
+  s.cacheSize--;
 }
 
-uint32_t FileBufferMgr::doBlockCopy(const BRM::LBID_t& lbid, const BRM::VER_t& ver, const uint8_t* data)
+void FileBufferMgr::depleteCache(Shard& s)
 {
-  uint32_t poolIdx;
-
-  if (!fEmptyPoolSlots.empty())
+  for (uint32_t i = 0; i < fDeleteBlocks && s.cacheSize > 0; ++i)
   {
-    poolIdx = fEmptyPoolSlots.front();
-    fEmptyPoolSlots.pop_front();
-  }
-  else
-  {
-    poolIdx = fFBPool.size();
-    fFBPool.resize(poolIdx + 1);  // shouldn't trigger a 'real' resize b/c of the reserve call
+    // Save position in FileBuffer pool for reuse.
+    s.emptyPoolSlots.push_back(evict(s));
   }
-
-  fFBPool[poolIdx].Lbid(lbid);
-  fFBPool[poolIdx].Verid(ver);
-  fFBPool[poolIdx].setData(data);
-  return poolIdx;
 }
 
-int FileBufferMgr::bulkInsert(const vector<CacheInsert_t>& ops)
+ostream& FileBufferMgr::formatLRUList(ostream& os) const
 {
-  uint32_t i;
-  int32_t pi;
-  int ret = 0;
-
-  boost::mutex::scoped_lock lk(fWLock);
+  filebuffer_list_t::const_iterator iter;
 
-  if (fReportFrequency)
+  for (uint32_t i = 0; i < fShardCount; i++)
   {
-    fLog << "bulkInsert: ";
-  }
+    Shard& s = fShards[i];
+    std::shared_lock<std::shared_mutex> lk(s.lock);
 
-  for (i = 0; i < ops.size(); i++)
-  {
-    const CacheInsert_t& op = ops[i];
-
-    if (gPMProfOn && gPMStatsPtr)
-      gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'I');
-
-    HashObject_t fbIndex(op.lbid, op.ver, 0);
-    filebuffer_pair_t pr = fbSet.insert(fbIndex);
-
-    if (!pr.second)
-    {
-      if (gPMProfOn && gPMStatsPtr)
-        gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'D');
-      continue;
-    }
+    for (iter = s.fbList.begin(); iter != s.fbList.end(); ++iter)
+      os << iter->lbid << '\t' << iter->ver << endl;
 
-    if (fReportFrequency)
-    {
-      fLog << op.lbid << " " << op.ver << ", ";
-    }
-    fCacheSize++;
-    fBlksLoaded++;
-    FBData_t fbdata = {op.lbid, op.ver, 0};
-    updateLRU(fbdata);
-    pi = doBlockCopy(op.lbid, op.ver, op.data);
-
-    HashObject_t& ref = const_cast<HashObject_t&>(*pr.first);
-    ref.poolIdx = pi;
-    fFBPool[pi].listLoc(fbList.begin());
-
-    if (gPMProfOn && gPMStatsPtr)
-      gPMStatsPtr->markEvent(op.lbid, pthread_self(), gSession, 'J');
-    ret++;
+    for (iter = s.probation.begin(); iter != s.probation.end(); ++iter)
+      os << iter->lbid << '\t' << iter->ver << '\t' << "probation" << endl;
   }
-  if (fReportFrequency)
-  {
-    fLog << endl;
-  }
-  idbassert(fCacheSize <= maxCacheSize());
 
-  return ret;
+  return os;
 }
 
 }  // namespace dbbc
@@ -28,13 +28,17 @@
 #include <iomanip>
 #include <tr1/unordered_set>
 #include <boost/thread.hpp>
+#include <boost/scoped_array.hpp>
 #include <deque>
+#include <shared_mutex>
 
 #include "primitivemsg.h"
 #include "blocksize.h"
 #include "filebuffer.h"
 #include "rwlock_local.h"
 
+class FileBufferMgrTest;
+
 /**
         @author Jason Rodriguez <jrodriguez@calpont.com>
 */
@@ -43,6 +47,18 @@
  * @brief manages storage of Disk Block Buffers via and LRU cache using the stl classes unordered_set and
  *list.
  *
+ * The cache is split into shards by LBID, each with its own lock, index, lists and part of the
+ * buffer pool, so lookups from concurrent PrimProc threads don't serialize on one mutex.
+ *
+ * DBBC/ReplacementPolicy picks how blocks are aged out, 2Q by default.  LRU keeps one list.  2Q puts new
+ * blocks on a FIFO probation list that is at most a quarter of the cache, and only promotes a
+ * block to the LRU list if it's read again after being evicted from probation, which it
+ * remembers in a ghost list of keys.  A big scan then only cycles through the probation list
+ * and can't evict the blocks other queries keep coming back to.
+ *
+ * Lookups only take a shard's lock shared.  A hit sets the block's clock bit instead of moving
+ * it in a list; eviction gives a block with the bit set a second chance by clearing it and
+ * moving it to the front, so the LRU list is a CLOCK approximation of LRU.
  **/
 
 namespace dbbc
@@ -105,6 +121,12 @@ class FileBufferMgr
 
   typedef std::deque<uint32_t> emptylist_t;
 
+  enum ReplacementPolicy
+  {
+    LRU,
+    TWO_Q
+  };
+
   /**
    * @brief ctor. Set max buffer size to numBlcks and block buffer size to blckSz
    **/
@@ -138,10 +160,7 @@ class FileBufferMgr
   /**
    * @brief returns the total number of Disk Blocks in the Cache
    **/
-  uint32_t size() const
-  {
-    return fbSet.size();
-  }
+  uint32_t size() const;
 
   /**
    * @brief
@@ -187,14 +206,15 @@ class FileBufferMgr
     return fMaxNumBlocks;
   }
 
-  uint32_t listSize() const
+  uint32_t listSize() const;
+
+  ReplacementPolicy replacementPolicy() const
   {
-    return fbList.size();
+    return fPolicy;
   }
-
-  const filebuffer_uset_iter_t end() const
+  uint32_t shardCount() const
   {
-    return fbSet.end();
+    return fShardCount;
   }
 
   void setReportingFrequency(const uint32_t d);
@@ -206,33 +226,61 @@ class FileBufferMgr
   std::ostream& formatLRUList(std::ostream& os) const;
 
  private:
+  struct Shard
+  {
+    Shard() : cacheSize(0), maxBlocks(0)
+    {
+    }
+
+    std::shared_mutex lock;  // shared for lookups, exclusive for anything that changes the shard
+    filebuffer_uset_t fbSet;
+    filebuffer_list_t fbList;     // LRU: every block, 2Q: the blocks that were read again
+    filebuffer_list_t probation;  // 2Q: the new blocks, in FIFO order
+    std::deque<HashObject_t> ghostList;  // 2Q: the blocks evicted from probation, oldest first
+    filebuffer_uset_t ghosts;            // 2Q: the same, for lookups
+    uint32_t cacheSize;
+    uint32_t maxBlocks;
+    FileBufferPool_t fbPool;       // vector<FileBuffer>, never grows past maxBlocks
+    emptylist_t emptyPoolSlots;    // keep track of fbPool slots that can be reused
+  };
+
+  // Blocks are read in runs of consecutive LBIDs, keep a run in one shard
+  inline Shard& shardOf(const BRM::LBID_t lbid) const
+  {
+    return fShards[((((uint64_t)lbid >> 6) * 0x9E3779B97F4A7C15ULL) >> 32) % fShardCount];
+  }
+
   uint32_t fMaxNumBlocks;  // the max number of blockSz blocks to keep in the Cache list
   uint32_t fBlockSz;       // size in bytes size of a data block - probably 8
 
-  mutable boost::mutex fWLock;
-  mutable filebuffer_uset_t fbSet;
-
-  mutable filebuffer_list_t fbList;  // rename this
-  uint32_t fCacheSize;
+  ReplacementPolicy fPolicy;
+  uint32_t fShardCount;
+  boost::scoped_array<Shard> fShards;
 
-  FileBufferPool_t fFBPool;  // vector<FileBuffer>
-  uint32_t fDeleteBlocks;
-  emptylist_t fEmptyPoolSlots;  // keep track of FBPool slots that can be reused
+  uint32_t fDeleteBlocks;  // per shard
 
-  void depleteCache();
+  void depleteCache(Shard& s);
   uint64_t fBlksLoaded;       // number of blocks inserted into cache
   uint64_t fBlksNotUsed;      // number of blocks inserted and not used
   uint64_t fReportFrequency;  // how many blocks are read between reports
+  boost::mutex fLogLock;
   std::ofstream fLog;
   config::Config* fConfig;
 
+  // the tests pick the policy Columnstore.xml sets
+  friend class ::FileBufferMgrTest;
+
   // do not implement
   FileBufferMgr(const FileBufferMgr& fbm);
   const FileBufferMgr& operator=(const FileBufferMgr& fbm);
 
-  // used by bulkInsert
-  void updateLRU(const FBData_t& f);
-  uint32_t doBlockCopy(const BRM::LBID_t& lbid, const BRM::VER_t& ver, const uint8_t* data);
+  // these expect the shard to be locked, touch() only needs the shared lock
+  bool insertBlock(Shard& s, const BRM::LBID_t lbid, const BRM::VER_t ver, const uint8_t* data,
+                   bool deplete);
+  void touch(Shard& s, uint32_t poolIdx) const;
+  uint32_t evict(Shard& s);
+  void remove(Shard& s, filebuffer_uset_iter_t iter);
+  void flushRanges(std::vector<std::pair<BRM::LBID_t, BRM::LBID_t> >& ranges);
 };
 
 }  // namespace dbbc
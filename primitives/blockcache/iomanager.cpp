@@ -46,7 +46,9 @@
 #include <stdexcept>
 #include <unistd.h>
 #include <stdlib.h>
+#include <deque>
 #include <string>
+#include <vector>
 #include <sstream>
 #include <tr1/unordered_map>
 #include <tr1/unordered_set>
@@ -58,6 +60,7 @@
 #include <errno.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/thread.hpp>
 #include <boost/thread/condition.hpp>
 #include <pthread.h>
@@ -82,6 +85,7 @@ using namespace logging;
 #include "rwlock_local.h"
 
 #include "iomanager.h"
+#include "ioring.h"
 #include "liboamcpp.h"
 
 #include "idbcompress.h"
@@ -372,6 +376,268 @@ static int updateptrs(char* ptr, FdCacheType_t::iterator fdit)
   return 0;
 }
 
+// The reads of queued requests a reader thread keeps in flight with io_uring,
+// DBBC/IOUringDepth of them.  While no other reader is idle, the reader takes
+// requests off the queue along with the one it works on, locks their LBID
+// ranges and submits their reads, in one system call.  That is done for range
+// reads of open files, of compressed files only if the chunk pointers are
+// current.  When the reader gets to such a request it uses the data if the
+// request reads the same bytes of the same file, pread() otherwise.
+//
+// A reader never waits for an LBID range while it holds the ranges of queued
+// requests, it lets them go first.
+class ReadAheadQueue
+{
+ public:
+  struct Slot
+  {
+    fileRequest* fr;
+    SPFdEntry_t fe;
+    uint64_t offset;
+    uint32_t len;
+    int32_t result;
+    uint32_t buf;   // index into fBufs
+    bool locked;    // the LBID range of fr is locked
+    bool issued;    // the read was submitted and its data wasn't used
+    bool inFlight;  // the read didn't complete yet
+  };
+
+  ReadAheadQueue(ioManager* iom, uint32_t depth, size_t bufSize, size_t maxCompSz)
+   : fIom(iom), fRing(depth), fSlots(depth), fCurBuf(depth), fMaxCompSz(maxCompSz)
+  {
+    vector<struct iovec> iovs;
+
+    for (uint32_t i = 0; i <= depth; i++)
+    {
+      void* buf = 0;
+
+      if (posix_memalign(&buf, 4096, bufSize) != 0)
+        throw bad_alloc();
+
+      fBufs.push_back(static_cast<char*>(buf));
+      iovs.push_back({buf, bufSize});
+    }
+
+    for (uint32_t i = 0; i < depth; i++)
+    {
+      fSlots[i].fr = 0;
+      fSlots[i].buf = i;
+      fSlots[i].locked = fSlots[i].issued = fSlots[i].inFlight = false;
+      fFree.push_back(i);
+    }
+
+    // pinned buffers spare the kernel mapping them for every O_DIRECT read
+    if (fRing.valid())
+      fRing.registerBuffers(&iovs[0], iovs.size());
+  }
+
+  ~ReadAheadQueue()
+  {
+    for (uint32_t i = 0; i < fSlots.size(); i++)
+      waitFor(fSlots[i]);
+
+    for (uint32_t i = 0; i < fBufs.size(); i++)
+      free(fBufs[i]);
+  }
+
+  bool valid() const
+  {
+    return fRing.valid();
+  }
+
+  // the read buffer of the thread
+  char* buffer() const
+  {
+    return fBufs[fCurBuf];
+  }
+
+  // the next queued request, null if none
+  fileRequest* next(Slot*& slot)
+  {
+    if (fPending.empty())
+      return 0;
+
+    slot = &fSlots[fPending.front()];
+    fPending.pop_front();
+    return slot->fr;
+  }
+
+  // take queued requests for the free slots and submit their reads
+  void fill()
+  {
+    while (!fFree.empty())
+    {
+      fileRequest* fr = fIom->tryGetNextRequest();
+
+      if (!fr)
+        break;
+
+      uint32_t id = fFree.back();
+      fFree.pop_back();
+      issue(id, fr);
+      fPending.push_back(id);
+    }
+
+    fRing.submit();
+  }
+
+  // let go of the LBID ranges of the queued requests, their reads are redone
+  void unlockPending()
+  {
+    for (deque<uint32_t>::iterator it = fPending.begin(); it != fPending.end(); ++it)
+    {
+      Slot& slot = fSlots[*it];
+
+      if (slot.locked)
+      {
+        fIom->dbrm()->releaseLBIDRange(slot.fr->Lbid(), slot.fr->BlocksRequested());
+        slot.locked = false;
+        slot.issued = false;
+      }
+    }
+  }
+
+  // pread() that takes the data of the read of slot if it read the same bytes,
+  // buf is swapped with the buffer of the slot then
+  ssize_t read(Slot* slot, IDBDataFile* fp, char*& buf, uint64_t offset, uint32_t len)
+  {
+    if (slot && slot->issued && slot->fe->fp == fp && slot->offset == offset && slot->len == len)
+    {
+      slot->issued = false;
+      waitFor(*slot);
+
+      if (slot->result == (int32_t)len)
+      {
+        swap(fCurBuf, slot->buf);
+        buf = fBufs[fCurBuf];
+        return len;
+      }
+    }
+
+    return fp->pread(buf, offset, len);
+  }
+
+  // done with the request of slot, its range was released by the caller
+  void retire(Slot*& slot)
+  {
+    waitFor(*slot);
+
+    if (slot->fe)
+    {
+      fdMapMutex.lock();
+      slot->fe->inUse--;
+      fdMapMutex.unlock();
+      slot->fe.reset();
+    }
+
+    slot->fr = 0;
+    slot->locked = slot->issued = false;
+    fFree.push_back(slot - &fSlots[0]);
+    slot = 0;
+  }
+
+ private:
+  void waitFor(Slot& slot)
+  {
+    while (slot.inFlight)
+    {
+      uint64_t id;
+      int32_t res;
+
+      if (!fRing.wait(id, res))
+      {
+        // can't happen with a valid ring, don't reuse the buffer
+        throw runtime_error("ReadAheadQueue: io_uring wait failed");
+      }
+
+      fSlots[id].result = res;
+      fSlots[id].inFlight = false;
+    }
+  }
+
+  void issue(uint32_t id, fileRequest* fr)
+  {
+    Slot& slot = fSlots[id];
+    BRM::OID_t oid;
+    uint16_t dbroot;
+    uint32_t partNum;
+    uint16_t segNum;
+    uint32_t offset;
+
+    slot.fr = fr;
+
+    // single blocks need a VSS lookup, leave them to thr_popper
+    if (fr->BlocksRequested() <= 1 ||
+        fIom->localLbidLookup(fr->Lbid(), fr->Ver().currentScn, fr->Flg(), oid, dbroot, partNum, segNum,
+                              offset) < 0)
+      return;
+
+    FdEntry fdKey(oid, dbroot, partNum, segNum, fr->CompType(), NULL);
+    uint64_t fileOffset = (uint64_t)offset * BLOCK_SIZE;
+
+    fdMapMutex.lock();
+    FdCacheType_t::iterator fdit = fdcache.find(fdKey);
+
+    if (fdit == fdcache.end() || !fdit->second.get() || fdit->second->fp->fd() < 0)
+    {
+      fdMapMutex.unlock();
+      return;
+    }
+
+    SPFdEntry_t fe = fdit->second;
+
+    if (fe->isCompressed())
+    {
+      uint64_t idx = fileOffset / (4 * 1024 * 1024);
+      time_t mtime = fe->fp->mtime();
+
+      if (mtime == (time_t)-1 || mtime > fe->cmpMTime || idx >= fe->ptrList.size() ||
+          fe->ptrList[idx].second > fMaxCompSz)
+      {
+        fdMapMutex.unlock();
+        return;
+      }
+
+      slot.offset = fe->ptrList[idx].first;
+      slot.len = fe->ptrList[idx].second;
+    }
+    else
+    {
+      if (fr->BlocksRequested() > fIom->blocksPerRead)
+      {
+        fdMapMutex.unlock();
+        return;
+      }
+
+      slot.offset = fileOffset;
+      slot.len = fr->BlocksRequested() * BLOCK_SIZE;
+    }
+
+    fe->inUse++;
+    fdMapMutex.unlock();
+    slot.fe = fe;
+
+    if (!fIom->dbrm()->tryLockLBIDRange(fr->Lbid(), fr->BlocksRequested()))
+      return;
+
+    slot.locked = true;
+
+    if (!fRing.prepRead(fe->fp->fd(), fBufs[slot.buf], slot.len, slot.offset, id, slot.buf))
+      return;
+
+    slot.issued = slot.inFlight = true;
+  }
+
+  ioManager* fIom;
+  IORing fRing;
+  vector<Slot> fSlots;
+  vector<char*> fBufs;
+  uint32_t fCurBuf;
+  size_t fMaxCompSz;
+  vector<uint32_t> fFree;
+  deque<uint32_t> fPending;
+};
+
 void* thr_popper(ioManager* arg)
 {
   utils::setThreadName("thr_popper");
@@ -448,6 +714,26 @@ void* thr_popper(ioManager* arg)
   uint8_t* uCmpBuf = 0;
   uCmpBuf = new uint8_t[4 * 1024 * 1024 + 4];
 
+  boost::scoped_ptr<ReadAheadQueue> readAhead;
+  ReadAheadQueue::Slot* ra = 0;
+
+  if (iom->IOUringDepth() > 0)
+  {
+    readAhead.reset(new ReadAheadQueue(iom, iom->IOUringDepth(), readBufferSz, maxCompSz));
+
+    if (readAhead->valid())
+    {
+      alignedbuff = readAhead->buffer();
+    }
+    else
+    {
+      Message::Args args;
+      args.add("thr_popper: io_uring isn't available, IOUringDepth is ignored");
+      primitiveprocessor::mlp->logInfoMessage(logging::M0006, args);
+      readAhead.reset();
+    }
+  }
+
   for (;;)
   {
     if (copyLocked)
@@ -456,17 +742,29 @@ void* thr_popper(ioManager* arg)
       copyLocked = false;
     }
 
+    if (ra)
+      readAhead->retire(ra);
+
     if (locked)
     {
       localLock.read_unlock();
       locked = false;
     }
 
-    fr = iom->getNextRequest();
+    fr = 0;
+
+    if (readAhead)
+      fr = readAhead->next(ra);
+
+    if (!fr)
+      fr = iom->getNextRequest();
 
     localLock.read_lock();
     locked = true;
 
+    if (readAhead)
+      readAhead->fill();
+
     if (iom->IOTrace())
       clock_gettime(CLOCK_REALTIME, &rqst1);
 
@@ -487,7 +785,21 @@ void* thr_popper(ioManager* arg)
     offset = 0;
 
     // special case for getBlock.
-    iom->dbrm()->lockLBIDRange(lbid, blocksRequested);
+    if (ra && ra->locked)
+    {
+      // locked when its read was issued
+    }
+    else if (!readAhead)
+    {
+      iom->dbrm()->lockLBIDRange(lbid, blocksRequested);
+    }
+    else if (!iom->dbrm()->tryLockLBIDRange(lbid, blocksRequested))
+    {
+      // don't wait for the range holding the ranges of queued requests
+      readAhead->unlockPending();
+      iom->dbrm()->lockLBIDRange(lbid, blocksRequested);
+    }
+
     copyLocked = true;
 
     // special case for getBlock.
@@ -854,7 +1166,11 @@ void* thr_popper(ioManager* arg)
             break;
           }
 
-          i = fp->pread(&alignedbuff[0], fdit->second->ptrList[idx].first, fdit->second->ptrList[idx].second);
+          if (readAhead)
+            i = readAhead->read(ra, fp, alignedbuff, fdit->second->ptrList[idx].first,
+                                fdit->second->ptrList[idx].second);
+          else
+            i = fp->pread(&alignedbuff[0], fdit->second->ptrList[idx].first, fdit->second->ptrList[idx].second);
 #ifdef IDB_COMP_POC_DEBUG
           {
             boost::mutex::scoped_lock lk(primitiveprocessor::compDebugMutex);
@@ -901,7 +1217,10 @@ void* thr_popper(ioManager* arg)
         }
         else
         {
-          i = fp->pread(&alignedbuff[acc], longSeekOffset, readSize - acc);
+          if (readAhead && acc == 0)
+            i = readAhead->read(ra, fp, alignedbuff, longSeekOffset, readSize);
+          else
+            i = fp->pread(&alignedbuff[acc], longSeekOffset, readSize - acc);
 #ifdef IDB_COMP_POC_DEBUG
           {
             boost::mutex::scoped_lock lk(primitiveprocessor::compDebugMutex);
@@ -1291,6 +1610,16 @@ ioManager::ioManager(FileBufferMgr& fbm, fileBlockRequestQueue& fbrq, int thrCou
     FDTraceFile().open(string(MCSLOGDIR) + "/trace/fdcache", ios_base::ate | ios_base::app);
   }
 
+  val = fConfig->getConfig("DBBC", "IOUringDepth");
+  temp = 0;
+  fIOUringDepth = 0;
+
+  if (val.length() > 0)
+    temp = static_cast<int>(Config::fromText(val));
+
+  if (temp > 0)
+    fIOUringDepth = std::min(temp, 64);
+
   fThreadCount = thrCount;
   go();
 }
@@ -1389,6 +1718,11 @@ fileRequest* ioManager::getNextRequest()
   return blk;
 }
 
+fileRequest* ioManager::tryGetNextRequest()
+{
+  return fIOMRequestQueue.tryPop();
+}
+
 //------------------------------------------------------------------------------
 // Prints stderr msg and updates fileRequest object to reflect an error.
 // Lastly, notifies waiting thread that fileRequest has been completed.
@@ -57,6 +57,7 @@ class ioManager
     return fThreadCount;
   }
   fileRequest* getNextRequest();
+  fileRequest* tryGetNextRequest();
   void go(void);
   void stop();
   FileBufferMgr& fileBufferManager()
@@ -101,6 +102,12 @@ class ioManager
     return fFDCacheTrace;
   }
 
+  // reads in flight per reader thread, 0 disables io_uring
+  uint32_t IOUringDepth() const
+  {
+    return fIOUringDepth;
+  }
+
   void handleBlockReadError(fileRequest* fr, const std::string& errMsg, bool* copyLocked,
                             int errorCode = fileRequest::FAILED);
 
@@ -137,6 +144,7 @@ class ioManager
   uint32_t fDecreaseOpenFilesCount;
   bool fFDCacheTrace;
   std::ofstream fFDTraceFile;
+  uint32_t fIOUringDepth;
 };
 
 // @bug2631, for remount filesystem by loadBlock() in primitiveserver
@@ -0,0 +1,292 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mcsconfig.h"
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include "ioring.h"
+
+#ifdef HAVE_IO_URING
+namespace
+{
+template <typename T>
+T* ringPtr(void* ring, uint32_t offset)
+{
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+}  // namespace
+
+namespace dbbc
+{
+IORing::IORing(uint32_t depth)
+ : fRingFd(-1)
+ , fBuffersRegistered(false)
+ , fToSubmit(0)
+ , fSqRing(MAP_FAILED)
+ , fCqRing(MAP_FAILED)
+ , fSqRingSize(0)
+ , fCqRingSize(0)
+ , fSqes(reinterpret_cast<struct io_uring_sqe*>(MAP_FAILED))
+ , fSqesSize(0)
+{
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  int fd = syscall(__NR_io_uring_setup, std::max(depth, 1U), &params);
+
+  if (fd < 0)
+    return;
+
+  fSqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  fCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+    fSqRingSize = fCqRingSize = std::max(fSqRingSize, fCqRingSize);
+
+  fSqRing = mmap(0, fSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+
+  if (fSqRing == MAP_FAILED)
+  {
+    close(fd);
+    return;
+  }
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+    fCqRing = fSqRing;
+  else
+    fCqRing = mmap(0, fCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+
+  fSqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes = mmap(0, fSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  fSqes = reinterpret_cast<struct io_uring_sqe*>(sqes);
+
+  if (fCqRing == MAP_FAILED || sqes == MAP_FAILED)
+  {
+    close(fd);
+    return;  // the dtor unmaps what was mapped
+  }
+
+  fSqHead = ringPtr<uint32_t>(fSqRing, params.sq_off.head);
+  fSqTail = ringPtr<uint32_t>(fSqRing, params.sq_off.tail);
+  fSqMask = ringPtr<uint32_t>(fSqRing, params.sq_off.ring_mask);
+  fSqEntries = ringPtr<uint32_t>(fSqRing, params.sq_off.ring_entries);
+  fSqArray = ringPtr<uint32_t>(fSqRing, params.sq_off.array);
+  fCqHead = ringPtr<uint32_t>(fCqRing, params.cq_off.head);
+  fCqTail = ringPtr<uint32_t>(fCqRing, params.cq_off.tail);
+  fCqMask = ringPtr<uint32_t>(fCqRing, params.cq_off.ring_mask);
+  fCqes = ringPtr<struct io_uring_cqe>(fCqRing, params.cq_off.cqes);
+
+  fRingFd = fd;
+#endif
+}
+
+IORing::~IORing()
+{
+  if (fSqes != MAP_FAILED)
+    munmap(fSqes, fSqesSize);
+
+  if (fCqRing != MAP_FAILED && fCqRing != fSqRing)
+    munmap(fCqRing, fCqRingSize);
+
+  if (fSqRing != MAP_FAILED)
+    munmap(fSqRing, fSqRingSize);
+
+  if (fRingFd >= 0)
+    close(fRingFd);
+}
+
+bool IORing::registerBuffers(const struct iovec* iovs, uint32_t count)
+{
+  if (!valid())
+    return false;
+
+#ifdef __NR_io_uring_register
+  fBuffersRegistered = (syscall(__NR_io_uring_register, fRingFd, IORING_REGISTER_BUFFERS, iovs, count) == 0);
+#endif
+  return fBuffersRegistered;
+}
+
+bool IORing::prepRead(int fd, void* buf, uint32_t len, uint64_t offset, uint64_t userData, int bufIndex)
+{
+  if (!valid())
+    return false;
+
+  // the kernel moves the head, only this thread moves the tail
+  uint32_t tail = *fSqTail;
+  uint32_t head = __atomic_load_n(fSqHead, __ATOMIC_ACQUIRE);
+
+  if (tail - head >= *fSqEntries)
+    return false;
+
+  uint32_t idx = tail & *fSqMask;
+  struct io_uring_sqe* sqe = &fSqes[idx];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = len;
+  sqe->off = offset;
+  sqe->user_data = userData;
+
+  if (fBuffersRegistered && bufIndex >= 0)
+  {
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->buf_index = bufIndex;
+  }
+  else
+  {
+    sqe->opcode = IORING_OP_READ;
+  }
+
+  fSqArray[idx] = idx;
+  __atomic_store_n(fSqTail, tail + 1, __ATOMIC_RELEASE);
+  fToSubmit++;
+  return true;
+}
+
+int IORing::enter(uint32_t toSubmit, uint32_t minComplete, uint32_t flags)
+{
+  int rc;
+
+#ifdef __NR_io_uring_enter
+  do
+  {
+    rc = syscall(__NR_io_uring_enter, fRingFd, toSubmit, minComplete, flags, 0, 0);
+  } while (rc < 0 && errno == EINTR);
+#else
+  rc = -1;
+  errno = ENOSYS;
+#endif
+
+  return (rc < 0 ? -errno : rc);
+}
+
+int IORing::submit()
+{
+  if (!valid() || fToSubmit == 0)
+    return 0;
+
+  int rc = enter(fToSubmit, 0, 0);
+
+  if (rc > 0)
+    fToSubmit -= std::min<uint32_t>(rc, fToSubmit);
+
+  return rc;
+}
+
+bool IORing::reap(uint64_t& userData, int32_t& res)
+{
+  if (!valid())
+    return false;
+
+  // the kernel moves the tail, only this thread moves the head
+  uint32_t head = *fCqHead;
+
+  if (head == __atomic_load_n(fCqTail, __ATOMIC_ACQUIRE))
+    return false;
+
+  const struct io_uring_cqe* cqe = &fCqes[head & *fCqMask];
+  userData = cqe->user_data;
+  res = cqe->res;
+  __atomic_store_n(fCqHead, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool IORing::wait(uint64_t& userData, int32_t& res)
+{
+  while (!reap(userData, res))
+  {
+    int rc = enter(fToSubmit, 1, IORING_ENTER_GETEVENTS);
+
+    if (rc < 0)
+      return false;
+
+    fToSubmit -= std::min<uint32_t>(rc, fToSubmit);
+  }
+
+  return true;
+}
+
+}  // namespace dbbc
+
+#else
+
+namespace dbbc
+{
+// Built without the io_uring headers, there is never a ring and the readers use pread()
+IORing::IORing(uint32_t)
+ : fRingFd(-1)
+ , fBuffersRegistered(false)
+ , fToSubmit(0)
+ , fSqRing(0)
+ , fCqRing(0)
+ , fSqRingSize(0)
+ , fCqRingSize(0)
+ , fSqes(0)
+ , fSqesSize(0)
+{
+}
+
+IORing::~IORing()
+{
+}
+
+bool IORing::registerBuffers(const struct iovec*, uint32_t)
+{
+  return false;
+}
+
+bool IORing::prepRead(int, void*, uint32_t, uint64_t, uint64_t, int)
+{
+  return false;
+}
+
+int IORing::enter(uint32_t, uint32_t, uint32_t)
+{
+  return -ENOSYS;
+}
+
+int IORing::submit()
+{
+  return 0;
+}
+
+bool IORing::reap(uint64_t&, int32_t&)
+{
+  return false;
+}
+
+bool IORing::wait(uint64_t&, int32_t&)
+{
+  return false;
+}
+
+}  // namespace dbbc
+
+#endif
@@ -0,0 +1,95 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+namespace dbbc
+{
+/** @brief An io_uring instance for the reads of one ioManager thread
+ *
+ * Only what the readers need: reads, into registered buffers if the buffers
+ * could be registered, and their completions.  The ring is set up with the
+ * system calls, liburing isn't needed.  valid() is false if the kernel doesn't
+ * have io_uring or doesn't let the process use it, or if it was built without
+ * HAVE_IO_URING, the readers use pread() then.
+ *
+ * Not thread safe, every reader thread has its own ring.
+ */
+class IORing
+{
+ public:
+  explicit IORing(uint32_t depth);
+  ~IORing();
+
+  bool valid() const
+  {
+    return fRingFd >= 0;
+  }
+
+  /** @brief Register buffers for fixed reads, false if the kernel refused,
+   *  e.g. over RLIMIT_MEMLOCK.  Reads then go to the buffers unregistered.
+   */
+  bool registerBuffers(const struct iovec* iovs, uint32_t count);
+
+  /** @brief Queue a read of len bytes at offset of fd into buf.  bufIndex is the
+   *  registered buffer holding buf, -1 if none.  False if the queue is full.
+   */
+  bool prepRead(int fd, void* buf, uint32_t len, uint64_t offset, uint64_t userData, int bufIndex = -1);
+
+  /** @brief Submit the queued reads.  Returns the number submitted, -errno on error */
+  int submit();
+
+  /** @brief Take a completion, false if none is ready.  res is the return of
+   *  the read, -errno on error.
+   */
+  bool reap(uint64_t& userData, int32_t& res);
+
+  /** @brief Take a completion, waiting for one.  False on error */
+  bool wait(uint64_t& userData, int32_t& res);
+
+ private:
+  IORing(const IORing&);
+  IORing& operator=(const IORing&);
+
+  int enter(uint32_t toSubmit, uint32_t minComplete, uint32_t flags);
+
+  int fRingFd;
+  bool fBuffersRegistered;
+  uint32_t fToSubmit;
+
+  void* fSqRing;
+  void* fCqRing;
+  size_t fSqRingSize;
+  size_t fCqRingSize;
+  struct io_uring_sqe* fSqes;
+  size_t fSqesSize;
+
+  uint32_t* fSqHead;
+  uint32_t* fSqTail;
+  uint32_t* fSqMask;
+  uint32_t* fSqEntries;
+  uint32_t* fSqArray;
+  uint32_t* fCqHead;
+  uint32_t* fCqTail;
+  uint32_t* fCqMask;
+  struct io_uring_cqe* fCqes;
+};
+
+}  // namespace dbbc
@@ -0,0 +1,104 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+// Column scan/filter kernels built with AVX-512 (F, BW, DQ, VL) enabled.
+// filterColumnData() calls them only if simd::getSimdLevel() allows it.
+
+#if defined(__x86_64__)
+
+// The headers column_filtering.h depends on must be included before the target pragma.
+// Otherwise their inline functions are compiled for AVX-512 (F, BW, DQ, VL) and the linker may pick
+// these copies for the rest of the binary.
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <type_traits>
+#include <immintrin.h>
+#include <boost/scoped_array.hpp>
+
+#include "primitiveprocessor.h"
+#include "messagelog.h"
+#include "messageobj.h"
+#include "we_type.h"
+#include "stats.h"
+#include "primproc.h"
+#include "dataconvert.h"
+#include "mcs_decimal.h"
+#include "simd_sse.h"
+#include "utils/common/columnwidth.h"
+#include "utils/common/bit_cast.h"
+#include "exceptclasses.h"
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,avx512f,avx512bw,avx512dq,avx512vl"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,avx512f,avx512bw,avx512dq,avx512vl")
+#endif
+
+#include "simd_avx.h"
+#include "column_filtering.h"
+
+namespace primitives
+{
+template <typename T, ENUM_KIND KIND>
+void vectorizedFilteringAVX512(NewColRequestHeader* in, ColResultHeader* out, const T* srcArray,
+                                const uint32_t srcSize, uint16_t* ridArray, const uint16_t ridSize,
+                                ParsedColumnFilter* parsedColumnFilter, const bool validMinMax,
+                                const T emptyValue, const T nullValue, T Min, T Max,
+                                const bool isNullValueMatches, const uint8_t* blockAux)
+{
+  using FT = typename IntegralTypeToFilterType<T>::type;
+  using ST = typename IntegralTypeToFilterSetType<T>::type;
+  vectorizedFilteringDispatcher<T, KIND, FT, ST, 512U>(
+      in, out, srcArray, srcSize, ridArray, ridSize, parsedColumnFilter, validMinMax, emptyValue, nullValue,
+      Min, Max, isNullValueMatches, blockAux);
+}
+
+#define VECTORIZED_FILTERING_INSTANTIATE(T, KIND)                                                             \
+  template void vectorizedFilteringAVX512<T, KIND>(                                                           \
+      NewColRequestHeader*, ColResultHeader*, const T*, const uint32_t, uint16_t*, const uint16_t,            \
+      ParsedColumnFilter*, const bool, const T, const T, T, T, const bool, const uint8_t*);
+
+VECTORIZED_FILTERING_INSTANTIATE(int8_t, KIND_DEFAULT)
+VECTORIZED_FILTERING_INSTANTIATE(int16_t, KIND_DEFAULT)
+VECTORIZED_FILTERING_INSTANTIATE(int32_t, KIND_DEFAULT)
+VECTORIZED_FILTERING_INSTANTIATE(int64_t, KIND_DEFAULT)
+VECTORIZED_FILTERING_INSTANTIATE(uint8_t, KIND_UNSIGNED)
+VECTORIZED_FILTERING_INSTANTIATE(uint16_t, KIND_UNSIGNED)
+VECTORIZED_FILTERING_INSTANTIATE(uint32_t, KIND_UNSIGNED)
+VECTORIZED_FILTERING_INSTANTIATE(uint64_t, KIND_UNSIGNED)
+VECTORIZED_FILTERING_INSTANTIATE(uint8_t, KIND_TEXT)
+VECTORIZED_FILTERING_INSTANTIATE(uint16_t, KIND_TEXT)
+VECTORIZED_FILTERING_INSTANTIATE(uint32_t, KIND_TEXT)
+VECTORIZED_FILTERING_INSTANTIATE(uint64_t, KIND_TEXT)
+VECTORIZED_FILTERING_INSTANTIATE(int32_t, KIND_FLOAT)
+VECTORIZED_FILTERING_INSTANTIATE(int64_t, KIND_FLOAT)
+
+#undef VECTORIZED_FILTERING_INSTANTIATE
+
+}  // namespace primitives
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif  // if defined(__x86_64__)
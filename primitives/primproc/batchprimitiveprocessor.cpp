@@ -58,6 +58,7 @@ using namespace boost;
 #include "threadnaming.h"
 #include "vlarray.h"
 #include "widedecimalutils.h"
+#include "hasher.h"
 
 #define MAX64 0x7fffffffffffffffLL
 #define MIN64 0x8000000000000000LL
@@ -135,6 +136,9 @@ BatchPrimitiveProcessor::BatchPrimitiveProcessor()
  , mJOINHasSkewedKeyColumn(false)
  , mSmallSideRGPtr(nullptr)
  , mSmallSideKeyColumnsPtr(nullptr)
+ , aggRowCount(0)
+ , aggSampled(false)
+ , aggFlushEveryRG(false)
  , hasDictStep(false)
  , sockIndex(0)
  , endOfJoinerRan(false)
@@ -190,6 +194,9 @@ BatchPrimitiveProcessor::BatchPrimitiveProcessor(ByteStream& b, double prefetch,
  , mJOINHasSkewedKeyColumn(false)
  , mSmallSideRGPtr(nullptr)
  , mSmallSideKeyColumnsPtr(nullptr)
+ , aggRowCount(0)
+ , aggSampled(false)
+ , aggFlushEveryRG(false)
  , hasDictStep(false)
  , sockIndex(0)
  , endOfJoinerRan(false)
@@ -267,6 +274,7 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
   hasRowGroup = tmp16 & HAS_ROWGROUP;
   getTupleJoinRowGroupData = tmp16 & JOIN_ROWGROUP_DATA;
   bool hasWideColumnsIn = tmp16 & HAS_WIDE_COLUMNS;
+  bool hasRuntimeFilters = tmp16 & HAS_RUNTIME_FILTERS;
 
   // This used to signify that there was input row data from previous jobsteps, and
   // it never quite worked right. No need to fix it or update it; all BPP's have started
@@ -530,6 +538,38 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
     }
   }
 
+  runtimeFilterProjectSteps.clear();
+
+  if (hasRuntimeFilters)
+  {
+    uint32_t filterNum, stepIndex;
+
+    bs >> filterNum;
+
+    for (i = 0; i < filterNum; i++)
+    {
+      std::shared_ptr<joiner::RuntimeFilter> filter(new joiner::RuntimeFilter());
+      ColumnCommand* col;
+
+      bs >> tmp8;
+      bs >> stepIndex;
+      filter->deserialize(bs);
+
+      if (tmp8)
+        col = dynamic_cast<ColumnCommand*>(filterSteps.at(stepIndex).get());
+      else
+        col = dynamic_cast<ColumnCommand*>(projectSteps.at(stepIndex).get());
+
+      if (col == NULL)
+        throw logic_error("BatchPrimitiveProcessor: a runtime filter is not on a column step");
+
+      col->setRuntimeFilter(filter);
+
+      if (!tmp8)
+        runtimeFilterProjectSteps.push_back(stepIndex);
+    }
+  }
+
   initProcessor();
 }
 
@@ -1096,6 +1136,10 @@ void BatchPrimitiveProcessor::initProcessor()
         filterSteps[i]->prep(OT_BOTH, true);
       else if (filterSteps[i]->filterFeeder() != Command::NOT_FEEDER)
         filterSteps[i]->prep(OT_BOTH, false);
+      // a runtime filter needs the values of the rids that pass
+      else if (filterSteps[i]->getCommandType() == Command::COLUMN_COMMAND &&
+               ((ColumnCommand*)filterSteps[i].get())->hasRuntimeFilter())
+        filterSteps[i]->prep(OT_BOTH, false);
       else
         filterSteps[i]->prep(OT_RID, false);
     }
@@ -1143,7 +1187,12 @@ void BatchPrimitiveProcessor::initProcessor()
       fAggregator->setJoinRowGroups(&smallSideRGs, &largeSideRG);
     }
     else
+    {
       fAggregator->setInputOutput(fe2 ? fe2Output : outputRG, &fAggregateRG);
+
+      if (!fe2)
+        initTokenGroupBy();
+    }
   }
 
   if (LIKELY(!hasWideColumnOut))
@@ -1561,6 +1610,9 @@ void BatchPrimitiveProcessor::execute()
       }
     }
 
+    if (!runtimeFilterProjectSteps.empty())
+      applyRuntimeFilters();
+
 #ifdef PRIMPROC_STOPWATCH
     stopwatch->stop("BatchPrimitiveProcessor::execute second part");
     stopwatch->start("BatchPrimitiveProcessor::execute third part");
@@ -1681,29 +1733,14 @@ void BatchPrimitiveProcessor::execute()
         }
         if (fe2)
         {
-          /* functionize this -> processFE2() */
           fe2Output.resetRowGroup(baseRid);
-          fe2Output.getRow(0, &fe2Out);
-          fe2Input->getRow(0, &fe2In);
-
-          // cerr << "input row: " << fe2In.toString() << endl;
-          for (j = 0; j < outputRG.getRowCount(); j++, fe2In.nextRow())
-          {
-            if (fe2->evaluate(&fe2In))
-            {
-              applyMapping(fe2Mapping, fe2In, &fe2Out);
-              // cerr << "   passed. output row: " << fe2Out.toString() << endl;
-              fe2Out.setRid(fe2In.getRelRid());
-              fe2Output.incRowCount();
-              fe2Out.nextRow();
-            }
-          }
+          processFE2(outputRG.getRowCount());
 
           if (!fAggregator)
           {
             *serialized << (uint8_t)1;  // the "count this msg" var
             fe2Output.setDBRoot(dbRoot);
-            fe2Output.serializeRGData(*serialized);
+            serializeRGDataByRef(fe2Output, *fe2Data);
             //*serialized << fe2Output.getDataSize();
             // serialized->append(fe2Output.getData(), fe2Output.getDataSize());
           }
@@ -1721,21 +1758,7 @@ void BatchPrimitiveProcessor::execute()
           else
             outputRG.setDBRoot(dbRoot);
 
-          fAggregator->addRowGroup(&toAggregate);
-
-          if ((currentBlockOffset + 1) == count)  // @bug4507, 8k
-          {
-            fAggregator->loadResult(*serialized);            // @bug4507, 8k
-          }                                                  // @bug4507, 8k
-          else if (utils::MonitorProcMem::isMemAvailable())  // @bug4507, 8k
-          {
-            fAggregator->loadEmptySet(*serialized);  // @bug4507, 8k
-          }                                          // @bug4507, 8k
-          else                                       // @bug4507, 8k
-          {
-            fAggregator->loadResult(*serialized);  // @bug4507, 8k
-            fAggregator->aggReset();               // @bug4507, 8k
-          }                                        // @bug4507, 8k
+          aggregateRowGroup(toAggregate, (currentBlockOffset + 1) == count);
         }
 
         if (!fAggregator && !fe2)
@@ -1743,7 +1766,7 @@ void BatchPrimitiveProcessor::execute()
           *serialized << (uint8_t)1;  // the "count this msg" var
           outputRG.setDBRoot(dbRoot);
           // cerr << "serializing " << outputRG.toString() << endl;
-          outputRG.serializeRGData(*serialized);
+          serializeRGDataByRef(outputRG, *outRowGroupData);
 
           //*serialized << outputRG.getDataSize();
           // serialized->append(outputRG.getData(), outputRG.getDataSize());
@@ -1832,45 +1855,17 @@ void BatchPrimitiveProcessor::execute()
               *serialized << sendCount;
               if (fe2)
               {
-                /* functionize this -> processFE2()*/
                 fe2Output.resetRowGroup(baseRid);
                 fe2Output.setDBRoot(dbRoot);
-                fe2Output.getRow(0, &fe2Out);
-                fe2Input->getRow(0, &fe2In);
-
-                for (j = 0; j < joinedRG.getRowCount(); j++, fe2In.nextRow())
-                {
-                  if (fe2->evaluate(&fe2In))
-                  {
-                    applyMapping(fe2Mapping, fe2In, &fe2Out);
-                    fe2Out.setRid(fe2In.getRelRid());
-                    fe2Output.incRowCount();
-                    fe2Out.nextRow();
-                  }
-                }
+                processFE2(joinedRG.getRowCount());
               }
 
               RowGroup& nextRG = (fe2 ? fe2Output : joinedRG);
               nextRG.setDBRoot(dbRoot);
 
               if (fAggregator)
-              {
-                fAggregator->addRowGroup(&nextRG);
-
-                if ((currentBlockOffset + 1) == count && moreRGs == false && startRid == 0)  // @bug4507, 8k
-                {
-                  fAggregator->loadResult(*serialized);            // @bug4507, 8k
-                }                                                  // @bug4507, 8k
-                else if (utils::MonitorProcMem::isMemAvailable())  // @bug4507, 8k
-                {
-                  fAggregator->loadEmptySet(*serialized);  // @bug4507, 8k
-                }                                          // @bug4507, 8k
-                else                                       // @bug4507, 8k
-                {
-                  fAggregator->loadResult(*serialized);  // @bug4507, 8k
-                  fAggregator->aggReset();               // @bug4507, 8k
-                }                                        // @bug4507, 8k
-              }
+                aggregateRowGroup(nextRG, (currentBlockOffset + 1) == count && moreRGs == false &&
+                                              startRid == 0);  // @bug4507, 8k
               else
               {
                 // cerr <<" * serialzing " << nextRG.toString() << endl;
@@ -2053,6 +2048,145 @@ void BatchPrimitiveProcessor::execute()
   }
 }
 
+void BatchPrimitiveProcessor::initTokenGroupBy()
+{
+  const uint32_t keyCount = fAggregator->getGroupByCols().size();
+  bool hasTokenKey = false;
+  uint32_t i, j;
+
+  tokenKeySteps.clear();
+
+  // the aggregation hashes the first keyCount columns of its input
+  for (i = 0; i < keyCount; i++)
+  {
+    RTSCommand* rts = NULL;
+
+    for (j = 0; j < projectCount; j++)
+      if (projectionMap[j] == (int)i)
+      {
+        rts = dynamic_cast<RTSCommand*>(projectSteps[j].get());
+        break;
+      }
+
+    switch (outputRG.getColType(i))
+    {
+      case execplan::CalpontSystemCatalog::CHAR:
+      case execplan::CalpontSystemCatalog::VARCHAR:
+      case execplan::CalpontSystemCatalog::BLOB:
+      case execplan::CalpontSystemCatalog::TEXT:
+        // a string that isn't a dictionary column needs the collation aware hash
+        if (!rts)
+          return;
+
+        hasTokenKey = true;
+        break;
+
+      default: rts = NULL; break;
+    }
+
+    tokenKeySteps.push_back(rts);
+  }
+
+  if (!hasTokenKey)
+  {
+    tokenKeySteps.clear();
+    return;
+  }
+
+  for (i = 0; i < keyCount; i++)
+    if (tokenKeySteps[i])
+      tokenKeySteps[i]->setKeepTokens(true);
+}
+
+void BatchPrimitiveProcessor::addTokenKeyedRows(RowGroup& rg)
+{
+  utils::Hasher64_r columnHasher;
+  const uint32_t lastCol = tokenKeySteps.size() - 1;
+  const uint32_t rowCount = rg.getRowCount();
+  Row row;
+
+  rg.initRow(&row);
+  rg.getRow(0, &row);
+  tokenKeyRows.resize(rowCount);
+
+  // the rows of rg are in the order of the rids the tokens were projected for
+  for (uint32_t r = 0; r < rowCount; r++, row.nextRow())
+  {
+    uint64_t hash = 0;
+
+    for (uint32_t i = 0; i <= lastCol; i++)
+    {
+      if (tokenKeySteps[i])
+        hash = columnHasher(&tokenKeySteps[i]->getTokens()[r], sizeof(int64_t), hash);
+      else
+        hash = columnHasher(row.getData() + row.getOffset(i), row.getColumnWidth(i), hash);
+    }
+
+    tokenKeyRows[r] = make_pair(row.getPointer(), columnHasher.finalize(hash, lastCol << 2));
+  }
+
+  fAggregateRG.setDBRoot(rg.getDBRoot());
+  fAggregator->addRowGroup(&rg, tokenKeyRows);
+}
+
+void BatchPrimitiveProcessor::aggregateRowGroup(RowGroup& rg, bool lastOne)
+{
+  if (!tokenKeySteps.empty() && &rg == &outputRG)
+    addTokenKeyedRows(rg);
+  else
+    fAggregator->addRowGroup(&rg);
+
+  if (!aggSampled)
+  {
+    aggRowCount += rg.getRowCount();
+
+    if (aggRowCount >= aggSampleRows)
+    {
+      aggSampled = true;
+      aggFlushEveryRG = (fAggregator->getGroupCount() * 2 > aggRowCount);
+    }
+  }
+
+  if (lastOne)                                                           // @bug4507, 8k
+    fAggregator->loadResult(*serialized);                                // @bug4507, 8k
+  else if (!aggFlushEveryRG && utils::MonitorProcMem::isMemAvailable())  // @bug4507, 8k
+    fAggregator->loadEmptySet(*serialized);                              // @bug4507, 8k
+  else                                                                   // @bug4507, 8k
+  {
+    fAggregator->loadResult(*serialized);  // @bug4507, 8k
+    resetAggregation();                    // @bug4507, 8k
+  }
+}
+
+void BatchPrimitiveProcessor::resetAggregation()
+{
+  fAggregator->aggReset();
+  aggRowCount = 0;
+}
+
+void BatchPrimitiveProcessor::processFE2(uint32_t rowCount)
+{
+  uint32_t i;
+
+  fe2Selection.resize(rowCount);
+
+  for (i = 0; i < rowCount; i++)
+    fe2Selection[i] = i;
+
+  // the filters and the expressions are evaluated a column at a time
+  fe2->evaluate(*fe2Input, fe2Selection);
+  fe2Output.getRow(0, &fe2Out);
+
+  for (i = 0; i < fe2Selection.size(); i++)
+  {
+    fe2Input->getRow(fe2Selection[i], &fe2In);
+    applyMapping(fe2Mapping, fe2In, &fe2Out);
+    fe2Out.setRid(fe2In.getRelRid());
+    fe2Output.incRowCount();
+    fe2Out.nextRow();
+  }
+}
+
 void BatchPrimitiveProcessor::writeErrorMsg(const string& error, uint16_t errCode, bool logIt, bool critical)
 {
   ISMPacketHeader ism;
@@ -2081,6 +2215,15 @@ void BatchPrimitiveProcessor::writeErrorMsg(const string& error, uint16_t errCod
   }
 }
 
+/* The runtime join filters on the project steps read their column for the rids
+   the filter steps left and drop the rows no small side key can match, before
+   the rest of the columns are projected. */
+void BatchPrimitiveProcessor::applyRuntimeFilters()
+{
+  for (uint32_t i = 0; i < runtimeFilterProjectSteps.size() && ridCount > 0; i++)
+    ((ColumnCommand*)projectSteps[runtimeFilterProjectSteps[i]].get())->applyRuntimeFilter();
+}
+
 void BatchPrimitiveProcessor::writeProjectionPreamble()
 {
   ISMPacketHeader ism;
@@ -2190,6 +2333,17 @@ void BatchPrimitiveProcessor::sendResponse()
   serialized.reset();
 }
 
+/* The response references the row data & strings of rg instead of copying them,
+ * rg gets new ones for the next rows.  The sockets write the old ones as they are
+ * and the EM side keeps the buffers it reads them into.  The join paths reuse
+ * what's in the row data across responses and don't do this. */
+void BatchPrimitiveProcessor::serializeRGDataByRef(RowGroup& rg, RGData& data)
+{
+  rg.serializeRGData(*serialized, true);
+  data.reinit(rg);
+  rg.setData(&data);
+}
+
 /* The output of a filter chain is either ELEMENT_TYPE or STRING_ELEMENT_TYPE */
 void BatchPrimitiveProcessor::makeResponse()
 {
@@ -2288,7 +2442,7 @@ int BatchPrimitiveProcessor::operator()()
   }
 
   if (fAggregator && currentBlockOffset == 0)  // @bug4507, 8k
-    fAggregator->aggReset();                   // @bug4507, 8k
+    resetAggregation();                        // @bug4507, 8k
 
   for (; currentBlockOffset < count; currentBlockOffset++)
   {
@@ -2297,9 +2451,10 @@ int BatchPrimitiveProcessor::operator()()
       if (sendThread->aborted())
         break;
 
-      if (sendThread->sizeTooBig())
+      if (sendThread->sizeTooBig() || sendThread->outOfCredit())
       {
-        // The send buffer is full of messages yet to be sent, so this thread would block anyway.
+        // The send buffer is full of messages yet to be sent, or the UM hasn't
+        // returned the credit to send them, so this thread would block anyway.
         freeLargeBuffers();
         return -1;  // the reschedule error code
       }
@@ -2566,6 +2721,7 @@ SBPP BatchPrimitiveProcessor::duplicate()
   bpp->sock = sock;
   bpp->writelock = writelock;
   bpp->hasDictStep = hasDictStep;
+  bpp->runtimeFilterProjectSteps = runtimeFilterProjectSteps;
   bpp->sendThread = sendThread;
   bpp->newConnection = true;
   bpp->initProcessor();
@@ -62,6 +62,8 @@ typedef std::tr1::unordered_map<int64_t, BRM::VSSData> VSSCache;
 
 namespace primitiveprocessor
 {
+class RTSCommand;
+
 typedef boost::shared_ptr<BatchPrimitiveProcessor> SBPP;
 
 class scalar_exception : public std::exception
@@ -195,6 +197,7 @@ class BatchPrimitiveProcessor
   void writeProjectionPreamble();
   void makeResponse();
   void sendResponse();
+  void serializeRGDataByRef(rowgroup::RowGroup& rg, rowgroup::RGData& data);
   /* Used by scan operations to increment the LBIDs in successive steps */
   void nextLBID();
 
@@ -381,6 +384,27 @@ class BatchPrimitiveProcessor
   rowgroup::RGData fAggRowGroupData;
   // boost::scoped_array<uint8_t> fAggRowGroupData;
 
+  /* Adaptive PM aggregation.  When the first aggSampleRows rows don't reduce to at most
+     half as many groups, aggregating here buys nothing, the UM has to merge nearly every
+     row anyway.  From then on the table is flushed after every RowGroup, which keeps it
+     small and in the cache instead of growing with the number of distinct keys. */
+  void aggregateRowGroup(rowgroup::RowGroup& rg, bool lastOne);
+  void resetAggregation();
+  static const uint64_t aggSampleRows = 65536;
+  uint64_t aggRowCount;  // rows added since the last reset
+  bool aggSampled;
+  bool aggFlushEveryRG;
+
+  /* When the group by columns are dictionary columns and fixed width columns, the
+     rows are hashed by the dictionary tokens instead of the strings.  Rows that share
+     a token share the string, so they land in the same group.  Equal strings with
+     different tokens can end up in different groups, which is fine, the UM merges
+     the groups of all PMs by the strings. */
+  void initTokenGroupBy();
+  void addTokenKeyedRows(rowgroup::RowGroup& rg);
+  std::vector<RTSCommand*> tokenKeySteps;  // per group by column, NULL if it isn't a token column
+  std::vector<std::pair<rowgroup::Row::Pointer, uint64_t> > tokenKeyRows;
+
   /* OR hacks */
   uint8_t bop;  // BOP_AND or BOP_OR
   bool hasPassThru;
@@ -397,9 +421,17 @@ class BatchPrimitiveProcessor
   boost::shared_array<int> fe1ToProjection, fe2Mapping;  // RG mappings
   boost::scoped_array<boost::shared_array<int>> joinFEMappings;
   rowgroup::Row fe1In, fe1Out, fe2In, fe2Out, joinFERow;
+  funcexp::Selection fe2Selection;
+
+  // runs fe2 on the first rowCount rows of fe2Input, appends the rows that pass to fe2Output
+  void processFE2(uint32_t rowCount);
 
   bool hasDictStep;
 
+  /* Runtime join filters on project steps, applied between the filter and the project phase */
+  std::vector<uint32_t> runtimeFilterProjectSteps;
+  void applyRuntimeFilters();
+
   primitives::PrimitiveProcessor pp;
 
   /* VSS cache members */
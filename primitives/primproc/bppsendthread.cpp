@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <stdexcept>
 #include <mutex>
+#include <chrono>
 #include "bppsendthread.h"
 #include "resourcemanager.h"
 
@@ -37,8 +38,10 @@ BPPSendThread::BPPSendThread()
  , gotException(false)
  , mainThreadWaiting(false)
  , sizeThreshold(100)
- , msgsLeft(-1)
+ , credit(0)
  , waiting(false)
+ , creditWaitNanos(0)
+ , creditWaitCount(0)
  , sawAllConnections(false)
  , fcEnabled(false)
  , currentByteSize(0)
@@ -47,15 +50,17 @@ BPPSendThread::BPPSendThread()
   runner = boost::thread(Runner_t(this));
 }
 
-BPPSendThread::BPPSendThread(uint32_t initMsgsLeft)
+BPPSendThread::BPPSendThread(int64_t initCredit)
  : die(false)
  , gotException(false)
  , mainThreadWaiting(false)
  , sizeThreshold(100)
- , msgsLeft(initMsgsLeft)
+ , credit(initCredit)
  , waiting(false)
+ , creditWaitNanos(0)
+ , creditWaitCount(0)
  , sawAllConnections(false)
- , fcEnabled(false)
+ , fcEnabled(true)
  , currentByteSize(0)
 {
   maxByteSize = joblist::ResourceManager::instance()->getMaxBPPSendQueue();
@@ -162,20 +167,23 @@ void BPPSendThread::sendResults(const vector<Msg_t>& msgs, bool newConnection)
     queueNotEmpty.notify_one();
 }
 
-void BPPSendThread::sendMore(int num)
+void BPPSendThread::grantCredit(int64_t bytes)
 {
   std::unique_lock<std::mutex> sl(ackLock);
 
-  //	cout << "got an ACK for " << num << " msgsLeft=" << msgsLeft << endl;
-  if (num == -1)
-    fcEnabled = false;
-  else if (num == 0)
-  {
-    fcEnabled = true;
-    msgsLeft = 0;
-  }
-  else
-    (void)atomicops::atomicAdd(&msgsLeft, num);
+  //	cout << "got " << bytes << " bytes of credit, credit=" << credit << endl;
+  fcEnabled = true;
+  (void)atomicops::atomicAdd<int64_t>(&credit, bytes);
+
+  sl.unlock();
+  if (waiting)
+    okToSend.notify_one();
+}
+
+void BPPSendThread::disableFlowControl()
+{
+  std::unique_lock<std::mutex> sl(ackLock);
+  fcEnabled = false;
 
   sl.unlock();
   if (waiting)
@@ -222,25 +230,32 @@ void BPPSendThread::mainLoop()
     sl.unlock();
 
     /* In the send loop below, msgsSent tracks progress on sending the msg array,
-     * i how many msgs are sent by 1 run of the loop, limited by msgCount or msgsLeft. */
+     * i how many msgs are sent by 1 run of the loop, limited by msgCount or the credit. */
     msgsSent = 0;
 
     while (msgsSent < msgCount && !die)
     {
       uint64_t bsSize;
 
-      if (msgsLeft <= 0 && fcEnabled && !die)
+      if (credit <= 0 && fcEnabled && !die)
       {
         std::unique_lock<std::mutex> sl2(ackLock);
-        while (msgsLeft <= 0 && fcEnabled && !die)
+        auto start = std::chrono::steady_clock::now();
+
+        while (credit <= 0 && fcEnabled && !die)
         {
           waiting = true;
           okToSend.wait(sl2);
           waiting = false;
         }
+
+        creditWaitNanos +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                .count();
+        creditWaitCount++;
       }
 
-      for (i = 0; msgsSent < msgCount && ((fcEnabled && msgsLeft > 0) || !fcEnabled) && !die; msgsSent++, i++)
+      for (i = 0; msgsSent < msgCount && ((fcEnabled && credit > 0) || !fcEnabled) && !die; msgsSent++, i++)
       {
         if (doLoadBalancing)
         {
@@ -270,7 +285,9 @@ void BPPSendThread::mainLoop()
           return;
         }
 
-        (void)atomicops::atomicDec(&msgsLeft);
+        if (fcEnabled)
+          (void)atomicops::atomicSub<int64_t>(&credit, bsSize);
+
         (void)atomicops::atomicSub(&currentByteSize, bsSize);
         msg[msgsSent].msg.reset();
       }
@@ -37,8 +37,8 @@ namespace primitiveprocessor
 class BPPSendThread
 {
  public:
-  BPPSendThread();                       // starts unthrottled
-  BPPSendThread(uint32_t initMsgsLeft);  // starts throttled
+  BPPSendThread();                    // starts unthrottled
+  BPPSendThread(int64_t initCredit);  // starts throttled
   virtual ~BPPSendThread();
 
   struct Msg_t
@@ -75,7 +75,26 @@ class BPPSendThread
            !die;
   }
 
-  void sendMore(int num);
+  // The queued responses use up the credit, more work would only queue more
+  bool outOfCredit()
+  {
+    return fcEnabled && credit <= (int64_t)currentByteSize && !die;
+  }
+
+  /* Credit flow control: the UM grants credit, the bytes this may send.  A
+     response goes while there is credit left, it may overdraw it by its size. */
+  void grantCredit(int64_t bytes);
+  void disableFlowControl();
+  // The time mainLoop() waited for credit, in ns, and how many times
+  uint64_t creditWaitTime() const
+  {
+    return creditWaitNanos;
+  }
+  uint32_t creditWaits() const
+  {
+    return creditWaitCount;
+  }
+
   void sendResults(const std::vector<Msg_t>& msgs, bool newConnection);
   void sendResult(const Msg_t& msg, bool newConnection);
   void mainLoop();
@@ -114,8 +133,10 @@ class BPPSendThread
   volatile bool die, gotException, mainThreadWaiting;
   std::string exceptionString;
   uint32_t sizeThreshold;
-  volatile int32_t msgsLeft;
+  volatile int64_t credit;  // bytes
   bool waiting;
+  uint64_t creditWaitNanos;
+  uint32_t creditWaitCount;
   std::mutex ackLock;
   std::condition_variable okToSend;
   // Condition to prevent run away queue
@@ -54,7 +54,8 @@ namespace primitiveprocessor
 {
 extern int noVB;
 
-ColumnCommand::ColumnCommand() : Command(COLUMN_COMMAND), blockCount(0), loadCount(0), suppressFilter(false)
+ColumnCommand::ColumnCommand()
+ : Command(COLUMN_COMMAND), blockCount(0), loadCount(0), suppressFilter(false), runtimeFilterMask(~0ULL)
 {
 }
 
@@ -509,6 +510,9 @@ void ColumnCommand::processResult()
       throw logic_error("ColumnCommand got a bad OutputType");
   }
 
+  if (runtimeFilter && outMsg->OutputType == OT_BOTH)
+    runtimeFilterResult();
+
   // check if feeding a filtercommand
   if (fFilterFeeder == LEFT_FEEDER)
   {
@@ -690,6 +694,107 @@ void ColumnCommand::projectResult()
   bpp->serialized->append(primitives::getFirstValueArrayPosition(outMsg), valuesByteSize);
 }
 
+void ColumnCommand::setRuntimeFilter(const std::shared_ptr<joiner::RuntimeFilter>& filter)
+{
+  runtimeFilter = filter;
+
+  if (datatypes::isUnsigned(colType.colDataType) && colType.colWidth < 8)
+    runtimeFilterMask = (1ULL << (colType.colWidth * 8)) - 1;
+  else
+    runtimeFilterMask = ~0ULL;
+}
+
+/* Filter step version, the rids and values of the filter result are in relRids & values */
+void ColumnCommand::runtimeFilterResult()
+{
+  uint32_t i, newRidCount = 0;
+
+  bpp->ridMap = 0;
+
+  for (i = 0; i < bpp->ridCount; i++)
+  {
+    if (!runtimeFilter->mayContain((int64_t)(values[i] & runtimeFilterMask)))
+      continue;
+
+    bpp->relRids[newRidCount] = bpp->relRids[i];
+    values[newRidCount] = values[i];
+
+    if (makeAbsRids)
+      bpp->absRids[newRidCount] = bpp->absRids[i];
+
+    bpp->ridMap |= 1 << (bpp->relRids[newRidCount] >> 9);
+    newRidCount++;
+  }
+
+  bpp->ridCount = newRidCount;
+}
+
+/* Project step version, runs after the filter steps.  It reads the column for the
+   current ridlist and removes the rids that don't pass from the BPP's ridlist and
+   the arrays that parallel it. */
+template <int W>
+void ColumnCommand::_applyRuntimeFilter()
+{
+  using T = typename datatypes::WidthToSIntegralType<W>::type;
+  T* valuesArray = primitives::getValuesArrayPosition<T>(primitives::getFirstValueArrayPosition(outMsg), 0);
+  primitives::RIDType* ridArray = NULL;
+  uint32_t i, j, newRidCount = 0;
+
+  // with noVB the projection can return fewer rids than it was given
+  if (outMsg->OutputType & OT_RID)
+    ridArray = primitives::getRIDArrayPosition(reinterpret_cast<uint8_t*>(&outMsg[1]), 0);
+
+  bpp->ridMap = 0;
+
+  for (i = 0, j = 0; i < outMsg->NVALS; i++, j++)
+  {
+    if (ridArray)
+      while (bpp->relRids[j] != ridArray[i])
+        j++;
+
+    if (!runtimeFilter->mayContain((int64_t)((int64_t)valuesArray[i] & runtimeFilterMask)))
+      continue;
+
+    bpp->relRids[newRidCount] = bpp->relRids[j];
+    bpp->values[newRidCount] = bpp->values[j];
+
+    if (bpp->wideColumnsWidths)
+      bpp->wide128Values[newRidCount] = bpp->wide128Values[j];
+
+    if (bpp->absRids)
+      bpp->absRids[newRidCount] = bpp->absRids[j];
+
+    if (bpp->needStrValues)
+      bpp->strValues[newRidCount].swap(bpp->strValues[j]);
+
+    bpp->ridMap |= 1 << (bpp->relRids[newRidCount] >> 9);
+    newRidCount++;
+  }
+
+  bpp->ridCount = newRidCount;
+}
+
+void ColumnCommand::applyRuntimeFilter()
+{
+  if (bpp->ridCount == 0)
+    return;
+
+  makeStepMsg();
+  issuePrimitive();
+
+  switch (colType.colWidth)
+  {
+    case 1: _applyRuntimeFilter<1>(); break;
+    case 2: _applyRuntimeFilter<2>(); break;
+    case 4: _applyRuntimeFilter<4>(); break;
+    case 8: _applyRuntimeFilter<8>(); break;
+
+    default:
+      throw NotImplementedExcept(std::string("ColumnCommand::applyRuntimeFilter does not support ") +
+                                 std::to_string(colType.colWidth) + std::string(" byte width."));
+  }
+}
+
 void ColumnCommand::removeRowsFromRowGroup(RowGroup& rg)
 {
   uint32_t gapSize = colType.colWidth + 2;
@@ -868,6 +973,8 @@ void ColumnCommand::duplicate(ColumnCommand* cc)
   cc->lastLbid = lastLbid;
   cc->r = r;
   cc->rowSize = rowSize;
+  cc->runtimeFilter = runtimeFilter;
+  cc->runtimeFilterMask = runtimeFilterMask;
   cc->Command::operator=(*this);
 }
 
@@ -929,6 +1036,8 @@ ColumnCommand& ColumnCommand::operator=(const ColumnCommand& c)
   parsedColumnFilter = c.parsedColumnFilter;
   suppressFilter = c.suppressFilter;
   lastLbid = c.lastLbid;
+  runtimeFilter = c.runtimeFilter;
+  runtimeFilterMask = c.runtimeFilterMask;
   return *this;
 }
 
@@ -32,6 +32,7 @@
 
 #include "command.h"
 #include "calpontsystemcatalog.h"
+#include "runtimefilter.h"
 
 namespace primitiveprocessor
 {
@@ -114,6 +115,15 @@ class ColumnCommand : public Command
     return colType.compressionType;
   }
 
+  /* Runtime join filters.  A filter step drops the rids that don't pass right after
+     its own filter, a project step does it when BPP calls applyRuntimeFilter() */
+  void setRuntimeFilter(const std::shared_ptr<joiner::RuntimeFilter>& filter);
+  bool hasRuntimeFilter() const
+  {
+    return (bool)runtimeFilter;
+  }
+  void applyRuntimeFilter();
+
  protected:
   virtual void loadData();
   template <int W>
@@ -156,6 +166,9 @@ class ColumnCommand : public Command
   void _projectResultRG(rowgroup::RowGroup& rg, uint32_t pos);
   virtual void projectResultRG(rowgroup::RowGroup& rg, uint32_t pos);
   void removeRowsFromRowGroup(rowgroup::RowGroup&);
+  void runtimeFilterResult();
+  template <int W>
+  void _applyRuntimeFilter();
   void makeScanMsg();
   void makeStepMsg();
   void setLBID(uint64_t rid);
@@ -202,6 +215,10 @@ class ColumnCommand : public Command
 
   bool wasVersioned;
 
+  std::shared_ptr<joiner::RuntimeFilter> runtimeFilter;
+  // the column values are sign extended, this turns the unsigned ones into the filter keys
+  uint64_t runtimeFilterMask;
+
   friend class RTSCommand;
 };
 
@@ -355,6 +355,15 @@ void DictStep::_execute()
     primMsg->LBID = (l_lbid == -1) ? l_lbid : l_lbid & 0xFFFFFFFFFL;
     primMsg->NVALS = 0;
 
+#if !defined(XXX_PRIMITIVES_TOKEN_RANGES_XXX)
+    // Only the RIDs are returned, the result of a token can be reused
+    if (fFilterFeeder == NOT_FEEDER && l_lbid >= 0)
+    {
+      filterCachedTokens(newRidList.get(), i, l_lbid);
+      continue;
+    }
+#endif
+
     /* When this is used as a filter, the strings can be thrown out.  JLF currently
      * constructs joblists s.t. only a FilterCommand will use the strings.
      */
@@ -406,6 +415,75 @@ void DictStep::_execute()
   // cout << "DS: /_execute()\n";
 }
 
+void DictStep::filterCachedTokens(OrderedToken* tokens, uint64_t& i, int64_t lbid)
+{
+  const uint64_t first = i;
+  OldGetSigParams* pt = (OldGetSigParams*)(primMsg->tokens);
+  std::tr1::unordered_map<int64_t, TokenResults>::iterator it = fTokenResults.find(lbid);
+
+  if (it == fTokenResults.end())
+  {
+    if (fTokenResults.size() >= MAX_CACHED_BLOCKS)
+      fTokenResults.clear();
+
+    it = fTokenResults.insert(make_pair(lbid, TokenResults())).first;
+  }
+
+  TokenResults& cached = it->second;
+
+  primMsg->OutputType = OT_RID;
+
+  // Send the tokens not seen yet, once each
+  for (; i < bpp->ridCount && (((int64_t)tokens[i].token) >> 10) == lbid; i++)
+  {
+    uint32_t offsetIndex = tokens[i].token & 0x3ff;
+
+    tokens[i].inResult = !cached.known[offsetIndex];
+
+    if (tokens[i].inResult)
+    {
+      idbassert(offsetIndex != 0);
+      cached.known[offsetIndex] = true;
+      pt[primMsg->NVALS].rid = tokens[i].rid;
+      pt[primMsg->NVALS].offsetIndex = offsetIndex;
+      primMsg->NVALS++;
+    }
+  }
+
+  const uint64_t* matched = NULL;
+  uint32_t matchCount = 0, m = 0;
+
+  if (primMsg->NVALS > 0)
+  {
+    memcpy(&pt[primMsg->NVALS], filterString.buf(), filterString.length());
+    issuePrimitive(true);
+    matchCount = ((DictOutput*)&result[0])->NVALS;
+    matched = (const uint64_t*)&result[sizeof(DictOutput)];
+  }
+
+  // The matching RIDs come back in input order, merge them with the cached results
+  for (uint64_t j = first; j < i; j++)
+  {
+    uint32_t offsetIndex = tokens[j].token & 0x3ff;
+
+    if (tokens[j].inResult)
+    {
+      bool isMatch = (m < matchCount && matched[m] == tokens[j].rid);
+
+      m += isMatch;
+      cached.match[offsetIndex] = isMatch;
+      tokens[j].inResult = false;
+    }
+
+    if (cached.match[offsetIndex])
+    {
+      bpp->absRids[tmpResultCounter] = tokens[j].rid;
+      bpp->relRids[tmpResultCounter] = tokens[j].rid - bpp->baseRid;
+      tmpResultCounter++;
+    }
+  }
+}
+
 /* This will do the same thing as execute() but put the result in bpp->serialized */
 void DictStep::_project()
 {
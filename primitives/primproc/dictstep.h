@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <bitset>
+#include <tr1/unordered_map>
+
 #include "command.h"
 #include "primitivemsg.h"
 
@@ -135,6 +138,9 @@ class DictStep : public Command
   void copyResultToTmpSpace(OrderedToken* ot);
   void copyResultToFinalPosition(OrderedToken* ot);
 
+  // filters the run of tokens in block lbid that starts at i, advances i past it
+  void filterCachedTokens(OrderedToken* tokens, uint64_t& i, int64_t lbid);
+
   // Worst case, 8192 tokens in the msg.  Each is 10 bytes. */
   boost::scoped_array<uint8_t> inputMsg;
   uint32_t tmpResultCounter;
@@ -160,6 +166,18 @@ class DictStep : public Command
   uint8_t eqOp;  // COMPARE_EQ or COMPARE_NE
   uint64_t fMinMax[2];
 
+  /* The filter results of the tokens seen so far, by dictionary block.  A
+   * string is compared once per token instead of once per row.  The offset
+   * index of a token is 10 bits, so a block has at most 1024 of them.
+   */
+  struct TokenResults
+  {
+    std::bitset<1024> known;
+    std::bitset<1024> match;
+  };
+  static const uint32_t MAX_CACHED_BLOCKS = 4096;
+  std::tr1::unordered_map<int64_t, TokenResults> fTokenResults;
+
   friend class RTSCommand;
 };
 
@@ -1347,19 +1347,19 @@ struct BPPHandler
   int doAck(ByteStream& bs)
   {
     uint32_t key;
-    int16_t msgCount;
+    uint64_t credit;
     SBPPV bpps;
     const ISMPacketHeader* ism = (const ISMPacketHeader*)bs.buf();
 
     key = ism->Interleave;
-    msgCount = (int16_t)ism->Size;
     bs.advance(sizeof(ISMPacketHeader));
+    bs >> credit;
 
     bpps = grabBPPs(key);
 
     if (bpps)
     {
-      bpps->getSendThread()->sendMore(msgCount);
+      bpps->getSendThread()->grantCredit(credit);
       return 0;
     }
     else
@@ -1369,7 +1369,8 @@ struct BPPHandler
   void createBPP(ByteStream& bs)
   {
     uint32_t i;
-    uint32_t key, initMsgsLeft;
+    uint32_t key;
+    uint64_t initCredit;
     SBPP bpp;
     SBPPV bppv;
 
@@ -1378,15 +1379,20 @@ struct BPPHandler
     bpp.reset(new BatchPrimitiveProcessor(bs, fPrimitiveServerPtr->prefetchThreshold(), bppv->getSendThread(),
                                           fPrimitiveServerPtr->ProcessorThreads()));
 
+    // the bytes the UM lets this send before it returns credit, -1 for no flow control
     if (bs.length() > 0)
-      bs >> initMsgsLeft;
+      bs >> initCredit;
     else
     {
-      initMsgsLeft = -1;
+      initCredit = -1;
     }
 
     idbassert(bs.length() == 0);
-    bppv->getSendThread()->sendMore(initMsgsLeft);
+
+    if (initCredit == (uint64_t)-1)
+      bppv->getSendThread()->disableFlowControl();
+    else
+      bppv->getSendThread()->grantCredit(initCredit);
     bppv->add(bpp);
 
     // this block of code creates some BPP instances up front for user queries,
@@ -1602,6 +1608,18 @@ struct BPPHandler
       {
         bppv->abort();
         bppMap.erase(it);
+
+        // a step that sat waiting for the UM to take its results shows up in the log
+        const uint64_t creditWaitLogMSecs = 1000;
+        uint64_t waitMSecs = bppv->getSendThread()->creditWaitTime() / 1000000;
+
+        if (waitMSecs >= creditWaitLogMSecs)
+        {
+          logging::Message::Args args;
+          args.add(string("PrimProc step ") + to_string(uniqueID) + " waited " + to_string(waitMSecs) +
+                   "ms for credit " + to_string(bppv->getSendThread()->creditWaits()) + " times");
+          mlp->logMessage(logging::M0000, args, false);
+        }
       }
       else
       {
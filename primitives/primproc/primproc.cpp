@@ -60,6 +60,7 @@ using namespace logging;
 using namespace primitiveprocessor;
 
 #include "archcheck.h"
+#include "simd_dispatch.h"
 using namespace archcheck;
 
 #include "liboamcpp.h"
@@ -640,6 +641,11 @@ int ServicePrimProc::Child()
   if ((strVal == "n") || (strVal == "N"))
     directIOFlag = 0;
 
+  // Column scans use the widest vector extension the CPU supports. SimdLevel can
+  // cap it, e.g. to compare the kernels or to avoid AVX-512 frequency drops.
+  simd::SimdLevel simdLevel = simd::setSimdLevel(
+      simd::simdLevelFromString(cf->getConfig(primitiveServers, "SimdLevel")));
+
 
   IDBPolicy::configIDBPolicy();
 
@@ -651,7 +657,8 @@ int ServicePrimProc::Child()
        << ", pw = " << processorWeight << ", pq = " << processorQueueSize << ", nb = " << BRPBlocks
        << ", nt = " << BRPThreads << ", nc = " << cacheCount << ", ra = " << blocksReadAhead
        << ", db = " << deleteBlocks << ", mb = " << maxBlocksPerRead << ", rd = " << rotatingDestination
-       << ", tr = " << PTTrace << ", ss = " << PMSmallSide << ", bp = " << BPPCount << endl;
+       << ", tr = " << PTTrace << ", ss = " << PMSmallSide << ", bp = " << BPPCount
+       << ", simd = " << simd::simdLevelName(simdLevel) << endl;
 
   PrimitiveServer server(serverThreads, serverQueueSize, processorWeight, processorQueueSize,
                          rotatingDestination, BRPBlocks, BRPThreads, cacheCount, maxBlocksPerRead,
@@ -29,6 +29,7 @@
 //
 
 #include <unistd.h>
+#include <cstring>
 
 #include "bpp.h"
 #include "exceptclasses.h"
@@ -117,6 +118,9 @@ void RTSCommand::projectIntoRowGroup(RowGroup& rg, uint32_t colNum)
         bpp->absRids[i] = bpp->relRids[i] + bpp->baseRid;
     }
 
+    if (tokens)
+      memcpy(tokens.get(), bpp->values, bpp->ridCount * sizeof(int64_t));
+
     dict.projectIntoRowGroup(rg, colNum);
   }
   else
@@ -144,10 +148,21 @@ void RTSCommand::projectIntoRowGroup(RowGroup& rg, uint32_t colNum)
         throw PrimitiveColumnProjectResultExcept(os.str());
     }
 
+    if (tokens)
+      memcpy(tokens.get(), tmpValues, bpp->ridCount * sizeof(int64_t));
+
     dict.projectIntoRowGroup(rg, tmpValues, colNum);
   }
 }
 
+void RTSCommand::setKeepTokens(bool k)
+{
+  if (k)
+    tokens.reset(new int64_t[LOGICAL_BLOCK_RIDS]);
+  else
+    tokens.reset();
+}
+
 uint64_t RTSCommand::getLBID()
 {
   if (!passThru)
@@ -32,6 +32,7 @@
 
 #include "command.h"
 #include <boost/scoped_ptr.hpp>
+#include <boost/scoped_array.hpp>
 #include <memory>
 
 namespace primitiveprocessor
@@ -67,6 +68,13 @@ class RTSCommand : public Command
   }
   void getLBIDList(uint32_t loopCount, std::vector<int64_t>* lbids);
 
+  /* Keep the tokens of the last projection, the PM aggregation hashes them instead of the strings */
+  void setKeepTokens(bool k);
+  const int64_t* getTokens() const
+  {
+    return tokens.get();
+  }
+
   // TODO: do we need to reference either col or dict?
   int getCompType() const
   {
@@ -80,6 +88,7 @@ class RTSCommand : public Command
   DictStep dict;
   uint8_t passThru;
   bool absNull;
+  boost::scoped_array<int64_t> tokens;
 };
 
 }  // namespace primitiveprocessor
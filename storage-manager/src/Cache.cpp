@@ -129,9 +129,9 @@ void Cache::validateCacheSize()
 }
 
 // new simplified version
-void Cache::read(const bf::path& prefix, const vector<string>& keys)
+void Cache::read(const bf::path& prefix, const vector<string>& keys, vector<string>* notCached)
 {
-  getPCache(prefix).read(keys);
+  getPCache(prefix).read(keys, notCached);
 }
 
 void Cache::doneReading(const bf::path& prefix, const vector<string>& keys)
@@ -51,7 +51,10 @@ class Cache : public boost::noncopyable, public ConfigListener
   // reading fcns
   // read() marks objects to be read s.t. they do not get flushed.
   // after reading them, unlock the 'logical file', and call doneReading().
-  void read(const boost::filesystem::path& prefix, const std::vector<std::string>& keys);
+  // If notCached isn't NULL, the objects that aren't in the cache aren't downloaded or marked,
+  // they are added to notCached instead.
+  void read(const boost::filesystem::path& prefix, const std::vector<std::string>& keys,
+            std::vector<std::string>* notCached = NULL);
   void doneReading(const boost::filesystem::path& prefix, const std::vector<std::string>& keys);
   bool exists(const boost::filesystem::path& prefix, const std::string& key);
   void exists(const boost::filesystem::path& prefix, const std::vector<std::string>& keys,
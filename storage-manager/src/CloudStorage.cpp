@@ -23,6 +23,7 @@
 #include <boost/thread/mutex.hpp>
 #include <string>
 #include <ctype.h>
+#include <string.h>
 #include <iostream>
 
 using namespace std;
@@ -84,7 +85,7 @@ CloudStorage::CloudStorage()
   logger = SMLogging::get();
 
   bytesUploaded = bytesDownloaded = objectsDeleted = objectsCopied = objectsGotten = objectsPut =
-      existenceChecks = 0;
+      existenceChecks = rangesGotten = 0;
 }
 
 void CloudStorage::printKPIs() const
@@ -97,6 +98,29 @@ void CloudStorage::printKPIs() const
   cout << "\tobjectsGotten = " << objectsGotten << endl;
   cout << "\tobjectsPut = " << objectsPut << endl;
   cout << "\texistenceChecks = " << existenceChecks << endl;
+  cout << "\trangesGotten = " << rangesGotten << endl;
+}
+
+int CloudStorage::getObject(const string& sourceKey, uint8_t* data, off_t offset, size_t length, size_t* size)
+{
+  boost::shared_array<uint8_t> obj;
+  size_t len = 0;
+
+  int err = getObject(sourceKey, &obj, &len);
+  if (err)
+    return err;
+  size_t count = ((size_t)offset < len ? min(length, len - offset) : 0);
+  if (count)
+    memcpy(data, &obj[offset], count);
+  if (size)
+    *size = count;
+  ++rangesGotten;
+  return 0;
+}
+
+bool CloudStorage::rangedGets() const
+{
+  return false;
 }
 
 }  // namespace storagemanager
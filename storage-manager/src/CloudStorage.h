@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string>
+#include <sys/types.h>
 #include <boost/shared_array.hpp>
 #include "SMLogging.h"
 
@@ -31,6 +32,12 @@ class CloudStorage
   virtual int getObject(const std::string& sourceKey, const std::string& destFile, size_t* size = NULL) = 0;
   virtual int getObject(const std::string& sourceKey, boost::shared_array<uint8_t>* data,
                         size_t* size = NULL) = 0;
+  /* Ranged GET of length bytes at offset into data.  size gets the number of bytes read, less than length
+     at the end of the object.  The default GETs the whole object, a backend that can GET a range of an
+     object overrides it and rangedGets(). */
+  virtual int getObject(const std::string& sourceKey, uint8_t* data, off_t offset, size_t length,
+                        size_t* size);
+  virtual bool rangedGets() const;
   virtual int putObject(const std::string& sourceFile, const std::string& destKey) = 0;
   virtual int putObject(const boost::shared_array<uint8_t> data, size_t len, const std::string& destKey) = 0;
   virtual int deleteObject(const std::string& key) = 0;
@@ -48,7 +55,7 @@ class CloudStorage
 
   // some KPIs
   size_t bytesUploaded, bytesDownloaded, objectsDeleted, objectsCopied, objectsGotten, objectsPut,
-      existenceChecks;
+      existenceChecks, rangesGotten;
 
  private:
 };
@@ -28,6 +28,8 @@
 #define BOOST_SPIRIT_THREADSAFE
 #include <boost/property_tree/json_parser.hpp>
 #include <iostream>
+#include <set>
+#include <algorithm>
 #include "checks.h"
 #include "vlarray.h"
 
@@ -81,6 +83,31 @@ IOCoordinator::IOCoordinator()
   cachePath = cache->getCachePath();
   journalPath = cache->getJournalPath();
 
+  // Cache/range_size enables reading objects that aren't in the cache by range instead of
+  // downloading them
+  string stmp = config->getValue("Cache", "range_size");
+  size_t rangeSize = strtoull(stmp.c_str(), NULL, 10);
+  if (rangeSize > 0)
+  {
+    CloudStorage* cs = CloudStorage::get();
+    stmp = config->getValue("Cache", "range_cache_size");
+    size_t rangeCacheSize = strtoull(stmp.c_str(), NULL, 10);
+    if (!cs->rangedGets())
+      logger->log(LOG_WARNING,
+                  "Cache/range_size is set, but the cloud storage service can't GET ranges of objects.  "
+                  "Objects will be downloaded to the cache.");
+    else if (rangeCacheSize < rangeSize)
+      logger->log(LOG_WARNING,
+                  "Cache/range_cache_size must be at least Cache/range_size.  "
+                  "Objects will be downloaded to the cache.");
+    else
+    {
+      rangeCache.reset(new RangeCache(cs, rangeSize, rangeCacheSize));
+      logger->log(LOG_INFO, "IOCoordinator: reading objects not in the cache in ranges of %zu bytes",
+                  rangeSize);
+    }
+  }
+
   bytesRead = bytesWritten = filesOpened = filesCreated = filesCopied = filesDeleted = bytesCopied =
       filesTruncated = listingCount = callsToWrite = 0;
   iocFilesOpened = iocObjectsCreated = iocJournalsCreated = iocBytesWritten = iocFilesDeleted = iocBytesRead =
@@ -121,6 +148,8 @@ void IOCoordinator::printKPIs() const
   cout << "\t\tiocJournalsCreated = " << iocJournalsCreated << endl;
   cout << "\t\tiocBytesRead = " << iocBytesRead << endl;
   cout << "\t\tiocBytesWritten = " << iocBytesWritten << endl;
+  if (rangeCache)
+    rangeCache->printKPIs();
 }
 
 int IOCoordinator::loadObject(int fd, uint8_t* data, off_t offset, size_t length)
@@ -197,10 +226,31 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
 
   // load them into the cache
   vector<string> keys;
+  set<string> rangedKeys;
   keys.reserve(relevants.size());
   for (const auto& object : relevants)
     keys.push_back(object.key);
-  cache->read(firstDir, keys);
+  if (rangeCache)
+  {
+    // objects that aren't in the cache are read by range, unless there is a journal to merge
+    vector<string> notCached, toDownload;
+    cache->read(firstDir, keys, &notCached);
+    for (const auto& key : notCached)
+    {
+      if (bf::exists(journalPath / firstDir / (key + ".journal")))
+        toDownload.push_back(key);
+      else
+        rangedKeys.insert(key);
+    }
+    if (!toDownload.empty())
+      cache->read(firstDir, toDownload);
+    if (!rangedKeys.empty())
+      keys.erase(remove_if(keys.begin(), keys.end(),
+                           [&rangedKeys](const string& key) { return rangedKeys.count(key) != 0; }),
+                 keys.end());
+  }
+  else
+    cache->read(firstDir, keys);
 
   // open the journal files and objects that exist to prevent them from being
   // deleted mid-operation
@@ -273,7 +323,9 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
     // otherwise it is the length of the object - starting offset
 
     size_t thisLength = min(object.length - thisOffset, length - count);
-    if (jit == journalFDs.end())
+    if (rangedKeys.find(object.key) != rangedKeys.end())
+      err = rangeCache->read(firstDir, object.key, object.length, &data[count], thisOffset, thisLength);
+    else if (jit == journalFDs.end())
       err = loadObject(objectFDs[object.key], &data[count], thisOffset, thisLength);
     else
       err = loadObjectAndJournal(keyToObjectName[object.key].c_str(), keyToJournalName[object.key].c_str(),
@@ -34,6 +34,7 @@
 #include "Replicator.h"
 #include "Utilities.h"
 #include "Ownership.h"
+#include "RangeCache.h"
 
 namespace storagemanager
 {
@@ -97,6 +98,7 @@ class IOCoordinator : public boost::noncopyable
   SMLogging* logger;
   Replicator* replicator;
   Ownership ownership;  // ACK!  Need a new name for this!
+  boost::scoped_ptr<RangeCache> rangeCache;  // NULL unless objects not in the cache are read by range
 
   size_t objectSize;
   boost::filesystem::path journalPath;
@@ -32,6 +32,8 @@ class LocalStorage : public CloudStorage
 
   int getObject(const std::string& sourceKey, const std::string& destFile, size_t* size = NULL);
   int getObject(const std::string& sourceKey, boost::shared_array<uint8_t>* data, size_t* size = NULL);
+  int getObject(const std::string& sourceKey, uint8_t* data, off_t offset, size_t length, size_t* size);
+  bool rangedGets() const;
   int putObject(const std::string& sourceFile, const std::string& destKey);
   int putObject(const boost::shared_array<uint8_t> data, size_t len, const std::string& destKey);
   int deleteObject(const std::string& key);
@@ -204,7 +204,7 @@ void PrefixCache::validateCacheSize()
                 "PrefixCache::validateCacheSize(): Cache size accounting agrees with reality for now.");
 }
 
-void PrefixCache::read(const vector<string>& keys)
+void PrefixCache::read(const vector<string>& keys, vector<string>* notCached)
 {
   /*  Move existing keys to the back of the LRU, start downloading nonexistant keys.
    */
@@ -223,6 +223,8 @@ void PrefixCache::read(const vector<string>& keys)
       addToDNE(mit->lit);
       lru.splice(lru.end(), lru, mit->lit);  // move them to the back so they are last to pick for eviction
     }
+    else if (notCached)
+      notCached->push_back(key);
     else
     {
       // There's window where the file has been downloaded but is not yet
@@ -45,7 +45,9 @@ class PrefixCache : public boost::noncopyable
   // reading fcns
   // read() marks objects to be read s.t. they do not get flushed.
   // after reading them, unlock the 'logical file', and call doneReading().
-  void read(const std::vector<std::string>& keys);
+  // If notCached isn't NULL, the objects that aren't in the cache aren't downloaded or marked,
+  // they are added to notCached instead.
+  void read(const std::vector<std::string>& keys, std::vector<std::string>* notCached = NULL);
   void doneReading(const std::vector<std::string>& keys);
   bool exists(const std::string& key) const;
   void exists(const std::vector<std::string>& keys, std::vector<bool>* out) const;
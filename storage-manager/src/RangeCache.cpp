@@ -0,0 +1,175 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "RangeCache.h"
+#include <errno.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+namespace bf = boost::filesystem;
+
+namespace storagemanager
+{
+RangeCache::RangeCache(CloudStorage* _cs, size_t _rangeSize, size_t _maxSize)
+ : cs(_cs), rangeSize(_rangeSize), maxSize(_maxSize), currentSize(0)
+{
+  rangeHits = rangeMisses = bytesGotten = 0;
+}
+
+RangeCache::~RangeCache()
+{
+}
+
+int RangeCache::read(const bf::path& prefix, const string& key, size_t objectLength, uint8_t* data,
+                     off_t offset, size_t length)
+{
+  if (length == 0)
+    return 0;
+  if (offset + length > objectLength)
+  {
+    errno = ENODATA;
+    return -1;
+  }
+
+  const string object = (prefix / key).string();
+  const size_t first = offset / rangeSize;
+  const size_t last = (offset + length - 1) / rangeSize;
+  vector<boost::shared_array<uint8_t> > ranges(last - first + 1);
+  vector<size_t> lengths(last - first + 1);
+
+  boost::unique_lock<boost::mutex> s(mutex);
+  auto oit = resident.find(object);
+  if (oit != resident.end())
+  {
+    for (auto rit = oit->second.lower_bound(first); rit != oit->second.end() && rit->first <= last; ++rit)
+    {
+      lru.splice(lru.end(), lru, rit->second);
+      ranges[rit->first - first] = rit->second->data;
+      lengths[rit->first - first] = rit->second->length;
+      ++rangeHits;
+    }
+  }
+  s.unlock();
+
+  // GET each run of missing ranges at once
+  size_t i = 0;
+  while (i < ranges.size())
+  {
+    if (ranges[i])
+    {
+      ++i;
+      continue;
+    }
+    size_t end = i;
+    while (end < ranges.size() && !ranges[end])
+      ++end;
+
+    off_t getOffset = (first + i) * rangeSize;
+    size_t getLength = min((first + end) * rangeSize, objectLength) - getOffset;
+    boost::shared_array<uint8_t> buf(new uint8_t[getLength]);
+    size_t got = 0;
+    int err = cs->getObject(key, buf.get(), getOffset, getLength, &got);
+    if (err)
+      return err;
+    if (got != getLength)
+    {
+      errno = ENODATA;
+      return -1;
+    }
+    s.lock();
+    rangeMisses += end - i;
+    bytesGotten += got;
+    const size_t runStart = i;
+    for (; i < end; ++i)
+    {
+      size_t rangeOffset = (i - runStart) * rangeSize;
+      lengths[i] = min(rangeSize, getLength - rangeOffset);
+      if (end - runStart == 1)
+        ranges[i] = buf;
+      else
+      {
+        ranges[i].reset(new uint8_t[lengths[i]]);
+        memcpy(ranges[i].get(), &buf[rangeOffset], lengths[i]);
+      }
+      insert(object, first + i, ranges[i], lengths[i]);
+    }
+    evict();
+    s.unlock();
+  }
+
+  // copy out of the ranges
+  size_t count = 0;
+  for (i = 0; i < ranges.size(); ++i)
+  {
+    size_t rangeOffset = (i == 0 ? offset - first * rangeSize : 0);
+    size_t toCopy = min(lengths[i] - rangeOffset, length - count);
+    memcpy(&data[count], &ranges[i][rangeOffset], toCopy);
+    count += toCopy;
+  }
+  return 0;
+}
+
+void RangeCache::insert(const string& object, size_t index, const boost::shared_array<uint8_t>& data,
+                        size_t length)
+{
+  auto& ranges = resident[object];
+  if (ranges.find(index) != ranges.end())
+    return;  // another reader got it first
+  lru.push_back(Range{object, index, data, length});
+  ranges[index] = --lru.end();
+  currentSize += length;
+}
+
+void RangeCache::evict()
+{
+  while (currentSize > maxSize && !lru.empty())
+  {
+    const Range& range = lru.front();
+    auto oit = resident.find(range.object);
+    oit->second.erase(range.index);
+    if (oit->second.empty())
+      resident.erase(oit);
+    currentSize -= range.length;
+    lru.pop_front();
+  }
+}
+
+size_t RangeCache::getCurrentSize() const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  return currentSize;
+}
+
+size_t RangeCache::getResidentRanges(const bf::path& prefix, const string& key) const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  auto oit = resident.find((prefix / key).string());
+  return (oit == resident.end() ? 0 : oit->second.size());
+}
+
+void RangeCache::printKPIs() const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  cout << "RangeCache" << endl;
+  cout << "\trangeHits = " << rangeHits << endl;
+  cout << "\trangeMisses = " << rangeMisses << endl;
+  cout << "\tbytesGotten = " << bytesGotten << endl;
+}
+
+}  // namespace storagemanager
@@ -0,0 +1,87 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_array.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "CloudStorage.h"
+
+/* RangeCache holds the ranges of objects that were read from cloud storage without downloading
+   the whole object.  Objects are split into aligned ranges of rangeSize bytes, the resident
+   ranges of each object are tracked, and the least recently used ranges go when the ranges hold
+   more than maxSize bytes.  Objects are immutable once in cloud storage, so a resident range can't
+   go stale, it only ages out.
+*/
+
+namespace storagemanager
+{
+class RangeCache : public boost::noncopyable
+{
+ public:
+  RangeCache(CloudStorage* cs, size_t rangeSize, size_t maxSize);
+  virtual ~RangeCache();
+
+  // copies length bytes at offset of the object to data, GETting the ranges that aren't resident.
+  // objectLength is the length of the object.  Returns 0, or -1 and sets errno.
+  int read(const boost::filesystem::path& prefix, const std::string& key, size_t objectLength, uint8_t* data,
+           off_t offset, size_t length);
+
+  // test helpers
+  size_t getCurrentSize() const;
+  size_t getResidentRanges(const boost::filesystem::path& prefix, const std::string& key) const;
+
+  void printKPIs() const;
+
+ private:
+  struct Range
+  {
+    std::string object;
+    size_t index;
+    boost::shared_array<uint8_t> data;
+    size_t length;
+  };
+  typedef std::list<Range> LRU_t;
+
+  CloudStorage* cs;
+  size_t rangeSize;
+  size_t maxSize;
+  size_t currentSize;
+
+  LRU_t lru;
+  // object -> range index -> its place in lru
+  std::unordered_map<std::string, std::map<size_t, LRU_t::iterator> > resident;
+  mutable boost::mutex mutex;
+
+  void insert(const std::string& object, size_t index, const boost::shared_array<uint8_t>& data,
+              size_t length);
+  void evict();
+
+  // KPIs, protected by mutex
+  size_t rangeHits, rangeMisses, bytesGotten;
+};
+
+}  // namespace storagemanager
@@ -22,13 +22,18 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <boost/filesystem.hpp>
+#include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/random_generator.hpp>
 #define BOOST_SPIRIT_THREADSAFE
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <openssl/hmac.h>
+#include <openssl/sha.h>
 #include "Utilities.h"
 
 using namespace std;
@@ -211,6 +216,8 @@ S3Storage::~S3Storage()
 {
   for (auto& conn : freeConns)
     ms3_deinit(conn.conn);
+  for (CURL* curl : freeCurlHandles)
+    curl_easy_cleanup(curl);
   ms3_library_deinit();
 }
 
@@ -407,6 +414,265 @@ int S3Storage::getObject(const string& _sourceKey, boost::shared_array<uint8_t>*
   return 0;
 }
 
+namespace
+{
+const char* emptyPayloadHash = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+string toHex(const uint8_t* data, size_t len)
+{
+  static const char digits[] = "0123456789abcdef";
+  string ret(len * 2, 0);
+  for (size_t i = 0; i < len; i++)
+  {
+    ret[i * 2] = digits[data[i] >> 4];
+    ret[i * 2 + 1] = digits[data[i] & 0xf];
+  }
+  return ret;
+}
+
+string sha256Hex(const string& s)
+{
+  uint8_t hash[SHA256_DIGEST_LENGTH];
+  SHA256((const uint8_t*)s.data(), s.length(), hash);
+  return toHex(hash, sizeof(hash));
+}
+
+string hmacSha256(const string& key, const string& s)
+{
+  uint8_t mac[EVP_MAX_MD_SIZE];
+  unsigned macLen = 0;
+  HMAC(EVP_sha256(), key.data(), key.length(), (const uint8_t*)s.data(), s.length(), mac, &macLen);
+  return string((const char*)mac, macLen);
+}
+
+// percent-encodes all but the unreserved characters and the path separators
+string uriEncodePath(const string& path)
+{
+  ostringstream os;
+  os << hex << uppercase;
+  for (unsigned char c : path)
+  {
+    if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '/')
+      os << c;
+    else
+      os << '%' << setw(2) << setfill('0') << (int)c;
+  }
+  return os.str();
+}
+}  // namespace
+
+string S3Storage::authorizationV4(const string& keyID, const string& secret, const string& region,
+                                  const string& method, const string& uri, const map<string, string>& headers)
+{
+  const string& amzDate = headers.at("x-amz-date");
+  const string date = amzDate.substr(0, 8);
+  const string scope = date + "/" + region + "/s3/aws4_request";
+  string canonicalHeaders, signedHeaders;
+
+  for (auto& header : headers)
+  {
+    canonicalHeaders += header.first + ":" + header.second + "\n";
+    signedHeaders += (signedHeaders.empty() ? "" : ";") + header.first;
+  }
+
+  const string canonicalRequest = method + "\n" + uri + "\n\n" + canonicalHeaders + "\n" + signedHeaders + "\n" +
+                                  headers.at("x-amz-content-sha256");
+  const string stringToSign =
+      "AWS4-HMAC-SHA256\n" + amzDate + "\n" + scope + "\n" + sha256Hex(canonicalRequest);
+  const string signingKey =
+      hmacSha256(hmacSha256(hmacSha256(hmacSha256("AWS4" + secret, date), region), "s3"), "aws4_request");
+  const string signature = hmacSha256(signingKey, stringToSign);
+
+  return "AWS4-HMAC-SHA256 Credential=" + keyID + "/" + scope + ", SignedHeaders=" + signedHeaders +
+         ", Signature=" + toHex((const uint8_t*)signature.data(), signature.length());
+}
+
+struct S3Storage::RangedGet
+{
+  CURL* curl;
+  uint8_t* data;
+  off_t offset;
+  size_t length;
+  size_t got;
+  long status;
+  string error;  // the response to a failed GET
+};
+
+size_t S3Storage::rangedGetCallback(void* contents, size_t size, size_t nmemb, void* userp)
+{
+  RangedGet* get = (RangedGet*)userp;
+  const uint8_t* in = (const uint8_t*)contents;
+  size_t len = size * nmemb;
+
+  if (get->status == 0)
+    curl_easy_getinfo(get->curl, CURLINFO_RESPONSE_CODE, &get->status);
+
+  if (get->status != 200 && get->status != 206)
+  {
+    if (get->error.length() < 1024)
+      get->error.append((const char*)in, len);
+    return size * nmemb;
+  }
+
+  // a server that ignores the Range header sends the whole object
+  if (get->status == 200 && get->offset > 0)
+  {
+    size_t skip = min((size_t)get->offset, len);
+    get->offset -= skip;
+    in += skip;
+    len -= skip;
+  }
+
+  len = min(len, get->length - get->got);
+  memcpy(&get->data[get->got], in, len);
+  get->got += len;
+  return size * nmemb;
+}
+
+int S3Storage::sendRangedGet(const string& sourceKey, RangedGet* get)
+{
+  // libmarias3 addresses AWS buckets by host name and the buckets of other endpoints by path
+  const bool aws = endpoint.empty() || endpoint.find("amazonaws.com") != string::npos;
+  string host = (endpoint.empty() ? string("s3.amazonaws.com") : endpoint);
+  const string path = uriEncodePath(aws ? "/" + sourceKey : "/" + bucket + "/" + sourceKey);
+  const string signingRegion = (region.empty() ? string("us-east-1") : region);
+
+  if (aws)
+    host = bucket + "." + host;
+  if (portNumber != 0 && portNumber != (useHTTP ? 80 : 443))
+    host += ":" + to_string(portNumber);
+
+  char amzDate[20];
+  time_t now = time(NULL);
+  struct tm gmt;
+  strftime(amzDate, sizeof(amzDate), "%Y%m%dT%H%M%SZ", gmtime_r(&now, &gmt));
+
+  map<string, string> headers;
+  headers["host"] = host;
+  headers["range"] = "bytes=" + to_string(get->offset) + "-" + to_string(get->offset + get->length - 1);
+  headers["x-amz-content-sha256"] = emptyPayloadHash;
+  headers["x-amz-date"] = amzDate;
+  if (!token.empty())
+    headers["x-amz-security-token"] = token;
+
+  struct curl_slist* headerList = NULL;
+  for (auto& header : headers)
+    headerList = curl_slist_append(headerList, (header.first + ": " + header.second).c_str());
+  headerList = curl_slist_append(
+      headerList,
+      ("Authorization: " + authorizationV4(key, secret, signingRegion, "GET", path, headers)).c_str());
+
+  const string url = (useHTTP ? "http://" : "https://") + host + path;
+  CURL* curl = get->curl;
+
+  curl_easy_reset(curl);
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, rangedGetCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, get);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  if (!sslVerify)
+  {
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+  }
+
+  CURLcode res = curl_easy_perform(curl);
+  curl_slist_free_all(headerList);
+  if (res != CURLE_OK)
+    return res;
+  // a body-less response never reached the callback
+  if (get->status == 0)
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &get->status);
+  return 0;
+}
+
+int S3Storage::getObject(const string& _sourceKey, uint8_t* data, off_t offset, size_t length, size_t* size)
+{
+  // the credentials of an assumed role are kept in libmarias3, GET the whole object then
+  if (!rangedGets())
+    return CloudStorage::getObject(_sourceKey, data, offset, length, size);
+
+  string sourceKey = prefix + _sourceKey;
+  RangedGet get;
+  int err;
+  bool retry;
+
+  if (length == 0)
+  {
+    if (size)
+      *size = 0;
+    return 0;
+  }
+
+  get.curl = getCurlHandle();
+  if (!get.curl)
+  {
+    logger->log(LOG_ERR, "S3Storage::getObject(): failed to GET a range, curl_easy_init() returned NULL");
+    errno = ENOMEM;
+    return -1;
+  }
+
+  do
+  {
+    get.data = data;
+    get.offset = offset;
+    get.length = length;
+    get.got = 0;
+    get.status = 0;
+    get.error.clear();
+    err = sendRangedGet(sourceKey, &get);
+
+    retry = (err != 0 || get.status >= 500 || (get.status == 403 && ec2iamEnabled));
+    if (retry && !skipRetryableErrors)
+    {
+      if (err)
+        logger->log(LOG_WARNING,
+                    "S3Storage::getObject(): failed to GET a range, got '%s'.  bucket = %s, key = %s.  Retrying...",
+                    curl_easy_strerror((CURLcode)err), bucket.c_str(), sourceKey.c_str());
+      else
+        logger->log(LOG_WARNING,
+                    "S3Storage::getObject(): failed to GET a range, server says %ld '%s'.  bucket = %s, key = %s."
+                    "  Retrying...",
+                    get.status, get.error.c_str(), bucket.c_str(), sourceKey.c_str());
+      if (ec2iamEnabled)
+      {
+        getIAMRoleFromMetadataEC2();
+        getCredentialsFromMetadataEC2();
+      }
+      sleep(5);
+    }
+  } while (retry && !skipRetryableErrors);
+  returnCurlHandle(get.curl);
+
+  // past the end of the object
+  if (!err && get.status == 416)
+    get.status = 206;
+
+  if (err || (get.status != 200 && get.status != 206))
+  {
+    if (err)
+      logger->log(LOG_ERR, "S3Storage::getObject(): failed to GET a range, got '%s'.  bucket = %s, key = %s.",
+                  curl_easy_strerror((CURLcode)err), bucket.c_str(), sourceKey.c_str());
+    else
+      logger->log(LOG_ERR,
+                  "S3Storage::getObject(): failed to GET a range, server says %ld '%s'.  bucket = %s, key = %s.",
+                  get.status, get.error.c_str(), bucket.c_str(), sourceKey.c_str());
+    errno = (err ? ECOMM : get.status == 404 ? ENOENT : get.status == 403 ? EKEYREJECTED : EPROTO);
+    return -1;
+  }
+
+  if (size)
+    *size = get.got;
+  ++rangesGotten;
+  return 0;
+}
+
+bool S3Storage::rangedGets() const
+{
+  return IAMrole.empty() || isEC2Instance;
+}
+
 int S3Storage::putObject(const string& sourceFile, const string& destKey)
 {
   boost::shared_array<uint8_t> data;
@@ -794,6 +1060,22 @@ ms3_st* S3Storage::getConnection()
   return ret;
 }
 
+CURL* S3Storage::getCurlHandle()
+{
+  boost::unique_lock<boost::mutex> s(connMutex);
+  if (freeCurlHandles.empty())
+    return curl_easy_init();
+  CURL* ret = freeCurlHandles.back();
+  freeCurlHandles.pop_back();
+  return ret;
+}
+
+void S3Storage::returnCurlHandle(CURL* curl)
+{
+  boost::unique_lock<boost::mutex> s(connMutex);
+  freeCurlHandles.push_back(curl);
+}
+
 void S3Storage::returnConnection(ms3_st* ms3)
 {
   assert(ms3);
@@ -20,6 +20,7 @@
 #include <deque>
 #include <string>
 #include <map>
+#include <vector>
 #include "CloudStorage.h"
 #include "libmarias3/marias3.h"
 #include "Config.h"
@@ -36,13 +37,29 @@ class S3Storage : public CloudStorage
 
   int getObject(const std::string& sourceKey, const std::string& destFile, size_t* size = NULL);
   int getObject(const std::string& sourceKey, boost::shared_array<uint8_t>* data, size_t* size = NULL);
+  int getObject(const std::string& sourceKey, uint8_t* data, off_t offset, size_t length, size_t* size);
+  bool rangedGets() const;
   int putObject(const std::string& sourceFile, const std::string& destKey);
   int putObject(const boost::shared_array<uint8_t> data, size_t len, const std::string& destKey);
   int deleteObject(const std::string& key);
   int copyObject(const std::string& sourceKey, const std::string& destKey);
   int exists(const std::string& key, bool* out);
 
+  /* The AWS signature version 4 Authorization header of a request without a payload.  headers are
+     the headers to sign, lower case names, with host, x-amz-content-sha256 and x-amz-date. */
+  static std::string authorizationV4(const std::string& keyID, const std::string& secret,
+                                     const std::string& region, const std::string& method,
+                                     const std::string& uri, const std::map<std::string, std::string>& headers);
+
  private:
+  struct RangedGet;
+
+  // libmarias3 has no ranged GET, it is sent with curl
+  int sendRangedGet(const std::string& sourceKey, RangedGet* get);
+  static size_t rangedGetCallback(void* contents, size_t size, size_t nmemb, void* userp);
+  CURL* getCurlHandle();
+  void returnCurlHandle(CURL*);
+
   bool getIAMRoleFromMetadataEC2();
   bool getCredentialsFromMetadataEC2();
   void testConnectivityAndPerms();
@@ -85,6 +102,7 @@ class S3Storage : public CloudStorage
 
   boost::mutex connMutex;
   std::deque<Connection> freeConns;  // using this as a stack to keep lru objects together
+  std::vector<CURL*> freeCurlHandles;
   const time_t maxIdleSecs = 30;
 };
 
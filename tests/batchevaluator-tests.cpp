@@ -0,0 +1,369 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "arithmeticcolumn.h"
+#include "arithmeticoperator.h"
+#include "batchevaluator.h"
+#include "constantcolumn.h"
+#include "functioncolumn.h"
+#include "functor_real.h"
+#include "joblisttypes.h"
+#include "logicoperator.h"
+#include "predicateoperator.h"
+#include "rowgroup.h"
+#include "simplecolumn.h"
+#include "simplefilter.h"
+
+using namespace execplan;
+using namespace funcexp;
+
+namespace
+{
+const uint32_t ROWS = 64;
+
+// a INT, b BIGINT, c DOUBLE
+enum
+{
+  COL_A,
+  COL_B,
+  COL_C
+};
+
+CalpontSystemCatalog::ColType colType(CalpontSystemCatalog::ColDataType type, uint32_t width)
+{
+  CalpontSystemCatalog::ColType ct;
+  ct.colDataType = type;
+  ct.colWidth = width;
+  ct.precision = (type == CalpontSystemCatalog::DOUBLE ? 0 : 19);
+  ct.scale = 0;
+  return ct;
+}
+
+const CalpontSystemCatalog::ColType& columnType(uint32_t col)
+{
+  static const CalpontSystemCatalog::ColType types[] = {colType(CalpontSystemCatalog::INT, 4),
+                                                        colType(CalpontSystemCatalog::BIGINT, 8),
+                                                        colType(CalpontSystemCatalog::DOUBLE, 8)};
+  return types[col];
+}
+
+}  // namespace
+
+class BatchEvaluatorTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    std::vector<uint32_t> offsets{2, 6, 14, 22};
+    std::vector<uint32_t> oids{3001, 3002, 3003};
+    std::vector<uint32_t> keys{1, 2, 3};
+    std::vector<CalpontSystemCatalog::ColDataType> types{
+        CalpontSystemCatalog::INT, CalpontSystemCatalog::BIGINT, CalpontSystemCatalog::DOUBLE};
+    std::vector<uint32_t> charsets(3, 8), scale(3, 0), precision{10, 19, 0};
+
+    rg = rowgroup::RowGroup(3, offsets, oids, keys, types, charsets, scale, precision, 20, false);
+    data.reinit(rg, ROWS);
+    rg.setData(&data);
+    rg.resetRowGroup(0);
+
+    rowgroup::Row row;
+    rg.initRow(&row);
+    rg.getRow(0, &row);
+
+    // every column has its own NULL pattern, a and b go negative
+    for (uint32_t i = 0; i < ROWS; i++, row.nextRow())
+    {
+      if (i % 5 == 0)
+        row.setUintField<4>(joblist::INTNULL, COL_A);
+      else
+        row.setIntField<4>((int32_t)i - 20, COL_A);
+
+      if (i % 7 == 3)
+        row.setUintField<8>(joblist::BIGINTNULL, COL_B);
+      else
+        row.setIntField<8>(((int64_t)i * 37) % 50 - 25, COL_B);
+
+      if (i % 11 == 4)
+        row.setUintField<8>(joblist::DOUBLENULL, COL_C);
+      else
+        row.setDoubleField(i * 0.75 - 10.0, COL_C);
+    }
+
+    rg.setRowCount(ROWS);
+
+    for (uint32_t i = 0; i < ROWS; i++)
+      all.push_back(i);
+
+    for (uint32_t i = 1; i < ROWS; i += 3)
+      sparse.push_back(i);
+  }
+
+  void TearDown() override
+  {
+    for (auto* tree : trees)
+      delete tree;
+  }
+
+  // the trees are freed with the test
+  ParseTree* keep(ParseTree* tree)
+  {
+    trees.push_back(tree);
+    return tree;
+  }
+
+  static SimpleColumn* column(uint32_t col)
+  {
+    SimpleColumn* sc = new SimpleColumn();
+    sc->inputIndex(col);
+    sc->resultType(columnType(col));
+    return sc;
+  }
+
+  static ConstantColumn* constant(int64_t val)
+  {
+    ConstantColumn* cc = new ConstantColumn(val);
+    cc->resultType(colType(CalpontSystemCatalog::BIGINT, 8));
+    return cc;
+  }
+
+  static ConstantColumn* constant(double val)
+  {
+    ConstantColumn* cc = new ConstantColumn(std::to_string(val), val);
+    cc->resultType(colType(CalpontSystemCatalog::DOUBLE, 8));
+    return cc;
+  }
+
+  static ParseTree* compare(const std::string& op, ReturnedColumn* lhs, ReturnedColumn* rhs)
+  {
+    SOP sop(new PredicateOperator(op));
+    sop->setOpType(lhs->resultType(), rhs->resultType());
+    return new ParseTree(new SimpleFilter(sop, lhs, rhs));
+  }
+
+  static ParseTree* logic(const std::string& op, ParseTree* lhs, ParseTree* rhs)
+  {
+    ParseTree* tree = new ParseTree(new LogicOperator(op));
+    tree->left(lhs);
+    tree->right(rhs);
+    return tree;
+  }
+
+  // NOT x is planned as x = 0
+  static ParseTree* negate(ReturnedColumn* arg)
+  {
+    return compare("=", arg, constant((int64_t)0));
+  }
+
+  static ArithmeticColumn* arithmetic(const std::string& op, ReturnedColumn* lhs, ReturnedColumn* rhs,
+                                      const CalpontSystemCatalog::ColType& type)
+  {
+    ArithmeticOperator* aop = new ArithmeticOperator(op);
+    aop->operationType(type);
+    aop->resultType(type);
+
+    ParseTree* tree = new ParseTree(aop);
+    tree->left(new ParseTree(lhs));
+    tree->right(new ParseTree(rhs));
+
+    ArithmeticColumn* ac = new ArithmeticColumn();
+    ac->expression(tree);
+    ac->resultType(type);
+    ac->operationType(type);
+    return ac;
+  }
+
+  // abs() has no batch implementation, it is evaluated row by row
+  static FunctionColumn* absOf(ReturnedColumn* arg)
+  {
+    static Func_abs absFunctor;
+    FunctionColumn* fc = new FunctionColumn();
+    FunctionParm parms;
+
+    parms.push_back(SPTP(new ParseTree(arg)));
+    fc->functionName("abs");
+    fc->setFunctor(&absFunctor);
+    fc->functionParms(parms);
+    fc->resultType(arg->resultType());
+    fc->operationType(arg->resultType());
+    return fc;
+  }
+
+  // the batch results are the ones of the row getters on every selected row
+  void expectSame(ParseTree* tree, BatchType type, const Selection& sel)
+  {
+    RowBatch batch(rg);
+    BatchColumn col;
+    rowgroup::Row row;
+
+    col.reset(type, sel.size());
+    BatchEvaluator::evaluate(tree, batch, sel, type, col);
+    rg.initRow(&row);
+
+    ASSERT_EQ(col.nulls.size(), sel.size());
+
+    for (uint32_t i = 0; i < sel.size(); i++)
+    {
+      bool isNull = false;
+      rg.getRow(sel[i], &row);
+
+      switch (type)
+      {
+        case BatchType::BOOL:
+        {
+          int64_t val = tree->getBoolVal(row, isNull);
+          EXPECT_EQ(col.intVals[i], val) << "row " << sel[i];
+          break;
+        }
+
+        case BatchType::DOUBLE:
+        {
+          double val = tree->getDoubleVal(row, isNull);
+
+          if (!isNull)
+            EXPECT_DOUBLE_EQ(col.doubleVals[i], val) << "row " << sel[i];
+
+          break;
+        }
+
+        default:
+        {
+          int64_t val = tree->getIntVal(row, isNull);
+
+          if (!isNull)
+            EXPECT_EQ(col.intVals[i], val) << "row " << sel[i];
+
+          break;
+        }
+      }
+
+      EXPECT_EQ((bool)col.nulls[i], isNull) << "row " << sel[i];
+    }
+  }
+
+  // the rows filter() keeps are the ones FuncExp::evaluate(Row&, filters) passes
+  void expectSameFilter(ParseTree* tree, const Selection& sel)
+  {
+    RowBatch batch(rg);
+    Selection kept(sel);
+    Selection expected;
+    rowgroup::Row row;
+
+    rg.initRow(&row);
+
+    for (uint32_t i = 0; i < sel.size(); i++)
+    {
+      bool isNull = false;
+      rg.getRow(sel[i], &row);
+
+      if (tree->getBoolVal(row, isNull))
+        expected.push_back(sel[i]);
+    }
+
+    BatchEvaluator::filter(tree, batch, kept);
+    EXPECT_EQ(kept, expected);
+  }
+
+  void expectSameAll(ParseTree* tree, BatchType type)
+  {
+    expectSame(tree, type, all);
+    expectSame(tree, type, sparse);
+  }
+
+  rowgroup::RowGroup rg;
+  rowgroup::RGData data;
+  Selection all;
+  Selection sparse;
+  std::vector<ParseTree*> trees;
+};
+
+TEST_F(BatchEvaluatorTest, Columns)
+{
+  expectSameAll(keep(new ParseTree(column(COL_A))), BatchType::INT);
+  expectSameAll(keep(new ParseTree(column(COL_B))), BatchType::INT);
+  expectSameAll(keep(new ParseTree(column(COL_C))), BatchType::DOUBLE);
+  // mixed types, an integer column read as double
+  expectSameAll(keep(new ParseTree(column(COL_A))), BatchType::DOUBLE);
+}
+
+TEST_F(BatchEvaluatorTest, Arithmetic)
+{
+  const CalpontSystemCatalog::ColType bigint = colType(CalpontSystemCatalog::BIGINT, 8);
+  const CalpontSystemCatalog::ColType dbl = colType(CalpontSystemCatalog::DOUBLE, 8);
+
+  expectSameAll(keep(new ParseTree(arithmetic("+", column(COL_A), column(COL_B), bigint))), BatchType::INT);
+  expectSameAll(keep(new ParseTree(arithmetic("*", column(COL_B), constant((int64_t)3), bigint))),
+                BatchType::INT);
+  // int and double operands
+  expectSameAll(keep(new ParseTree(arithmetic("-", column(COL_C), column(COL_A), dbl))), BatchType::DOUBLE);
+  // division by the zeros of b gives NULL
+  expectSameAll(keep(new ParseTree(arithmetic("/", column(COL_C), column(COL_B), dbl))), BatchType::DOUBLE);
+}
+
+TEST_F(BatchEvaluatorTest, Predicates)
+{
+  expectSameAll(keep(compare(">", column(COL_A), constant((int64_t)0))), BatchType::BOOL);
+  expectSameAll(keep(compare("<=", column(COL_B), column(COL_A))), BatchType::BOOL);
+  expectSameAll(keep(compare("<>", column(COL_C), constant(2.0))), BatchType::BOOL);
+  // an integer column against a double one
+  expectSameAll(keep(compare("<", column(COL_A), column(COL_C))), BatchType::BOOL);
+
+  SOP isNull(new PredicateOperator("isnull"));
+  CalpontSystemCatalog::ColType bType = columnType(COL_B);
+  isNull->setOpType(bType, bType);
+  expectSameAll(keep(new ParseTree(new SimpleFilter(isNull, column(COL_B),
+                                                    new ConstantColumn("", ConstantColumn::NULLDATA)))),
+                BatchType::BOOL);
+}
+
+TEST_F(BatchEvaluatorTest, AndOrNot)
+{
+  ParseTree* both = keep(logic("and", compare(">", column(COL_A), constant((int64_t)-5)),
+                               compare("<", column(COL_B), constant((int64_t)10))));
+  ParseTree* either = keep(logic("or", compare(">", column(COL_A), constant((int64_t)10)),
+                                 compare("<", column(COL_C), constant(0.0))));
+  ParseTree* neither = keep(negate(column(COL_A)));
+  ParseTree* nested = keep(logic("or", logic("and", compare(">=", column(COL_A), column(COL_B)), negate(column(COL_B))),
+                                 logic("xor", compare(">", column(COL_C), constant(5.0)),
+                                       compare("<", column(COL_A), constant((int64_t)0)))));
+
+  for (ParseTree* tree : {both, either, neither, nested})
+  {
+    expectSameAll(tree, BatchType::BOOL);
+    expectSameFilter(tree, all);
+    expectSameFilter(tree, sparse);
+  }
+}
+
+TEST_F(BatchEvaluatorTest, Fallbacks)
+{
+  // a function without batch implementation, alone and under batch evaluated nodes
+  expectSameAll(keep(new ParseTree(absOf(column(COL_B)))), BatchType::INT);
+  expectSameAll(keep(new ParseTree(arithmetic("+", absOf(column(COL_A)), column(COL_B),
+                                              colType(CalpontSystemCatalog::BIGINT, 8)))),
+                BatchType::INT);
+
+  ParseTree* filter = keep(logic("and", compare(">", absOf(column(COL_B)), constant((int64_t)10)),
+                                 compare("<>", column(COL_A), constant((int64_t)3))));
+  expectSameAll(filter, BatchType::BOOL);
+  expectSameFilter(filter, all);
+
+  // a predicate asked for a type it doesn't batch goes row by row
+  expectSameAll(keep(compare(">", column(COL_A), constant((int64_t)0))), BatchType::DOUBLE);
+}
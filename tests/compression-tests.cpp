@@ -19,7 +19,10 @@
 #include <string>
 #include <vector>
 
+#include "mcsconfig.h"
 #include "idbcompress.h"
+#include "chunkencoding.h"
+#include "rowencoding.h"
 
 class CompressionTest : public ::testing::Test
 {
@@ -106,3 +109,195 @@ TEST_F(CompressionTest, LZvsSnappyUnique)
     std::cout << "Snappy ratio: " << (float)((float)generatedSize / (float)compressedSizeSnappy) << std::endl;
   }
 }
+
+#ifdef HAVE_ZSTD
+TEST_F(CompressionTest, ZSTDChunkReadBySnappy)
+{
+  std::unique_ptr<compress::CompressInterface> zstdCompressor(
+      new compress::CompressInterfaceZSTD(0, compress::CompressInterfaceZSTD::DEFAULT_LEVEL));
+  std::unique_ptr<compress::CompressInterface> snappyCompressor(new compress::CompressInterfaceSnappy());
+  std::string data = "aaaaaaahi";
+  auto generated = genPermutations(data);
+
+  size_t compressedSize = zstdCompressor->maxCompressedSize(generated.size());
+  std::unique_ptr<unsigned char[]> compressedData(new unsigned char[compressedSize]);
+  auto rc = zstdCompressor->compressBlock(generated.data(), generated.size(), compressedData.get(),
+                                          compressedSize);
+  ASSERT_EQ(rc, 0);
+  EXPECT_LT(compressedSize, generated.size() / 4);
+
+  // a chunk is uncompressed by the codec that wrote it, whatever the column's codec is
+  size_t uncompressedSize = generated.size();
+  std::unique_ptr<unsigned char[]> uncompressedData(new unsigned char[uncompressedSize]);
+  rc = snappyCompressor->uncompressBlock(reinterpret_cast<char*>(compressedData.get()), compressedSize,
+                                         uncompressedData.get(), uncompressedSize);
+  ASSERT_EQ(rc, 0);
+  ASSERT_EQ(uncompressedSize, generated.size());
+  EXPECT_EQ(std::memcmp(uncompressedData.get(), generated.data(), uncompressedSize), 0);
+}
+#endif
+
+static uint64_t nextRandom(uint64_t& x)
+{
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x;
+}
+
+template <typename T>
+static compress::ChunkEncoding::Plan roundTrip(const std::vector<T>& values)
+{
+  const char* in = reinterpret_cast<const char*>(values.data());
+  const size_t inLen = values.size() * sizeof(T);
+  compress::ChunkEncoding::Plan plan;
+
+  size_t encodedLen = compress::ChunkEncoding::plan(in, inLen, sizeof(T), plan);
+  EXPECT_GT(encodedLen, 0U);
+
+  std::vector<char> encoded(encodedLen);
+  EXPECT_EQ(compress::ChunkEncoding::encode(in, plan, encoded.data()), encodedLen);
+
+  std::vector<T> decoded(values.size());
+  size_t outLen = inLen;
+  EXPECT_TRUE(compress::ChunkEncoding::decode(encoded.data(), encodedLen,
+                                              reinterpret_cast<char*>(decoded.data()), outLen));
+  EXPECT_EQ(outLen, inLen);
+  EXPECT_EQ(decoded, values);
+
+  // a buffer that is too small is refused
+  outLen = inLen - 1;
+  EXPECT_FALSE(compress::ChunkEncoding::decode(encoded.data(), encodedLen,
+                                               reinterpret_cast<char*>(decoded.data()), outLen));
+  return plan;
+}
+
+TEST_F(CompressionTest, ChunkEncodingFOR)
+{
+  std::vector<int32_t> values;
+  uint64_t x = 88172645463325252ULL;
+
+  for (int32_t i = 0; i < 100000; i++)
+    values.push_back(-1000 + nextRandom(x) % 2000);
+
+  auto plan = roundTrip(values);
+  EXPECT_EQ(plan.type, compress::ChunkEncoding::FOR);
+  EXPECT_EQ(plan.bits, 11);
+}
+
+TEST_F(CompressionTest, ChunkEncodingDelta)
+{
+  std::vector<int64_t> values;
+
+  for (int64_t i = 0; i < 100000; i++)
+    values.push_back(1700000000000000LL + i * 1000 + i % 3);
+
+  auto plan = roundTrip(values);
+  EXPECT_EQ(plan.type, compress::ChunkEncoding::DELTA);
+  EXPECT_EQ(plan.bits, 2);
+}
+
+TEST_F(CompressionTest, ChunkEncodingRLE)
+{
+  std::vector<int16_t> values;
+
+  for (int16_t v : {3, -7, 12000, 3})
+    values.insert(values.end(), 30000, v);
+
+  auto plan = roundTrip(values);
+  EXPECT_EQ(plan.type, compress::ChunkEncoding::RLE);
+  EXPECT_EQ(plan.runs, 3U);
+  EXPECT_EQ(plan.tailCount, 30000U);
+}
+
+TEST_F(CompressionTest, ChunkEncodingEmptyTail)
+{
+  const uint64_t emptyVal = 0x8000000000000001ULL;
+  std::vector<uint64_t> values(524288, emptyVal);
+
+  // only the empty values, the chunk is all tail
+  auto plan = roundTrip(values);
+  EXPECT_EQ(plan.count, 0U);
+
+  // the empty values after the last row don't widen the range
+  uint64_t x = 88172645463325252ULL;
+
+  for (uint64_t i = 0; i < 1000; i++)
+    values[i] = 0xFFFFFFFFFFFFFF00ULL + nextRandom(x) % 200;
+
+  plan = roundTrip(values);
+  EXPECT_EQ(plan.type, compress::ChunkEncoding::FOR);
+  EXPECT_EQ(plan.bits, 8);
+  EXPECT_EQ(plan.tailCount, 524288U - 1000U);
+}
+
+TEST_F(CompressionTest, ChunkEncodingWideRange)
+{
+  std::vector<int64_t> values;
+  uint64_t x = 88172645463325252ULL;
+
+  for (int i = 0; i < 10000; i++)
+    values.push_back((int64_t)nextRandom(x));
+
+  auto plan = roundTrip(values);
+  EXPECT_EQ(plan.bits, 64);
+
+  std::vector<int8_t> bytes;
+
+  for (int i = 0; i < 10000; i++)
+    bytes.push_back((int8_t)(i * 37));
+
+  roundTrip(bytes);
+
+  compress::ChunkEncoding::Plan unused;
+  EXPECT_EQ(compress::ChunkEncoding::plan(reinterpret_cast<const char*>(bytes.data()), 10, 16, unused), 0U);
+  EXPECT_EQ(compress::ChunkEncoding::plan(reinterpret_cast<const char*>(bytes.data()), 10, 4, unused), 0U);
+}
+
+TEST_F(CompressionTest, RowEncodingRoundTrip)
+{
+  // a 16 byte header, then rows of an int64 key, an int32, a char, a 3 byte column and an int128
+  const std::vector<uint32_t> layout = {16, 0, 8, 12, 13, 16, 32};
+  const uint32_t rows = 5000;
+  std::vector<char> data(16 + rows * 32);
+  uint64_t x = 88172645463325252ULL;
+
+  for (uint32_t i = 0; i < 16; i++)
+    data[i] = (char)i;
+
+  for (uint32_t i = 0; i < rows; i++)
+  {
+    char* row = &data[16 + i * 32];
+    int64_t key = 1000000 + i;
+    int32_t small = nextRandom(x) % 100;
+    __int128 wide = (__int128)nextRandom(x) << 64 | nextRandom(x);
+
+    memcpy(row, &key, 8);
+    memcpy(row + 8, &small, 4);
+    row[12] = 'a' + i % 3;
+    memcpy(row + 13, "xyz", 3);
+    memcpy(row + 16, &wide, 16);
+  }
+
+  std::vector<char> encoded;
+  ASSERT_TRUE(compress::RowEncoding::encode(data.data(), data.size(), layout, encoded));
+  // the key and the small column encode, the wide one doesn't
+  EXPECT_LT(encoded.size(), data.size() - rows * 8);
+
+  std::vector<char> decoded(data.size());
+  ASSERT_TRUE(
+      compress::RowEncoding::decode(encoded.data(), encoded.size(), layout, decoded.data(), decoded.size()));
+  EXPECT_EQ(decoded, data);
+
+  // truncated, or not rows of the layout
+  EXPECT_FALSE(
+      compress::RowEncoding::decode(encoded.data(), encoded.size() - 1, layout, decoded.data(), decoded.size()));
+  EXPECT_FALSE(compress::RowEncoding::encode(data.data(), data.size() - 1, layout, encoded));
+  EXPECT_FALSE(compress::RowEncoding::encode(data.data(), data.size(), {16, 8, 32}, encoded));
+  EXPECT_FALSE(compress::RowEncoding::encode(data.data(), data.size(), {16, 0, 12, 8, 32}, encoded));
+
+  // no rows, only the header
+  ASSERT_TRUE(compress::RowEncoding::encode(data.data(), 16, layout, encoded));
+  EXPECT_EQ(encoded.size(), 16U + 5 * 5);
+  ASSERT_TRUE(compress::RowEncoding::decode(encoded.data(), encoded.size(), layout, decoded.data(), 16));
+}
@@ -0,0 +1,155 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include "IDBPolicy.h"
+#include "../writeengine/dictionary/we_dctnryindex.h"
+
+using WriteEngine::DctnryIndex;
+using WriteEngine::Token;
+
+static Token makeToken(uint64_t fbo, uint64_t op)
+{
+  Token token;
+  token.fbo = fbo;
+  token.op = op;
+  token.bc = 0;
+  return token;
+}
+
+static std::string str(uint32_t i)
+{
+  return "value" + std::to_string(i);
+}
+
+static void insert(DctnryIndex& index, uint32_t i)
+{
+  std::string s = str(i);
+  index.insert((const unsigned char*)s.data(), s.length(), makeToken(1000 + i / 100, i % 100));
+}
+
+static bool find(const DctnryIndex& index, uint32_t i, Token& token)
+{
+  std::string s = str(i);
+  return index.find((const unsigned char*)s.data(), s.length(), token);
+}
+
+class DctnryIndexTest : public ::testing::Test
+{
+ protected:
+  std::string storeFile;
+
+  void SetUp() override
+  {
+    idbdatafile::IDBPolicy::init(false, false, "", 0);
+    storeFile = "/tmp/dctnryindex-tests." + std::to_string(getpid()) + ".cdf";
+  }
+
+  void TearDown() override
+  {
+    DctnryIndex::remove(storeFile);
+  }
+};
+
+TEST_F(DctnryIndexTest, InsertFind)
+{
+  DctnryIndex index;
+  Token token;
+
+  index.setMaxStrings(500);
+  EXPECT_TRUE(index.enabled());
+  EXPECT_FALSE(index.isDirty());
+
+  for (uint32_t i = 0; i < 1000; i++)
+    insert(index, i);
+
+  // the strings past the cap aren't indexed
+  EXPECT_EQ(index.size(), 500U);
+  EXPECT_TRUE(index.isDirty());
+
+  for (uint32_t i = 0; i < 500; i++)
+  {
+    ASSERT_TRUE(find(index, i, token));
+    EXPECT_EQ(token.fbo, 1000 + i / 100);
+    EXPECT_EQ(token.op, i % 100);
+  }
+
+  EXPECT_FALSE(find(index, 500, token));
+
+  index.clear();
+  EXPECT_EQ(index.size(), 0U);
+  EXPECT_FALSE(find(index, 1, token));
+}
+
+TEST_F(DctnryIndexTest, SaveLoad)
+{
+  DctnryIndex index, loaded;
+  Token token;
+
+  index.setMaxStrings(1000);
+  loaded.setMaxStrings(1000);
+
+  for (uint32_t i = 0; i < 300; i++)
+    insert(index, i);
+
+  ASSERT_EQ(index.save(storeFile, 1234, 17, 4000), 0);
+  EXPECT_FALSE(index.isDirty());
+
+  ASSERT_TRUE(loaded.load(storeFile, 1234, 17, 4000));
+  EXPECT_EQ(loaded.size(), 300U);
+  EXPECT_FALSE(loaded.isDirty());
+
+  for (uint32_t i = 0; i < 300; i++)
+  {
+    ASSERT_TRUE(find(loaded, i, token));
+    EXPECT_EQ(token.fbo, 1000 + i / 100);
+    EXPECT_EQ(token.op, i % 100);
+  }
+}
+
+TEST_F(DctnryIndexTest, StoreChanged)
+{
+  DctnryIndex index, loaded;
+
+  index.setMaxStrings(1000);
+  loaded.setMaxStrings(1000);
+  insert(index, 1);
+  ASSERT_EQ(index.save(storeFile, 1234, 17, 4000), 0);
+
+  // the store doesn't end where it did when the index was saved
+  EXPECT_FALSE(loaded.load(storeFile, 1235, 17, 4000));
+  EXPECT_FALSE(loaded.load(storeFile, 1234, 18, 4000));
+  EXPECT_FALSE(loaded.load(storeFile, 1234, 17, 3990));
+  EXPECT_EQ(loaded.size(), 0U);
+
+  DctnryIndex::remove(storeFile);
+  EXPECT_FALSE(loaded.load(storeFile, 1234, 17, 4000));
+}
+
+TEST_F(DctnryIndexTest, Disabled)
+{
+  DctnryIndex index;
+
+  insert(index, 1);
+  EXPECT_FALSE(index.enabled());
+  EXPECT_EQ(index.size(), 0U);
+  EXPECT_FALSE(index.load(storeFile, 1234, 17, 4000));
+}
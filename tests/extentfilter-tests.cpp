@@ -0,0 +1,273 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+#include "extentmap.h"
+#include "extentfilter.h"
+#include "lbidlist.h"
+#include "primitivemsg.h"
+
+using BRM::ExtentFilter;
+
+static ExtentFilter makeFilter(int64_t first, int64_t count, uint32_t maxBytes)
+{
+  ExtentFilter filter(maxBytes);
+
+  for (int64_t i = first; i < first + count; i++)
+    filter.add(i * 7);
+
+  filter.finish();
+  return filter;
+}
+
+TEST(ExtentFilterTest, NoFalseNegatives)
+{
+  ExtentFilter filter = makeFilter(-5000, 10000, 64 * 1024);
+
+  ASSERT_TRUE(filter.hasBloomFilter());
+
+  for (int64_t i = -5000; i < 5000; i++)
+    EXPECT_TRUE(filter.mayContain(i * 7));
+}
+
+TEST(ExtentFilterTest, FalsePositiveRate)
+{
+  ExtentFilter filter = makeFilter(0, 10000, 64 * 1024);
+  uint32_t falsePositives = 0;
+
+  for (int64_t i = 0; i < 100000; i++)
+    falsePositives += filter.mayContain(i * 7 + 3);
+
+  EXPECT_LT(falsePositives, 3000U);
+}
+
+TEST(ExtentFilterTest, Finish)
+{
+  // a few distinct values fold the filter down
+  ExtentFilter small = makeFilter(0, 100, 64 * 1024);
+
+  ASSERT_TRUE(small.hasBloomFilter());
+  EXPECT_LT(small.getSize(), 1024U);
+
+  for (int64_t i = 0; i < 100; i++)
+    EXPECT_TRUE(small.mayContain(i * 7));
+
+  // far too many for the size, the filter is dropped and lets everything through
+  ExtentFilter full = makeFilter(0, 200000, 1024);
+
+  EXPECT_FALSE(full.hasBloomFilter());
+  EXPECT_TRUE(full.mayContain(3));
+
+  // none at all
+  ExtentFilter registersOnly;
+
+  registersOnly.add(1);
+  registersOnly.finish();
+  EXPECT_FALSE(registersOnly.hasBloomFilter());
+  EXPECT_EQ(registersOnly.estimateDistinct(), 1U);
+}
+
+TEST(ExtentFilterTest, EstimateDistinct)
+{
+  for (int64_t count : {10, 1000, 100000})
+  {
+    ExtentFilter filter = makeFilter(0, count, 0);
+
+    // the values again, they aren't counted twice
+    for (int64_t i = 0; i < count; i++)
+      filter.add(i * 7);
+
+    EXPECT_LT(std::llabs((int64_t)filter.estimateDistinct() - count), count * 15 / 100 + 1) << count;
+  }
+}
+
+TEST(ExtentFilterTest, Serialize)
+{
+  ExtentFilter filter = makeFilter(100, 5000, 16 * 1024), copy;
+  messageqcpp::ByteStream bs;
+
+  filter.startLbid = 123456;
+  filter.partitionNum = 3;
+  filter.segmentNum = 2;
+  filter.seqNum = 17;
+  filter.loVal = 700;
+  filter.hiVal = 35693;
+  filter.serialize(bs);
+  copy.deserialize(bs);
+
+  EXPECT_EQ(bs.length(), 0U);
+  EXPECT_EQ(copy.startLbid, filter.startLbid);
+  EXPECT_EQ(copy.partitionNum, filter.partitionNum);
+  EXPECT_EQ(copy.segmentNum, filter.segmentNum);
+  EXPECT_EQ(copy.seqNum, filter.seqNum);
+  EXPECT_EQ(copy.loVal, filter.loVal);
+  EXPECT_EQ(copy.hiVal, filter.hiVal);
+  EXPECT_EQ(copy.getSize(), filter.getSize());
+  EXPECT_EQ(copy.estimateDistinct(), filter.estimateDistinct());
+
+  for (int64_t i = 0; i < 10000; i++)
+    EXPECT_EQ(copy.mayContain(i), filter.mayContain(i));
+}
+
+TEST(ExtentFilterTest, IsCurrent)
+{
+  ExtentFilter filter = makeFilter(0, 10, 1024);
+  BRM::EMEntry extent;
+
+  extent.range.start = 4096;
+  extent.partitionNum = 1;
+  extent.segmentNum = 2;
+  extent.partition.cprange.isValid = BRM::CP_VALID;
+  extent.partition.cprange.loVal = 0;
+  extent.partition.cprange.hiVal = 63;
+  extent.partition.cprange.sequenceNum = 5;
+
+  filter.startLbid = 4096;
+  filter.partitionNum = 1;
+  filter.segmentNum = 2;
+  filter.loVal = 0;
+  filter.hiVal = 63;
+  filter.setSeqNumAfterUpdate(4);
+  EXPECT_TRUE(filter.isCurrent(extent));
+
+  // any later CP update retires the filter
+  extent.partition.cprange.sequenceNum = 6;
+  EXPECT_FALSE(filter.isCurrent(extent));
+  extent.partition.cprange.sequenceNum = 5;
+  extent.partition.cprange.isValid = BRM::CP_INVALID;
+  EXPECT_FALSE(filter.isCurrent(extent));
+  extent.partition.cprange.isValid = BRM::CP_VALID;
+  extent.partition.cprange.hiVal = 64;
+  EXPECT_FALSE(filter.isCurrent(extent));
+
+  filter.setSeqNumAfterUpdate(EM_MAX_SEQNUM);
+  EXPECT_EQ(filter.seqNum, 0);
+}
+
+class LBIDListExtentFilterTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    ExtentFilter filter = makeFilter(0, 1000, 16 * 1024);
+
+    extent.range.start = 8192;
+    extent.partitionNum = 0;
+    extent.segmentNum = 1;
+    extent.partition.cprange.isValid = BRM::CP_VALID;
+    extent.partition.cprange.loVal = 0;
+    extent.partition.cprange.hiVal = 6993;
+    extent.partition.cprange.sequenceNum = 3;
+
+    filter.startLbid = 8192;
+    filter.partitionNum = 0;
+    filter.segmentNum = 1;
+    filter.loVal = 0;
+    filter.hiVal = 6993;
+    filter.setSeqNumAfterUpdate(2);
+    filters[filter.startLbid] = filter;
+    lbidList.setExtentFilters(filters);
+
+    ct.colDataType = execplan::CalpontSystemCatalog::BIGINT;
+    ct.colWidth = 8;
+
+    // a value inside the CP range the Bloom filter rules out
+    for (absent = 1; filter.mayContain(absent); absent += 7)
+      ;
+  }
+
+  void addOp(int8_t op, int64_t value)
+  {
+    bs << (uint8_t)op << (uint8_t)0 << (uint64_t)value;
+    nops++;
+  }
+
+  bool scan(uint8_t bop)
+  {
+    return lbidList.ExtentFilterPredicate(extent, &bs, nops, ct, bop);
+  }
+
+  joblist::LBIDList lbidList{0};
+  BRM::ExtentFilterStore::FilterMap filters;
+  BRM::EMEntry extent;
+  execplan::CalpontSystemCatalog::ColType ct;
+  messageqcpp::ByteStream bs;
+  uint16_t nops = 0;
+  int64_t absent;
+};
+
+TEST_F(LBIDListExtentFilterTest, Single)
+{
+  addOp(COMPARE_EQ, 70);
+  EXPECT_TRUE(scan(BOP_NONE));
+
+  bs.reset();
+  nops = 0;
+  addOp(COMPARE_EQ, absent);
+  EXPECT_FALSE(scan(BOP_NONE));
+
+  // the filter can't rule out a range
+  bs.reset();
+  nops = 0;
+  addOp(COMPARE_LT, absent);
+  EXPECT_TRUE(scan(BOP_NONE));
+}
+
+TEST_F(LBIDListExtentFilterTest, And)
+{
+  addOp(COMPARE_EQ, 70);
+  addOp(COMPARE_NE, 140);
+  EXPECT_TRUE(scan(BOP_AND));
+
+  // one ruled out term is enough
+  addOp(COMPARE_EQ, absent);
+  EXPECT_FALSE(scan(BOP_AND));
+}
+
+TEST_F(LBIDListExtentFilterTest, Or)
+{
+  addOp(COMPARE_EQ, absent);
+  EXPECT_FALSE(scan(BOP_OR));
+
+  // every term has to be ruled out
+  addOp(COMPARE_EQ, 70);
+  EXPECT_TRUE(scan(BOP_OR));
+
+  bs.reset();
+  nops = 0;
+  addOp(COMPARE_EQ, absent);
+  addOp(COMPARE_GT, 0);
+  EXPECT_TRUE(scan(BOP_OR));
+}
+
+TEST_F(LBIDListExtentFilterTest, StaleFilter)
+{
+  addOp(COMPARE_EQ, absent);
+  extent.partition.cprange.sequenceNum = 4;
+  EXPECT_TRUE(scan(BOP_NONE));
+
+  // a truncated extent doesn't match its filter any more
+  extent.partition.cprange.sequenceNum = 3;
+  extent.partition.cprange.hiVal = 69;
+  EXPECT_TRUE(scan(BOP_NONE));
+
+  lbidList.setExtentFilters(BRM::ExtentFilterStore::FilterMap());
+  extent.partition.cprange.hiVal = 6993;
+  EXPECT_TRUE(scan(BOP_NONE));
+}
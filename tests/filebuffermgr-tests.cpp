@@ -0,0 +1,145 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "filebuffermgr.h"
+#include "stats.h"
+
+// PrimProc defines these
+dbbc::Stats* gPMStatsPtr = NULL;
+bool gPMProfOn = false;
+uint32_t gSession = 0;
+
+using dbbc::FileBuffer;
+using dbbc::FileBufferMgr;
+using dbbc::HashObject_t;
+
+const uint32_t CACHE_BLOCKS = 8;
+const BRM::LBID_t LBIDS = 16;
+
+class FileBufferMgrTest : public ::testing::Test
+{
+ protected:
+  static void setPolicy(FileBufferMgr& fbm, FileBufferMgr::ReplacementPolicy policy)
+  {
+    fbm.fPolicy = policy;
+  }
+
+  // every cached block is on one list, where its pool entry says it is
+  static void checkShards(FileBufferMgr& fbm)
+  {
+    for (uint32_t i = 0; i < fbm.fShardCount; i++)
+    {
+      FileBufferMgr::Shard& s = fbm.fShards[i];
+
+      ASSERT_EQ(s.fbSet.size(), s.cacheSize);
+      ASSERT_EQ(s.fbList.size() + s.probation.size(), s.cacheSize);
+      ASSERT_LE(s.cacheSize, s.maxBlocks);
+
+      for (const HashObject_t& fb : s.fbSet)
+      {
+        ASSERT_LT(fb.poolIdx, s.fbPool.size());
+        EXPECT_EQ(s.fbPool[fb.poolIdx].Lbid(), fb.lbid);
+        EXPECT_EQ(s.fbPool[fb.poolIdx].listLoc()->lbid, fb.lbid);
+      }
+    }
+  }
+
+  static void insert(FileBufferMgr& fbm, BRM::LBID_t lbid)
+  {
+    std::vector<uint8_t> data(BLOCK_SIZE, (uint8_t)lbid);
+    fbm.insert(lbid, 0, data.data());
+  }
+
+  // whether lbid is cached with its data, a hit sets its reference bit
+  static bool cached(FileBufferMgr& fbm, BRM::LBID_t lbid)
+  {
+    FileBuffer fb;
+
+    if (!fbm.find(HashObject_t(lbid, 0, 0), fb))
+      return false;
+
+    return fb.getData()[0] == (uint8_t)lbid && fb.getData()[BLOCK_SIZE - 1] == (uint8_t)lbid;
+  }
+
+  // inserts blocks with every cached one referenced, the new block has to stay
+  void allReferenced(FileBufferMgr::ReplacementPolicy policy)
+  {
+    FileBufferMgr fbm(CACHE_BLOCKS);
+    setPolicy(fbm, policy);
+    uint32_t x = 2463534242U;
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      BRM::LBID_t lbid = x % LBIDS;
+
+      for (BRM::LBID_t other = 0; other < LBIDS; other++)
+        cached(fbm, other);
+
+      insert(fbm, lbid);
+      ASSERT_TRUE(cached(fbm, lbid)) << "lbid " << lbid << " insert " << i;
+      ASSERT_LE(fbm.size(), CACHE_BLOCKS);
+      checkShards(fbm);
+    }
+
+    EXPECT_EQ(fbm.size(), CACHE_BLOCKS);
+  }
+};
+
+TEST_F(FileBufferMgrTest, LRUAllReferenced)
+{
+  allReferenced(FileBufferMgr::LRU);
+}
+
+TEST_F(FileBufferMgrTest, TwoQAllReferenced)
+{
+  allReferenced(FileBufferMgr::TWO_Q);
+}
+
+// CLOCK: a full cache of referenced blocks gives each a second chance, the oldest goes
+TEST_F(FileBufferMgrTest, ClockSecondChance)
+{
+  FileBufferMgr fbm(CACHE_BLOCKS);
+  setPolicy(fbm, FileBufferMgr::LRU);
+
+  for (BRM::LBID_t lbid = 0; lbid < CACHE_BLOCKS; lbid++)
+    insert(fbm, lbid);
+
+  for (BRM::LBID_t lbid = 0; lbid < CACHE_BLOCKS; lbid++)
+    ASSERT_TRUE(cached(fbm, lbid));
+
+  insert(fbm, CACHE_BLOCKS);
+  EXPECT_TRUE(cached(fbm, CACHE_BLOCKS));
+  EXPECT_FALSE(fbm.exists(0, 0));
+
+  for (BRM::LBID_t lbid = 1; lbid < CACHE_BLOCKS; lbid++)
+    EXPECT_TRUE(fbm.exists(lbid, 0));
+
+  checkShards(fbm);
+
+  // the bits are clear now, the next one goes without going around
+  insert(fbm, CACHE_BLOCKS + 1);
+  EXPECT_TRUE(fbm.exists(CACHE_BLOCKS + 1, 0));
+  EXPECT_FALSE(fbm.exists(1, 0));
+  checkShards(fbm);
+}
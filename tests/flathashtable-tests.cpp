@@ -0,0 +1,142 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flathashtable.h"
+
+using rowgroup::Row;
+
+// the parts of TypelessData the table uses
+struct TestKey
+{
+  uint8_t* data;
+  uint32_t len;
+
+  bool operator==(const TestKey& k) const
+  {
+    return len == k.len && len != 0 && memcmp(data, k.data, len) == 0;
+  }
+};
+
+typedef joiner::FlatHashTable<TestKey> Table;
+
+class FlatHashTableTest : public ::testing::Test
+{
+ protected:
+  TestKey key(uint32_t i)
+  {
+    strings.push_back("key" + std::to_string(i) + "_" + std::string(i % 7, 'x'));
+    return TestKey{(uint8_t*)strings.back().data(), (uint32_t)strings.back().length()};
+  }
+
+  // never reallocated, the keys point into it
+  std::vector<std::string> strings;
+
+  void SetUp() override
+  {
+    strings.reserve(1000000);
+  }
+};
+
+TEST_F(FlatHashTableTest, InsertFind)
+{
+  Table table;
+  std::vector<Row::Pointer> matches;
+  size_t rowCount = 0;
+
+  // key i has i % 3 + 1 rows
+  for (uint32_t i = 0; i < 50000; i++)
+    for (uint32_t j = 0; j <= i % 3; j++, rowCount++)
+      table.insert(std::make_pair(key(i), Row::Pointer((uint8_t*)(uintptr_t)(i * 4 + j + 1))));
+
+  EXPECT_EQ(table.size(), rowCount);
+
+  for (uint32_t i = 0; i < 50000; i++)
+  {
+    matches.clear();
+    ASSERT_EQ(table.find(key(i), matches), i % 3 + 1);
+
+    for (auto& m : matches)
+      EXPECT_EQ(((uintptr_t)m.data - 1) / 4, i);
+  }
+
+  matches.clear();
+  EXPECT_EQ(table.find(key(50000), matches), 0U);
+  EXPECT_EQ(table.find(key(123456), matches), 0U);
+  EXPECT_TRUE(matches.empty());
+}
+
+TEST_F(FlatHashTableTest, SkewedKeys)
+{
+  Table table;
+  std::vector<Row::Pointer> matches;
+  TestKey hot = key(7);
+  uint64_t sum = 0;
+
+  // a key with most of the rows, the rows are chained to its slot
+  for (uint32_t i = 1; i <= 500000; i++)
+    table.insert(std::make_pair(i % 100 ? hot : key(i), Row::Pointer((uint8_t*)(uintptr_t)i)));
+
+  EXPECT_EQ(table.size(), 500000U);
+  ASSERT_EQ(table.find(hot, matches), 495000U);
+
+  for (auto& m : matches)
+  {
+    EXPECT_NE((uintptr_t)m.data % 100, 0U);
+    sum += (uintptr_t)m.data;
+  }
+
+  EXPECT_EQ(sum, 500000ULL * 500001 / 2 - 100ULL * 5000 * 5001 / 2);
+
+  matches.clear();
+  ASSERT_EQ(table.find(key(300), matches), 1U);
+  EXPECT_EQ((uintptr_t)matches[0].data, 300U);
+}
+
+TEST_F(FlatHashTableTest, Iterate)
+{
+  Table table;
+  uint64_t sum = 0;
+  size_t count = 0;
+
+  for (uint32_t i = 1; i <= 1000; i++)
+    table.insert(std::make_pair(key(i), Row::Pointer((uint8_t*)(uintptr_t)i)));
+
+  for (Table::iterator it = table.begin(); it != table.end(); ++it)
+  {
+    sum += (uintptr_t)it->second.data;
+    count++;
+  }
+
+  EXPECT_EQ(count, 1000U);
+  EXPECT_EQ(sum, 1000U * 1001U / 2);
+  EXPECT_GT(table.getMemUsage(), 1000U * sizeof(Table::Entry));
+}
+
+TEST_F(FlatHashTableTest, Empty)
+{
+  Table table;
+  std::vector<Row::Pointer> matches;
+
+  EXPECT_TRUE(table.empty());
+  EXPECT_TRUE(table.begin() == table.end());
+  EXPECT_EQ(table.find(key(1), matches), 0U);
+}
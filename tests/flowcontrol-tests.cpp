@@ -0,0 +1,250 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "distributedenginecomm.h"
+#include "bppsendthread.h"
+#include "inetstreamsocket.h"
+#include "iosocket.h"
+#include "fair_threadpool.h"
+
+// bppsendthread.cpp is built in, these come from primitiveserver.cpp in PrimProc
+namespace primitiveprocessor
+{
+uint32_t connectionsPerUM = 1;
+uint32_t BPPCount = 1;
+}  // namespace primitiveprocessor
+
+using joblist::StepCredit;
+using messageqcpp::ByteStream;
+using messageqcpp::SBS;
+
+static SBS makeMsg(uint32_t len)
+{
+  SBS msg(new ByteStream(len));
+  msg->needAtLeast(len);
+  memset(msg->getInputPtr(), 'x', len);
+  msg->advanceInputPtr(len);
+  return msg;
+}
+
+TEST(StepCreditTest, ReturnsToTheSender)
+{
+  StepCredit credit(2, 4000);
+  SBS fromPM0 = makeMsg(1000), alsoFromPM0 = makeMsg(1000), fromPM1 = makeMsg(1500);
+  const uint64_t size = fromPM0->lengthWithHdrOverhead();
+  std::vector<uint64_t> toSend;
+
+  credit.sent(0, fromPM0);
+  credit.sent(0, alsoFromPM0);
+  credit.sent(1, fromPM1);
+  EXPECT_EQ(credit.getCreditUsed(0), 2 * size);
+  EXPECT_EQ(credit.getCreditUsed(1), fromPM1->lengthWithHdrOverhead());
+
+  // PM 1 gets back what it sent, even though PM 0 has more out
+  ASSERT_TRUE(credit.read({fromPM1}, false, toSend));
+  ASSERT_EQ(toSend.size(), 2U);
+  EXPECT_EQ(toSend[0], 0U);
+  EXPECT_EQ(toSend[1], fromPM1->lengthWithHdrOverhead());
+  EXPECT_EQ(credit.getCreditUsed(0), 2 * size);
+  EXPECT_EQ(credit.getCreditUsed(1), 0U);
+
+  ASSERT_TRUE(credit.read({fromPM0, alsoFromPM0}, true, toSend));
+  EXPECT_EQ(toSend[0], 2 * size);
+  EXPECT_EQ(toSend[1], 0U);
+  EXPECT_EQ(credit.getCreditUsed(0), 0U);
+}
+
+TEST(StepCreditTest, ReturnsInChunks)
+{
+  StepCredit credit(1, 40000);
+  std::vector<SBS> msgs;
+  std::vector<uint64_t> toSend;
+
+  for (uint32_t i = 0; i < 20; i++)
+  {
+    msgs.push_back(makeMsg(1000));
+    credit.sent(0, msgs.back());
+  }
+
+  const uint64_t size = msgs[0]->lengthWithHdrOverhead();
+  uint32_t next = 0;
+
+  // a quarter of the credit is about 10 messages
+  while (next < 9)
+    EXPECT_FALSE(credit.read({msgs[next++]}, false, toSend));
+
+  ASSERT_TRUE(credit.read({msgs[next++]}, false, toSend));
+  EXPECT_EQ(toSend[0], 10 * size);
+
+  // the step caught up, the rest goes back however little it is
+  ASSERT_TRUE(credit.read({msgs[next++]}, true, toSend));
+  EXPECT_EQ(toSend[0], size);
+  EXPECT_EQ(credit.getCreditUsed(0), 9 * size);
+}
+
+TEST(StepCreditTest, LocalExchange)
+{
+  StepCredit credit(2, 4000);
+  SBS fromPM = makeMsg(1000), local = makeMsg(1000);
+  std::vector<uint64_t> toSend;
+
+  credit.sent(1, fromPM);
+
+  // a message that wasn't sent() doesn't return anything, a null one neither
+  EXPECT_FALSE(credit.read({local, SBS()}, true, toSend));
+  EXPECT_EQ(credit.getCreditUsed(1), fromPM->lengthWithHdrOverhead());
+
+  ASSERT_TRUE(credit.read({local, fromPM}, true, toSend));
+  EXPECT_EQ(toSend[0], 0U);
+  EXPECT_EQ(toSend[1], fromPM->lengthWithHdrOverhead());
+}
+
+TEST(StepCreditTest, Stalls)
+{
+  StepCredit credit(2, 3000);
+  SBS first = makeMsg(1000), second = makeMsg(1000), third = makeMsg(1000);
+  std::vector<uint64_t> toSend;
+
+  credit.sent(0, first);
+  credit.sent(0, second);
+  EXPECT_FALSE(credit.outOfCredit());
+  EXPECT_EQ(credit.getStallTime(), 0U);
+
+  // the third message overdraws the credit
+  credit.sent(0, third);
+  EXPECT_TRUE(credit.outOfCredit());
+  usleep(10000);
+  EXPECT_GE(credit.getStallTime(), 10000000U);
+
+  ASSERT_TRUE(credit.read({first}, false, toSend));
+  EXPECT_FALSE(credit.outOfCredit());
+
+  uint64_t stalled = credit.getStallTime();
+  EXPECT_GE(stalled, 10000000U);
+  usleep(1000);
+  EXPECT_EQ(credit.getStallTime(), stalled);
+}
+
+class BPPSendThreadTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    messageqcpp::SocketParms parms;
+    messageqcpp::InetStreamSocket* writer = new messageqcpp::InetStreamSocket();
+    parms.sd(fds[0]);
+    writer->socketParms(parms);
+    parms.sd(fds[1]);
+    reader.socketParms(parms);
+
+    sock.reset(new messageqcpp::IOSocket(writer));
+    sockLock.reset(new boost::mutex());
+    // only asked how many threads are blocked on the queue, needs none
+    pool.reset(new threadpool::FairThreadPool(1, 0, 0, 0));
+    readFd = fds[1];
+    writeFd = fds[0];
+  }
+
+  void TearDown() override
+  {
+    close(writeFd);
+    close(readFd);
+  }
+
+  // sends count msgs of len bytes through st
+  void send(primitiveprocessor::BPPSendThread& st, uint32_t count, uint32_t len)
+  {
+    std::vector<primitiveprocessor::BPPSendThread::Msg_t> msgs;
+
+    for (uint32_t i = 0; i < count; i++)
+      msgs.emplace_back(makeMsg(len), sock, sockLock, 0);
+
+    st.sendResults(msgs, true);
+  }
+
+  // whether a msg arrives in 100ms
+  bool received()
+  {
+    struct timespec timeout = {0, 100000000};
+    bool timedOut = false;
+    SBS msg = reader.read(&timeout, &timedOut);
+    return !timedOut && msg && msg->length() > 0;
+  }
+
+  messageqcpp::InetStreamSocket reader;
+  primitiveprocessor::SP_UM_IOSOCK sock;
+  primitiveprocessor::SP_UM_MUTEX sockLock;
+  boost::shared_ptr<threadpool::FairThreadPool> pool;
+  int readFd, writeFd;
+};
+
+TEST_F(BPPSendThreadTest, SendsOnCredit)
+{
+  const uint32_t len = 1000;
+  const int64_t size = makeMsg(len)->lengthWithHdrOverhead();
+
+  primitiveprocessor::BPPSendThread st(2 * size);
+  st.setProcessorPool(pool);
+  EXPECT_TRUE(st.flowControlEnabled());
+  EXPECT_FALSE(st.outOfCredit());
+
+  // two go on the credit, the other two wait for more
+  send(st, 4, len);
+  EXPECT_TRUE(received());
+  EXPECT_TRUE(received());
+  EXPECT_FALSE(received());
+  EXPECT_TRUE(st.outOfCredit());
+
+  // a message may overdraw the credit by its size
+  st.grantCredit(1);
+  EXPECT_TRUE(received());
+  EXPECT_FALSE(received());
+  EXPECT_TRUE(st.outOfCredit());
+  EXPECT_EQ(st.creditWaits(), 1U);
+
+  st.grantCredit(10 * size);
+  EXPECT_TRUE(received());
+  EXPECT_FALSE(st.outOfCredit());
+  EXPECT_EQ(st.creditWaits(), 2U);
+  EXPECT_GE(st.creditWaitTime(), 100000000U);
+}
+
+TEST_F(BPPSendThreadTest, DisableFlowControl)
+{
+  const uint32_t len = 1000;
+  primitiveprocessor::BPPSendThread st(0);
+  st.setProcessorPool(pool);
+
+  send(st, 2, len);
+  EXPECT_FALSE(received());
+  EXPECT_TRUE(st.outOfCredit());
+
+  // -1 from the UM, everything goes
+  st.disableFlowControl();
+  EXPECT_FALSE(st.flowControlEnabled());
+  EXPECT_FALSE(st.outOfCredit());
+  EXPECT_TRUE(received());
+  EXPECT_TRUE(received());
+}
@@ -0,0 +1,161 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ioring.h"
+
+using dbbc::IORing;
+
+const uint32_t CHUNK = 64 * 1024;
+const uint32_t CHUNKS = 8;
+
+class IORingTest : public ::testing::Test
+{
+ protected:
+  std::string fileName;
+  int fd = -1;
+
+  void SetUp() override
+  {
+    fileName = "/tmp/ioring-tests." + std::to_string(getpid());
+    fd = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    ASSERT_GE(fd, 0);
+
+    std::vector<char> chunk(CHUNK);
+
+    for (uint32_t i = 0; i < CHUNKS; i++)
+    {
+      memset(chunk.data(), 'a' + i, CHUNK);
+      ASSERT_EQ(write(fd, chunk.data(), CHUNK), (ssize_t)CHUNK);
+    }
+  }
+
+  void TearDown() override
+  {
+    close(fd);
+    unlink(fileName.c_str());
+  }
+
+  // all the reads come back once, with the data of their chunk
+  void readChunks(IORing& ring, std::vector<char*>& bufs, bool fixed)
+  {
+    for (uint32_t i = 0; i < CHUNKS; i++)
+      ASSERT_TRUE(ring.prepRead(fd, bufs[i], CHUNK, (uint64_t)i * CHUNK, i, fixed ? i : -1));
+
+    ASSERT_EQ(ring.submit(), (int)CHUNKS);
+
+    std::vector<bool> done(CHUNKS, false);
+
+    for (uint32_t n = 0; n < CHUNKS; n++)
+    {
+      uint64_t userData;
+      int32_t res;
+
+      ASSERT_TRUE(ring.wait(userData, res));
+      ASSERT_LT(userData, CHUNKS);
+      EXPECT_FALSE(done[userData]);
+      EXPECT_EQ(res, (int32_t)CHUNK);
+      EXPECT_EQ(bufs[userData][0], 'a' + (char)userData);
+      EXPECT_EQ(bufs[userData][CHUNK - 1], 'a' + (char)userData);
+      done[userData] = true;
+    }
+
+    uint64_t userData;
+    int32_t res;
+    EXPECT_FALSE(ring.reap(userData, res));
+  }
+};
+
+TEST_F(IORingTest, Reads)
+{
+  IORing ring(CHUNKS);
+
+  if (!ring.valid())
+    GTEST_SKIP() << "io_uring isn't available";
+
+  std::vector<std::vector<char>> storage(CHUNKS, std::vector<char>(CHUNK));
+  std::vector<char*> bufs;
+
+  for (auto& buf : storage)
+    bufs.push_back(buf.data());
+
+  readChunks(ring, bufs, false);
+  // the ring is reusable once the completions are taken
+  readChunks(ring, bufs, false);
+}
+
+TEST_F(IORingTest, RegisteredBuffers)
+{
+  IORing ring(CHUNKS);
+
+  if (!ring.valid())
+    GTEST_SKIP() << "io_uring isn't available";
+
+  std::vector<char*> bufs;
+  std::vector<struct iovec> iovs;
+
+  for (uint32_t i = 0; i < CHUNKS; i++)
+  {
+    void* buf = nullptr;
+    ASSERT_EQ(posix_memalign(&buf, 4096, CHUNK), 0);
+    bufs.push_back(static_cast<char*>(buf));
+    iovs.push_back({buf, CHUNK});
+  }
+
+  // reads fall back to unregistered buffers if the kernel refuses them
+  bool fixed = ring.registerBuffers(iovs.data(), iovs.size());
+  readChunks(ring, bufs, fixed);
+
+  for (auto buf : bufs)
+    free(buf);
+}
+
+TEST_F(IORingTest, QueueFullAndErrors)
+{
+  IORing ring(2);
+
+  if (!ring.valid())
+    GTEST_SKIP() << "io_uring isn't available";
+
+  std::vector<char> buf(CHUNK);
+  uint64_t userData;
+  int32_t res;
+
+  ASSERT_TRUE(ring.prepRead(-1, buf.data(), CHUNK, 0, 7));
+  ASSERT_TRUE(ring.prepRead(fd, buf.data(), CHUNK, (uint64_t)CHUNKS * CHUNK, 8));
+  EXPECT_FALSE(ring.prepRead(fd, buf.data(), CHUNK, 0, 9));
+
+  ASSERT_EQ(ring.submit(), 2);
+
+  for (int n = 0; n < 2; n++)
+  {
+    ASSERT_TRUE(ring.wait(userData, res));
+
+    if (userData == 7)
+      EXPECT_EQ(res, -EBADF);
+    else
+      EXPECT_EQ(res, 0);  // past the end of the file
+  }
+}
@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "mcs_basic_types.h"
@@ -25,6 +26,7 @@
 #include "datatypes/mcs_int128.h"
 #include "stats.h"
 #include "primitives/linux-port/primitiveprocessor.h"
+#include "simd_dispatch.h"
 #include "col1block.h"
 #include "col2block.h"
 #include "col4block.h"
@@ -120,6 +122,200 @@ class ColumnScanFilterTest : public ::testing::Test
 
     return nullptr;
   }
+
+  // The filters simdScan() applies. scalarRFs keep LT, LE, GE and GT as they are but make
+  // filterColumnData skip the vectorized kernels, so the scan goes through scalarFiltering.
+  struct SimdScanCase
+  {
+    const char* name;
+    uint16_t nops;
+    uint8_t bop;
+    uint8_t cops[2];
+    int64_t vals[2];
+    uint8_t scalarRFs[2];
+  };
+
+  struct SimdScanResult
+  {
+    uint32_t nvals;
+    uint16_t validMinMax;
+    int128_t min;
+    int128_t max;
+    std::vector<primitives::RIDType> rids;
+    std::vector<uint8_t> values;
+  };
+
+  alignas(utils::MAXCOLUMNWIDTH) uint8_t simdBlock[BLOCK_SIZE];
+  uint8_t simdAuxBlock[BLOCK_SIZE];
+
+  template <typename T>
+  static T simdNullValue()
+  {
+    using UT = typename datatypes::make_unsigned<T>::type;
+    return static_cast<T>(static_cast<UT>(1) << (8 * sizeof(T) - 1));
+  }
+
+  // Signed values in [-100, 100] with NULLs, empty values and empty AUX rows mixed in.
+  template <typename T>
+  void fillSimdBlock()
+  {
+    T* values = reinterpret_cast<T*>(simdBlock);
+    const T nullValue = simdNullValue<T>();
+
+    for (uint32_t r = 0; r < BLOCK_SIZE / sizeof(T); ++r)
+    {
+      if (r % 7 == 3)
+        values[r] = nullValue;
+      else if (r % 11 == 5)
+        values[r] = nullValue + 1;
+      else
+        values[r] = static_cast<T>((int64_t)(r * 37 % 201) - 100);
+    }
+
+    for (uint32_t r = 0; r < BLOCK_SIZE; ++r)
+      simdAuxBlock[r] = (r % 13 == 6) ? execplan::AUX_COL_EMPTYVALUE : 0;
+  }
+
+  // What the scan has to return, counted the slow way.
+  template <typename T>
+  uint32_t simdExpectedCount(const SimdScanCase& c, bool inputRids, bool aux)
+  {
+    const T* values = reinterpret_cast<const T*>(simdBlock);
+    const T nullValue = simdNullValue<T>();
+    uint32_t count = 0;
+
+    for (uint32_t r = 0; r < BLOCK_SIZE / sizeof(T); r += (inputRids ? 3 : 1))
+    {
+      if (aux ? simdAuxBlock[r] == execplan::AUX_COL_EMPTYVALUE : values[r] == nullValue + 1)
+        continue;
+
+      if (values[r] == nullValue)
+      {
+        count += (c.nops == 0);
+        continue;
+      }
+
+      bool matches = (c.nops == 0 || c.bop == BOP_AND);
+
+      for (uint32_t f = 0; f < c.nops; ++f)
+      {
+        const T v = values[r];
+        const T filterValue = static_cast<T>(c.vals[f]);
+        bool cmp = (c.cops[f] == COMPARE_LT)   ? v < filterValue
+                   : (c.cops[f] == COMPARE_LE) ? v <= filterValue
+                   : (c.cops[f] == COMPARE_GE) ? v >= filterValue
+                                               : v > filterValue;
+        matches = (c.bop == BOP_AND) ? matches && cmp : matches || cmp;
+      }
+
+      count += matches;
+    }
+
+    return count;
+  }
+
+  template <typename T>
+  SimdScanResult simdScan(const SimdScanCase& c, uint8_t outputType, bool inputRids, bool aux, bool scalar)
+  {
+    constexpr uint8_t W = sizeof(T);
+    SetUp();
+    in->colType = ColRequestHeaderDataType();
+    in->colType.DataSize = W;
+    in->colType.DataType = (W == 1)   ? SystemCatalog::TINYINT
+                           : (W == 2) ? SystemCatalog::SMALLINT
+                           : (W == 4) ? SystemCatalog::INT
+                           : (W == 8) ? SystemCatalog::BIGINT
+                                      : SystemCatalog::DECIMAL;
+    in->OutputType = outputType;
+    in->NOPS = c.nops;
+    in->BOP = c.bop;
+    in->NVALS = 0;
+    in->hasAuxCol = aux;
+
+    uint8_t* pos = in->getFilterStringPtr();
+
+    for (uint32_t f = 0; f < c.nops; ++f)
+    {
+      ColArgs* arg = reinterpret_cast<ColArgs*>(pos);
+      T tmp = static_cast<T>(c.vals[f]);
+      arg->COP = c.cops[f];
+      arg->rf = scalar ? c.scalarRFs[f] : 0;
+      memcpy(arg->val, &tmp, W);
+      pos += sizeof(ColArgs) + W;
+    }
+
+    if (inputRids)
+    {
+      uint16_t* inRids = reinterpret_cast<uint16_t*>(pos);
+
+      for (uint32_t r = 0; r < BLOCK_SIZE / W; r += 3)
+        inRids[in->NVALS++] = r;
+    }
+
+    pp.setBlockPtr(reinterpret_cast<int*>(simdBlock));
+    pp.setBlockPtrAux(aux ? reinterpret_cast<int*>(simdAuxBlock) : nullptr);
+    pp.columnScanAndFilter<T>(in, out);
+
+    SimdScanResult result;
+    result.nvals = out->NVALS;
+    result.validMinMax = out->ValidMinMax;
+    result.min = out->Min;
+    result.max = out->Max;
+
+    if (outputType & OT_RID)
+    {
+      primitives::RIDType* outRids = getRIDArrayPosition(getFirstRIDArrayPosition(out), 0);
+      result.rids.assign(outRids, outRids + out->NVALS);
+    }
+
+    if (outputType & (OT_DATAVALUE | OT_TOKEN))
+    {
+      uint8_t* outValues = getFirstValueArrayPosition(out);
+      result.values.assign(outValues, outValues + out->NVALS * W);
+    }
+
+    return result;
+  }
+
+  // Every filter, output type, RID input and AUX combination at the current SIMD level
+  // returns exactly what scalarFiltering returns.
+  template <typename T>
+  void checkSimdMatchesScalar()
+  {
+    static const SimdScanCase cases[] = {
+        {"no filter", 0, BOP_NONE, {0, 0}, {0, 0}, {0, 0}},
+        {"GE", 1, BOP_AND, {COMPARE_GE, 0}, {0, 0}, {ROUND_NEG, 0}},
+        {"GT and LT", 2, BOP_AND, {COMPARE_GT, COMPARE_LT}, {-50, 50}, {ROUND_POS, ROUND_NEG}},
+        {"LE or GE", 2, BOP_OR, {COMPARE_LE, COMPARE_GE}, {-90, 90}, {ROUND_POS, ROUND_NEG}},
+    };
+    static const uint8_t outputTypes[] = {OT_DATAVALUE, OT_RID, OT_BOTH};
+
+    fillSimdBlock<T>();
+
+    for (const SimdScanCase& c : cases)
+      for (uint8_t outputType : outputTypes)
+        for (bool inputRids : {false, true})
+          for (bool aux : {false, true})
+          {
+            SCOPED_TRACE(::testing::Message() << "width " << sizeof(T) << ", " << c.name << ", output type "
+                                              << (int)outputType << (inputRids ? ", input RIDs" : "")
+                                              << (aux ? ", AUX" : ""));
+            SimdScanResult scalar = simdScan<T>(c, outputType, inputRids, aux, true);
+            SimdScanResult vector = simdScan<T>(c, outputType, inputRids, aux, false);
+
+            ASSERT_EQ(scalar.nvals, (simdExpectedCount<T>(c, inputRids, aux)));
+            ASSERT_EQ(vector.nvals, scalar.nvals);
+            EXPECT_EQ(vector.rids, scalar.rids);
+            EXPECT_EQ(vector.values, scalar.values);
+            EXPECT_EQ(vector.validMinMax, scalar.validMinMax);
+
+            if (scalar.validMinMax)
+            {
+              EXPECT_TRUE(vector.min == scalar.min);
+              EXPECT_TRUE(vector.max == scalar.max);
+            }
+          }
+  }
 };
 
 TEST_F(ColumnScanFilterTest, ColumnScan1Byte)
@@ -1006,3 +1202,91 @@ TEST_F(ColumnScanFilterTest, ColumnScan16Bytes2CompFilters)
   EXPECT_EQ(expectedMax.getValue(), __col16block_cdf_umax);
   EXPECT_EQ(expectedMin.getValue(), __col16block_cdf_umin);
 }
+
+// Every vector width the CPU supports must produce the same results as the SSE kernels.
+TEST_F(ColumnScanFilterTest, ColumnScanAllSimdLevels)
+{
+  const simd::SimdLevel savedLevel = simd::getSimdLevel();
+  const simd::SimdLevel detectedLevel = simd::detectSimdLevel();
+
+  for (uint8_t l = 0; l <= static_cast<uint8_t>(detectedLevel); ++l)
+  {
+    const simd::SimdLevel level = static_cast<simd::SimdLevel>(l);
+    ASSERT_EQ(simd::setSimdLevel(level), level);
+    SCOPED_TRACE(simd::simdLevelName(level));
+
+    // 1 byte values, no filters.
+    {
+      using IntegralType = datatypes::WidthToSIntegralType<1>::type;
+      using UT = datatypes::make_unsigned<IntegralType>::type;
+      SetUp();
+      in->colType = ColRequestHeaderDataType();
+      in->colType.DataSize = 1;
+      in->colType.DataType = SystemCatalog::TINYINT;
+      in->OutputType = OT_DATAVALUE;
+      in->NOPS = 0;
+      in->NVALS = 0;
+
+      pp.setBlockPtr((int*)readBlockFromLiteralArray("col1block.cdf", block));
+      pp.columnScanAndFilter<IntegralType>(in, out);
+
+      UT* results = getValuesArrayPosition<UT>(getFirstValueArrayPosition(out), 0);
+      EXPECT_EQ(out->NVALS, 8160);
+      EXPECT_EQ(results[8032], 0x7F);
+      EXPECT_EQ(results[8033], 0x80);
+      for (i = 8034; i < 8160; ++i)
+        EXPECT_EQ(results[i], i % 255 + 1);
+
+      datatypes::TSInt128 expectedMax(&(out->Max));
+      datatypes::TSInt128 expectedMin(&(out->Min));
+      EXPECT_EQ(expectedMax.getValue(), __col1block_cdf_umax);
+      EXPECT_EQ(expectedMin.getValue(), __col1block_cdf_umin);
+    }
+
+    // 4 byte values, two filters.
+    {
+      using IntegralType = datatypes::WidthToSIntegralType<4>::type;
+      using UT = datatypes::make_unsigned<IntegralType>::type;
+      IntegralType tmp;
+      SetUp();
+      in->colType = ColRequestHeaderDataType();
+      in->colType.DataSize = 4;
+      in->colType.DataType = SystemCatalog::INT;
+      in->OutputType = OT_DATAVALUE;
+      in->NOPS = 2;
+      in->BOP = BOP_AND;
+      in->NVALS = 0;
+
+      tmp = 20;
+      args->COP = COMPARE_LT;
+      memcpy(args->val, &tmp, in->colType.DataSize);
+      args = reinterpret_cast<ColArgs*>(
+          &input[sizeof(NewColRequestHeader) + sizeof(ColArgs) + in->colType.DataSize]);
+      args->COP = COMPARE_GT;
+      tmp = 10;
+      memcpy(args->val, &tmp, in->colType.DataSize);
+
+      pp.setBlockPtr((int*)readBlockFromLiteralArray("col4block.cdf", block));
+      pp.columnScanAndFilter<IntegralType>(in, out);
+
+      UT* results = getValuesArrayPosition<UT>(getFirstValueArrayPosition(out), 0);
+      ASSERT_EQ(out->NVALS, 9);
+      for (i = 0; i < out->NVALS; i++)
+        EXPECT_EQ(results[i], 11 + (uint32_t)i);
+
+      datatypes::TSInt128 expectedMax(&(out->Max));
+      datatypes::TSInt128 expectedMin(&(out->Min));
+      EXPECT_EQ(expectedMax.getValue(), __col4block_cdf_umax);
+      EXPECT_EQ(expectedMin.getValue(), __col4block_cdf_umin);
+    }
+
+    // Every width against scalarFiltering, 16 bytes is scalar at every level.
+    checkSimdMatchesScalar<int8_t>();
+    checkSimdMatchesScalar<int16_t>();
+    checkSimdMatchesScalar<int32_t>();
+    checkSimdMatchesScalar<int64_t>();
+    checkSimdMatchesScalar<int128_t>();
+  }
+
+  simd::setSimdLevel(savedLevel);
+}
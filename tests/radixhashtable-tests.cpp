@@ -0,0 +1,124 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "radixhashtable.h"
+
+using joiner::RadixHashTable;
+typedef RadixHashTable<uint64_t> Table;
+
+// every key i gets i % 4 + 1 values
+static std::vector<Table::value_type> makeEntries(int64_t keyCount)
+{
+  std::vector<Table::value_type> entries;
+
+  for (int64_t i = 0; i < keyCount; i++)
+    for (int64_t j = 0; j <= i % 4; j++)
+      entries.emplace_back(i * 31 - keyCount, i * 10 + j);
+
+  // mix the keys up so the values of a key aren't inserted together
+  std::reverse(entries.begin(), entries.begin() + entries.size() / 2);
+  return entries;
+}
+
+static void checkTable(const Table& table, int64_t keyCount)
+{
+  std::vector<uint64_t> matches;
+
+  for (int64_t i = 0; i < keyCount; i++)
+  {
+    matches.clear();
+    ASSERT_EQ(table.find(i * 31 - keyCount, matches), (uint32_t)(i % 4 + 1));
+    std::sort(matches.begin(), matches.end());
+
+    for (int64_t j = 0; j <= i % 4; j++)
+      EXPECT_EQ(matches[j], (uint64_t)(i * 10 + j));
+  }
+
+  matches.clear();
+  EXPECT_EQ(table.find(keyCount * 31, matches), 0U);
+  EXPECT_EQ(table.find(-keyCount - 1, matches), 0U);
+  EXPECT_TRUE(matches.empty());
+}
+
+TEST(RadixHashTableTest, SinglePartition)
+{
+  std::vector<Table::value_type> entries = makeEntries(1000);
+  size_t entryCount = entries.size();
+  Table table(entries, 1024 * 1024);
+
+  EXPECT_TRUE(entries.empty());
+  EXPECT_EQ(table.size(), entryCount);
+  EXPECT_EQ(table.getPartitionCount(), 1U);
+  checkTable(table, 1000);
+}
+
+TEST(RadixHashTableTest, ManyPartitions)
+{
+  std::vector<Table::value_type> entries = makeEntries(100000);
+  size_t entryCount = entries.size();
+  Table table(entries, 16 * 1024);
+
+  EXPECT_EQ(table.size(), entryCount);
+  EXPECT_GT(table.getPartitionCount(), 64U);
+  checkTable(table, 100000);
+}
+
+TEST(RadixHashTableTest, BuildMemUsage)
+{
+  for (int64_t keyCount : {0, 10, 100000})
+  {
+    std::vector<Table::value_type> entries = makeEntries(keyCount);
+    size_t entryCount = entries.size();
+    Table table(entries, 16 * 1024);
+
+    // the estimate covers the entries, which are gone now, and the table
+    EXPECT_GE(Table::buildMemUsage(entryCount),
+              entryCount * sizeof(Table::value_type) + table.getMemUsage()) << keyCount;
+  }
+}
+
+TEST(RadixHashTableTest, FullScan)
+{
+  std::vector<Table::value_type> entries = makeEntries(5000);
+  std::vector<uint64_t> expected, values;
+
+  for (auto& entry : entries)
+    expected.push_back(entry.second);
+
+  Table table(entries, 4096);
+
+  for (size_t i = 0; i < table.size(); i++)
+    values.push_back(table.at(i));
+
+  std::sort(expected.begin(), expected.end());
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values, expected);
+}
+
+TEST(RadixHashTableTest, Empty)
+{
+  std::vector<Table::value_type> entries;
+  std::vector<uint64_t> matches;
+  Table table(entries, 4096);
+
+  EXPECT_EQ(table.size(), 0U);
+  EXPECT_EQ(table.find(0, matches), 0U);
+}
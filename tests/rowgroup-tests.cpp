@@ -17,11 +17,17 @@
 
 #include <gtest/gtest.h>  // googletest header file
 #include <iostream>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "rowgroup.h"
+#include "columnar.h"
+#include "rowaggregation.h"
 #include "columnwidth.h"
 #include "joblisttypes.h"
 #include "dataconvert.h"
+#include "inetstreamsocket.h"
+#include "compressed_iss.h"
 
 #define WIDE_DEC_PRECISION 38U
 #define INITIAL_ROW_OFFSET 2
@@ -317,3 +323,552 @@ TEST_F(RowDecimalTest, RowEqualsCheck)
     }
   }
 }
+
+const uint32_t ROWS = 100;
+
+class ColumnarRGDataTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    std::vector<CSCDataType> types{execplan::CalpontSystemCatalog::INT, execplan::CalpontSystemCatalog::UTINYINT,
+                                   execplan::CalpontSystemCatalog::BIGINT, execplan::CalpontSystemCatalog::DATE};
+    std::vector<uint32_t> widths{4, 1, 8, 4};
+    std::vector<uint32_t> offsets{INITIAL_ROW_OFFSET};
+    std::vector<uint32_t> roids, tkeys, cscale, precision, charSetNumVec;
+
+    for (size_t i = 0; i < types.size(); i++)
+    {
+      offsets.push_back(offsets.back() + widths[i]);
+      roids.push_back(3001 + i);
+      tkeys.push_back(i + 1);
+      cscale.push_back(0);
+      precision.push_back(10);
+      charSetNumVec.push_back(8);
+    }
+
+    rg = rgOut = rowgroup::RowGroup(roids.size(), offsets, roids, tkeys, types, charSetNumVec, cscale,
+                                    precision, 20, false);
+    rgD.reinit(rg);
+    rgDOut.reinit(rgOut);
+    rg.setData(&rgD);
+    rgOut.setData(&rgDOut);
+    rg.resetRowGroup(0x1234);
+
+    rowgroup::Row r;
+    rg.initRow(&r);
+    rg.getRow(0, &r);
+
+    for (uint32_t i = 0; i < ROWS; i++, r.nextRow())
+    {
+      r.setRid(i * 2);
+      r.setIntField<4>(i % 7 == 0 ? joblist::INTNULL : (int32_t)i - 50, 0);
+      r.setUintField<1>(i % 5 == 0 ? joblist::UTINYINTNULL : i, 1);
+      r.setIntField<8>((int64_t)i << 40, 2);
+      r.setUintField<4>(joblist::DATENULL, 3);
+    }
+
+    rg.setRowCount(ROWS);
+  }
+
+  rowgroup::RowGroup rg, rgOut;
+  rowgroup::RGData rgD, rgDOut;
+};
+
+TEST_F(ColumnarRGDataTest, ColumnsAndNulls)
+{
+  rowgroup::ColumnarRGData cols(rg);
+
+  ASSERT_EQ(cols.getRowCount(), ROWS);
+  ASSERT_EQ(cols.getColumnCount(), 4U);
+  EXPECT_EQ(cols.getBaseRid(), 0x1234U);
+  EXPECT_EQ(cols.getColumnWidth(0), 4U);
+  EXPECT_EQ(cols.getColumnWidth(1), 1U);
+  EXPECT_EQ(cols.getColumnWidth(2), 8U);
+
+  const int32_t* ints = cols.getColumn<int32_t>(0);
+  const uint8_t* utinys = cols.getColumn<uint8_t>(1);
+  const int64_t* bigints = cols.getColumn<int64_t>(2);
+
+  for (uint32_t i = 0; i < ROWS; i++)
+  {
+    EXPECT_EQ(cols.isNull(0, i), i % 7 == 0);
+    EXPECT_EQ(cols.isNull(1, i), i % 5 == 0);
+    EXPECT_FALSE(cols.isNull(2, i));
+    EXPECT_TRUE(cols.isNull(3, i));
+    EXPECT_EQ(cols.getRids()[i], i * 2);
+
+    if (i % 7 != 0)
+    {
+      EXPECT_EQ(ints[i], (int32_t)i - 50);
+    }
+    if (i % 5 != 0)
+    {
+      EXPECT_EQ(utinys[i], i);
+    }
+    EXPECT_EQ(bigints[i], (int64_t)i << 40);
+  }
+
+  EXPECT_EQ(cols.getNullCount(0), 15U);
+  EXPECT_EQ(cols.getNullCount(1), 20U);
+  EXPECT_EQ(cols.getNullCount(2), 0U);
+  EXPECT_EQ(cols.getNullCount(3), ROWS);
+}
+
+TEST_F(ColumnarRGDataTest, SomeColumns)
+{
+  std::vector<uint32_t> some{2};
+  rowgroup::ColumnarRGData cols(rg, &some);
+
+  EXPECT_FALSE(cols.hasColumn(0));
+  EXPECT_FALSE(cols.hasColumn(1));
+  EXPECT_TRUE(cols.hasColumn(2));
+  EXPECT_FALSE(cols.hasColumn(3));
+  EXPECT_EQ(cols.getColumn<int64_t>(2)[ROWS - 1], (int64_t)(ROWS - 1) << 40);
+}
+
+TEST_F(ColumnarRGDataTest, BackToRows)
+{
+  rowgroup::ColumnarRGData cols(rg);
+  cols.toRows(rgOut);
+
+  ASSERT_EQ(rgOut.getRowCount(), ROWS);
+  EXPECT_EQ(rgOut.getBaseRid(), 0x1234U);
+
+  rowgroup::Row r, rOut;
+  rg.initRow(&r);
+  rgOut.initRow(&rOut);
+  rg.getRow(0, &r);
+  rgOut.getRow(0, &rOut);
+
+  for (uint32_t i = 0; i < ROWS; i++, r.nextRow(), rOut.nextRow())
+  {
+    EXPECT_EQ(rOut.getRelRid(), r.getRelRid());
+    EXPECT_TRUE(r.equals(rOut));
+  }
+}
+
+TEST_F(ColumnarRGDataTest, Refill)
+{
+  rowgroup::ColumnarRGData cols(rg);
+  std::vector<uint32_t> some{0};
+
+  rg.setRowCount(ROWS / 2);
+  cols.fromRows(rg, &some);
+
+  ASSERT_EQ(cols.getRowCount(), ROWS / 2);
+  EXPECT_TRUE(cols.hasColumn(0));
+  EXPECT_FALSE(cols.hasColumn(1));
+  EXPECT_FALSE(cols.hasColumn(3));
+  EXPECT_EQ(cols.getNullCount(0), 8U);
+
+  for (uint32_t i = 0; i < ROWS / 2; i++)
+  {
+    EXPECT_EQ(cols.isNull(0, i), i % 7 == 0);
+    EXPECT_EQ(cols.getRids()[i], i * 2);
+  }
+}
+
+// aggregateColumns() off, every RowGroup goes through aggregateRow()
+class RowPathAggregation : public rowgroup::RowAggregation
+{
+ public:
+  using rowgroup::RowAggregation::RowAggregation;
+
+ protected:
+  bool aggregateColumns(const rowgroup::RowGroup*) override
+  {
+    return false;
+  }
+};
+
+TEST_F(ColumnarRGDataTest, AggregateColumns)
+{
+  using namespace rowgroup;
+
+  std::vector<CSCDataType> types{execplan::CalpontSystemCatalog::UBIGINT, execplan::CalpontSystemCatalog::UBIGINT,
+                                 execplan::CalpontSystemCatalog::INT,     execplan::CalpontSystemCatalog::INT,
+                                 execplan::CalpontSystemCatalog::UTINYINT, execplan::CalpontSystemCatalog::UTINYINT,
+                                 execplan::CalpontSystemCatalog::BIGINT,  execplan::CalpontSystemCatalog::BIGINT,
+                                 execplan::CalpontSystemCatalog::DATE,    execplan::CalpontSystemCatalog::UBIGINT};
+  std::vector<uint32_t> widths{8, 8, 4, 4, 1, 1, 8, 8, 4, 8};
+  std::vector<uint32_t> offsets{INITIAL_ROW_OFFSET};
+  std::vector<uint32_t> roids, tkeys, cscale, precision, charSetNumVec;
+
+  for (size_t i = 0; i < types.size(); i++)
+  {
+    offsets.push_back(offsets.back() + widths[i]);
+    roids.push_back(4001 + i);
+    tkeys.push_back(i + 1);
+    cscale.push_back(0);
+    precision.push_back(10);
+    charSetNumVec.push_back(8);
+  }
+
+  // COUNT(*), COUNT(c0), MIN and MAX of c0..c2, MIN(c3) and COUNT(c3) of the all NULL column
+  std::vector<SP_ROWAGG_FUNC_t> funcs{
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_COUNT_ASTERISK, ROWAGG_FUNCT_UNDEFINE, 0, 0)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_COUNT_COL_NAME, ROWAGG_FUNCT_UNDEFINE, 0, 1)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MIN, ROWAGG_FUNCT_UNDEFINE, 0, 2)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MAX, ROWAGG_FUNCT_UNDEFINE, 0, 3)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MIN, ROWAGG_FUNCT_UNDEFINE, 1, 4)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MAX, ROWAGG_FUNCT_UNDEFINE, 1, 5)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MIN, ROWAGG_FUNCT_UNDEFINE, 2, 6)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MAX, ROWAGG_FUNCT_UNDEFINE, 2, 7)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_MIN, ROWAGG_FUNCT_UNDEFINE, 3, 8)),
+      SP_ROWAGG_FUNC_t(new RowAggFunctionCol(ROWAGG_COUNT_COL_NAME, ROWAGG_FUNCT_UNDEFINE, 3, 9))};
+  std::vector<SP_ROWAGG_GRPBY_t> groupBy;
+
+  RowGroup aggOut(roids.size(), offsets, roids, tkeys, types, charSetNumVec, cscale, precision, 20, false);
+  RowGroup rowOut = aggOut;
+  RGData aggOutData(aggOut, 1), rowOutData(rowOut, 1);
+  aggOut.setData(&aggOutData);
+  rowOut.setData(&rowOutData);
+  aggOut.resetRowGroup(0);
+  rowOut.resetRowGroup(0);
+
+  RowAggregation columnAgg(groupBy, funcs);
+  RowPathAggregation rowAgg(groupBy, funcs);
+  columnAgg.setInputOutput(rg, &aggOut);
+  rowAgg.setInputOutput(rg, &rowOut);
+
+  // the whole RowGroup, then a part of it into the same buffers
+  for (uint32_t rows : {ROWS, ROWS / 3})
+  {
+    rg.setRowCount(rows);
+    columnAgg.addRowGroup(&rg);
+    rowAgg.addRowGroup(&rg);
+  }
+
+  Row aggRow, rowRow;
+  aggOut.initRow(&aggRow);
+  rowOut.initRow(&rowRow);
+  aggOut.getRow(0, &aggRow);
+  rowOut.getRow(0, &rowRow);
+
+  EXPECT_EQ(aggRow.getUintField<8>(0), ROWS + ROWS / 3);
+  EXPECT_EQ(aggRow.getIntField<4>(2), -49);
+  EXPECT_TRUE(aggRow.isNullValue(8));
+  EXPECT_EQ(aggRow.getUintField<8>(9), 0U);
+
+  for (uint32_t col = 0; col < types.size(); col++)
+  {
+    EXPECT_EQ(aggRow.isNullValue(col), rowRow.isNullValue(col)) << "column " << col;
+    EXPECT_EQ(aggRow.getUintField(col), rowRow.getUintField(col)) << "column " << col;
+  }
+}
+
+const uint32_t BYREF_ROWS = 500;
+
+class RGDataByRefTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    std::vector<CSCDataType> types{execplan::CalpontSystemCatalog::INT,
+                                   execplan::CalpontSystemCatalog::VARCHAR};
+    std::vector<uint32_t> offsets{INITIAL_ROW_OFFSET, INITIAL_ROW_OFFSET + 4, INITIAL_ROW_OFFSET + 4 + 100};
+    std::vector<uint32_t> roids{3001, 3002}, tkeys{1, 2}, cscale{0, 0}, precision{10, 10},
+        charSetNumVec{8, 8};
+
+    // the strings go to the string table
+    rg = rowgroup::RowGroup(2, offsets, roids, tkeys, types, charSetNumVec, cscale, precision, 20, true);
+    rgD.reinit(rg);
+    rg.setData(&rgD);
+    rg.resetRowGroup(0x5678);
+
+    rowgroup::Row r;
+    rg.initRow(&r);
+    rg.getRow(0, &r);
+
+    for (uint32_t i = 0; i < BYREF_ROWS; i++, r.nextRow())
+    {
+      r.setIntField<4>(i, 0);
+      r.setStringField(value(i), 1);
+    }
+
+    rg.setRowCount(BYREF_ROWS);
+  }
+
+  static std::string value(uint32_t i)
+  {
+    return std::string(30 + i % 50, 'a' + i % 26);
+  }
+
+  void checkRows(rowgroup::RGData& data)
+  {
+    rowgroup::RowGroup out(rg);
+    rowgroup::Row r;
+    out.setData(&data);
+    out.initRow(&r);
+    out.getRow(0, &r);
+
+    ASSERT_EQ(out.getRowCount(), BYREF_ROWS);
+    EXPECT_EQ(out.getBaseRid(), 0x5678U);
+
+    for (uint32_t i = 0; i < BYREF_ROWS; i++, r.nextRow())
+    {
+      EXPECT_EQ(r.getIntField<4>(0), (int64_t)i);
+      EXPECT_EQ(r.getStringField(1), value(i));
+    }
+  }
+
+  rowgroup::RowGroup rg;
+  rowgroup::RGData rgD;
+};
+
+TEST_F(RGDataByRefTest, KeepsTheBuffers)
+{
+  messageqcpp::ByteStream bs;
+  rg.serializeRGData(bs, true);
+
+  // only the framing is copied, the row data and the strings are attached
+  EXPECT_GE(bs.getAttachments().size(), 2U);
+  EXPECT_LT(bs.length(), 100U);
+
+  rowgroup::RGData out;
+  out.deserialize(bs, true);
+  EXPECT_EQ(out.rowData.get(), rgD.rowData.get());
+  EXPECT_EQ(bs.length(), 0U);
+  checkRows(out);
+}
+
+TEST_F(RGDataByRefTest, Flatten)
+{
+  messageqcpp::ByteStream bs, plain;
+  rg.serializeRGData(bs, true);
+  rg.serializeRGData(plain);
+
+  bs.flatten();
+  EXPECT_FALSE(bs.hasAttachments());
+  EXPECT_TRUE(bs == plain);
+
+  rowgroup::RGData out;
+  out.deserialize(bs, true);
+  EXPECT_NE(out.rowData.get(), rgD.rowData.get());
+  checkRows(out);
+}
+
+TEST_F(RGDataByRefTest, CopyAndNest)
+{
+  messageqcpp::ByteStream bs, outer, inner;
+  uint32_t tmp;
+
+  bs << (uint32_t)7;
+  rg.serializeRGData(bs, true);
+  bs << (uint32_t)9;
+
+  // a copy references the same buffers, nesting copies them in
+  messageqcpp::ByteStream copy(bs);
+  EXPECT_TRUE(copy == bs);
+  outer << bs;
+  EXPECT_FALSE(outer.hasAttachments());
+  outer >> inner;
+
+  for (auto* in : {&copy, &inner})
+  {
+    rowgroup::RGData out;
+    *in >> tmp;
+    EXPECT_EQ(tmp, 7U);
+    out.deserialize(*in, true);
+    *in >> tmp;
+    EXPECT_EQ(tmp, 9U);
+    checkRows(out);
+  }
+}
+
+TEST_F(RGDataByRefTest, Socket)
+{
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  messageqcpp::InetStreamSocket writer, reader;
+  messageqcpp::SocketParms parms;
+  parms.sd(fds[0]);
+  writer.socketParms(parms);
+  parms.sd(fds[1]);
+  reader.socketParms(parms);
+
+  messageqcpp::ByteStream bs;
+  bs << (uint8_t)1;
+  rg.serializeRGData(bs, true);
+  bs << (uint8_t)2;
+  writer.write(bs);
+
+  messageqcpp::SBS in = reader.read();
+  uint8_t tmp8;
+  rowgroup::RGData out;
+
+  *in >> tmp8;
+  EXPECT_EQ(tmp8, 1);
+  out.deserialize(*in, true);
+  *in >> tmp8;
+  EXPECT_EQ(tmp8, 2);
+  EXPECT_TRUE(in->empty());
+  checkRows(out);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// sets what Columnstore.xml sets, and reaches the attachment encoding
+class CompressedSocketTest
+{
+ public:
+  static void adaptive(messageqcpp::CompressedInetStreamSocket& socket)
+  {
+    socket.useCompression = true;
+    socket.adaptive = true;
+    socket.alg.reset(new compress::CompressInterfaceLZ4());
+  }
+
+  static void compressAttached(const messageqcpp::CompressedInetStreamSocket& socket,
+                               const messageqcpp::ByteStream& msg, messageqcpp::ByteStream& smsg)
+  {
+    socket.compressAttached(msg, smsg);
+  }
+
+  static messageqcpp::SBS uncompressAttached(const messageqcpp::CompressedInetStreamSocket& socket,
+                                             messageqcpp::ByteStream& msg)
+  {
+    return socket.uncompressAttached(msg);
+  }
+};
+
+TEST_F(RGDataByRefTest, CompressedAttachments)
+{
+  messageqcpp::CompressedInetStreamSocket socket;
+  CompressedSocketTest::adaptive(socket);
+
+  // bytes the codec can't make smaller
+  const uint32_t NOISE = 4096;
+  boost::shared_array<uint8_t> noise(new uint8_t[NOISE]);
+  uint64_t x = 88172645463325252ULL;
+
+  for (uint32_t i = 0; i < NOISE; i++)
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    noise[i] = (uint8_t)x;
+  }
+
+  messageqcpp::ByteStream bs, smsg;
+  bs << (uint8_t)1;
+  rg.serializeRGData(bs, true);
+  bs.attach(noise, NOISE);
+  bs << (uint8_t)2;
+
+  CompressedSocketTest::compressAttached(socket, bs, smsg);
+
+  std::vector<messageqcpp::ByteStream::Attachment> attachments = bs.getAttachments();
+  std::vector<messageqcpp::ByteStream::Attachment> payloads = smsg.getAttachments();
+  ASSERT_EQ(payloads.size(), attachments.size());
+
+  // the rows go through RowEncoding and the codec, the noise is sent as it is
+  for (size_t i = 0; i < attachments.size(); i++)
+  {
+    if (attachments[i].rowLayout)
+    {
+      EXPECT_LT(payloads[i].length, attachments[i].length / 2);
+    }
+  }
+
+  EXPECT_EQ(payloads.back().data.get(), noise.get());
+  EXPECT_EQ(payloads.back().length, NOISE);
+
+  messageqcpp::SBS in = CompressedSocketTest::uncompressAttached(socket, smsg);
+  uint8_t tmp8;
+  uint32_t len;
+  rowgroup::RGData out;
+
+  *in >> tmp8;
+  EXPECT_EQ(tmp8, 1);
+  out.deserialize(*in, true);
+  boost::shared_array<uint8_t> noiseOut = in->takeAttachment(len);
+  ASSERT_EQ(len, NOISE);
+  EXPECT_EQ(memcmp(noiseOut.get(), noise.get(), NOISE), 0);
+  *in >> tmp8;
+  EXPECT_EQ(tmp8, 2);
+  EXPECT_TRUE(in->empty());
+  checkRows(out);
+}
+
+TEST_F(RGDataByRefTest, CompressedSocket)
+{
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  messageqcpp::CompressedInetStreamSocket writer, reader;
+  messageqcpp::SocketParms parms;
+  CompressedSocketTest::adaptive(writer);
+  CompressedSocketTest::adaptive(reader);
+  parms.sd(fds[0]);
+  writer.socketParms(parms);
+  parms.sd(fds[1]);
+  reader.socketParms(parms);
+
+  // nothing is measured yet, the first message is compressed
+  messageqcpp::ByteStream bs;
+  bs << (uint8_t)1;
+  rg.serializeRGData(bs, true);
+  bs << (uint8_t)2;
+  writer.write(bs);
+
+  messageqcpp::SBS in = reader.read();
+  uint8_t tmp8;
+  rowgroup::RGData out;
+
+  *in >> tmp8;
+  EXPECT_EQ(tmp8, 1);
+  out.deserialize(*in, true);
+  *in >> tmp8;
+  EXPECT_EQ(tmp8, 2);
+  EXPECT_TRUE(in->empty());
+  checkRows(out);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST(CompressionAdvisorTest, Decision)
+{
+  using messageqcpp::CompressionAdvisor;
+  const size_t timed = CompressionAdvisor::MIN_TIMED_WRITE;
+
+  // compresses until both the codec and the wire are measured
+  CompressionAdvisor slowWire;
+  EXPECT_TRUE(slowWire.compress());
+  slowWire.compressed(1000000, 500000, 1000000);
+  EXPECT_TRUE(slowWire.compress());
+  // too short to time the network
+  slowWire.sent(timed - 1, 1);
+  EXPECT_TRUE(slowWire.compress());
+
+  // half the size at 1 byte/ns, the wire takes 0.1 byte/ns: 5ns saved per byte for 1ns in the codec
+  slowWire.sent(timed, timed * 10);
+
+  for (uint32_t i = 0; i < 2 * CompressionAdvisor::PROBE_INTERVAL; i++)
+    EXPECT_TRUE(slowWire.compress());
+
+  // the wire takes 10 bytes/ns, 0.05ns saved per byte for 1ns in the codec
+  CompressionAdvisor fastWire;
+  fastWire.compressed(1000000, 500000, 1000000);
+  fastWire.sent(timed, timed / 10);
+
+  // data the codec doesn't shrink
+  CompressionAdvisor incompressible;
+  incompressible.compressed(1000000, 1000000, 1000);
+  incompressible.sent(timed, timed * 10);
+
+  for (CompressionAdvisor* advisor : {&fastWire, &incompressible})
+  {
+    uint32_t compressed = 0;
+
+    for (uint32_t i = 0; i < 2 * CompressionAdvisor::PROBE_INTERVAL; i++)
+      compressed += advisor->compress();
+
+    // only the probes
+    EXPECT_EQ(compressed, 2U);
+  }
+}
@@ -0,0 +1,96 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <limits>
+
+#include "runtimefilter.h"
+
+using joiner::RuntimeFilter;
+
+TEST(RuntimeFilterTest, NoFalseNegatives)
+{
+  RuntimeFilter filter(10000, 1024 * 1024);
+
+  for (int64_t i = 0; i < 10000; i++)
+    filter.insert(i * 7 - 30000);
+
+  EXPECT_TRUE(filter.hasBloomFilter());
+  EXPECT_EQ(filter.getKeyCount(), 10000U);
+
+  for (int64_t i = 0; i < 10000; i++)
+    EXPECT_TRUE(filter.mayContain(i * 7 - 30000));
+}
+
+TEST(RuntimeFilterTest, FalsePositiveRate)
+{
+  RuntimeFilter filter(10000, 1024 * 1024);
+  uint32_t falsePositives = 0;
+
+  for (int64_t i = 0; i < 10000; i++)
+    filter.insert(i * 2);
+
+  // the odd numbers are in the min/max range but not in the filter
+  for (int64_t i = 0; i < 10000; i++)
+    if (filter.mayContain(i * 2 + 1))
+      falsePositives++;
+
+  EXPECT_LT(falsePositives, 500U);
+}
+
+TEST(RuntimeFilterTest, MinMaxOnly)
+{
+  RuntimeFilter filter(1000000, 1024);
+
+  filter.insert(-5);
+  filter.insert(100);
+
+  EXPECT_FALSE(filter.hasBloomFilter());
+  EXPECT_TRUE(filter.mayContain(-5));
+  EXPECT_TRUE(filter.mayContain(50));
+  EXPECT_TRUE(filter.mayContain(100));
+  EXPECT_FALSE(filter.mayContain(-6));
+  EXPECT_FALSE(filter.mayContain(101));
+}
+
+TEST(RuntimeFilterTest, Empty)
+{
+  RuntimeFilter filter(0, 1024);
+
+  EXPECT_FALSE(filter.mayContain(0));
+  EXPECT_FALSE(filter.mayContain(std::numeric_limits<int64_t>::min()));
+  EXPECT_FALSE(filter.mayContain(std::numeric_limits<int64_t>::max()));
+}
+
+TEST(RuntimeFilterTest, Serialize)
+{
+  RuntimeFilter filter(1000, 1024 * 1024), copy;
+  messageqcpp::ByteStream bs;
+
+  for (int64_t i = 0; i < 1000; i++)
+    filter.insert(i * 1000003);
+
+  filter.serialize(bs);
+  copy.deserialize(bs);
+
+  EXPECT_EQ(bs.length(), 0U);
+  EXPECT_EQ(copy.getKeyCount(), filter.getKeyCount());
+  EXPECT_EQ(copy.getSize(), filter.getSize());
+
+  for (int64_t i = -1000; i < 2000000; i += 7)
+    EXPECT_EQ(copy.mayContain(i), filter.mayContain(i));
+}
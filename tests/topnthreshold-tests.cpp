@@ -0,0 +1,92 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "topnthreshold.h"
+
+using joblist::TopNThreshold;
+
+TEST(TopNThresholdTest, Desc)
+{
+  TopNThreshold threshold(false, false);
+
+  // nothing is ruled out before the first cutoff
+  EXPECT_FALSE(threshold.excludes(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min()));
+
+  threshold.update(100);
+  EXPECT_TRUE(threshold.excludes(-50, 99));
+  EXPECT_FALSE(threshold.excludes(-50, 100));
+  EXPECT_FALSE(threshold.excludes(150, 200));
+
+  // the cutoff never gets looser
+  threshold.update(50);
+  EXPECT_EQ(threshold.getCutoff(), 100);
+  threshold.update(120);
+  EXPECT_TRUE(threshold.excludes(0, 110));
+}
+
+TEST(TopNThresholdTest, Asc)
+{
+  TopNThreshold threshold(true, false);
+
+  EXPECT_FALSE(threshold.excludes(std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max()));
+
+  threshold.update(-10);
+  EXPECT_TRUE(threshold.excludes(-9, 1000));
+  EXPECT_FALSE(threshold.excludes(-10, 1000));
+  EXPECT_TRUE(threshold.better(-20, -10));
+}
+
+TEST(TopNThresholdTest, Unsigned)
+{
+  TopNThreshold desc(false, true), asc(true, true);
+  const int64_t big = (int64_t)0x8000000000000000ULL;
+
+  EXPECT_FALSE(desc.excludes(0, 0));
+  EXPECT_FALSE(asc.excludes(-1, -1));
+
+  // values past INT64_MAX are large, not negative
+  desc.update(big);
+  EXPECT_TRUE(desc.excludes(0, 1000));
+  EXPECT_FALSE(desc.excludes(0, -1));
+
+  asc.update(1000);
+  EXPECT_TRUE(asc.excludes(big, -1));
+  EXPECT_FALSE(asc.excludes(5, big));
+}
+
+TEST(TopNThresholdTest, ConcurrentUpdates)
+{
+  TopNThreshold threshold(false, false);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back(
+        [&threshold, t]
+        {
+          for (int64_t i = 0; i < 100000; i++)
+            threshold.update(i * 4 + t);
+        });
+
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(threshold.getCutoff(), 99999 * 4 + 3);
+}
@@ -241,6 +241,18 @@ struct StorageToFiltering<T, KIND, typename std::enable_if<KIND != KIND_FLOAT>::
 template <typename VT, typename T, typename ENABLE = void>
 class SimdFilterProcessor;
 
+// Maps a column storage type onto the filter processor of the given vector width.
+// NEON has 128 bit vectors only.
+template <typename T, ENUM_KIND KIND, uint16_t VEC_BIT_SIZE>
+struct SimdFilterProcessorOfWidth;
+
+template <typename T, ENUM_KIND KIND>
+struct SimdFilterProcessorOfWidth<T, KIND, 128U>
+{
+  using type = SimdFilterProcessor<typename IntegralToSIMD<T, KIND>::type,
+                                   typename StorageToFiltering<T, KIND>::type>;
+};
+
 // Dummy class that captures all impossible cases, e.g. integer vector as VT and flot as CHECK_T.we use
 // int32_t to do operations
 template <typename VT, typename CHECK_T>
@@ -0,0 +1,968 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+// 256 bit (AVX2) and 512 bit (AVX-512 F/BW/DQ/VL) SimdFilterProcessor families.
+// They mirror the 128 bit processors from simd_sse.h so the column filtering templates
+// can be instantiated with any of them. Masks are vectors with all bits of a lane set
+// for every matching value just as SSE compare results are. AVX-512 compare results
+// are expanded from k-registers into such vectors.
+//
+// The baseline build targets SSE4.2 only. Include this header from translation units that
+// enable the AVX2/AVX-512 target with a pragma for the code that follows the include, e.g.
+// column_avx2.cpp, and call the code built there only when simd::getSimdLevel() allows it.
+
+#if defined(__x86_64__)
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <immintrin.h>
+
+#include "simd_sse.h"
+
+namespace simd
+{
+using vi256_t = __m256i;
+using vi256f_t = __m256;
+using vi256d_t = __m256d;
+using vi512_t = __m512i;
+using vi512f_t = __m512;
+using vi512d_t = __m512d;
+
+// The same wrappers as 128 bit ones to use the vector types as template class parameter arguments.
+// GCC doesn't see the vector alignment of __m256i/__m512i declared under a target pragma when it
+// picks operator new, the explicit alignas makes std::vector of wrappers allocate aligned storage.
+struct alignas(32) vi256_wr
+{
+  __m256i v;
+};
+
+struct alignas(32) vi256f_wr
+{
+  __m256 v;
+};
+
+struct alignas(32) vi256d_wr
+{
+  __m256d v;
+};
+
+struct alignas(64) vi512_wr
+{
+  __m512i v;
+};
+
+struct alignas(64) vi512f_wr
+{
+  __m512 v;
+};
+
+struct alignas(64) vi512d_wr
+{
+  __m512d v;
+};
+
+template <typename T, ENUM_KIND KIND, typename ENABLE = void>
+struct IntegralToSIMD256;
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD256<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(double) == sizeof(T)>::type>
+{
+  using type = vi256d_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD256<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(float) == sizeof(T)>::type>
+{
+  using type = vi256f_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD256<T, KIND, typename std::enable_if<KIND != KIND_FLOAT>::type>
+{
+  using type = vi256_wr;
+};
+
+template <typename T, ENUM_KIND KIND, typename ENABLE = void>
+struct IntegralToSIMD512;
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD512<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(double) == sizeof(T)>::type>
+{
+  using type = vi512d_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD512<T, KIND,
+                         typename std::enable_if<KIND == KIND_FLOAT && sizeof(float) == sizeof(T)>::type>
+{
+  using type = vi512f_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct IntegralToSIMD512<T, KIND, typename std::enable_if<KIND != KIND_FLOAT>::type>
+{
+  using type = vi512_wr;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct SimdFilterProcessorOfWidth<T, KIND, 256U>
+{
+  using type = SimdFilterProcessor<typename IntegralToSIMD256<T, KIND>::type,
+                                   typename StorageToFiltering<T, KIND>::type>;
+};
+
+template <typename T, ENUM_KIND KIND>
+struct SimdFilterProcessorOfWidth<T, KIND, 512U>
+{
+  using type = SimdFilterProcessor<typename IntegralToSIMD512<T, KIND>::type,
+                                   typename StorageToFiltering<T, KIND>::type>;
+};
+
+// std::conditional drops the alignment attributes of the vector types so map them explicitly.
+template <typename T, uint16_t VEC_BIT_SIZE>
+struct FloatingSimdType;
+
+template <>
+struct FloatingSimdType<float, 256U>
+{
+  using type = vi256f_t;
+};
+
+template <>
+struct FloatingSimdType<double, 256U>
+{
+  using type = vi256d_t;
+};
+
+template <>
+struct FloatingSimdType<float, 512U>
+{
+  using type = vi512f_t;
+};
+
+template <>
+struct FloatingSimdType<double, 512U>
+{
+  using type = vi512d_t;
+};
+
+// 256 bit processor for all integral types up to 8 bytes wide.
+// AVX2 has only signed compares so unsigned values are compared with their sign bits flipped.
+template <typename VT, typename CHECK_T>
+class SimdFilterProcessor<
+    VT, CHECK_T,
+    typename std::enable_if<std::is_same<VT, vi256_wr>::value && std::is_integral<CHECK_T>::value &&
+                            sizeof(CHECK_T) <= sizeof(int64_t)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 32U;
+  constexpr static const uint16_t vecBitSize = 256U;
+  using T = typename datatypes::WidthToSIntegralType<sizeof(CHECK_T)>::type;
+  using SimdWrapperType = vi256_wr;
+  using SimdType = vi256_t;
+  using FilterType = T;
+  using StorageType = T;
+  using MaskType = vi256_t;
+  using BitMaskType = uint32_t;
+  constexpr static const bool isUnsignedType = std::is_unsigned<CHECK_T>::value;
+  // Mask calculation for int and float types differs.
+  // See corresponding intrinsics algos for details.
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+
+  // MaskType ctor. Zero-extends AUX column mask bytes, one byte per value.
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return loadFrom(inputArray);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inputArray)));
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(inputArray)));
+    else
+      return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(*reinterpret_cast<const int32_t*>(inputArray)));
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill) const
+  {
+    return loadValue(fill);
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_set1_epi8(fill);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_set1_epi16(fill);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_set1_epi32(fill);
+    else
+      return _mm256_set1_epi64x(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from) const
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const SimdType*>(from));
+  }
+
+  // Compare
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_cmpeq_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_cmpeq_epi16(x, y);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_cmpeq_epi32(x, y);
+    else
+      return _mm256_cmpeq_epi64(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    if constexpr (isUnsignedType)
+    {
+      const SimdType signVec = loadValue(std::numeric_limits<T>::min());
+      return signedCmpGt(_mm256_xor_si256(x, signVec), _mm256_xor_si256(y, signVec));
+    }
+    else
+    {
+      return signedCmpGt(x, y);
+    }
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return _mm256_xor_si256(cmpGt(y, x), trueMask());
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return _mm256_xor_si256(cmpGt(x, y), trueMask());
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmpGt(y, x);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return _mm256_xor_si256(cmpEq(x, y), trueMask());
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE BitMaskType convertVectorToBitMask(SimdType vmask) const
+  {
+    return _mm256_movemask_epi8(vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    return cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    return cmpEq(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    return _mm256_setzero_si256();
+  }
+
+  // store
+  MCS_FORCE_INLINE void store(char* dst, SimdType x) const
+  {
+    _mm256_storeu_si256(reinterpret_cast<SimdType*>(dst), x);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    return _mm256_blendv_epi8(x, y, mask);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return _mm256_and_si256(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int64_t))
+      return blend(x, y, cmpGt(x, y));
+    else if constexpr (sizeof(T) == sizeof(int8_t))
+      return isUnsignedType ? _mm256_min_epu8(x, y) : _mm256_min_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return isUnsignedType ? _mm256_min_epu16(x, y) : _mm256_min_epi16(x, y);
+    else
+      return isUnsignedType ? _mm256_min_epu32(x, y) : _mm256_min_epi32(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int64_t))
+      return blend(x, y, cmpGt(y, x));
+    else if constexpr (sizeof(T) == sizeof(int8_t))
+      return isUnsignedType ? _mm256_max_epu8(x, y) : _mm256_max_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return isUnsignedType ? _mm256_max_epu16(x, y) : _mm256_max_epi16(x, y);
+    else
+      return isUnsignedType ? _mm256_max_epu32(x, y) : _mm256_max_epi32(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm256_setzero_si256();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm256_set1_epi64x(0xFFFFFFFFFFFFFFFFLL);
+  }
+
+ private:
+  MCS_FORCE_INLINE MaskType signedCmpGt(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm256_cmpgt_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm256_cmpgt_epi16(x, y);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm256_cmpgt_epi32(x, y);
+    else
+      return _mm256_cmpgt_epi64(x, y);
+  }
+};
+
+// 256 bit processors for float and double. StorageVecProcType processes NULL/EMPTY magics
+// that are compared as integers.
+template <typename VT, typename T>
+class SimdFilterProcessor<
+    VT, T,
+    typename std::enable_if<(std::is_same<VT, vi256f_wr>::value && std::is_same<T, float>::value) ||
+                            (std::is_same<VT, vi256d_wr>::value && std::is_same<T, double>::value)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 32U;
+  constexpr static const uint16_t vecBitSize = 256U;
+  constexpr static const bool isDouble = std::is_same<T, double>::value;
+  using FilterType = T;
+  using NullEmptySimdType = vi256_t;
+  using SimdWrapperType = VT;
+  using SimdType = typename FloatingSimdType<T, 256U>::type;
+  using StorageSimdType = vi256_t;
+  using StorageType = typename datatypes::WidthToSIntegralType<sizeof(T)>::type;
+  using MaskType = vi256_t;
+  using BitMaskType = uint32_t;
+  using StorageVecProcType = SimdFilterProcessor<vi256_wr, StorageType>;
+  // Mask calculation for int and float types differs.
+  // See corresponding intrinsics algos for details.
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.maskCtor(inputArray);
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    // This spec borrows the expr from u-/int64 based proceesor class.
+    return (SimdType)nullEmptyProcessor.loadValue(fill);
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (isDouble)
+      return _mm256_set1_pd(fill);
+    else
+      return _mm256_set1_ps(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from) const
+  {
+    if constexpr (isDouble)
+      return _mm256_loadu_pd(reinterpret_cast<const T*>(from));
+    else
+      return _mm256_loadu_ps(reinterpret_cast<const T*>(from));
+  }
+
+  // Compare. The predicates match the ones of _mm_cmp*_p[sd] intrinsics the 128 bit processors use.
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_EQ_OQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_NEQ_UQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE BitMaskType convertVectorToBitMask(SimdType vmask) const
+  {
+    if constexpr (isDouble)
+      return _mm256_movemask_pd(vmask);
+    else
+      return _mm256_movemask_ps(vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    // This spec borrows the expr from u-/int64 based proceesor class.
+    return nullEmptyProcessor.cmpNe((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(MaskType x, MaskType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpEq((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    if constexpr (isDouble)
+      return _mm256_setzero_pd();
+    else
+      return _mm256_setzero_ps();
+  }
+
+  MCS_FORCE_INLINE void store(char* dst, SimdType x) const
+  {
+    if constexpr (isDouble)
+      _mm256_storeu_pd(reinterpret_cast<T*>(dst), x);
+    else
+      _mm256_storeu_ps(reinterpret_cast<T*>(dst), x);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm256_min_pd(x, y);
+    else
+      return _mm256_min_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm256_max_pd(x, y);
+    else
+      return _mm256_max_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    if constexpr (isDouble)
+      return _mm256_blendv_pd(x, y, mask);
+    else
+      return _mm256_blendv_ps(x, y, mask);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return (SimdType)cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm256_and_pd(x, y);
+    else
+      return _mm256_and_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm256_setzero_si256();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm256_set1_epi64x(0xFFFFFFFFFFFFFFFFLL);
+  }
+
+ private:
+  template <int PREDICATE>
+  MCS_FORCE_INLINE MaskType cmp(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm256_castpd_si256(_mm256_cmp_pd(x, y, PREDICATE));
+    else
+      return _mm256_castps_si256(_mm256_cmp_ps(x, y, PREDICATE));
+  }
+};
+
+// 512 bit processor for all integral types up to 8 bytes wide.
+// AVX-512 compares produce k-masks. These are expanded into vectors so the filtering code
+// can treat masks of all processor families the same way.
+template <typename VT, typename CHECK_T>
+class SimdFilterProcessor<
+    VT, CHECK_T,
+    typename std::enable_if<std::is_same<VT, vi512_wr>::value && std::is_integral<CHECK_T>::value &&
+                            sizeof(CHECK_T) <= sizeof(int64_t)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 64U;
+  constexpr static const uint16_t vecBitSize = 512U;
+  using T = typename datatypes::WidthToSIntegralType<sizeof(CHECK_T)>::type;
+  using SimdWrapperType = vi512_wr;
+  using SimdType = vi512_t;
+  using FilterType = T;
+  using StorageType = T;
+  using MaskType = vi512_t;
+  using BitMaskType = uint64_t;
+  constexpr static const bool isUnsignedType = std::is_unsigned<CHECK_T>::value;
+  // Mask calculation for int and float types differs.
+  // See corresponding intrinsics algos for details.
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+
+  // MaskType ctor. Zero-extends AUX column mask bytes, one byte per value.
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return loadFrom(inputArray);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputArray)));
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inputArray)));
+    else
+      return _mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(inputArray)));
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill) const
+  {
+    return loadValue(fill);
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm512_set1_epi8(fill);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm512_set1_epi16(fill);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm512_set1_epi32(fill);
+    else
+      return _mm512_set1_epi64(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from) const
+  {
+    return _mm512_loadu_si512(reinterpret_cast<const void*>(from));
+  }
+
+  // Compare
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_EQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_NLT>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_NLE>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_LE>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_LT>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmp<_MM_CMPINT_NE>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE BitMaskType convertVectorToBitMask(SimdType vmask) const
+  {
+    return _mm512_movepi8_mask(vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    return cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    return cmpEq(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    return _mm512_setzero_si512();
+  }
+
+  // store
+  MCS_FORCE_INLINE void store(char* dst, SimdType x) const
+  {
+    _mm512_storeu_si512(reinterpret_cast<void*>(dst), x);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(mask), x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return _mm512_and_si512(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return isUnsignedType ? _mm512_min_epu8(x, y) : _mm512_min_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return isUnsignedType ? _mm512_min_epu16(x, y) : _mm512_min_epi16(x, y);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return isUnsignedType ? _mm512_min_epu32(x, y) : _mm512_min_epi32(x, y);
+    else
+      return isUnsignedType ? _mm512_min_epu64(x, y) : _mm512_min_epi64(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return isUnsignedType ? _mm512_max_epu8(x, y) : _mm512_max_epi8(x, y);
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return isUnsignedType ? _mm512_max_epu16(x, y) : _mm512_max_epi16(x, y);
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return isUnsignedType ? _mm512_max_epu32(x, y) : _mm512_max_epi32(x, y);
+    else
+      return isUnsignedType ? _mm512_max_epu64(x, y) : _mm512_max_epi64(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm512_setzero_si512();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm512_set1_epi64(0xFFFFFFFFFFFFFFFFLL);
+  }
+
+ private:
+  template <int PREDICATE>
+  MCS_FORCE_INLINE MaskType cmp(SimdType x, SimdType y) const
+  {
+    if constexpr (sizeof(T) == sizeof(int8_t))
+      return _mm512_movm_epi8(isUnsignedType ? _mm512_cmp_epu8_mask(x, y, PREDICATE)
+                                             : _mm512_cmp_epi8_mask(x, y, PREDICATE));
+    else if constexpr (sizeof(T) == sizeof(int16_t))
+      return _mm512_movm_epi16(isUnsignedType ? _mm512_cmp_epu16_mask(x, y, PREDICATE)
+                                              : _mm512_cmp_epi16_mask(x, y, PREDICATE));
+    else if constexpr (sizeof(T) == sizeof(int32_t))
+      return _mm512_movm_epi32(isUnsignedType ? _mm512_cmp_epu32_mask(x, y, PREDICATE)
+                                              : _mm512_cmp_epi32_mask(x, y, PREDICATE));
+    else
+      return _mm512_movm_epi64(isUnsignedType ? _mm512_cmp_epu64_mask(x, y, PREDICATE)
+                                              : _mm512_cmp_epi64_mask(x, y, PREDICATE));
+  }
+};
+
+// 512 bit processors for float and double.
+template <typename VT, typename T>
+class SimdFilterProcessor<
+    VT, T,
+    typename std::enable_if<(std::is_same<VT, vi512f_wr>::value && std::is_same<T, float>::value) ||
+                            (std::is_same<VT, vi512d_wr>::value && std::is_same<T, double>::value)>::type>
+{
+ public:
+  constexpr static const uint16_t vecByteSize = 64U;
+  constexpr static const uint16_t vecBitSize = 512U;
+  constexpr static const bool isDouble = std::is_same<T, double>::value;
+  using FilterType = T;
+  using NullEmptySimdType = vi512_t;
+  using SimdWrapperType = VT;
+  using SimdType = typename FloatingSimdType<T, 512U>::type;
+  using StorageSimdType = vi512_t;
+  using StorageType = typename datatypes::WidthToSIntegralType<sizeof(T)>::type;
+  using MaskType = vi512_t;
+  using BitMaskType = uint16_t;
+  using StorageVecProcType = SimdFilterProcessor<vi512_wr, StorageType>;
+  // Mask calculation for int and float types differs.
+  // See corresponding intrinsics algos for details.
+  constexpr static const uint16_t FilterMaskStep = sizeof(T);
+
+  MCS_FORCE_INLINE MaskType maskCtor(const char* inputArray) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.maskCtor(inputArray);
+  }
+
+  // Load value
+  MCS_FORCE_INLINE SimdType emptyNullLoadValue(const T fill) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    // This spec borrows the expr from u-/int64 based proceesor class.
+    return (SimdType)nullEmptyProcessor.loadValue(fill);
+  }
+
+  MCS_FORCE_INLINE SimdType loadValue(const T fill) const
+  {
+    if constexpr (isDouble)
+      return _mm512_set1_pd(fill);
+    else
+      return _mm512_set1_ps(fill);
+  }
+
+  // Load from
+  MCS_FORCE_INLINE SimdType loadFrom(const char* from) const
+  {
+    if constexpr (isDouble)
+      return _mm512_loadu_pd(reinterpret_cast<const T*>(from));
+    else
+      return _mm512_loadu_ps(reinterpret_cast<const T*>(from));
+  }
+
+  // Compare. The predicates match the ones of _mm_cmp*_p[sd] intrinsics the 128 bit processors use.
+  MCS_FORCE_INLINE MaskType cmpEq(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_EQ_OQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpGt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_GT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LE_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpLt(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_LT_OS>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpNe(SimdType x, SimdType y) const
+  {
+    return cmp<_CMP_NEQ_UQ>(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysFalse(SimdType x, SimdType y) const
+  {
+    return falseMask();
+  }
+
+  MCS_FORCE_INLINE MaskType cmpAlwaysTrue(SimdType x, SimdType y) const
+  {
+    return trueMask();
+  }
+
+  // misc
+  MCS_FORCE_INLINE BitMaskType convertVectorToBitMask(SimdType vmask) const
+  {
+    if constexpr (isDouble)
+      return _mm512_movepi64_mask((NullEmptySimdType)vmask);
+    else
+      return _mm512_movepi32_mask((NullEmptySimdType)vmask);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    // This spec borrows the expr from u-/int64 based proceesor class.
+    return nullEmptyProcessor.cmpNe((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpNe(MaskType x, MaskType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpNe(x, y);
+  }
+
+  MCS_FORCE_INLINE MaskType nullEmptyCmpEq(SimdType x, SimdType y) const
+  {
+    StorageVecProcType nullEmptyProcessor;
+    return nullEmptyProcessor.cmpEq((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE SimdType setToZero() const
+  {
+    if constexpr (isDouble)
+      return _mm512_setzero_pd();
+    else
+      return _mm512_setzero_ps();
+  }
+
+  MCS_FORCE_INLINE void store(char* dst, SimdType x) const
+  {
+    if constexpr (isDouble)
+      _mm512_storeu_pd(reinterpret_cast<T*>(dst), x);
+    else
+      _mm512_storeu_ps(reinterpret_cast<T*>(dst), x);
+  }
+
+  MCS_FORCE_INLINE SimdType min(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm512_min_pd(x, y);
+    else
+      return _mm512_min_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType max(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm512_max_pd(x, y);
+    else
+      return _mm512_max_ps(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType blend(SimdType x, SimdType y, SimdType mask) const
+  {
+    if constexpr (isDouble)
+      return _mm512_mask_blend_pd(_mm512_movepi64_mask((NullEmptySimdType)mask), x, y);
+    else
+      return _mm512_mask_blend_ps(_mm512_movepi32_mask((NullEmptySimdType)mask), x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType cmpGtSimdType(SimdType x, SimdType y) const
+  {
+    return (SimdType)cmpGt(x, y);
+  }
+
+  MCS_FORCE_INLINE SimdType bwAnd(SimdType x, SimdType y) const
+  {
+    return (SimdType)_mm512_and_si512((NullEmptySimdType)x, (NullEmptySimdType)y);
+  }
+
+  MCS_FORCE_INLINE MaskType falseMask() const
+  {
+    return _mm512_setzero_si512();
+  }
+
+  MCS_FORCE_INLINE MaskType trueMask() const
+  {
+    return _mm512_set1_epi64(0xFFFFFFFFFFFFFFFFLL);
+  }
+
+ private:
+  template <int PREDICATE>
+  MCS_FORCE_INLINE MaskType cmp(SimdType x, SimdType y) const
+  {
+    if constexpr (isDouble)
+      return _mm512_movm_epi64(_mm512_cmp_pd_mask(x, y, PREDICATE));
+    else
+      return _mm512_movm_epi32(_mm512_cmp_ps_mask(x, y, PREDICATE));
+  }
+};
+
+}  // namespace simd
+
+#endif  // if defined(__x86_64__)
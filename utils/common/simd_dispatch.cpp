@@ -0,0 +1,96 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+
+#include "simd_dispatch.h"
+
+namespace
+{
+simd::SimdLevel cpuSimdLevel()
+{
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  // The AVX-512 kernels use byte/word compares (BW) and mask moves for
+  // dword/qword lanes (DQ) so all of them are required.
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+    return simd::SimdLevel::AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return simd::SimdLevel::AVX2;
+#endif
+  return simd::SimdLevel::SSE;
+}
+
+std::atomic<simd::SimdLevel>& currentSimdLevel()
+{
+  static std::atomic<simd::SimdLevel> level{simd::detectSimdLevel()};
+  return level;
+}
+}  // namespace
+
+namespace simd
+{
+SimdLevel detectSimdLevel()
+{
+  static const SimdLevel detected = cpuSimdLevel();
+  return detected;
+}
+
+SimdLevel getSimdLevel()
+{
+  return currentSimdLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel setSimdLevel(const SimdLevel level)
+{
+  SimdLevel effective = std::min(level, detectSimdLevel());
+  currentSimdLevel().store(effective, std::memory_order_relaxed);
+  return effective;
+}
+
+SimdLevel simdLevelFromString(const std::string& value)
+{
+  std::string lower(value);
+  std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+
+  if (lower == "sse" || lower == "sse4.2" || lower == "neon")
+    return SimdLevel::SSE;
+  if (lower == "avx2")
+    return SimdLevel::AVX2;
+
+  return SimdLevel::AVX512;
+}
+
+const char* simdLevelName(const SimdLevel level)
+{
+  switch (level)
+  {
+    case SimdLevel::AVX512: return "avx512";
+    case SimdLevel::AVX2: return "avx2";
+    default: break;
+  }
+#if defined(__aarch64__)
+  return "neon";
+#else
+  return "sse4.2";
+#endif
+}
+
+}  // namespace simd
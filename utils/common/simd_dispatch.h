@@ -0,0 +1,57 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace simd
+{
+// Vector width families the column filtering kernels are built for.
+// SSE means the baseline 128-bit processors (NEON on ARM).
+enum class SimdLevel : uint8_t
+{
+  SSE = 0,
+  AVX2 = 1,
+  AVX512 = 2
+};
+
+// Vector width in bits that corresponds to the level.
+constexpr uint16_t simdLevelBitSize(const SimdLevel level)
+{
+  return (level == SimdLevel::AVX512) ? 512U : (level == SimdLevel::AVX2) ? 256U : 128U;
+}
+
+// The widest level the CPU and the OS support. Runs cpuid only once.
+SimdLevel detectSimdLevel();
+
+// The level the scan kernels currently dispatch to.
+SimdLevel getSimdLevel();
+
+// Caps the dispatch level. The value is clamped to detectSimdLevel() so
+// the kernels never run instructions the CPU doesn't support.
+// Returns the level that is actually set.
+SimdLevel setSimdLevel(const SimdLevel level);
+
+// Parses a configuration value, e.g. "sse4.2", "avx2" or "avx512".
+// An empty or unknown value means the widest detected level.
+SimdLevel simdLevelFromString(const std::string& value);
+
+const char* simdLevelName(const SimdLevel level);
+
+}  // namespace simd
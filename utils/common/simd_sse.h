@@ -148,6 +148,18 @@ static inline vi128_t bitMaskToByteMask16(MT m)
 template <typename VT, typename T, typename ENABLE = void>
 class SimdFilterProcessor;
 
+// Maps a column storage type onto the filter processor of the given vector width.
+// The wider x86 families are added by simd_avx.h.
+template <typename T, ENUM_KIND KIND, uint16_t VEC_BIT_SIZE>
+struct SimdFilterProcessorOfWidth;
+
+template <typename T, ENUM_KIND KIND>
+struct SimdFilterProcessorOfWidth<T, KIND, 128U>
+{
+  using type = SimdFilterProcessor<typename IntegralToSIMD<T, KIND>::type,
+                                   typename StorageToFiltering<T, KIND>::type>;
+};
+
 // Dummy class that captures all impossible cases, e.g. integer vector as VT and flot as CHECK_T.
 template <typename VT, typename CHECK_T>
 class SimdFilterProcessor<
@@ -0,0 +1,435 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+using namespace std;
+
+#include "chunkencoding.h"
+
+namespace
+{
+using compress::ChunkEncoding;
+
+template <typename T>
+inline int64_t load(const char* p, size_t i)
+{
+  T v;
+  memcpy(&v, p + i * sizeof(T), sizeof(T));
+  return v;
+}
+
+template <typename T>
+inline void store(char* p, size_t i, int64_t v)
+{
+  T t = (T)v;
+  memcpy(p + i * sizeof(T), &t, sizeof(T));
+}
+
+inline uint8_t bitsFor(uint64_t range)
+{
+  return (range == 0 ? 0 : 64 - __builtin_clzll(range));
+}
+
+inline size_t packedSize(uint64_t n, uint8_t bits)
+{
+  return (n * bits + 7) / 8;
+}
+
+class BitWriter
+{
+ public:
+  explicit BitWriter(char* out) : fOut(out), fAcc(0), fBits(0)
+  {
+  }
+
+  inline void put(uint64_t v, uint8_t bits)
+  {
+    fAcc |= (unsigned __int128)v << fBits;
+    fBits += bits;
+
+    if (fBits >= 64)
+    {
+      uint64_t word = (uint64_t)fAcc;
+      memcpy(fOut, &word, sizeof(word));
+      fOut += sizeof(word);
+      fAcc >>= 64;
+      fBits -= 64;
+    }
+  }
+
+  char* flush()
+  {
+    for (; fBits > 0; fBits -= min<uint32_t>(fBits, 8))
+    {
+      *fOut++ = (char)(uint8_t)fAcc;
+      fAcc >>= 8;
+    }
+
+    return fOut;
+  }
+
+ private:
+  char* fOut;
+  unsigned __int128 fAcc;
+  uint32_t fBits;
+};
+
+class BitReader
+{
+ public:
+  explicit BitReader(const char* in) : fIn((const uint8_t*)in), fAcc(0), fBits(0)
+  {
+  }
+
+  inline uint64_t get(uint8_t bits)
+  {
+    if (bits == 0)
+      return 0;
+
+    while (fBits < bits)
+    {
+      fAcc |= (unsigned __int128)*fIn++ << fBits;
+      fBits += 8;
+    }
+
+    uint64_t v = (uint64_t)fAcc;
+
+    if (bits < 64)
+      v &= (1ULL << bits) - 1;
+
+    fAcc >>= bits;
+    fBits -= bits;
+    return v;
+  }
+
+ private:
+  const uint8_t* fIn;
+  unsigned __int128 fAcc;
+  uint32_t fBits;
+};
+
+void writeHeader(const ChunkEncoding::Plan& plan, char* out)
+{
+  uint8_t bytes[4] = {plan.type, plan.width, plan.bits, 0};
+
+  memcpy(out, bytes, 4);
+  memcpy(out + 4, &plan.count, 4);
+  memcpy(out + 8, &plan.tailCount, 4);
+  memcpy(out + 12, &plan.runs, 4);
+  memcpy(out + 16, &plan.tailValue, 8);
+  memcpy(out + 24, &plan.base, 8);
+  memcpy(out + 32, &plan.minDelta, 8);
+}
+
+void readHeader(const char* in, ChunkEncoding::Plan& plan)
+{
+  plan.type = in[0];
+  plan.width = in[1];
+  plan.bits = in[2];
+  memcpy(&plan.count, in + 4, 4);
+  memcpy(&plan.tailCount, in + 8, 4);
+  memcpy(&plan.runs, in + 12, 4);
+  memcpy(&plan.tailValue, in + 16, 8);
+  memcpy(&plan.base, in + 24, 8);
+  memcpy(&plan.minDelta, in + 32, 8);
+}
+
+template <typename T>
+size_t planT(const char* in, size_t n, ChunkEncoding::Plan& plan)
+{
+  plan.width = sizeof(T);
+  plan.tailValue = load<T>(in, n - 1);
+  plan.tailCount = 1;
+
+  while (plan.tailCount < n && load<T>(in, n - 1 - plan.tailCount) == plan.tailValue)
+    plan.tailCount++;
+
+  plan.count = n - plan.tailCount;
+  plan.runs = 0;
+  plan.base = 0;
+  plan.minDelta = 0;
+  plan.bits = 0;
+
+  if (plan.count == 0)
+  {
+    plan.type = ChunkEncoding::RLE;
+    return ChunkEncoding::HEADER_SIZE;
+  }
+
+  int64_t minVal = load<T>(in, 0), maxVal = minVal;
+  int64_t minDelta = numeric_limits<int64_t>::max(), maxDelta = numeric_limits<int64_t>::min();
+  int64_t prev = minVal;
+  uint32_t runs = 1;
+
+  for (size_t i = 1; i < plan.count; i++)
+  {
+    int64_t v = load<T>(in, i);
+    int64_t delta = (int64_t)((uint64_t)v - (uint64_t)prev);
+
+    minVal = min(minVal, v);
+    maxVal = max(maxVal, v);
+    minDelta = min(minDelta, delta);
+    maxDelta = max(maxDelta, delta);
+    runs += (v != prev);
+    prev = v;
+  }
+
+  const uint8_t forBits = bitsFor((uint64_t)maxVal - (uint64_t)minVal);
+  const size_t forSize = packedSize(plan.count, forBits);
+  const size_t rleSize = (size_t)runs * (sizeof(T) + sizeof(uint32_t));
+
+  plan.type = ChunkEncoding::FOR;
+  plan.bits = forBits;
+  plan.base = minVal;
+  size_t size = forSize;
+
+  if (plan.count > 1)
+  {
+    const uint8_t deltaBits = bitsFor((uint64_t)maxDelta - (uint64_t)minDelta);
+    const size_t deltaSize = packedSize(plan.count - 1, deltaBits);
+
+    if (deltaSize < size)
+    {
+      plan.type = ChunkEncoding::DELTA;
+      plan.bits = deltaBits;
+      plan.base = load<T>(in, 0);
+      plan.minDelta = minDelta;
+      size = deltaSize;
+    }
+  }
+
+  if (rleSize < size)
+  {
+    plan.type = ChunkEncoding::RLE;
+    plan.bits = 0;
+    plan.base = 0;
+    plan.minDelta = 0;
+    plan.runs = runs;
+    size = rleSize;
+  }
+
+  return ChunkEncoding::HEADER_SIZE + size;
+}
+
+template <typename T>
+size_t encodeT(const char* in, const ChunkEncoding::Plan& plan, char* out)
+{
+  char* data = out + ChunkEncoding::HEADER_SIZE;
+
+  writeHeader(plan, out);
+
+  switch (plan.type)
+  {
+    case ChunkEncoding::FOR:
+    {
+      BitWriter writer(data);
+
+      for (size_t i = 0; i < plan.count; i++)
+        writer.put((uint64_t)load<T>(in, i) - (uint64_t)plan.base, plan.bits);
+
+      return writer.flush() - out;
+    }
+
+    case ChunkEncoding::DELTA:
+    {
+      BitWriter writer(data);
+      int64_t prev = plan.base;
+
+      for (size_t i = 1; i < plan.count; i++)
+      {
+        int64_t v = load<T>(in, i);
+        writer.put((uint64_t)v - (uint64_t)prev - (uint64_t)plan.minDelta, plan.bits);
+        prev = v;
+      }
+
+      return writer.flush() - out;
+    }
+
+    case ChunkEncoding::RLE:
+    {
+      size_t i = 0;
+
+      while (i < plan.count)
+      {
+        int64_t v = load<T>(in, i);
+        uint32_t len = 1;
+
+        while (i + len < plan.count && load<T>(in, i + len) == v)
+          len++;
+
+        store<T>(data, 0, v);
+        memcpy(data + sizeof(T), &len, sizeof(len));
+        data += sizeof(T) + sizeof(len);
+        i += len;
+      }
+
+      return data - out;
+    }
+  }
+
+  return 0;
+}
+
+template <typename T>
+bool decodeT(const char* in, size_t inLen, const ChunkEncoding::Plan& plan, char* out)
+{
+  const char* data = in + ChunkEncoding::HEADER_SIZE;
+  const size_t dataLen = inLen - ChunkEncoding::HEADER_SIZE;
+
+  switch (plan.type)
+  {
+    case ChunkEncoding::FOR:
+    {
+      if (plan.bits > 64 || dataLen < packedSize(plan.count, plan.bits))
+        return false;
+
+      BitReader reader(data);
+
+      for (size_t i = 0; i < plan.count; i++)
+        store<T>(out, i, (int64_t)((uint64_t)plan.base + reader.get(plan.bits)));
+
+      break;
+    }
+
+    case ChunkEncoding::DELTA:
+    {
+      if (plan.count == 0)
+        break;
+
+      if (plan.bits > 64 || dataLen < packedSize(plan.count - 1, plan.bits))
+        return false;
+
+      BitReader reader(data);
+      uint64_t prev = plan.base;
+
+      store<T>(out, 0, prev);
+
+      for (size_t i = 1; i < plan.count; i++)
+      {
+        prev += (uint64_t)plan.minDelta + reader.get(plan.bits);
+        store<T>(out, i, (int64_t)prev);
+      }
+
+      break;
+    }
+
+    case ChunkEncoding::RLE:
+    {
+      if (dataLen < (size_t)plan.runs * (sizeof(T) + sizeof(uint32_t)))
+        return false;
+
+      size_t i = 0;
+
+      for (uint32_t r = 0; r < plan.runs; r++)
+      {
+        int64_t v = load<T>(data, 0);
+        uint32_t len;
+
+        memcpy(&len, data + sizeof(T), sizeof(len));
+        data += sizeof(T) + sizeof(len);
+
+        if (len > plan.count - i)
+          return false;
+
+        for (uint32_t k = 0; k < len; k++)
+          store<T>(out, i + k, v);
+
+        i += len;
+      }
+
+      if (i != plan.count)
+        return false;
+
+      break;
+    }
+
+    default: return false;
+  }
+
+  for (size_t i = plan.count; i < (size_t)plan.count + plan.tailCount; i++)
+    store<T>(out, i, plan.tailValue);
+
+  return true;
+}
+
+}  // namespace
+
+namespace compress
+{
+size_t ChunkEncoding::plan(const char* in, size_t inLen, uint32_t width, Plan& plan)
+{
+  if (width == 0 || inLen == 0 || inLen % width != 0 || inLen / width > numeric_limits<uint32_t>::max())
+    return 0;
+
+  const size_t n = inLen / width;
+
+  switch (width)
+  {
+    case 1: return planT<int8_t>(in, n, plan);
+    case 2: return planT<int16_t>(in, n, plan);
+    case 4: return planT<int32_t>(in, n, plan);
+    case 8: return planT<int64_t>(in, n, plan);
+    default: return 0;
+  }
+}
+
+size_t ChunkEncoding::encode(const char* in, const Plan& plan, char* out)
+{
+  switch (plan.width)
+  {
+    case 1: return encodeT<int8_t>(in, plan, out);
+    case 2: return encodeT<int16_t>(in, plan, out);
+    case 4: return encodeT<int32_t>(in, plan, out);
+    case 8: return encodeT<int64_t>(in, plan, out);
+    default: return 0;
+  }
+}
+
+bool ChunkEncoding::decode(const char* in, size_t inLen, char* out, size_t& outLen)
+{
+  Plan plan;
+
+  if (inLen < HEADER_SIZE)
+    return false;
+
+  readHeader(in, plan);
+
+  const size_t len = ((size_t)plan.count + plan.tailCount) * plan.width;
+
+  if (len > outLen)
+    return false;
+
+  bool ok;
+
+  switch (plan.width)
+  {
+    case 1: ok = decodeT<int8_t>(in, inLen, plan, out); break;
+    case 2: ok = decodeT<int16_t>(in, inLen, plan, out); break;
+    case 4: ok = decodeT<int32_t>(in, inLen, plan, out); break;
+    case 8: ok = decodeT<int64_t>(in, inLen, plan, out); break;
+    default: ok = false; break;
+  }
+
+  if (ok)
+    outLen = len;
+
+  return ok;
+}
+
+}  // namespace compress
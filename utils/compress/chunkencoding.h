@@ -0,0 +1,91 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#define EXPORT
+
+namespace compress
+{
+/** @brief Lightweight encodings of the fixed width values of a column chunk
+ *
+ * A chunk of a column holds up to 4MB of 1, 2, 4 or 8 byte values.  Integer
+ * columns often fit one of these encodings a lot better than a general
+ * purpose codec:
+ *
+ *  - FOR, frame of reference: the values minus the min, bit packed
+ *  - DELTA: the differences of consecutive values minus the min difference,
+ *    bit packed, for sorted columns and timestamps
+ *  - RLE: (value, length) runs, for columns with few distinct values
+ *
+ * The run of equal values at the end of a chunk, usually the empty values
+ * after the last row, is kept apart and isn't part of the encoded values.
+ *
+ * plan() looks at the values and picks the smallest encoding, the caller
+ * decides whether that beats the codec.
+ */
+class ChunkEncoding
+{
+ public:
+  enum Type
+  {
+    NONE = 0,
+    FOR = 1,
+    DELTA = 2,
+    RLE = 3
+  };
+
+  struct Plan
+  {
+    uint8_t type;
+    uint8_t width;
+    uint8_t bits;        // bits per packed value
+    uint32_t count;      // values encoded
+    uint32_t tailCount;  // values in the run at the end
+    uint32_t runs;       // RLE runs
+    int64_t tailValue;
+    int64_t base;      // FOR min, or DELTA first value
+    int64_t minDelta;  // DELTA min difference
+  };
+
+  static const uint32_t HEADER_SIZE = 40;
+
+  /** @brief Picks the encoding of in, width is the column width.
+   *  Returns the encoded size, 0 if no encoding applies.
+   */
+  EXPORT static size_t plan(const char* in, size_t inLen, uint32_t width, Plan& plan);
+
+  /** @brief Encodes in as planned, out must hold the size plan() returned.
+   *  Returns the encoded size.
+   */
+  EXPORT static size_t encode(const char* in, const Plan& plan, char* out);
+
+  /** @brief Decodes in, outLen is the size of out on input and the size of the
+   *  values on return.  Returns false if in isn't a valid encoding or out is
+   *  too small.
+   */
+  EXPORT static bool decode(const char* in, size_t inLen, char* out, size_t& outLen);
+};
+
+}  // namespace compress
+
+#undef EXPORT
@@ -30,6 +30,7 @@ using namespace std;
 #include "snappy.h"
 #include "hasher.h"
 #include "mcsconfig.h"
+#include "configcpp.h"
 #ifdef HAVE_LZ4
 #include "lz4.h"
 #else
@@ -39,9 +40,19 @@ using namespace std;
   ((unsigned)(isize) > (unsigned)LZ4_MAX_INPUT_SIZE ? 0 : (isize) + ((isize) / 255) + 16)
 #endif
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#else
+// Taken from zstd.h.
+#define ZSTD_COMPRESSBOUND(srcSize) \
+  ((srcSize) + ((srcSize) >> 8) +   \
+   (((srcSize) < (128 << 10)) ? (((128 << 10) - (srcSize)) >> 11) : 0))
+#endif
+
 #define IDBCOMP_DLLEXPORT
 #include "idbcompress.h"
 #undef IDBCOMP_DLLEXPORT
+#include "chunkencoding.h"
 
 namespace
 {
@@ -55,6 +66,14 @@ const int CHECKSUM_OFFSET = 1;
 const int LEN_OFFSET = 5;
 const unsigned HEADER_SIZE = 9;
 
+// the chunk holds a ChunkEncoding instead of the output of the codec
+const uint8_t CHUNK_MAGIC_ENCODED = 0xfa;
+
+// signatures of the codecs
+const uint8_t CHUNK_MAGIC_SNAPPY = 0xfd;
+const uint8_t CHUNK_MAGIC_LZ4 = 0xfc;
+const uint8_t CHUNK_MAGIC_ZSTD = 0xfb;
+
 // The max number of lbids to be stored in segment file.
 const uint32_t LBID_MAX_SIZE = 48;
 
@@ -94,6 +113,71 @@ void initCompressedDBFileHeader(void* hdrBuf, uint32_t columnWidth,
   std::memset(hdr->fHeader.fLBIDS, 0, sizeof(hdr->fHeader.fLBIDS));
 }
 
+// The codec that wrote a chunk with the given signature.  The chunks of a file
+// can be rewritten with another codec than the one of the column, e.g. when
+// a cold partition is recompressed with Zstd.
+const compress::CompressInterface* chunkCodec(uint8_t magic)
+{
+  static const compress::CompressInterfaceSnappy snappy;
+  static const compress::CompressInterfaceLZ4 lz4;
+  static const compress::CompressInterfaceZSTD zstd(0, compress::CompressInterfaceZSTD::DEFAULT_LEVEL);
+
+  switch (magic)
+  {
+    case CHUNK_MAGIC_SNAPPY: return &snappy;
+    case CHUNK_MAGIC_LZ4: return &lz4;
+    case CHUNK_MAGIC_ZSTD: return &zstd;
+  }
+
+  return nullptr;
+}
+
+// WriteEngine/ZstdCompressionLevel, read once
+int configuredZstdLevel()
+{
+  static const int level = []
+  {
+    int64_t configured = 0;
+
+    try
+    {
+      configured = config::Config::fromText(
+          config::Config::makeConfig()->getConfig("WriteEngine", "ZstdCompressionLevel"));
+    }
+    catch (std::exception&)
+    {
+    }
+
+    if (configured == 0)
+      return compress::CompressInterfaceZSTD::DEFAULT_LEVEL;
+
+#ifdef HAVE_ZSTD
+    configured = std::max<int64_t>(std::min<int64_t>(configured, ZSTD_maxCLevel()), ZSTD_minCLevel());
+#endif
+    return (int)configured;
+  }();
+
+  return level;
+}
+
+#ifdef HAVE_ZSTD
+// Zstd contexts are reused by the threads of a process, allocating them for
+// every chunk costs more than compressing small chunks.
+struct ZstdContexts
+{
+  ZSTD_CCtx* cctx = nullptr;
+  ZSTD_DCtx* dctx = nullptr;
+
+  ~ZstdContexts()
+  {
+    ZSTD_freeCCtx(cctx);
+    ZSTD_freeDCtx(dctx);
+  }
+};
+
+thread_local ZstdContexts zstdContexts;
+#endif
+
 }  // namespace
 
 namespace compress
@@ -112,20 +196,26 @@ CompressInterface::CompressInterface(unsigned int numUserPaddingBytes)
 /*static*/
 bool CompressInterface::isCompressionAvail(int compressionType)
 {
+#ifdef HAVE_ZSTD
+  if (compressionType == 4)
+    return true;
+#endif
   return ((compressionType == 0) || (compressionType == 1) || (compressionType == 2) ||
           (compressionType == 3));
 }
 
 size_t CompressInterface::getMaxCompressedSizeGeneric(size_t inLen)
 {
-  return std::max(snappy::MaxCompressedLength(inLen), LZ4_COMPRESSBOUND(inLen)) + HEADER_SIZE;
+  return std::max({snappy::MaxCompressedLength(inLen), (size_t)LZ4_COMPRESSBOUND(inLen),
+                   (size_t)ZSTD_COMPRESSBOUND(inLen)}) +
+         HEADER_SIZE;
 }
 
 //------------------------------------------------------------------------------
 // Compress a block of data
 //------------------------------------------------------------------------------
 int CompressInterface::compressBlock(const char* in, const size_t inLen, unsigned char* out,
-                                     size_t& outLen) const
+                                     size_t& outLen, uint32_t colWidth) const
 {
   size_t snaplen = 0;
   utils::Hasher128 hasher;
@@ -149,6 +239,19 @@ int CompressInterface::compressBlock(const char* in, const size_t inLen, unsigne
   uint32_t* checksum = (uint32_t*)&out[CHECKSUM_OFFSET];
   uint32_t* len = (uint32_t*)&out[LEN_OFFSET];
   *signature = getChunkMagicNumber();
+
+  if (colWidth > 0)
+  {
+    ChunkEncoding::Plan plan;
+    size_t encodedLen = ChunkEncoding::plan(in, inLen, colWidth, plan);
+
+    // overwrite the codec output if the encoding is smaller
+    if (encodedLen > 0 && encodedLen < snaplen)
+    {
+      snaplen = ChunkEncoding::encode(in, plan, reinterpret_cast<char*>(&out[HEADER_SIZE]));
+      *signature = CHUNK_MAGIC_ENCODED;
+    }
+  }
   *checksum = hasher((char*)&out[HEADER_SIZE], snaplen);
   *len = snaplen;
 
@@ -204,6 +307,36 @@ int CompressInterface::uncompressBlock(const char* in, const size_t inLen, unsig
 
     outLen = tmpOutLen;
   }
+  else if (storedMagic == CHUNK_MAGIC_ENCODED)
+  {
+    if (inLen < HEADER_SIZE)
+      return ERR_BADINPUT;
+
+    storedChecksum = *((uint32_t*)&in[CHECKSUM_OFFSET]);
+    storedLen = *((uint32_t*)(&in[LEN_OFFSET]));
+
+    if (inLen < storedLen + HEADER_SIZE)
+      return ERR_BADINPUT;
+
+    realChecksum = hasher(&in[HEADER_SIZE], storedLen);
+
+    if (storedChecksum != realChecksum)
+      return ERR_CHECKSUM;
+
+    if (!ChunkEncoding::decode(&in[HEADER_SIZE], storedLen, reinterpret_cast<char*>(out), tmpOutLen))
+    {
+      cerr << "uncompressBlock failed to decode!" << endl;
+      return ERR_DECOMPRESS;
+    }
+
+    outLen = tmpOutLen;
+  }
+  else if (const CompressInterface* codec = chunkCodec(storedMagic))
+  {
+    // the chunk was written by another codec
+    outLen = tmpOutLen;
+    return codec->uncompressBlock(in, inLen, out, outLen);
+  }
   else
   {
     // v1 compression or bad header
@@ -614,6 +747,90 @@ uint8_t CompressInterfaceLZ4::getChunkMagicNumber() const
   return CHUNK_MAGIC_LZ4;
 }
 
+// Zstd
+CompressInterfaceZSTD::CompressInterfaceZSTD(uint32_t numUserPaddingBytes, int level)
+ : CompressInterface(numUserPaddingBytes), fLevel(level != 0 ? level : configuredZstdLevel())
+{
+}
+
+int32_t CompressInterfaceZSTD::compress(const char* in, size_t inLen, char* out, size_t* outLen) const
+{
+#ifdef HAVE_ZSTD
+  if (!zstdContexts.cctx && !(zstdContexts.cctx = ZSTD_createCCtx()))
+    return ERR_COMPRESS;
+
+  auto compressedLen = ZSTD_compressCCtx(zstdContexts.cctx, out, *outLen, in, inLen, fLevel);
+
+  if (ZSTD_isError(compressedLen))
+  {
+    cerr << "ZSTD_compressCCtx failed: " << ZSTD_getErrorName(compressedLen) << ". InLen: " << inLen
+         << ", outLen: " << *outLen << endl;
+    return ERR_COMPRESS;
+  }
+
+#ifdef DEBUG_COMPRESSION
+  std::cout << "ZSTD::compress: inLen " << inLen << ", comressedLen " << compressedLen << std::endl;
+#endif
+
+  *outLen = compressedLen;
+  return ERR_OK;
+#else
+  return ERR_COMPRESS;
+#endif
+}
+
+int32_t CompressInterfaceZSTD::uncompress(const char* in, size_t inLen, char* out, size_t* outLen) const
+{
+#ifdef HAVE_ZSTD
+  if (!zstdContexts.dctx && !(zstdContexts.dctx = ZSTD_createDCtx()))
+    return ERR_DECOMPRESS;
+
+  auto decompressedLen = ZSTD_decompressDCtx(zstdContexts.dctx, out, *outLen, in, inLen);
+
+  if (ZSTD_isError(decompressedLen))
+  {
+    cerr << "ZSTD_decompressDCtx failed: " << ZSTD_getErrorName(decompressedLen) << endl;
+    cerr << "InLen: " << inLen << ", outLen: " << *outLen << endl;
+    return ERR_DECOMPRESS;
+  }
+
+  *outLen = decompressedLen;
+
+#ifdef DEBUG_COMPRESSION
+  std::cout << "ZSTD::uncompress: inLen " << inLen << ", outLen " << *outLen << std::endl;
+#endif
+
+  return ERR_OK;
+#else
+  return ERR_DECOMPRESS;
+#endif
+}
+
+size_t CompressInterfaceZSTD::maxCompressedSize(size_t uncompSize) const
+{
+  return (ZSTD_COMPRESSBOUND(uncompSize) + HEADER_SIZE);
+}
+
+bool CompressInterfaceZSTD::getUncompressedSize(char* in, size_t inLen, size_t* outLen) const
+{
+#ifdef HAVE_ZSTD
+  auto size = ZSTD_getFrameContentSize(in, inLen);
+
+  if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR)
+    return false;
+
+  *outLen = size;
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint8_t CompressInterfaceZSTD::getChunkMagicNumber() const
+{
+  return CHUNK_MAGIC_ZSTD;
+}
+
 CompressInterface* getCompressInterfaceByType(uint32_t compressionType, uint32_t numUserPaddingBytes)
 {
   switch (compressionType)
@@ -621,6 +838,7 @@ CompressInterface* getCompressInterfaceByType(uint32_t compressionType, uint32_t
     case 1:
     case 2: return new CompressInterfaceSnappy(numUserPaddingBytes);
     case 3: return new CompressInterfaceLZ4(numUserPaddingBytes);
+    case 4: return new CompressInterfaceZSTD(numUserPaddingBytes);
   }
 
   return nullptr;
@@ -633,6 +851,8 @@ CompressInterface* getCompressInterfaceByName(const std::string& compressionName
     return new CompressInterfaceSnappy(numUserPaddingBytes);
   else if (compressionName == "LZ4")
     return new CompressInterfaceLZ4(numUserPaddingBytes);
+  else if (compressionName == "ZSTD")
+    return new CompressInterfaceZSTD(numUserPaddingBytes);
   return nullptr;
 }
 
@@ -642,7 +862,8 @@ void initializeCompressorPool(
 {
   compressorPool = {
       make_pair(2, std::shared_ptr<CompressInterface>(new CompressInterfaceSnappy(numUserPaddingBytes))),
-      make_pair(3, std::shared_ptr<CompressInterface>(new CompressInterfaceLZ4(numUserPaddingBytes)))};
+      make_pair(3, std::shared_ptr<CompressInterface>(new CompressInterfaceLZ4(numUserPaddingBytes))),
+      make_pair(4, std::shared_ptr<CompressInterface>(new CompressInterfaceZSTD(numUserPaddingBytes)))};
 }
 
 std::shared_ptr<CompressInterface> getCompressorByType(
@@ -664,6 +885,12 @@ std::shared_ptr<CompressInterface> getCompressorByType(
         return nullptr;
       }
       return compressorPool[3];
+    case 4:
+      if (!compressorPool.count(4))
+      {
+        return nullptr;
+      }
+      return compressorPool[4];
   }
 
   return nullptr;
@@ -75,10 +75,13 @@ class CompressInterface
    * Compresses specified "in" buffer of length "inLen" bytes.
    * Compressed data and size are returned in "out" and "outLen".
    * "out" should be sized using maxCompressedSize() to allow for incompressible data.
+   * If "colWidth" is the width of the column values in "in", the chunk is stored
+   * with a ChunkEncoding instead when that is smaller.
    * Returns 0 if success.
    */
 
-  EXPORT int compressBlock(const char* in, const size_t inLen, unsigned char* out, size_t& outLen) const;
+  EXPORT int compressBlock(const char* in, const size_t inLen, unsigned char* out, size_t& outLen,
+                           uint32_t colWidth = 0) const;
 
   /**
    * outLen must be initialized with the size of the out buffer before calling uncompressBlock.
@@ -348,6 +351,50 @@ class CompressInterfaceLZ4 : public CompressInterface
   const uint8_t CHUNK_MAGIC_LZ4 = 0xfc;
 };
 
+class CompressInterfaceZSTD : public CompressInterface
+{
+ public:
+  static const int DEFAULT_LEVEL = 3;
+
+  /**
+   * A level of 0 takes the level from WriteEngine/ZstdCompressionLevel.
+   * The level only matters to compress().
+   */
+  EXPORT CompressInterfaceZSTD(uint32_t numUserPaddingBytes = 0, int level = 0);
+  EXPORT ~CompressInterfaceZSTD() = default;
+  /**
+   * Compress the given block using Zstd compression API.
+   */
+  EXPORT int32_t compress(const char* in, size_t inLen, char* out, size_t* outLen) const override;
+  /**
+   * Uncompress the given block using Zstd compression API.
+   */
+  EXPORT int32_t uncompress(const char* in, size_t inLen, char* out, size_t* outLen) const override;
+  /**
+   * Get max compressed size for the given `uncompSize` value using Zstd
+   * compression API.
+   */
+  EXPORT size_t maxCompressedSize(size_t uncompSize) const override;
+
+  /**
+   * Get uncompressed size for the given block from the Zstd frame header.
+   */
+  EXPORT
+  bool getUncompressedSize(char* in, size_t inLen, size_t* outLen) const override;
+
+  int level() const
+  {
+    return fLevel;
+  }
+
+ protected:
+  uint8_t getChunkMagicNumber() const override;
+
+ private:
+  const uint8_t CHUNK_MAGIC_ZSTD = 0xfb;
+  int fLevel;
+};
+
 using CompressorPool = std::unordered_map<uint32_t, std::shared_ptr<CompressInterface>>;
 
 /**
@@ -386,7 +433,8 @@ inline bool CompressInterface::isCompressionAvail(int c)
 {
   return (c == 0);
 }
-inline int CompressInterface::compressBlock(const char*, const size_t, unsigned char*, size_t&) const
+inline int CompressInterface::compressBlock(const char*, const size_t, unsigned char*, size_t&,
+                                            uint32_t) const
 {
   return -1;
 }
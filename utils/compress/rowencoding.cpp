@@ -0,0 +1,201 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstring>
+using namespace std;
+
+#include "rowencoding.h"
+#include "chunkencoding.h"
+
+namespace
+{
+// a column is a byte for raw or encoded, its size, then the bytes
+const uint8_t RAW = 0;
+const uint8_t ENCODED = 1;
+const size_t COLUMN_HEADER = 1 + sizeof(uint32_t);
+
+template <uint32_t W>
+void gather(const char* in, size_t rows, uint32_t rowSize, char* out)
+{
+  for (size_t i = 0; i < rows; i++, in += rowSize, out += W)
+    memcpy(out, in, W);
+}
+
+template <uint32_t W>
+void scatter(const char* in, size_t rows, uint32_t rowSize, char* out)
+{
+  for (size_t i = 0; i < rows; i++, in += W, out += rowSize)
+    memcpy(out, in, W);
+}
+
+void gather(const char* in, size_t rows, uint32_t rowSize, uint32_t width, char* out)
+{
+  switch (width)
+  {
+    case 1: gather<1>(in, rows, rowSize, out); break;
+    case 2: gather<2>(in, rows, rowSize, out); break;
+    case 4: gather<4>(in, rows, rowSize, out); break;
+    case 8: gather<8>(in, rows, rowSize, out); break;
+    case 16: gather<16>(in, rows, rowSize, out); break;
+    default:
+      for (size_t i = 0; i < rows; i++, in += rowSize, out += width)
+        memcpy(out, in, width);
+  }
+}
+
+void scatter(const char* in, size_t rows, uint32_t rowSize, uint32_t width, char* out)
+{
+  switch (width)
+  {
+    case 1: scatter<1>(in, rows, rowSize, out); break;
+    case 2: scatter<2>(in, rows, rowSize, out); break;
+    case 4: scatter<4>(in, rows, rowSize, out); break;
+    case 8: scatter<8>(in, rows, rowSize, out); break;
+    case 16: scatter<16>(in, rows, rowSize, out); break;
+    default:
+      for (size_t i = 0; i < rows; i++, in += width, out += rowSize)
+        memcpy(out, in, width);
+  }
+}
+
+// the row count of len bytes, -1 if they aren't rows of layout
+int64_t rowCount(size_t len, const vector<uint32_t>& layout)
+{
+  if (layout.size() < 3)
+    return -1;
+
+  const uint32_t header = layout[0];
+  const uint32_t rowSize = layout.back();
+
+  // the columns have to cover the rows
+  if (layout[1] != 0 || rowSize == 0 || len < header || (len - header) % rowSize != 0)
+    return -1;
+
+  for (size_t c = 1; c + 1 < layout.size(); c++)
+  {
+    if (layout[c] > layout[c + 1])
+      return -1;
+  }
+
+  return (len - header) / rowSize;
+}
+
+}  // namespace
+
+namespace compress
+{
+bool RowEncoding::encode(const char* in, size_t len, const vector<uint32_t>& layout, vector<char>& out)
+{
+  const int64_t rows = rowCount(len, layout);
+
+  if (rows < 0)
+    return false;
+
+  const uint32_t header = layout[0];
+  const uint32_t rowSize = layout.back();
+  vector<char> column;
+
+  out.clear();
+  out.reserve(len + layout.size() * COLUMN_HEADER);
+  out.insert(out.end(), in, in + header);
+
+  for (size_t c = 1; c + 1 < layout.size(); c++)
+  {
+    const uint32_t width = layout[c + 1] - layout[c];
+
+    if (width == 0)
+      continue;
+
+    column.resize(rows * width);
+    gather(in + header + layout[c], rows, rowSize, width, column.data());
+
+    ChunkEncoding::Plan plan;
+    size_t encodedLen = ChunkEncoding::plan(column.data(), column.size(), width, plan);
+    bool encoded = (encodedLen > 0 && encodedLen < column.size());
+    uint32_t size = (encoded ? encodedLen : column.size());
+    size_t pos = out.size();
+
+    out.resize(pos + COLUMN_HEADER + size);
+    out[pos] = (encoded ? ENCODED : RAW);
+    memcpy(&out[pos + 1], &size, sizeof(size));
+
+    if (encoded)
+      ChunkEncoding::encode(column.data(), plan, &out[pos + COLUMN_HEADER]);
+    else
+      memcpy(&out[pos + COLUMN_HEADER], column.data(), size);
+  }
+
+  return true;
+}
+
+bool RowEncoding::decode(const char* in, size_t inLen, const vector<uint32_t>& layout, char* out,
+                         size_t outLen)
+{
+  const int64_t rows = rowCount(outLen, layout);
+
+  if (rows < 0 || inLen < layout[0])
+    return false;
+
+  const uint32_t header = layout[0];
+  const uint32_t rowSize = layout.back();
+  const char* end = in + inLen;
+  vector<char> column;
+
+  memcpy(out, in, header);
+  in += header;
+
+  for (size_t c = 1; c + 1 < layout.size(); c++)
+  {
+    const uint32_t width = layout[c + 1] - layout[c];
+    uint32_t size;
+
+    if (width == 0)
+      continue;
+
+    if ((size_t)(end - in) < COLUMN_HEADER)
+      return false;
+
+    const uint8_t type = in[0];
+    memcpy(&size, in + 1, sizeof(size));
+    in += COLUMN_HEADER;
+
+    if ((size_t)(end - in) < size)
+      return false;
+
+    const char* values = in;
+    size_t valuesLen = rows * width;
+
+    if (type == ENCODED)
+    {
+      column.resize(valuesLen);
+
+      if (!ChunkEncoding::decode(in, size, column.data(), valuesLen) || valuesLen != column.size())
+        return false;
+
+      values = column.data();
+    }
+    else if (type != RAW || size != valuesLen)
+      return false;
+
+    scatter(values, rows, rowSize, width, out + header + layout[c]);
+    in += size;
+  }
+
+  return in == end;
+}
+
+}  // namespace compress
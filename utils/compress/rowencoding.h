@@ -0,0 +1,57 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <vector>
+
+#define EXPORT
+
+namespace compress
+{
+/** @brief Column by column encoding of fixed size rows, for the network
+ *
+ * Rows of RowGroup data interleave the columns, which hides the runs and the
+ * small ranges of a column from a general purpose codec.  This puts the values
+ * of every column together and encodes the ones of 1, 2, 4 and 8 bytes with
+ * ChunkEncoding if that is smaller.  The other widths are only put together.
+ * The result goes to the codec.
+ *
+ * The layout is the size of the header in front of the rows, then where each
+ * column starts in a row, then the row size.
+ */
+class RowEncoding
+{
+ public:
+  /** @brief Encodes the len bytes of in into out.  False if in isn't rows of layout */
+  EXPORT static bool encode(const char* in, size_t len, const std::vector<uint32_t>& layout,
+                            std::vector<char>& out);
+
+  /** @brief Decodes in into the outLen bytes of out.  False if in isn't a valid
+   *  encoding of outLen bytes of rows of layout.
+   */
+  EXPORT static bool decode(const char* in, size_t inLen, const std::vector<uint32_t>& layout, char* out,
+                            size_t outLen);
+};
+
+}  // namespace compress
+
+#undef EXPORT
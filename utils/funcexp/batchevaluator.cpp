@@ -0,0 +1,748 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "batchevaluator.h"
+
+#include "arithmeticcolumn.h"
+#include "arithmeticoperator.h"
+#include "constantcolumn.h"
+#include "functioncolumn.h"
+#include "logicoperator.h"
+#include "predicateoperator.h"
+#include "simplefilter.h"
+#include "simplecolumn_int.h"
+#include "simplecolumn_uint.h"
+#include "simplecolumn_decimal.h"
+using namespace execplan;
+
+#include "rowgroup.h"
+using namespace rowgroup;
+
+using namespace funcexp;
+
+namespace
+{
+// Calls getter(row, isNull, i) for every row of the selection with the
+// incoming null flag of the row and keeps the flag it leaves.
+template <typename Getter>
+inline void forEachRow(RowBatch& batch, const Selection& sel, BatchColumn& col, Getter getter)
+{
+  const uint32_t size = sel.size();
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    bool isNull = col.nulls[i];
+    getter(batch.row(sel[i]), isNull, i);
+    col.nulls[i] = isNull;
+  }
+}
+
+template <class Node>
+void rowByRow(Node* node, RowBatch& batch, const Selection& sel, BatchType type, BatchColumn& col)
+{
+  col.resize(type, sel.size());
+
+  switch (type)
+  {
+    case BatchType::INT:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.intVals[i] = node->getIntVal(row, isNull); });
+      break;
+
+    case BatchType::UINT:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i)
+                 { col.intVals[i] = static_cast<int64_t>(node->getUintVal(row, isNull)); });
+      break;
+
+    case BatchType::DOUBLE:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.doubleVals[i] = node->getDoubleVal(row, isNull); });
+      break;
+
+    case BatchType::FLOAT:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.doubleVals[i] = node->getFloatVal(row, isNull); });
+      break;
+
+    case BatchType::DECIMAL:
+      forEachRow(batch, sel, col, [&](Row& row, bool& isNull, uint32_t i)
+                 { col.decimalVals[i] = node->getDecimalVal(row, isNull); });
+      break;
+
+    case BatchType::STRING:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.strVals[i] = node->getStrVal(row, isNull); });
+      break;
+
+    case BatchType::BOOL:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.intVals[i] = node->getBoolVal(row, isNull); });
+      break;
+
+    case BatchType::DATE:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.intVals[i] = node->getDateIntVal(row, isNull); });
+      break;
+
+    case BatchType::DATETIME:
+      forEachRow(batch, sel, col, [&](Row& row, bool& isNull, uint32_t i)
+                 { col.intVals[i] = node->getDatetimeIntVal(row, isNull); });
+      break;
+
+    case BatchType::TIMESTAMP:
+      forEachRow(batch, sel, col, [&](Row& row, bool& isNull, uint32_t i)
+                 { col.intVals[i] = node->getTimestampIntVal(row, isNull); });
+      break;
+
+    case BatchType::TIME:
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.intVals[i] = node->getTimeIntVal(row, isNull); });
+      break;
+  }
+}
+
+// The simple column getters are inline. The qualified calls on the exact
+// class skip the virtual dispatch and let the compiler inline them.
+template <class SC>
+bool simpleColumn(TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type, BatchColumn& col)
+{
+  SC* sc = dynamic_cast<SC*>(node);
+
+  if (!sc)
+    return false;
+
+  switch (type)
+  {
+    case BatchType::INT:
+      col.resize(type, sel.size());
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i) { col.intVals[i] = sc->SC::getIntVal(row, isNull); });
+      return true;
+
+    case BatchType::UINT:
+      col.resize(type, sel.size());
+      forEachRow(batch, sel, col,
+                 [&](Row& row, bool& isNull, uint32_t i)
+                 { col.intVals[i] = static_cast<int64_t>(sc->SC::getUintVal(row, isNull)); });
+      return true;
+
+    case BatchType::DOUBLE:
+      col.resize(type, sel.size());
+      forEachRow(batch, sel, col, [&](Row& row, bool& isNull, uint32_t i)
+                 { col.doubleVals[i] = sc->SC::getDoubleVal(row, isNull); });
+      return true;
+
+    case BatchType::DECIMAL:
+      col.resize(type, sel.size());
+      forEachRow(batch, sel, col, [&](Row& row, bool& isNull, uint32_t i)
+                 { col.decimalVals[i] = sc->SC::getDecimalVal(row, isNull); });
+      return true;
+
+    default: return false;
+  }
+}
+
+template <template <int> class SC>
+bool simpleColumnOfWidth(TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type,
+                         BatchColumn& col)
+{
+  return simpleColumn<SC<8>>(node, batch, sel, type, col) || simpleColumn<SC<4>>(node, batch, sel, type, col) ||
+         simpleColumn<SC<2>>(node, batch, sel, type, col) || simpleColumn<SC<1>>(node, batch, sel, type, col);
+}
+
+bool simpleColumns(TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type, BatchColumn& col)
+{
+  if (!dynamic_cast<SimpleColumn*>(node))
+    return false;
+
+  return simpleColumnOfWidth<SimpleColumn_INT>(node, batch, sel, type, col) ||
+         simpleColumnOfWidth<SimpleColumn_UINT>(node, batch, sel, type, col) ||
+         simpleColumnOfWidth<SimpleColumn_Decimal>(node, batch, sel, type, col);
+}
+
+// Constants don't depend on the row, so they are evaluated once and copied.
+void constantColumn(ConstantColumn* cc, RowBatch& batch, const Selection& sel, BatchType type,
+                    BatchColumn& col)
+{
+  const uint32_t size = sel.size();
+  BatchColumn one;
+  Selection first(1, sel[0]);
+
+  one.reset(type, 1);
+  rowByRow(static_cast<TreeNode*>(cc), batch, first, type, one);
+  col.resize(type, size);
+
+  switch (type)
+  {
+    case BatchType::DOUBLE:
+    case BatchType::FLOAT: std::fill(col.doubleVals.begin(), col.doubleVals.begin() + size, one.doubleVals[0]); break;
+
+    case BatchType::DECIMAL:
+      std::fill(col.decimalVals.begin(), col.decimalVals.begin() + size, one.decimalVals[0]);
+      break;
+
+    case BatchType::STRING: std::fill(col.strVals.begin(), col.strVals.begin() + size, one.strVals[0]); break;
+
+    default: std::fill(col.intVals.begin(), col.intVals.begin() + size, one.intVals[0]); break;
+  }
+
+  if (one.nulls[0])
+    std::fill(col.nulls.begin(), col.nulls.begin() + size, 1);
+}
+
+inline void storeArithmeticResult(ArithmeticOperator* op, BatchType type, BatchColumn& col, uint32_t i)
+{
+  switch (type)
+  {
+    case BatchType::INT: col.intVals[i] = op->TreeNode::getIntVal(); break;
+
+    case BatchType::UINT: col.intVals[i] = static_cast<int64_t>(op->TreeNode::getUintVal()); break;
+
+    case BatchType::DOUBLE: col.doubleVals[i] = op->TreeNode::getDoubleVal(); break;
+
+    case BatchType::FLOAT: col.doubleVals[i] = op->TreeNode::getFloatVal(); break;
+
+    case BatchType::DECIMAL: col.decimalVals[i] = op->getDecimalResult(); break;
+
+    case BatchType::STRING: col.strVals[i] = op->TreeNode::getStrVal(op->timeZone()); break;
+
+    case BatchType::BOOL: col.intVals[i] = op->TreeNode::getBoolVal(); break;
+
+    case BatchType::DATE: col.intVals[i] = op->TreeNode::getDateIntVal(); break;
+
+    case BatchType::DATETIME: col.intVals[i] = op->TreeNode::getDatetimeIntVal(); break;
+
+    case BatchType::TIMESTAMP: col.intVals[i] = op->TreeNode::getTimestampIntVal(); break;
+
+    case BatchType::TIME: col.intVals[i] = op->TreeNode::getTimeIntVal(); break;
+  }
+}
+
+// Both operands are always evaluated, the right one with the null flags the
+// left one leaves, like ArithmeticOperator::evaluate() does.
+bool arithmetic(ArithmeticOperator* op, ParseTree* lop, ParseTree* rop, RowBatch& batch, const Selection& sel,
+                BatchType type, BatchColumn& col)
+{
+  BatchType operandType;
+
+  switch (op->operationType().colDataType)
+  {
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::TINYINT: operandType = BatchType::INT; break;
+
+    case CalpontSystemCatalog::UBIGINT:
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UMEDINT:
+    case CalpontSystemCatalog::USMALLINT:
+    case CalpontSystemCatalog::UTINYINT: operandType = BatchType::UINT; break;
+
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UDOUBLE:
+    case CalpontSystemCatalog::UFLOAT: operandType = BatchType::DOUBLE; break;
+
+    case CalpontSystemCatalog::DECIMAL:
+    case CalpontSystemCatalog::UDECIMAL: operandType = BatchType::DECIMAL; break;
+
+    default: return false;
+  }
+
+  const uint32_t size = sel.size();
+  BatchColumn lhs, rhs;
+
+  lhs.nulls = col.nulls;
+  BatchEvaluator::evaluate(lop, batch, sel, operandType, lhs);
+  rhs.nulls = lhs.nulls;
+  BatchEvaluator::evaluate(rop, batch, sel, operandType, rhs);
+  col.resize(type, size);
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    bool isNull = rhs.nulls[i];
+
+    switch (operandType)
+    {
+      case BatchType::INT: op->compute(lhs.intVals[i], rhs.intVals[i], isNull); break;
+
+      case BatchType::UINT:
+        op->compute(static_cast<uint64_t>(lhs.intVals[i]), static_cast<uint64_t>(rhs.intVals[i]), isNull);
+        break;
+
+      case BatchType::DOUBLE: op->compute(lhs.doubleVals[i], rhs.doubleVals[i], isNull); break;
+
+      default: op->compute(lhs.decimalVals[i], rhs.decimalVals[i], isNull); break;
+    }
+
+    storeArithmeticResult(op, type, col, i);
+    col.nulls[i] = isNull;
+  }
+
+  return true;
+}
+
+// SimpleFilter getBoolVal()/getIntVal() on numeric operands. The operands are
+// evaluated on the rows PredicateOperator::getBoolVal() would evaluate them on.
+bool simpleFilter(SimpleFilter* sf, RowBatch& batch, const Selection& sel, BatchType type, BatchColumn& col)
+{
+  if (type != BatchType::BOOL && type != BatchType::INT)
+    return false;
+
+  PredicateOperator* op = dynamic_cast<PredicateOperator*>(sf->op().get());
+
+  if (!op)
+    return false;
+
+  BatchType operandType;
+
+  switch (op->operationType().colDataType)
+  {
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT: operandType = BatchType::INT; break;
+
+    case CalpontSystemCatalog::UBIGINT:
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UMEDINT:
+    case CalpontSystemCatalog::UTINYINT:
+    case CalpontSystemCatalog::USMALLINT: operandType = BatchType::UINT; break;
+
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UFLOAT:
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::UDOUBLE: operandType = BatchType::DOUBLE; break;
+
+    default: return false;
+  }
+
+  const uint32_t size = sel.size();
+
+  switch (op->op())
+  {
+    case OP_ISNULL:
+    case OP_ISNOTNULL:
+    {
+      BatchColumn lhs;
+      const bool isNotNull = (op->op() == OP_ISNOTNULL);
+
+      lhs.nulls = col.nulls;
+      BatchEvaluator::evaluate(sf->lhs(), batch, sel, operandType, lhs);
+      col.resize(type, size);
+
+      for (uint32_t i = 0; i < size; i++)
+      {
+        col.intVals[i] = isNotNull ? !lhs.nulls[i] : lhs.nulls[i] != 0;
+        col.nulls[i] = 0;
+      }
+
+      return true;
+    }
+
+    case OP_EQ:
+    case OP_NE:
+    case OP_GT:
+    case OP_GE:
+    case OP_LT:
+    case OP_LE: break;
+
+    default: return false;
+  }
+
+  col.resize(type, size);
+
+  // A row that comes in as NULL is false and the operands are not evaluated.
+  std::vector<uint32_t> positions;
+  positions.reserve(size);
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    col.intVals[i] = 0;
+
+    if (!col.nulls[i])
+      positions.push_back(i);
+  }
+
+  if (positions.empty())
+    return true;
+
+  Selection lhsSel;
+  BatchColumn lhs;
+  BatchEvaluator::select(sel, positions, lhsSel);
+  lhs.reset(operandType, lhsSel.size());
+  BatchEvaluator::evaluate(sf->lhs(), batch, lhsSel, operandType, lhs);
+
+  // The right operand is skipped where the left one is NULL
+  std::vector<uint32_t> rhsPositions;
+  std::vector<uint32_t> lhsPositions;
+  rhsPositions.reserve(positions.size());
+  lhsPositions.reserve(positions.size());
+
+  for (uint32_t j = 0; j < positions.size(); j++)
+  {
+    if (lhs.nulls[j])
+    {
+      col.nulls[positions[j]] = 1;
+    }
+    else
+    {
+      rhsPositions.push_back(positions[j]);
+      lhsPositions.push_back(j);
+    }
+  }
+
+  if (rhsPositions.empty())
+    return true;
+
+  Selection rhsSel;
+  BatchColumn rhs;
+  BatchEvaluator::select(sel, rhsPositions, rhsSel);
+  rhs.reset(operandType, rhsSel.size());
+  BatchEvaluator::evaluate(sf->rhs(), batch, rhsSel, operandType, rhs);
+
+  for (uint32_t k = 0; k < rhsPositions.size(); k++)
+  {
+    const uint32_t i = rhsPositions[k];
+    const uint32_t j = lhsPositions[k];
+    bool result;
+
+    switch (operandType)
+    {
+      case BatchType::INT: result = op->compare(lhs.intVals[j], rhs.intVals[k]); break;
+
+      case BatchType::UINT:
+        result = op->compare(static_cast<uint64_t>(lhs.intVals[j]), static_cast<uint64_t>(rhs.intVals[k]));
+        break;
+
+      default: result = op->compare(lhs.doubleVals[j], rhs.doubleVals[k]); break;
+    }
+
+    col.intVals[i] = result && !rhs.nulls[k];
+    col.nulls[i] = rhs.nulls[k];
+  }
+
+  return true;
+}
+
+// Evaluates tree as BOOL on the rows at positions with the given incoming null flags.
+void subBool(ParseTree* tree, RowBatch& batch, const Selection& sel, const std::vector<uint32_t>& positions,
+             const std::vector<uint8_t>& nulls, BatchColumn& sub)
+{
+  Selection subSel;
+  BatchEvaluator::select(sel, positions, subSel);
+  sub.nulls.resize(positions.size());
+
+  for (uint32_t j = 0; j < positions.size(); j++)
+    sub.nulls[j] = nulls[positions[j]];
+
+  BatchEvaluator::evaluate(tree, batch, subSel, BatchType::BOOL, sub);
+}
+
+// LogicOperator::getBoolVal()
+void logic(LogicOperator* op, ParseTree* lop, ParseTree* rop, RowBatch& batch, const Selection& sel,
+           BatchColumn& col)
+{
+  const uint32_t size = sel.size();
+  BatchColumn lhs, rhs;
+  std::vector<uint32_t> positions;
+
+  lhs.nulls = col.nulls;
+  BatchEvaluator::evaluate(lop, batch, sel, BatchType::BOOL, lhs);
+  col.resize(BatchType::BOOL, size);
+  positions.reserve(size);
+
+  switch (op->op())
+  {
+    case OP_AND:
+    {
+      // the right operand only where the left one is true, with its null flag
+      for (uint32_t i = 0; i < size; i++)
+      {
+        col.intVals[i] = 0;
+        col.nulls[i] = lhs.nulls[i];
+
+        if (lhs.intVals[i])
+          positions.push_back(i);
+      }
+
+      subBool(rop, batch, sel, positions, lhs.nulls, rhs);
+      break;
+    }
+
+    case OP_OR:
+    {
+      // the right operand where the left one is false, with the null flag reset
+      std::vector<uint8_t> noNulls(size, 0);
+
+      for (uint32_t i = 0; i < size; i++)
+      {
+        col.intVals[i] = 1;
+        col.nulls[i] = lhs.nulls[i];
+
+        if (!lhs.intVals[i])
+          positions.push_back(i);
+      }
+
+      subBool(rop, batch, sel, positions, noNulls, rhs);
+      break;
+    }
+
+    case OP_XOR:
+    {
+      for (uint32_t i = 0; i < size; i++)
+      {
+        col.intVals[i] = 0;
+        col.nulls[i] = lhs.nulls[i];
+
+        if (!lhs.nulls[i])
+          positions.push_back(i);
+      }
+
+      subBool(rop, batch, sel, positions, lhs.nulls, rhs);
+
+      for (uint32_t j = 0; j < positions.size(); j++)
+      {
+        const uint32_t i = positions[j];
+
+        if (!rhs.nulls[j])
+          rhs.intVals[j] = (lhs.intVals[i] != 0) != (rhs.intVals[j] != 0);
+        else
+          rhs.intVals[j] = 0;
+      }
+
+      break;
+    }
+
+    default: throw std::runtime_error("invalid logical operation");
+  }
+
+  BatchEvaluator::scatter(rhs, BatchType::BOOL, positions, col);
+}
+
+}  // namespace
+
+namespace funcexp
+{
+void BatchEvaluator::evaluate(ParseTree* tree, RowBatch& batch, const Selection& sel, BatchType type,
+                              BatchColumn& col)
+{
+  if (sel.empty())
+  {
+    col.resize(type, 0);
+    return;
+  }
+
+  if (!tree->left() || !tree->right())
+  {
+    evaluate(tree->data(), batch, sel, type, col);
+    return;
+  }
+
+  if (ArithmeticOperator* op = dynamic_cast<ArithmeticOperator*>(tree->data()))
+  {
+    if (arithmetic(op, tree->left(), tree->right(), batch, sel, type, col))
+      return;
+  }
+  else if (LogicOperator* op = dynamic_cast<LogicOperator*>(tree->data()))
+  {
+    if (type == BatchType::BOOL)
+    {
+      logic(op, tree->left(), tree->right(), batch, sel, col);
+      return;
+    }
+  }
+
+  evaluateRows(tree, batch, sel, type, col);
+}
+
+void BatchEvaluator::evaluate(TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type,
+                              BatchColumn& col)
+{
+  if (sel.empty())
+  {
+    col.resize(type, 0);
+    return;
+  }
+
+  if (ArithmeticColumn* ac = dynamic_cast<ArithmeticColumn*>(node))
+  {
+    evaluate(ac->expression(), batch, sel, type, col);
+    return;
+  }
+
+  if (FunctionColumn* fc = dynamic_cast<FunctionColumn*>(node))
+  {
+    if (fc->evaluateBatch(batch, sel, type, col))
+      return;
+  }
+  else if (ConstantColumn* cc = dynamic_cast<ConstantColumn*>(node))
+  {
+    constantColumn(cc, batch, sel, type, col);
+    return;
+  }
+  else if (SimpleFilter* sf = dynamic_cast<SimpleFilter*>(node))
+  {
+    if (simpleFilter(sf, batch, sel, type, col))
+      return;
+  }
+  else if (simpleColumns(node, batch, sel, type, col))
+  {
+    return;
+  }
+
+  evaluateRows(node, batch, sel, type, col);
+}
+
+void BatchEvaluator::evaluateRows(ParseTree* tree, RowBatch& batch, const Selection& sel, BatchType type,
+                                  BatchColumn& col)
+{
+  rowByRow(tree, batch, sel, type, col);
+}
+
+void BatchEvaluator::evaluateRows(TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type,
+                                  BatchColumn& col)
+{
+  rowByRow(node, batch, sel, type, col);
+}
+
+void BatchEvaluator::filter(ParseTree* filter, RowBatch& batch, Selection& sel)
+{
+  BatchColumn result;
+  uint32_t passed = 0;
+
+  result.reset(BatchType::BOOL, sel.size());
+  evaluate(filter, batch, sel, BatchType::BOOL, result);
+
+  for (uint32_t i = 0; i < sel.size(); i++)
+  {
+    if (result.intVals[i])
+      sel[passed++] = sel[i];
+  }
+
+  sel.resize(passed);
+}
+
+void BatchEvaluator::select(const Selection& sel, const std::vector<uint32_t>& positions, Selection& subSel)
+{
+  subSel.resize(positions.size());
+
+  for (uint32_t j = 0; j < positions.size(); j++)
+    subSel[j] = sel[positions[j]];
+}
+
+void BatchEvaluator::evaluateAt(TreeNode* node, RowBatch& batch, const Selection& sel,
+                                const std::vector<uint32_t>& positions, BatchType type, BatchColumn& col)
+{
+  if (positions.empty())
+    return;
+
+  if (positions.size() == sel.size())
+  {
+    evaluate(node, batch, sel, type, col);
+    return;
+  }
+
+  Selection subSel;
+  BatchColumn sub;
+
+  select(sel, positions, subSel);
+  sub.nulls.resize(positions.size());
+
+  for (uint32_t j = 0; j < positions.size(); j++)
+    sub.nulls[j] = col.nulls[positions[j]];
+
+  evaluate(node, batch, subSel, type, sub);
+  scatter(sub, type, positions, col);
+}
+
+void BatchEvaluator::scatter(const BatchColumn& sub, BatchType type, const std::vector<uint32_t>& positions,
+                             BatchColumn& col)
+{
+  for (uint32_t j = 0; j < positions.size(); j++)
+  {
+    const uint32_t i = positions[j];
+
+    switch (type)
+    {
+      case BatchType::DOUBLE:
+      case BatchType::FLOAT: col.doubleVals[i] = sub.doubleVals[j]; break;
+
+      case BatchType::DECIMAL: col.decimalVals[i] = sub.decimalVals[j]; break;
+
+      case BatchType::STRING: col.strVals[i] = sub.strVals[j]; break;
+
+      default: col.intVals[i] = sub.intVals[j]; break;
+    }
+
+    col.nulls[i] = sub.nulls[j];
+  }
+}
+
+bool BatchEvaluator::evaluateDatePart(TreeNode* arg, RowBatch& batch, const Selection& sel, BatchType type,
+                                      BatchColumn& col, uint32_t dateShift, uint32_t datetimeShift, int64_t mask)
+{
+  uint32_t shift;
+
+  if (!isIntConvertible(type))
+    return false;
+
+  switch (arg->resultType().colDataType)
+  {
+    case CalpontSystemCatalog::DATE: shift = dateShift; break;
+
+    case CalpontSystemCatalog::DATETIME: shift = datetimeShift; break;
+
+    default: return false;
+  }
+
+  const uint32_t size = sel.size();
+  BatchColumn val;
+
+  val.nulls = col.nulls;
+  evaluate(arg, batch, sel, BatchType::INT, val);
+  col.resize(type, size);
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    setInt(col, type, i, (val.intVals[i] >> shift) & mask);
+    col.nulls[i] = val.nulls[i];
+  }
+
+  return true;
+}
+
+bool BatchEvaluator::isIntConvertible(BatchType type)
+{
+  switch (type)
+  {
+    case BatchType::INT:
+    case BatchType::UINT:
+    case BatchType::DOUBLE:
+    case BatchType::FLOAT: return true;
+
+    default: return false;
+  }
+}
+
+}  // namespace funcexp
@@ -0,0 +1,107 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <vector>
+
+#include "parsetree.h"
+#include "rowbatch.h"
+
+namespace funcexp
+{
+/** @brief Column at a time evaluation of F&E expression trees
+ *
+ * Each node of the tree is evaluated for the whole selection before its parent
+ * is, so the virtual dispatch and the Row positioning are paid once per node and
+ * batch instead of once per node and row. Arithmetic, comparison and logic
+ * operators, constants, simple columns and the functors that implement
+ * Func::evaluateBatch() are evaluated that way. Every other node falls back to
+ * its row based getters.
+ *
+ * The batch evaluation follows the row based one exactly, including the isNull
+ * flag the getters share and the short-circuit of the predicates and the logic
+ * operators, i.e. a node is only evaluated on the rows the row based evaluation
+ * would evaluate it on.
+ */
+class BatchEvaluator
+{
+ public:
+  /** @brief evaluate a parse tree on the selection
+   *
+   * @param col on input col.nulls holds the incoming isNull flag for every
+   *        entry of sel. On output the values of type and the result flags.
+   */
+  static void evaluate(execplan::ParseTree* tree, RowBatch& batch, const Selection& sel, BatchType type,
+                       BatchColumn& col);
+
+  /** @brief evaluate a tree node on the selection. See above for col. */
+  static void evaluate(execplan::TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type,
+                       BatchColumn& col);
+
+  /** @brief row based fallbacks, call the getter of type for every row */
+  static void evaluateRows(execplan::ParseTree* tree, RowBatch& batch, const Selection& sel, BatchType type,
+                           BatchColumn& col);
+  static void evaluateRows(execplan::TreeNode* node, RowBatch& batch, const Selection& sel, BatchType type,
+                           BatchColumn& col);
+
+  /** @brief remove the rows filter doesn't pass from sel */
+  static void filter(execplan::ParseTree* filter, RowBatch& batch, Selection& sel);
+
+  /** @brief evaluate node only on the rows at positions
+   *
+   * positions are indexes into sel, used for the branches of the conditional
+   * functions. The incoming flags are taken from col.nulls and the results are
+   * stored at the same positions of col, which must be sized for type.
+   */
+  static void evaluateAt(execplan::TreeNode* node, RowBatch& batch, const Selection& sel,
+                         const std::vector<uint32_t>& positions, BatchType type, BatchColumn& col);
+
+  /** @brief sub selection helpers
+   *
+   * select() collects the rows at positions and scatter() copies the results of
+   * the sub selection back to their positions in col.
+   */
+  static void select(const Selection& sel, const std::vector<uint32_t>& positions, Selection& subSel);
+  static void scatter(const BatchColumn& sub, BatchType type, const std::vector<uint32_t>& positions,
+                      BatchColumn& col);
+
+  /** @brief (arg >> shift) & mask of a DATE or DATETIME argument, for year(), month() etc.
+   *
+   * Returns false before touching col for the other argument types.
+   */
+  static bool evaluateDatePart(execplan::TreeNode* arg, RowBatch& batch, const Selection& sel, BatchType type,
+                               BatchColumn& col, uint32_t dateShift, uint32_t datetimeShift, int64_t mask);
+
+  /** @brief store an integer result as type, the way Func_Int converts it */
+  static bool isIntConvertible(BatchType type);
+  static inline void setInt(BatchColumn& col, BatchType type, uint32_t i, int64_t val)
+  {
+    switch (type)
+    {
+      case BatchType::DOUBLE: col.doubleVals[i] = (double)val; break;
+
+      case BatchType::FLOAT: col.doubleVals[i] = (float)(double)val; break;
+
+      default: col.intVals[i] = val; break;
+    }
+  }
+};
+
+}  // namespace funcexp
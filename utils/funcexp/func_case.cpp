@@ -35,6 +35,8 @@ using namespace execplan;
 #include "rowgroup.h"
 using namespace rowgroup;
 
+#include "batchevaluator.h"
+
 #include "errorcodes.h"
 #include "idberrorinfo.h"
 #include "errorids.h"
@@ -722,4 +724,98 @@ int64_t Func_searched_case::getTimeIntVal(rowgroup::Row& row, FunctionParm& parm
   return parm[i]->data()->getTimeIntVal(row, isNull);
 }
 
+
+bool Func_searched_case::evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& parm,
+                                       CalpontSystemCatalog::ColType&, BatchType type, BatchColumn& col)
+{
+  // getUintVal() is Func's cast of getIntVal(). Float and bool are left to the row getters.
+  const BatchType branchType = (type == BatchType::UINT) ? BatchType::INT : type;
+
+  if (type == BatchType::FLOAT || type == BatchType::BOOL)
+    return false;
+
+  const uint32_t size = sel.size();
+  const uint64_t hasElse = parm.size() % 2;  // if 1, then ELSE exist
+  const uint64_t whereCount = hasElse ? (parm.size() - 1) / 2 : parm.size() / 2;
+
+  // Like searched_case_cmp() the conditions are tried in order on the rows that
+  // have no match yet, and the isNull flag carries from one condition to the next.
+  std::vector<uint8_t> flags(col.nulls.begin(), col.nulls.begin() + size);
+  std::vector<std::vector<uint32_t> > matched(whereCount);
+  std::vector<uint32_t> pending(size), stillPending;
+
+  for (uint32_t i = 0; i < size; i++)
+    pending[i] = i;
+
+  for (uint64_t w = 0; w < whereCount && !pending.empty(); w++)
+  {
+    Selection condSel;
+    BatchColumn cond;
+
+    BatchEvaluator::select(sel, pending, condSel);
+    cond.nulls.resize(pending.size());
+
+    for (uint32_t j = 0; j < pending.size(); j++)
+      cond.nulls[j] = flags[pending[j]];
+
+    BatchEvaluator::evaluate(parm[w].get(), batch, condSel, BatchType::BOOL, cond);
+    stillPending.clear();
+
+    for (uint32_t j = 0; j < pending.size(); j++)
+    {
+      flags[pending[j]] = cond.nulls[j];
+
+      if (cond.intVals[j])
+        matched[w].push_back(pending[j]);
+      else
+        stillPending.push_back(pending[j]);
+    }
+
+    pending.swap(stillPending);
+  }
+
+  // isNull is reset before the result is evaluated
+  col.resize(branchType, size);
+  std::fill(col.nulls.begin(), col.nulls.begin() + size, 0);
+
+  for (uint64_t w = 0; w < whereCount; w++)
+    BatchEvaluator::evaluateAt(parm[w + whereCount]->data(), batch, sel, matched[w], branchType, col);
+
+  if (hasElse)
+  {
+    BatchEvaluator::evaluateAt(parm[parm.size() - 1]->data(), batch, sel, pending, branchType, col);
+    return true;
+  }
+
+  // No match and no ELSE is NULL, with the values the row getters return
+  for (uint32_t j = 0; j < pending.size(); j++)
+  {
+    const uint32_t i = pending[j];
+    col.nulls[i] = 1;
+
+    switch (branchType)
+    {
+      case BatchType::INT: col.intVals[i] = joblist::BIGINTNULL; break;
+
+      case BatchType::DOUBLE: col.doubleVals[i] = doubleNullVal(); break;
+
+      case BatchType::DECIMAL: col.decimalVals[i] = IDB_Decimal(); break;
+
+      case BatchType::STRING: col.strVals[i].clear(); break;
+
+      case BatchType::DATE: col.intVals[i] = joblist::DATENULL; break;
+
+      case BatchType::DATETIME: col.intVals[i] = joblist::DATETIMENULL; break;
+
+      case BatchType::TIMESTAMP: col.intVals[i] = joblist::TIMESTAMPNULL; break;
+
+      case BatchType::TIME: col.intVals[i] = joblist::TIMENULL; break;
+
+      default: break;
+    }
+  }
+
+  return true;
+}
+
 }  // namespace funcexp
@@ -29,6 +29,7 @@ using namespace std;
 #include "functor_int.h"
 #include "functioncolumn.h"
 #include "rowgroup.h"
+#include "batchevaluator.h"
 using namespace execplan;
 
 #include "dataconvert.h"
@@ -142,4 +143,10 @@ int64_t Func_day::getIntVal(rowgroup::Row& row, FunctionParm& parm, bool& isNull
   return -1;
 }
 
+bool Func_day::evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& parm,
+                             CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col)
+{
+  return BatchEvaluator::evaluateDatePart(parm[0]->data(), batch, sel, type, col, 6, 38, 0x3f);
+}
+
 }  // namespace funcexp
@@ -33,6 +33,8 @@ using namespace execplan;
 #include "rowgroup.h"
 using namespace rowgroup;
 
+#include "batchevaluator.h"
+
 namespace
 {
 bool boolVal(SPTP& parm, Row& row, long timeZone)
@@ -233,4 +235,46 @@ int64_t Func_if::getTimeIntVal(Row& row, FunctionParm& parm, bool& isNull, Calpo
     return parm[2]->data()->getTimeIntVal(row, isNull);
   }
 }
+
+bool Func_if::evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& parm,
+                            CalpontSystemCatalog::ColType& ct, BatchType type, BatchColumn& col)
+{
+  // getUintVal() is Func's cast of getIntVal(). Float and bool are left to the row getters.
+  const BatchType branchType = (type == BatchType::UINT) ? BatchType::INT : type;
+
+  if (type == BatchType::FLOAT || type == BatchType::BOOL)
+    return false;
+
+  const uint32_t size = sel.size();
+  BatchColumn cond;
+  cond.reset(BatchType::BOOL, size);
+
+  try
+  {
+    BatchEvaluator::evaluate(parm[0].get(), batch, sel, BatchType::BOOL, cond);
+  }
+  catch (logging::NotImplementedExcept&)
+  {
+    // boolVal() converts such conditions row by row
+    return false;
+  }
+
+  std::vector<uint32_t> thenRows, elseRows;
+  thenRows.reserve(size);
+  elseRows.reserve(size);
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    if (cond.intVals[i] && !cond.nulls[i])
+      thenRows.push_back(i);
+    else
+      elseRows.push_back(i);
+  }
+
+  col.resize(branchType, size);
+  BatchEvaluator::evaluateAt(parm[1]->data(), batch, sel, thenRows, branchType, col);
+  BatchEvaluator::evaluateAt(parm[2]->data(), batch, sel, elseRows, branchType, col);
+  return true;
+}
+
 }  // namespace funcexp
@@ -32,6 +32,7 @@ using namespace std;
 using namespace execplan;
 
 #include "rowgroup.h"
+#include "batchevaluator.h"
 
 namespace funcexp
 {
@@ -54,4 +55,28 @@ int64_t Func_length::getIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNul
   return strlen(fp[0]->data()->getStrVal(row, isNull).c_str());
 }
 
+bool Func_length::evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                                CalpontSystemCatalog::ColType&, BatchType type, BatchColumn& col)
+{
+  if (!BatchEvaluator::isIntConvertible(type))
+    return false;
+
+  const bool binary = (fp[0]->data()->resultType().colDataType == CalpontSystemCatalog::VARBINARY) ||
+                      (fp[0]->data()->resultType().colDataType == CalpontSystemCatalog::BLOB);
+  const uint32_t size = sel.size();
+  BatchColumn str;
+
+  str.nulls = col.nulls;
+  BatchEvaluator::evaluate(fp[0]->data(), batch, sel, BatchType::STRING, str);
+  col.resize(type, size);
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    BatchEvaluator::setInt(col, type, i, binary ? str.strVals[i].length() : strlen(str.strVals[i].c_str()));
+    col.nulls[i] = str.nulls[i];
+  }
+
+  return true;
+}
+
 }  // namespace funcexp
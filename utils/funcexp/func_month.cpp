@@ -29,6 +29,7 @@ using namespace std;
 #include "functor_int.h"
 #include "functioncolumn.h"
 #include "rowgroup.h"
+#include "batchevaluator.h"
 using namespace execplan;
 
 #include "dataconvert.h"
@@ -141,4 +142,10 @@ int64_t Func_month::getIntVal(rowgroup::Row& row, FunctionParm& parm, bool& isNu
   return -1;
 }
 
+bool Func_month::evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& parm,
+                               CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col)
+{
+  return BatchEvaluator::evaluateDatePart(parm[0]->data(), batch, sel, type, col, 12, 44, 0xf);
+}
+
 }  // namespace funcexp
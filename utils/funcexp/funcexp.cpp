@@ -25,6 +25,7 @@
 #include <boost/thread/mutex.hpp>
 
 #include "funcexp.h"
+#include "batchevaluator.h"
 #include "functor_all.h"
 #include "functor_bool.h"
 #include "functor_dtm.h"
@@ -547,4 +548,289 @@ void FuncExp::evaluate(rowgroup::Row& row, std::vector<execplan::SRCP>& expressi
   }
 }
 
+void FuncExp::evaluate(rowgroup::RowGroup& rowgroup, std::vector<execplan::SRCP>& expressions)
+{
+  Selection selection(rowgroup.getRowCount());
+
+  for (uint32_t i = 0; i < selection.size(); i++)
+    selection[i] = i;
+
+  evaluate(rowgroup, selection, expressions);
+}
+
+void FuncExp::evaluate(rowgroup::RowGroup& rowgroup, execplan::ParseTree* filters, Selection& selection)
+{
+  RowBatch batch(rowgroup);
+  BatchEvaluator::filter(filters, batch, selection);
+}
+
+void FuncExp::evaluate(rowgroup::RowGroup& rowgroup, const Selection& selection,
+                       std::vector<execplan::SRCP>& expressions)
+{
+  if (selection.empty())
+    return;
+
+  RowBatch batch(rowgroup);
+  BatchColumn col;
+  const uint32_t size = selection.size();
+
+  for (uint32_t e = 0; e < expressions.size(); e++)
+  {
+    ReturnedColumn* expression = expressions[e].get();
+    const uint32_t outputIndex = expression->outputIndex();
+
+    switch (expression->resultType().colDataType)
+    {
+      case CalpontSystemCatalog::DATE:
+      {
+        col.reset(BatchType::INT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::INT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          int64_t val = col.intVals[i];
+
+          // @bug6061, workaround date_add always return datetime for both date and datetime
+          if (val & 0xFFFFFFFF00000000)
+            val = (((val >> 32) & 0xFFFFFFC0) | 0x3E);
+
+          batch.row(selection[i]).setUintField<4>(col.nulls[i] ? DATENULL : val, outputIndex);
+        }
+
+        break;
+      }
+
+      case CalpontSystemCatalog::DATETIME:
+      {
+        col.reset(BatchType::DATETIME, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::DATETIME, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setUintField<8>(col.nulls[i] ? DATETIMENULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::TIMESTAMP:
+      {
+        col.reset(BatchType::TIMESTAMP, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::TIMESTAMP, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setUintField<8>(col.nulls[i] ? TIMESTAMPNULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::TIME:
+      {
+        col.reset(BatchType::TIME, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::TIME, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setIntField<8>(col.nulls[i] ? TIMENULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::CHAR:
+      case CalpontSystemCatalog::VARCHAR:
+
+      // TODO: might not be right thing for BLOB
+      case CalpontSystemCatalog::BLOB:
+      case CalpontSystemCatalog::TEXT:
+      {
+        col.reset(BatchType::STRING, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::STRING, col);
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          if (col.nulls[i])
+            batch.row(selection[i]).setStringField(CPNULLSTRMARK, outputIndex);
+          else
+            batch.row(selection[i]).setStringField(col.strVals[i], outputIndex);
+        }
+
+        break;
+      }
+
+      case CalpontSystemCatalog::BIGINT:
+      {
+        col.reset(BatchType::INT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::INT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setIntField<8>(col.nulls[i] ? BIGINTNULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::UBIGINT:
+      {
+        col.reset(BatchType::UINT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::UINT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setUintField<8>(col.nulls[i] ? UBIGINTNULL : (uint64_t)col.intVals[i],
+                                                  outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::INT:
+      case CalpontSystemCatalog::MEDINT:
+      {
+        col.reset(BatchType::INT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::INT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setIntField<4>(col.nulls[i] ? INTNULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::UINT:
+      case CalpontSystemCatalog::UMEDINT:
+      {
+        col.reset(BatchType::UINT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::UINT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setUintField<4>(col.nulls[i] ? UINTNULL : (uint64_t)col.intVals[i],
+                                                  outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::SMALLINT:
+      {
+        col.reset(BatchType::INT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::INT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setIntField<2>(col.nulls[i] ? SMALLINTNULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::USMALLINT:
+      {
+        col.reset(BatchType::UINT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::UINT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setUintField<2>(col.nulls[i] ? USMALLINTNULL : (uint64_t)col.intVals[i],
+                                                  outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::TINYINT:
+      {
+        col.reset(BatchType::INT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::INT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setIntField<1>(col.nulls[i] ? TINYINTNULL : col.intVals[i], outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::UTINYINT:
+      {
+        col.reset(BatchType::UINT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::UINT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+          batch.row(selection[i]).setUintField<1>(col.nulls[i] ? UTINYINTNULL : (uint64_t)col.intVals[i],
+                                                  outputIndex);
+
+        break;
+      }
+
+      case CalpontSystemCatalog::DOUBLE:
+      case CalpontSystemCatalog::UDOUBLE:
+      {
+        col.reset(BatchType::DOUBLE, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::DOUBLE, col);
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          if (col.nulls[i])
+            batch.row(selection[i]).setIntField<8>(DOUBLENULL, outputIndex);
+          else
+            batch.row(selection[i]).setDoubleField(col.doubleVals[i], outputIndex);
+        }
+
+        break;
+      }
+
+      case CalpontSystemCatalog::FLOAT:
+      case CalpontSystemCatalog::UFLOAT:
+      {
+        col.reset(BatchType::FLOAT, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::FLOAT, col);
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          if (col.nulls[i])
+            batch.row(selection[i]).setIntField<4>(FLOATNULL, outputIndex);
+          else
+            batch.row(selection[i]).setFloatField(col.doubleVals[i], outputIndex);
+        }
+
+        break;
+      }
+
+      case CalpontSystemCatalog::DECIMAL:
+      case CalpontSystemCatalog::UDECIMAL:
+      {
+        const uint32_t colWidth = expression->resultType().colWidth;
+        col.reset(BatchType::DECIMAL, size);
+        BatchEvaluator::evaluate(expression, batch, selection, BatchType::DECIMAL, col);
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+          rowgroup::Row& row = batch.row(selection[i]);
+
+          if (colWidth == datatypes::MAXDECIMALWIDTH)
+          {
+            if (col.nulls[i])
+              row.setBinaryField_offset(const_cast<int128_t*>(&datatypes::Decimal128Null), colWidth,
+                                        row.getOffset(outputIndex));
+            else
+              row.setBinaryField_offset(&col.decimalVals[i].s128Value, colWidth, row.getOffset(outputIndex));
+          }
+          else
+          {
+            row.setIntField<8>(col.nulls[i] ? BIGINTNULL : col.decimalVals[i].value, outputIndex);
+          }
+        }
+
+        break;
+      }
+
+      case CalpontSystemCatalog::LONGDOUBLE:
+      {
+        // no batch type for long double, evaluate row by row
+        for (uint32_t i = 0; i < size; i++)
+        {
+          rowgroup::Row& row = batch.row(selection[i]);
+          bool isNull = false;
+          long double val = expression->getLongDoubleVal(row, isNull);
+
+          row.setLongDoubleField(isNull ? LONGDOUBLENULL : val, outputIndex);
+        }
+
+        break;
+      }
+
+      default:  // treat as int64
+      {
+        throw std::runtime_error("funcexp::evaluate(): non support datatype to set field.");
+      }
+    }
+  }
+}
+
 }  // namespace funcexp
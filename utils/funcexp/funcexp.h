@@ -32,6 +32,7 @@
 #include "rowgroup.h"
 #include "returnedcolumn.h"
 #include "parsetree.h"
+#include "rowbatch.h"
 
 namespace execplan
 {
@@ -79,12 +80,31 @@ class FuncExp
    */
   void evaluate(rowgroup::Row& row, std::vector<execplan::SRCP>& expressions);
 
+  /********************************************************************
+   * Batch based evaluation APIs
+   ********************************************************************/
+
   /** @brief evaluate a F&E column on rowgroup. used for F&E on the select and group by clause
    *
    * @param row input rowgroup that contains all the columns in all the expressions
    * @param expressions vector of F&Es that needs evaluation. The results are filled on each row.
    */
-  inline void evaluate(rowgroup::RowGroup& rowgroup, std::vector<execplan::SRCP>& expressions);
+  void evaluate(rowgroup::RowGroup& rowgroup, std::vector<execplan::SRCP>& expressions);
+
+  /** @brief evaluate F&E columns on the selected rows of rowgroup
+   *
+   * Same results as the row based evaluate() called on every selected row, but each
+   * expression is evaluated one column at a time, see BatchEvaluator.
+   * @param selection row numbers within the rowgroup to evaluate
+   */
+  void evaluate(rowgroup::RowGroup& rowgroup, const Selection& selection,
+                std::vector<execplan::SRCP>& expressions);
+
+  /** @brief evaluate a filter stack on the selected rows of rowgroup
+   *
+   * @param selection row numbers within the rowgroup. The failed rows are removed from it.
+   */
+  void evaluate(rowgroup::RowGroup& rowgroup, execplan::ParseTree* filters, Selection& selection);
 
   /** @brief get functor from functor map
    *
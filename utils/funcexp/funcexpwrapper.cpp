@@ -123,6 +123,16 @@ bool FuncExpWrapper::evaluate(Row* r)
   return true;
 }
 
+void FuncExpWrapper::evaluate(RowGroup& rg, Selection& selection)
+{
+  uint32_t i;
+
+  for (i = 0; i < filters.size() && !selection.empty(); i++)
+    fe->evaluate(rg, filters[i].get(), selection);
+
+  fe->evaluate(rg, selection, rcs);
+}
+
 void FuncExpWrapper::addFilter(const boost::shared_ptr<ParseTree>& f)
 {
   filters.push_back(f);
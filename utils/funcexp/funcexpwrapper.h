@@ -55,6 +55,13 @@ class FuncExpWrapper : public messageqcpp::Serializeable
   void deserialize(messageqcpp::ByteStream&);
 
   bool evaluate(rowgroup::Row*);
+
+  /** @brief evaluate the filters and the returned columns on the selected rows of rg
+   *
+   * Same as evaluate(Row*) on every selected row. The rows the filters don't
+   * pass are removed from selection.
+   */
+  void evaluate(rowgroup::RowGroup& rg, Selection& selection);
   inline bool evaluateFilter(uint32_t num, rowgroup::Row* r);
   inline uint32_t getFilterCount() const;
 
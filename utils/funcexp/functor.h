@@ -37,6 +37,8 @@
 
 #include "dataconvert.h"
 
+#include "rowbatch.h"
+
 namespace rowgroup
 {
 class Row;
@@ -150,6 +152,18 @@ class Func
     return getDoubleVal(row, fp, isNull, op_ct);
   }
 
+  /** @brief evaluate the function on a batch of rows
+   *
+   * Fills col with the values of type for every row of sel, see BatchEvaluator
+   * for the col contract. The default has no batch implementation and returns
+   * false before touching col, so the caller falls back to the row getters.
+   */
+  virtual bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                             execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col)
+  {
+    return false;
+  }
+
   float floatNullVal() const
   {
     return fFloatNullVal;
@@ -197,6 +197,9 @@ class Func_searched_case : public Func_All
 
   int64_t getTimeIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
                         execplan::CalpontSystemCatalog::ColType& op_ct);
+
+  bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                     execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col);
 };
 
 /** @brief Func_if class
@@ -240,6 +243,9 @@ class Func_if : public Func_All
 
   int64_t getTimeIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
                         execplan::CalpontSystemCatalog::ColType& op_ct);
+
+  bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                     execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col);
 };
 
 /** @brief Func_ifnull class
@@ -137,6 +137,9 @@ class Func_length : public Func_Int
 
   int64_t getIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
                     execplan::CalpontSystemCatalog::ColType& op_ct);
+
+  bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                     execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col);
 };
 
 /** @brief Func_sign class
@@ -178,6 +181,9 @@ class Func_day : public Func_Int
 
   int64_t getIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
                     execplan::CalpontSystemCatalog::ColType& op_ct);
+
+  bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                     execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col);
 };
 
 /** @brief Func_minute class
@@ -216,6 +222,9 @@ class Func_month : public Func_Int
 
   int64_t getIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
                     execplan::CalpontSystemCatalog::ColType& op_ct);
+
+  bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                     execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col);
 };
 
 /** @brief Func_week class
@@ -254,6 +263,9 @@ class Func_year : public Func_Int
 
   int64_t getIntVal(rowgroup::Row& row, FunctionParm& fp, bool& isNull,
                     execplan::CalpontSystemCatalog::ColType& op_ct);
+
+  bool evaluateBatch(RowBatch& batch, const Selection& sel, FunctionParm& fp,
+                     execplan::CalpontSystemCatalog::ColType& op_ct, BatchType type, BatchColumn& col);
 };
 
 /** @brief Func_to_days class
@@ -0,0 +1,121 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rowgroup.h"
+#include "mcs_decimal.h"
+
+namespace funcexp
+{
+/** @brief The getter a batch column is evaluated with.
+ *
+ * Every value maps to one of the TreeNode getters so the batch results are
+ * exactly what the row based evaluation returns.
+ */
+enum class BatchType : uint8_t
+{
+  INT,        // getIntVal(), kept in intVals
+  UINT,       // getUintVal(), kept in intVals
+  DOUBLE,     // getDoubleVal(), kept in doubleVals
+  FLOAT,      // getFloatVal(), kept in doubleVals
+  DECIMAL,    // getDecimalVal(), kept in decimalVals
+  STRING,     // getStrVal(), kept in strVals
+  BOOL,       // getBoolVal(), 0 or 1 in intVals
+  DATE,       // getDateIntVal(), kept in intVals
+  DATETIME,   // getDatetimeIntVal(), kept in intVals
+  TIMESTAMP,  // getTimestampIntVal(), kept in intVals
+  TIME        // getTimeIntVal(), kept in intVals
+};
+
+/** @brief Row numbers within a RowGroup a batch is evaluated for */
+typedef std::vector<uint32_t> Selection;
+
+/** @brief Values of one expression over a selection
+ *
+ * Slot i belongs to the i-th entry of the selection the column is evaluated for.
+ * nulls is both input and output: it carries the isNull flag the row based
+ * getter would have been called with and receives the flag it returns.
+ */
+class BatchColumn
+{
+ public:
+  /** @brief size the value vector of type and keep the nulls as they are */
+  void resize(BatchType type, uint32_t size)
+  {
+    switch (type)
+    {
+      case BatchType::DOUBLE:
+      case BatchType::FLOAT: doubleVals.resize(size); break;
+
+      case BatchType::DECIMAL: decimalVals.resize(size); break;
+
+      case BatchType::STRING: strVals.resize(size); break;
+
+      default: intVals.resize(size); break;
+    }
+
+    nulls.resize(size, 0);
+  }
+
+  /** @brief reset the column to size rows with a cleared null flag */
+  void reset(BatchType type, uint32_t size)
+  {
+    nulls.assign(size, 0);
+    resize(type, size);
+  }
+
+  std::vector<int64_t> intVals;
+  std::vector<double> doubleVals;
+  std::vector<execplan::IDB_Decimal> decimalVals;
+  std::vector<std::string> strVals;
+  std::vector<uint8_t> nulls;
+};
+
+/** @brief A RowGroup positioned row by row for the batch evaluation */
+class RowBatch
+{
+ public:
+  explicit RowBatch(rowgroup::RowGroup& rowGroup) : fRowGroup(rowGroup)
+  {
+    fRowGroup.initRow(&fRow);
+  }
+
+  /** @brief position the batch row on rowNum and return it */
+  inline rowgroup::Row& row(uint32_t rowNum)
+  {
+    fRowGroup.getRow(rowNum, &fRow);
+    return fRow;
+  }
+
+  inline rowgroup::RowGroup& rowGroup()
+  {
+    return fRowGroup;
+  }
+
+ private:
+  rowgroup::RowGroup& fRowGroup;
+  rowgroup::Row fRow;
+};
+
+}  // namespace funcexp
@@ -191,6 +191,15 @@ class IDBDataFile
    */
   virtual int fallocate(int mode, off64_t offset, off64_t length) = 0;
 
+  /**
+   * The fd() method returns the kernel file descriptor of the file, for
+   * asynchronous reads.  Returns -1 if the file doesn't have one.
+   */
+  virtual int fd() const
+  {
+    return -1;
+  }
+
   int colWidth()
   {
     return m_fColWidth;
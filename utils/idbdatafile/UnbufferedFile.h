@@ -46,6 +46,10 @@ class UnbufferedFile : public IDBDataFile, boost::noncopyable
   /* virtual */ int flush();
   /* virtual */ time_t mtime();
   /* virtual */ int fallocate(int mode, off64_t offset, off64_t length);
+  /* virtual */ int fd() const
+  {
+    return m_fd;
+  }
 
  protected:
   /* virtual */
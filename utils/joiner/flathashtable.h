@@ -0,0 +1,262 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
+
+#include "hasher.h"
+#include "rowgroup.h"
+
+namespace joiner
+{
+/** @brief A flat open addressing multimap for the typeless (string & compound) UM joins
+ *
+ * The layout is the one of the Swiss tables: the slots are split into groups of
+ * 16 and every slot has a control byte that holds 7 bits of the hash of its
+ * key, or EMPTY.  A probe compares the control bytes of a whole group with one
+ * SIMD compare and only looks at the slots whose tag matches, then at the full
+ * 64 bit hash and only then at the key bytes.  The probe ends at the first
+ * group with an empty slot.  There are no deletes, so a key is found before that.
+ *
+ * A slot is a distinct key, its rows are chained through the entries, which are
+ * kept in insertion order.  A skewed key costs one probe per row, not one per
+ * row already inserted.
+ *
+ * The keys stay in the key arenas of the TupleJoiner (storedKeyAlloc), an entry
+ * holds the key, the row and the next entry of the key.  The entries mimic the
+ * pairs of the node based tables so the scans can use it->first & it->second.
+ *
+ * Not thread-safe, the TupleJoiner locks the bucket a table belongs to.
+ */
+template <typename Key>
+class FlatHashTable
+{
+ public:
+  struct Entry
+  {
+    Key first;
+    rowgroup::Row::Pointer second;
+    size_t next;  // the next row of the key, or NONE
+  };
+
+  typedef typename std::vector<Entry>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+
+  FlatHashTable() : fCtrl(GROUP_SIZE, EMPTY), fSlots(GROUP_SIZE), fKeys(0), fGroupMask(0), fMemUsage(0)
+  {
+    updateMemUsage();
+  }
+
+  static inline uint64_t hash(const Key& key)
+  {
+    return utils::Hasher128()((const char*)key.data, key.len);
+  }
+
+  inline void insert(const std::pair<Key, rowgroup::Row::Pointer>& element)
+  {
+    const uint64_t h = hash(element.first);
+    const size_t capacity = fEntries.capacity();
+    size_t pos = findSlot(h, element.first);
+
+    fEntries.push_back(Entry{element.first, element.second, NONE});
+
+    if (pos != NONE)
+    {
+      // after the first row of the key, the chain isn't ordered
+      Entry& head = fEntries[fSlots[pos].entry];
+
+      fEntries.back().next = head.next;
+      head.next = fEntries.size() - 1;
+    }
+    else
+    {
+      // keep the load factor under 7/8
+      if ((fKeys + 1) * 8 > fSlots.size() * 7)
+        grow();
+
+      place(Slot{h, fEntries.size() - 1});
+      fKeys++;
+    }
+
+    if (fEntries.capacity() != capacity || pos == NONE)
+      updateMemUsage();
+  }
+
+  /** @brief append the rows of key to out, returns the number of them */
+  template <typename C>
+  inline uint32_t find(const Key& key, C& out) const
+  {
+    size_t pos = findSlot(hash(key), key);
+    uint32_t ret = 0;
+
+    if (pos == NONE)
+      return 0;
+
+    for (size_t e = fSlots[pos].entry; e != NONE; e = fEntries[e].next, ret++)
+      out.push_back(fEntries[e].second);
+
+    return ret;
+  }
+
+  inline const_iterator begin() const
+  {
+    return fEntries.begin();
+  }
+  inline const_iterator end() const
+  {
+    return fEntries.end();
+  }
+  inline size_t size() const
+  {
+    return fEntries.size();
+  }
+  inline bool empty() const
+  {
+    return fEntries.empty();
+  }
+  // the memory tracking thread of THJS reads it while rows are inserted
+  uint64_t getMemUsage() const
+  {
+    return fMemUsage.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot
+  {
+    uint64_t hash;
+    size_t entry;  // the first row of the key
+  };
+
+  static const uint32_t GROUP_SIZE = 16;
+  static const int8_t EMPTY = -128;
+  static constexpr size_t NONE = ~(size_t)0;
+
+  // the low 7 bits are the tag, the rest picks the group
+  static inline int8_t tagOf(uint64_t h)
+  {
+    return h & 0x7f;
+  }
+  inline size_t groupOf(uint64_t h) const
+  {
+    return (h >> 7) & fGroupMask;
+  }
+
+  // a bit for every control byte of the group equal to c
+  static inline uint32_t match(const int8_t* group, int8_t c)
+  {
+#if defined(__x86_64__)
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(c)));
+#else
+    uint32_t mask = 0;
+
+    for (uint32_t i = 0; i < GROUP_SIZE; i++)
+      mask |= (uint32_t)(group[i] == c) << i;
+
+    return mask;
+#endif
+  }
+
+  // the slot of key, NONE if it isn't in the table
+  inline size_t findSlot(uint64_t h, const Key& key) const
+  {
+    const int8_t tag = tagOf(h);
+    size_t group = groupOf(h), step = 0;
+
+    while (true)
+    {
+      const size_t first = group * GROUP_SIZE;
+      uint32_t mask = match(&fCtrl[first], tag);
+
+      while (mask)
+      {
+        const size_t pos = first + __builtin_ctz(mask);
+
+        if (fSlots[pos].hash == h && fEntries[fSlots[pos].entry].first == key)
+          return pos;
+
+        mask &= mask - 1;
+      }
+
+      if (match(&fCtrl[first], EMPTY))
+        return NONE;
+
+      group = (group + ++step) & fGroupMask;
+    }
+  }
+
+  // the first empty slot in the probe sequence of s, there is always one
+  inline void place(const Slot& s)
+  {
+    size_t group = groupOf(s.hash), step = 0;
+
+    while (true)
+    {
+      const size_t first = group * GROUP_SIZE;
+      uint32_t mask = match(&fCtrl[first], EMPTY);
+
+      if (mask)
+      {
+        size_t pos = first + __builtin_ctz(mask);
+        fCtrl[pos] = tagOf(s.hash);
+        fSlots[pos] = s;
+        return;
+      }
+
+      group = (group + ++step) & fGroupMask;
+    }
+  }
+
+  void grow()
+  {
+    std::vector<int8_t> oldCtrl(fSlots.size() * 2, EMPTY);
+    std::vector<Slot> oldSlots(fSlots.size() * 2);
+
+    oldCtrl.swap(fCtrl);
+    oldSlots.swap(fSlots);
+    fGroupMask = fCtrl.size() / GROUP_SIZE - 1;
+
+    for (size_t i = 0; i < oldCtrl.size(); i++)
+      if (oldCtrl[i] != EMPTY)
+        place(oldSlots[i]);
+  }
+
+  void updateMemUsage()
+  {
+    fMemUsage.store(fCtrl.size() * (sizeof(Slot) + 1) + fEntries.capacity() * sizeof(Entry),
+                    std::memory_order_relaxed);
+  }
+
+  std::vector<int8_t> fCtrl;  // a control byte per slot
+  std::vector<Slot> fSlots;
+  std::vector<Entry> fEntries;
+  size_t fKeys;       // the number of distinct keys
+  size_t fGroupMask;  // group count - 1, the count is a power of 2
+  std::atomic<uint64_t> fMemUsage;
+};
+
+}  // namespace joiner
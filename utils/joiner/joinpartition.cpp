@@ -569,43 +569,22 @@ int64_t JoinPartition::processLargeBuffer(RGData& rgData)
   return ret;
 }
 
-bool JoinPartition::getNextPartition(vector<RGData>* smallData, uint64_t* partitionID, JoinPartition** jp)
+JoinPartition* JoinPartition::getNextPartition()
 {
   if (fileMode)
   {
-    ByteStream bs;
-    RGData rgData;
-
     if (nextPartitionToReturn > 0)
-      return false;
-
-    // cout << "reading the small side" << endl;
-    nextSmallOffset = 0;
-
-    while (1)
-    {
-      readByteStream(0, &bs);
-
-      if (bs.length() == 0)
-        break;
-
-      rgData.deserialize(bs);
-      // smallRG.setData(&rgData);
-      // cout << "read a smallRG with " << smallRG.getRowCount() << " rows" << endl;
-      smallData->push_back(rgData);
-    }
+      return NULL;
 
     nextPartitionToReturn = 1;
-    *partitionID = uniqueID;
-    *jp = this;
-    return true;
+    return this;
   }
 
-  bool ret = false;
+  JoinPartition* ret = NULL;
 
   while (!ret && nextPartitionToReturn < bucketCount)
   {
-    ret = buckets[nextPartitionToReturn]->getNextPartition(smallData, partitionID, jp);
+    ret = buckets[nextPartitionToReturn]->getNextPartition();
 
     if (!ret)
       nextPartitionToReturn++;
@@ -614,6 +593,26 @@ bool JoinPartition::getNextPartition(vector<RGData>* smallData, uint64_t* partit
   return ret;
 }
 
+void JoinPartition::readSmallSidePartition(vector<RGData>* smallData)
+{
+  ByteStream bs;
+  RGData rgData;
+
+  idbassert(fileMode);
+  nextSmallOffset = 0;
+
+  while (1)
+  {
+    readByteStream(0, &bs);
+
+    if (bs.length() == 0)
+      break;
+
+    rgData.deserialize(bs);
+    smallData->push_back(rgData);
+  }
+}
+
 boost::shared_ptr<RGData> JoinPartition::getNextLargeRGData()
 {
   boost::shared_ptr<RGData> ret;
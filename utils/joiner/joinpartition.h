@@ -49,11 +49,20 @@ class JoinPartition
   int64_t insertLargeSideRow(const rowgroup::Row& row);
   int64_t doneInsertingLargeData();
 
-  /* Returns true if there are more partitions to fetch, false otherwise */
-  bool getNextPartition(std::vector<rowgroup::RGData>* smallData, uint64_t* partitionID, JoinPartition** jp);
+  /* Returns the next leaf partition to process, NULL after the last one.  This walks the
+     tree, so the caller has to serialize calls on the root node.  The leaves themselves can
+     be processed concurrently, they don't share any state. */
+  JoinPartition* getNextPartition();
 
+  /* Called on a leaf partition, reads back its small side */
+  void readSmallSidePartition(std::vector<rowgroup::RGData>* smallData);
   boost::shared_ptr<rowgroup::RGData> getNextLargeRGData();
 
+  uint64_t getUniqueID() const
+  {
+    return uniqueID;
+  }
+
   /* It's important to follow the sequence of operations to maintain the correct
      internal state.  Right now it doesn't check that you the programmer are doing things
      right, it'll likely fail queries or crash if you do things wrong.
@@ -63,8 +72,8 @@ class JoinPartition
      After that's done, call doneInsertingSmallData() and initForLargeSideFeed().
      Then, insert the large-side data.  When done, call doneInsertingLargeData()
      and initForProcessing().
-     In the processing phase, use getNextPartition() and getNextLargeRGData()
-     to get the data back out.  After processing all partitions, if it's necessary
+     In the processing phase, use getNextPartition() to get the leaf partitions, and
+     readSmallSidePartition() and getNextLargeRGData() on them to get the data back out.  After processing all partitions, if it's necessary
      to process more iterations of the large side, call initForProcessing() again, and
      continue as before.
   */
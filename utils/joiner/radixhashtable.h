@@ -0,0 +1,248 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "hasher.h"
+#include "exceptclasses.h"
+
+namespace joiner
+{
+/** @brief A read-only multimap on int64 keys for the large UM joins
+ *
+ * The entries are split into partitions by the high bits of the key hash and
+ * every partition gets its own open addressing table, sized to fit in the
+ * cache.  The values of a key are stored next to each other, so a probe
+ * touches one partition table and one run of values instead of walking the
+ * nodes of a node based table that is spread over the whole heap.
+ *
+ * The table is built once from all the entries and can't be modified after.
+ * The slots index the values with 32 bit fields, a table holds at most
+ * MAX_ENTRIES entries.
+ */
+template <typename V>
+class RadixHashTable
+{
+ public:
+  typedef std::pair<int64_t, V> value_type;
+
+  // keeps the table sizes, the value offsets and the counts in 32 bits
+  static const uint64_t MAX_ENTRIES = 1ULL << 30;
+
+  /** @param entries the key/value pairs, at most MAX_ENTRIES, cleared on return
+   *  @param partitionBytes the target size of a partition table
+   */
+  RadixHashTable(std::vector<value_type>& entries, uint64_t partitionBytes);
+
+  /** @brief an upper bound of the memory the build of a table of entryCount
+   *  entries takes at its peak, the entries included
+   */
+  static uint64_t buildMemUsage(uint64_t entryCount)
+  {
+    // the tables are less than 4 slots an entry or 2 slots, one per partition at most
+    return entryCount * (sizeof(value_type) + sizeof(V) + 4 * sizeof(Slot)) +
+           (1ULL << MAX_RADIX_BITS) * (2 * sizeof(Slot) + sizeof(Partition));
+  }
+
+  /** @brief append the values of key to out, returns the number of them */
+  template <typename C>
+  inline uint32_t find(int64_t key, C& out) const
+  {
+    uint64_t hash = utils::fmix((uint64_t)key);
+    const Partition& part = fPartitions[partitionOf(hash, fRadixBits)];
+    uint32_t pos = (uint32_t)hash & part.slotMask;
+    const Slot* slots = &fSlots[part.slotOffset];
+
+    while (slots[pos].count != 0)
+    {
+      if (slots[pos].key == key)
+      {
+        const Slot& slot = slots[pos];
+
+        for (uint32_t i = 0; i < slot.count; i++)
+          out.push_back(fValues[slot.begin + i]);
+
+        return slot.count;
+      }
+
+      pos = (pos + 1) & part.slotMask;
+    }
+
+    return 0;
+  }
+
+  /** @brief the values in storage order, for the full scans */
+  inline const V& at(size_t i) const
+  {
+    return fValues[i];
+  }
+  inline size_t size() const
+  {
+    return fValues.size();
+  }
+  inline uint32_t getPartitionCount() const
+  {
+    return fPartitions.size();
+  }
+  uint64_t getMemUsage() const
+  {
+    return fPartitions.capacity() * sizeof(Partition) + fSlots.capacity() * sizeof(Slot) +
+           fValues.capacity() * sizeof(V);
+  }
+
+ private:
+  struct Slot
+  {
+    int64_t key;
+    uint32_t begin;  // first value of the key in fValues
+    uint32_t count;  // 0 if the slot is empty
+  };
+  struct Partition
+  {
+    uint64_t slotOffset;  // the first slot of the partition table in fSlots
+    uint32_t slotMask;    // table size - 1, the size is a power of 2
+  };
+
+  static const uint32_t MAX_RADIX_BITS = 16;
+
+  static inline uint32_t partitionOf(uint64_t hash, uint32_t radixBits)
+  {
+    return (hash >> 32) >> (32 - radixBits);
+  }
+
+  uint32_t fRadixBits;
+  std::vector<Partition> fPartitions;
+  std::vector<Slot> fSlots;  // every partition table, one after the other
+  std::vector<V> fValues;    // the values, grouped by key
+};
+
+template <typename V>
+RadixHashTable<V>::RadixHashTable(std::vector<value_type>& entries, uint64_t partitionBytes) : fRadixBits(0)
+{
+  const uint64_t entryCount = entries.size();
+  // tables are kept at most half full
+  const uint64_t entriesPerPartition = std::max<uint64_t>(partitionBytes / sizeof(Slot) / 2, 1);
+  uint32_t i, partitionCount;
+
+  idbassert(entryCount <= MAX_ENTRIES);
+
+  while (fRadixBits < MAX_RADIX_BITS && (entryCount >> fRadixBits) > entriesPerPartition)
+    fRadixBits++;
+
+  partitionCount = 1 << fRadixBits;
+
+  /* Partition the entries in place: count, then swap each one into the range
+     of its partition.  A copy would double the memory the build takes. */
+  std::vector<uint32_t> counts(partitionCount + 1, 0);
+
+  for (const auto& entry : entries)
+    counts[partitionOf(utils::fmix((uint64_t)entry.first), fRadixBits) + 1]++;
+
+  for (i = 1; i <= partitionCount; i++)
+    counts[i] += counts[i - 1];
+
+  {
+    std::vector<uint32_t> next(counts.begin(), counts.end() - 1);
+
+    for (i = 0; i < partitionCount; i++)
+      while (next[i] < counts[i + 1])
+      {
+        value_type& entry = entries[next[i]];
+        uint32_t part = partitionOf(utils::fmix((uint64_t)entry.first), fRadixBits);
+
+        if (part == i)
+          next[i]++;
+        else
+          std::swap(entry, entries[next[part]++]);
+      }
+  }
+
+  /* Size the tables */
+  uint64_t slotCount = 0;
+
+  fPartitions.resize(partitionCount);
+
+  for (i = 0; i < partitionCount; i++)
+  {
+    uint32_t tableSize = 2;
+
+    while (tableSize < 2ULL * (counts[i + 1] - counts[i]))
+      tableSize <<= 1;
+
+    fPartitions[i].slotOffset = slotCount;
+    fPartitions[i].slotMask = tableSize - 1;
+    slotCount += tableSize;
+  }
+
+  fSlots.resize(slotCount, Slot{0, 0, 0});
+  fValues.resize(entryCount);
+
+  /* Build each partition table.  The first pass counts the values of every
+     key, the second one lays them out key by key. */
+  std::vector<value_type>& partitioned = entries;
+  uint32_t valueOffset = 0;
+
+  for (i = 0; i < partitionCount; i++)
+  {
+    const Partition& part = fPartitions[i];
+    Slot* slots = &fSlots[part.slotOffset];
+    uint32_t j, pos;
+
+    for (j = counts[i]; j < counts[i + 1]; j++)
+    {
+      int64_t key = partitioned[j].first;
+
+      pos = (uint32_t)utils::fmix((uint64_t)key) & part.slotMask;
+
+      while (slots[pos].count != 0 && slots[pos].key != key)
+        pos = (pos + 1) & part.slotMask;
+
+      slots[pos].key = key;
+      slots[pos].count++;
+    }
+
+    // begin is set past the end of the key's run and is moved back as the values are stored
+    for (pos = 0; pos <= part.slotMask; pos++)
+    {
+      valueOffset += slots[pos].count;
+      slots[pos].begin = valueOffset;
+    }
+
+    for (j = counts[i]; j < counts[i + 1]; j++)
+    {
+      int64_t key = partitioned[j].first;
+
+      pos = (uint32_t)utils::fmix((uint64_t)key) & part.slotMask;
+
+      while (slots[pos].key != key || slots[pos].count == 0)
+        pos = (pos + 1) & part.slotMask;
+
+      fValues[--slots[pos].begin] = std::move(partitioned[j].second);
+    }
+  }
+
+  std::vector<value_type>().swap(entries);
+}
+
+}  // namespace joiner
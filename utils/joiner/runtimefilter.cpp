@@ -0,0 +1,145 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <limits>
+#include <sstream>
+
+#include "runtimefilter.h"
+
+using namespace std;
+using namespace rowgroup;
+using namespace execplan;
+using namespace messageqcpp;
+
+namespace joiner
+{
+RuntimeFilter::RuntimeFilter()
+ : fMin(numeric_limits<int64_t>::max()), fMax(numeric_limits<int64_t>::min()), fKeyCount(0), fBlockMask(0)
+{
+}
+
+RuntimeFilter::RuntimeFilter(uint64_t keyCount, uint64_t maxBytes) : RuntimeFilter()
+{
+  const uint64_t blockBytes = BLOCK_WORDS * sizeof(uint32_t);
+  uint64_t blocks = 1;
+
+  while (blocks * blockBytes * 8 < keyCount * BITS_PER_KEY)
+    blocks <<= 1;
+
+  // A filter a lot smaller than it should be lets almost every row through, keep the
+  // min/max only then.
+  if (blocks * blockBytes > maxBytes)
+  {
+    if (blocks * blockBytes > maxBytes * 4)
+      return;
+
+    while (blocks > 1 && blocks * blockBytes > maxBytes)
+      blocks >>= 1;
+  }
+
+  fBlockMask = blocks - 1;
+  fBlocks.resize(blocks * BLOCK_WORDS, 0);
+}
+
+bool RuntimeFilter::canFilter(const RowGroup& smallRG, uint32_t smallCol, const RowGroup& largeRG,
+                              uint32_t largeCol)
+{
+  CalpontSystemCatalog::ColDataType type = largeRG.getColType(largeCol);
+
+  if (smallRG.getColType(smallCol) != type ||
+      smallRG.getColumnWidth(smallCol) != largeRG.getColumnWidth(largeCol) ||
+      smallRG.getScale()[smallCol] != largeRG.getScale()[largeCol] || largeRG.getColumnWidth(largeCol) > 8)
+    return false;
+
+  switch (type)
+  {
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::UTINYINT:
+    case CalpontSystemCatalog::USMALLINT:
+    case CalpontSystemCatalog::UMEDINT:
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UBIGINT:
+    case CalpontSystemCatalog::DECIMAL:
+    case CalpontSystemCatalog::UDECIMAL:
+    case CalpontSystemCatalog::DATE:
+    case CalpontSystemCatalog::DATETIME:
+    case CalpontSystemCatalog::TIMESTAMP:
+    case CalpontSystemCatalog::TIME: return true;
+
+    default: return false;
+  }
+}
+
+void RuntimeFilter::insert(int64_t key)
+{
+  fKeyCount++;
+
+  if (key < fMin)
+    fMin = key;
+
+  if (key > fMax)
+    fMax = key;
+
+  if (fBlocks.empty())
+    return;
+
+  uint64_t hash = utils::fmix((uint64_t)key);
+  uint32_t* block = &fBlocks[((hash >> 32) & fBlockMask) * BLOCK_WORDS];
+
+  for (uint32_t i = 0; i < BLOCK_WORDS; i++)
+    block[i] |= 1U << (((uint32_t)hash * salt[i]) >> 27);
+}
+
+void RuntimeFilter::serialize(ByteStream& bs) const
+{
+  bs << (uint64_t)fMin;
+  bs << (uint64_t)fMax;
+  bs << fKeyCount;
+  bs << fBlockMask;
+  serializeInlineVector<uint32_t>(bs, fBlocks);
+}
+
+void RuntimeFilter::deserialize(ByteStream& bs)
+{
+  uint64_t tmp64;
+
+  bs >> tmp64;
+  fMin = (int64_t)tmp64;
+  bs >> tmp64;
+  fMax = (int64_t)tmp64;
+  bs >> fKeyCount;
+  bs >> fBlockMask;
+  deserializeInlineVector<uint32_t>(bs, fBlocks);
+}
+
+string RuntimeFilter::toString() const
+{
+  ostringstream os;
+
+  os << "RuntimeFilter: " << fKeyCount << " keys, range [" << fMin << ", " << fMax << "]";
+
+  if (hasBloomFilter())
+    os << ", " << getSize() << " byte Bloom filter";
+
+  return os.str();
+}
+
+}  // namespace joiner
@@ -0,0 +1,121 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bytestream.h"
+#include "hasher.h"
+#include "rowgroup.h"
+
+namespace joiner
+{
+/** @brief A filter on the large side key of a join, built from the small side
+ *
+ * It is built on the UM once the small side of a join is read and is shipped
+ * with the large side scan, so PrimProc can drop the rows that can't find a
+ * match before it projects the rest of the columns and sends them to the UM.
+ * It holds the min/max of the small side keys and a split block Bloom filter:
+ * every key sets one bit in each of the 8 words of a 256 bit block, so a lookup
+ * touches a single cache line.  There are no false negatives, the rows it lets
+ * through are joined as usual.
+ *
+ * The keys are the int64 values the TupleJoiner hashes, getIntField() or, for
+ * the unsigned types, getUintField().
+ */
+class RuntimeFilter
+{
+ public:
+  RuntimeFilter();
+
+  /** @param keyCount the number of small side rows, sizes the Bloom filter
+   *  @param maxBytes the size limit of the Bloom filter.  If keyCount needs a lot
+   *         more than that, only the min/max is kept.
+   */
+  RuntimeFilter(uint64_t keyCount, uint64_t maxBytes);
+
+  /** @brief Whether a join on these key columns can be filtered
+   *
+   * Both sides have to hold the same integer type, so that the stored values
+   * are equal exactly when the keys match.
+   */
+  static bool canFilter(const rowgroup::RowGroup& smallRG, uint32_t smallCol,
+                        const rowgroup::RowGroup& largeRG, uint32_t largeCol);
+
+  /** @brief The key of the column the way the filter stores it */
+  static inline int64_t getKey(const rowgroup::Row& r, uint32_t col)
+  {
+    return (r.isUnsigned(col) ? (int64_t)r.getUintField(col) : r.getIntField(col));
+  }
+
+  void insert(int64_t key);
+
+  /** @brief False if no small side row has that key */
+  inline bool mayContain(int64_t key) const
+  {
+    if (key < fMin || key > fMax)
+      return false;
+
+    if (fBlocks.empty())
+      return true;
+
+    uint64_t hash = utils::fmix((uint64_t)key);
+    const uint32_t* block = &fBlocks[((hash >> 32) & fBlockMask) * BLOCK_WORDS];
+
+    for (uint32_t i = 0; i < BLOCK_WORDS; i++)
+      if (!(block[i] & (1U << (((uint32_t)hash * salt[i]) >> 27))))
+        return false;
+
+    return true;
+  }
+
+  bool hasBloomFilter() const
+  {
+    return !fBlocks.empty();
+  }
+  uint64_t getKeyCount() const
+  {
+    return fKeyCount;
+  }
+  uint64_t getSize() const
+  {
+    return fBlocks.size() * sizeof(uint32_t);
+  }
+
+  void serialize(messageqcpp::ByteStream& bs) const;
+  void deserialize(messageqcpp::ByteStream& bs);
+
+  std::string toString() const;
+
+ private:
+  static constexpr uint32_t BLOCK_WORDS = 8;
+  static constexpr uint32_t BITS_PER_KEY = 10;  // ~1% false positives
+  static constexpr uint32_t salt[BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+  int64_t fMin, fMax;
+  uint64_t fKeyCount;
+  uint64_t fBlockMask;            // the block count - 1, the count is a power of 2
+  std::vector<uint32_t> fBlocks;  // empty if only the min/max is used
+};
+
+}  // namespace joiner
@@ -35,6 +35,13 @@ using namespace joblist;
 
 namespace joiner
 {
+// the size of a level of the data cache, def if the system doesn't know it
+static uint64_t getCacheSize(int level, uint64_t def)
+{
+  long size = sysconf(level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+  return (size > 0 ? size : def);
+}
+
 // Typed joiner ctor
 TupleJoiner::TupleJoiner(const rowgroup::RowGroup& smallInput, const rowgroup::RowGroup& largeInput,
                          uint32_t smallJoinColumn, uint32_t largeJoinColumn, JoinType jt,
@@ -49,6 +56,8 @@ TupleJoiner::TupleJoiner(const rowgroup::RowGroup& smallInput, const rowgroup::R
  , uniqueLimit(100)
  , finished(false)
  , jobstepThreadPool(jsThreadPool)
+ , radixJoin(false)
+ , radixJoinThreshold(getCacheSize(3, 8 * 1024 * 1024))
  , _convertToDiskJoin(false)
 {
   uint i;
@@ -157,20 +166,17 @@ TupleJoiner::TupleJoiner(const rowgroup::RowGroup& smallInput, const rowgroup::R
  , uniqueLimit(100)
  , finished(false)
  , jobstepThreadPool(jsThreadPool)
+ , radixJoin(false)
+ , radixJoinThreshold(getCacheSize(3, 8 * 1024 * 1024))
  , _convertToDiskJoin(false)
 {
   uint i;
 
   getBucketCount();
 
-  _pool.reset(new boost::shared_ptr<PoolAllocator>[bucketCount]);
   ht.reset(new boost::scoped_ptr<typelesshash_t>[bucketCount]);
   for (i = 0; i < bucketCount; i++)
-  {
-    STLPoolAllocator<pair<const TypelessData, Row::Pointer>> alloc;
-    _pool[i] = alloc.getPoolAllocator();
-    ht[i].reset(new typelesshash_t(10, hasher(), typelesshash_t::key_equal(), alloc));
-  }
+    ht[i].reset(new typelesshash_t());
   m_bucketLocks.reset(new boost::mutex[bucketCount]);
 
   smallRG.initRow(&smallNullRow);
@@ -293,6 +299,90 @@ void TupleJoiner::bucketsToTables(buckets_t* buckets, hash_table_t* tables)
   }
 }
 
+template <typename hash_table_t, typename radix_table_t>
+void TupleJoiner::bucketToRadixTable(uint bucket, boost::scoped_ptr<hash_table_t>& table,
+                                     boost::scoped_ptr<radix_table_t>& radixTable, uint64_t partitionBytes)
+{
+  vector<typename radix_table_t::value_type> entries;
+
+  entries.reserve(table->size());
+
+  for (auto& element : *table)
+    entries.emplace_back(element.first, element.second);
+
+  // free the nodes before building the new table
+  typename hash_table_t::allocator_type alloc;
+  _pool[bucket] = alloc.getPoolAllocator();
+  table.reset(new hash_table_t(10, hasher(), typename hash_table_t::key_equal(), alloc));
+
+  radixTable.reset(new radix_table_t(entries, partitionBytes));
+}
+
+// whether makeRadixTables() converts the tables of this join
+bool TupleJoiner::wantRadixTables() const
+{
+  if (joinAlg != UM || typelessJoin || ld || radixJoin || getMemUsage() <= radixJoinThreshold)
+    return false;
+
+  // a bucket too big for a radix table keeps the hash tables
+  for (uint i = 0; i < bucketCount; i++)
+    if ((!smallRG.usesStringTable() ? h[i]->size() : sth[i]->size()) > radixhash_t::MAX_ENTRIES)
+      return false;
+
+  return true;
+}
+
+uint64_t TupleJoiner::getRadixBuildMemUsage() const
+{
+  uint64_t ret = 0;
+
+  if (!wantRadixTables())
+    return 0;
+
+  // the buckets are converted in parallel
+  for (uint i = 0; i < bucketCount; i++)
+    ret += (!smallRG.usesStringTable() ? radixhash_t::buildMemUsage(h[i]->size())
+                                       : stradixhash_t::buildMemUsage(sth[i]->size()));
+
+  return ret;
+}
+
+/* Once all of the small side is in, the node based tables of a large integer
+   join are replaced by radix partitioned ones.  The buckets are converted in
+   parallel, each one is partitioned into tables that fit in the L2 cache. */
+void TupleJoiner::makeRadixTables()
+{
+  uint i;
+
+  if (!wantRadixTables())
+    return;
+
+  uint64_t partitionBytes = getCacheSize(2, 256 * 1024) / 2;
+  utils::VLArray<uint64_t> jobs(bucketCount);
+
+  if (!smallRG.usesStringTable())
+  {
+    rh.reset(new boost::scoped_ptr<radixhash_t>[bucketCount]);
+
+    for (i = 0; i < bucketCount; i++)
+      jobs[i] = jobstepThreadPool->invoke([this, i, partitionBytes]
+                                          { this->bucketToRadixTable(i, h[i], rh[i], partitionBytes); });
+  }
+  else
+  {
+    rsth.reset(new boost::scoped_ptr<stradixhash_t>[bucketCount]);
+
+    for (i = 0; i < bucketCount; i++)
+      jobs[i] = jobstepThreadPool->invoke([this, i, partitionBytes]
+                                          { this->bucketToRadixTable(i, sth[i], rsth[i], partitionBytes); });
+  }
+
+  for (i = 0; i < bucketCount; i++)
+    jobstepThreadPool->join(jobs[i]);
+
+  radixJoin = true;
+}
+
 void TupleJoiner::um_insertTypeless(uint threadID, uint rowCount, Row& r)
 {
   utils::VLArray<TypelessData> td(rowCount);
@@ -499,8 +589,6 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
     if (UNLIKELY(typelessJoin))
     {
       TypelessData largeKey;
-      thIterator it;
-      pair<thIterator, thIterator> range;
 
       largeKey = makeTypelessKey(largeSideRow, largeKeyColumns, keyLength, &tmpKeyAlloc[threadID], smallRG,
                                  smallKeyColumns);
@@ -508,13 +596,9 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         return;
 
       uint bucket = bucketPicker((char*)largeKey.data, largeKey.len, bpSeed) & bucketMask;
-      range = ht[bucket]->equal_range(largeKey);
 
-      if (range.first == range.second && !(joinType & (LARGEOUTER | MATCHNULLS)))
+      if (ht[bucket]->find(largeKey, *matches) == 0 && !(joinType & (LARGEOUTER | MATCHNULLS)))
         return;
-
-      for (; range.first != range.second; ++range.first)
-        matches->push_back(range.first->second);
     }
     else if (largeSideRow.getColType(largeKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE && ld)
     {
@@ -565,6 +649,13 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         for (; range.first != range.second; ++range.first)
           matches->push_back(range.first->second);
       }
+      else if (radixJoin)
+      {
+        uint bucket = bucketPicker((char*)&largeKey, sizeof(largeKey), bpSeed) & bucketMask;
+
+        if (rh[bucket]->find(largeKey, *matches) == 0 && !(joinType & (LARGEOUTER | MATCHNULLS)))
+          return;
+      }
       else
       {
         uint bucket = bucketPicker((char*)&largeKey, sizeof(largeKey), bpSeed) & bucketMask;
@@ -577,6 +668,14 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
           matches->push_back(range.first->second);
       }
     }
+    else if (radixJoin)
+    {
+      int64_t largeKey = largeSideRow.getIntField(largeKeyColumns[0]);
+      uint bucket = bucketPicker((char*)&largeKey, sizeof(largeKey), bpSeed) & bucketMask;
+
+      if (rsth[bucket]->find(largeKey, *matches) == 0 && !(joinType & (LARGEOUTER | MATCHNULLS)))
+        return;
+    }
     else
     {
       int64_t largeKey = largeSideRow.getIntField(largeKeyColumns[0]);
@@ -608,6 +707,16 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
       for (; range.first != range.second; ++range.first)
         matches->push_back(range.first->second);
     }
+    else if (radixJoin)
+    {
+      int64_t nullVal = getJoinNullValue();
+      uint bucket = bucketPicker((char*)&nullVal, sizeof(nullVal), bpSeed) & bucketMask;
+
+      if (rh)
+        rh[bucket]->find(nullVal, *matches);
+      else
+        rsth[bucket]->find(nullVal, *matches);
+    }
     else if (!largeRG.usesStringTable())
     {
       auto nullVal = getJoinNullValue();
@@ -642,6 +751,16 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
           for (it = ld[i]->begin(); it != ld[i]->end(); ++it)
             matches->push_back(it->second);
       }
+      else if (radixJoin)
+      {
+        for (uint i = 0; i < bucketCount; i++)
+          if (rh)
+            for (size_t j = 0; j < rh[i]->size(); j++)
+              matches->push_back(rh[i]->at(j));
+          else
+            for (size_t j = 0; j < rsth[i]->size(); j++)
+              matches->push_back(rsth[i]->at(j));
+      }
       else if (!smallRG.usesStringTable())
       {
         iterator it;
@@ -691,6 +810,7 @@ void TupleJoiner::doneInserting()
   /* Put together the discrete values for the runtime casual partitioning restriction */
 
   finished = true;
+  makeRadixTables();
 
   for (col = 0; col < smallKeyColumns.size(); col++)
   {
@@ -702,6 +822,7 @@ void TupleJoiner::doneInserting()
     ldhash_t::iterator ldit;
     typelesshash_t::iterator thit;
     uint32_t i, pmpos = 0, rowCount;
+    size_t radixPos = 0;
     Row smallRow;
     auto smallSideColIdx = smallKeyColumns[col];
     auto smallSideColType = smallRG.getColType(smallSideColIdx);
@@ -720,6 +841,8 @@ void TupleJoiner::doneInserting()
       thit = ht[bucket]->begin();
     else if (isLongDouble(smallRG.getColType(smallKeyColumns[0])))
       ldit = ld[bucket]->begin();
+    else if (radixJoin)
+      radixPos = 0;
     else if (!smallRG.usesStringTable())
       hit = h[bucket]->begin();
     else
@@ -743,6 +866,24 @@ void TupleJoiner::doneInserting()
         smallRow.setPointer(ldit->second);
         ++ldit;
       }
+      else if (rh)
+      {
+        while (radixPos == rh[bucket]->size())
+        {
+          ++bucket;
+          radixPos = 0;
+        }
+        smallRow.setPointer(rh[bucket]->at(radixPos++));
+      }
+      else if (rsth)
+      {
+        while (radixPos == rsth[bucket]->size())
+        {
+          ++bucket;
+          radixPos = 0;
+        }
+        smallRow.setPointer(rsth[bucket]->at(radixPos++));
+      }
       else if (!smallRG.usesStringTable())
       {
         while (hit == h[bucket]->end())
@@ -904,6 +1045,10 @@ void TupleJoiner::setInUM(vector<RGData>& rgs)
   cout << "done\n";
 #endif
 
+  // a PM join moved to the UM after the small side was read
+  if (finished)
+    makeRadixTables();
+
   if (typelessJoin)
   {
     tmpKeyAlloc.reset(new FixedAllocator[threadCount]);
@@ -1026,6 +1171,22 @@ void TupleJoiner::getUnmarkedRows(vector<Row::Pointer>* out)
             out->push_back(it->second);
         }
     }
+    else if (radixJoin)
+    {
+      for (uint i = 0; i < bucketCount; i++)
+      {
+        size_t size = (rh ? rh[i]->size() : rsth[i]->size());
+
+        for (size_t j = 0; j < size; j++)
+        {
+          Row::Pointer p = (rh ? Row::Pointer(rh[i]->at(j)) : rsth[i]->at(j));
+          smallR.setPointer(p);
+
+          if (!smallR.isMarked())
+            out->push_back(p);
+        }
+      }
+    }
     else if (!smallRG.usesStringTable())
     {
       iterator it;
@@ -1061,7 +1222,7 @@ uint64_t TupleJoiner::getMemUsage() const
   {
     size_t ret = 0;
     for (uint i = 0; i < bucketCount; i++)
-      ret += _pool[i]->getMemUsage();
+      ret += ht[i]->getMemUsage();
     for (int i = 0; i < numCores; i++)
       ret += storedKeyAlloc[i].getMemUsage();
     return ret;
@@ -1071,6 +1232,12 @@ uint64_t TupleJoiner::getMemUsage() const
     size_t ret = 0;
     for (uint i = 0; i < bucketCount; i++)
       ret += _pool[i]->getMemUsage();
+    if (rh)
+      for (uint i = 0; i < bucketCount; i++)
+        ret += rh[i]->getMemUsage();
+    else if (rsth)
+      for (uint i = 0; i < bucketCount; i++)
+        ret += rsth[i]->getMemUsage();
     return ret;
   }
   else
@@ -1208,6 +1375,10 @@ size_t TupleJoiner::size() const
         ret += ht[i]->size();
       else if (smallRG.getColType(smallKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE)
         ret += ld[i]->size();
+      else if (rh)
+        ret += rh[i]->size();
+      else if (rsth)
+        ret += rsth[i]->size();
       else if (!smallRG.usesStringTable())
         ret += h[i]->size();
       else
@@ -1801,7 +1972,7 @@ void TupleJoiner::clearData()
     STLPoolAllocator<pair<const TypelessData, Row::Pointer>> alloc;
     _pool[i] = alloc.getPoolAllocator();
     if (typelessJoin)
-      ht[i].reset(new typelesshash_t(10, hasher(), typelesshash_t::key_equal(), alloc));
+      ht[i].reset(new typelesshash_t());
     else if (smallRG.getColTypes()[smallKeyColumns[0]] == CalpontSystemCatalog::LONGDOUBLE)
       ld[i].reset(new ldhash_t(10, hasher(), ldhash_t::key_equal(), alloc));
     else if (smallRG.usesStringTable())
@@ -1810,6 +1981,10 @@ void TupleJoiner::clearData()
       h[i].reset(new hash_t(10, hasher(), hash_t::key_equal(), alloc));
   }
 
+  rh.reset();
+  rsth.reset();
+  radixJoin = false;
+
   std::vector<rowgroup::Row::Pointer> empty;
   rows.swap(empty);
   finished = false;
@@ -1834,6 +2009,7 @@ std::shared_ptr<TupleJoiner> TupleJoiner::copyForDiskJoin()
 
   ret->nullValueForJoinColumn = nullValueForJoinColumn;
   ret->uniqueLimit = uniqueLimit;
+  ret->radixJoinThreshold = radixJoinThreshold;
 
   ret->discreteValues.reset(new bool[smallKeyColumns.size()]);
   ret->cpValues.reset(new vector<int128_t>[smallKeyColumns.size()]);
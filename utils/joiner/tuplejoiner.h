@@ -36,6 +36,8 @@
 #include "threadpool.h"
 #include "columnwidth.h"
 #include "mcs_string.h"
+#include "radixhashtable.h"
+#include "flathashtable.h"
 
 namespace joiner
 {
@@ -409,6 +411,21 @@ class TupleJoiner
     uniqueLimit = limit;
   }
 
+  /* Radix partitioned UM join support.  Integer joins whose hash tables outgrow
+     the threshold are converted to RadixHashTables once the small side is read. */
+  inline void setRadixJoinThreshold(uint64_t bytes)
+  {
+    radixJoinThreshold = bytes;
+  }
+  inline bool isRadixJoin() const
+  {
+    return radixJoin;
+  }
+  /* The memory doneInserting() takes on top of getMemUsage() while it builds the
+     radix tables, 0 if they aren't built.  The caller reserves it or disables the
+     conversion with setRadixJoinThreshold(). */
+  uint64_t getRadixBuildMemUsage() const;
+
   /* Semi-join interface */
   inline bool semiJoin()
   {
@@ -471,16 +488,16 @@ class TupleJoiner
       int64_t, rowgroup::Row::Pointer, hasher, std::equal_to<int64_t>,
       utils::STLPoolAllocator<std::pair<const int64_t, rowgroup::Row::Pointer> > >
       sthash_t;
-  typedef std::tr1::unordered_multimap<
-      TypelessData, rowgroup::Row::Pointer, hasher, std::equal_to<TypelessData>,
-      utils::STLPoolAllocator<std::pair<const TypelessData, rowgroup::Row::Pointer> > >
-      typelesshash_t;
+  typedef FlatHashTable<TypelessData> typelesshash_t;
   // MCOL-1822 Add support for Long Double AVG/SUM small side
   typedef std::tr1::unordered_multimap<
       long double, rowgroup::Row::Pointer, hasher, LongDoubleEq,
       utils::STLPoolAllocator<std::pair<const long double, rowgroup::Row::Pointer> > >
       ldhash_t;
 
+  typedef RadixHashTable<uint8_t*> radixhash_t;
+  typedef RadixHashTable<rowgroup::Row::Pointer> stradixhash_t;
+
   typedef hash_t::iterator iterator;
   typedef typelesshash_t::iterator thIterator;
   typedef ldhash_t::iterator ldIterator;
@@ -562,6 +579,17 @@ class TupleJoiner
   template <typename buckets_t, typename hash_table_t>
   void bucketsToTables(buckets_t*, hash_table_t*);
 
+  // radix partitioned UM join on ints, replaces h or sth when the small side is too big for the cache
+  boost::scoped_array<boost::scoped_ptr<radixhash_t> > rh;
+  boost::scoped_array<boost::scoped_ptr<stradixhash_t> > rsth;
+  bool radixJoin;
+  uint64_t radixJoinThreshold;
+  bool wantRadixTables() const;
+  void makeRadixTables();
+  template <typename hash_table_t, typename radix_table_t>
+  void bucketToRadixTable(uint bucket, boost::scoped_ptr<hash_table_t>& table,
+                          boost::scoped_ptr<radix_table_t>& radixTable, uint64_t partitionBytes);
+
   bool _convertToDiskJoin;
 };
 
@@ -60,16 +60,19 @@ void ByteStream::doCopy(const ByteStream& rhs)
   fCurOutPtr = fBuf + ISSOverhead;
   // Copy `longStrings` as well.
   longStrings = rhs.longStrings;
+  attachments = rhs.getAttachments();
+  fNextAttachment = 0;
 }
 
-ByteStream::ByteStream(const ByteStream& rhs) : fBuf(0), fCurInPtr(0), fCurOutPtr(0), fMaxLen(0)
+ByteStream::ByteStream(const ByteStream& rhs)
+ : fBuf(0), fCurInPtr(0), fCurOutPtr(0), fMaxLen(0), fNextAttachment(0)
 {
   // don't need to copy an empty ByteStream
   if (rhs.fBuf)
     doCopy(rhs);
 }
 
-ByteStream::ByteStream(const SBS& rhs) : fBuf(0), fCurInPtr(0), fCurOutPtr(0), fMaxLen(0)
+ByteStream::ByteStream(const SBS& rhs) : fBuf(0), fCurInPtr(0), fCurOutPtr(0), fMaxLen(0), fNextAttachment(0)
 {
   if (rhs->fBuf)
     doCopy(*rhs);
@@ -88,13 +91,16 @@ ByteStream& ByteStream::operator=(const ByteStream& rhs)
       fMaxLen = 0;
       // Clear `longStrings`.
       longStrings.clear();
+      attachments.clear();
+      fNextAttachment = 0;
     }
   }
 
   return *this;
 }
 
-ByteStream::ByteStream(uint32_t initSize) : fBuf(0), fCurInPtr(0), fCurOutPtr(0), fMaxLen(0)
+ByteStream::ByteStream(uint32_t initSize)
+ : fBuf(0), fCurInPtr(0), fCurOutPtr(0), fMaxLen(0), fNextAttachment(0)
 {
   if (initSize > 0)
     growBuf(initSize);
@@ -167,6 +173,100 @@ void ByteStream::setLongStrings(const std::vector<boost::shared_array<uint8_t>>&
   longStrings = other;
 }
 
+void ByteStream::attach(const boost::shared_array<uint8_t>& buf, uint32_t len, uint32_t start,
+                        const RowLayout& rowLayout)
+{
+  if (fBuf == 0)
+    growBuf();
+
+  Attachment a;
+  a.data = buf;
+  a.start = start;
+  a.length = len;
+  a.rowLayout = rowLayout;
+  a.offset = fCurInPtr - (fBuf + ISSOverhead);
+  attachments.push_back(a);
+}
+
+boost::shared_array<uint8_t> ByteStream::takeAttachment(uint32_t& len)
+{
+  if (!hasAttachments())
+    return boost::shared_array<uint8_t>();
+
+  uint32_t pos = fCurOutPtr - (fBuf + ISSOverhead);
+
+  // skip the ones the reader went past
+  while (fNextAttachment < attachments.size() && attachments[fNextAttachment].offset < pos)
+    fNextAttachment++;
+
+  if (fNextAttachment == attachments.size() || attachments[fNextAttachment].offset != pos)
+    return boost::shared_array<uint8_t>();
+
+  len = attachments[fNextAttachment].length;
+  return attachments[fNextAttachment++].data;
+}
+
+std::vector<ByteStream::Attachment> ByteStream::getAttachments() const
+{
+  std::vector<Attachment> ret;
+
+  if (!hasAttachments())
+    return ret;
+
+  uint32_t pos = fCurOutPtr - (fBuf + ISSOverhead);
+
+  for (uint32_t i = fNextAttachment; i < attachments.size(); i++)
+  {
+    if (attachments[i].offset < pos)
+      continue;
+
+    ret.push_back(attachments[i]);
+    ret.back().offset -= pos;
+  }
+
+  return ret;
+}
+
+void ByteStream::setAttachments(const std::vector<Attachment>& other)
+{
+  uint32_t pos = (fBuf ? fCurOutPtr - (fBuf + ISSOverhead) : 0);
+
+  if (fBuf == 0 && !other.empty())
+    growBuf();
+
+  attachments = other;
+  fNextAttachment = 0;
+
+  for (auto& a : attachments)
+    a.offset += pos;
+}
+
+void ByteStream::flatten()
+{
+  if (!hasAttachments())
+    return;
+
+  std::vector<Attachment> rest = getAttachments();
+  uint32_t len = length();
+  uint32_t pos = 0;
+
+  for (const auto& a : rest)
+    len += a.length;
+
+  ByteStream flat(len);
+
+  for (const auto& a : rest)
+  {
+    flat.append(fCurOutPtr + pos, a.offset - pos);
+    flat.append(a.data.get() + a.start, a.length);
+    pos = a.offset;
+  }
+
+  flat.append(fCurOutPtr + pos, length() - pos);
+  flat.longStrings.swap(longStrings);
+  swap(flat);
+}
+
 ByteStream& ByteStream::operator<<(const int8_t b)
 {
   if (fBuf == 0 || (fCurInPtr - fBuf + 1U > fMaxLen + ISSOverhead))
@@ -521,6 +621,8 @@ void ByteStream::load(const uint8_t* bp, uint32_t len)
   memcpy(fBuf + ISSOverhead, bp, len);
   fCurOutPtr = fBuf + ISSOverhead;
   fCurInPtr = fBuf + len + ISSOverhead;
+  attachments.clear();
+  fNextAttachment = 0;
 }
 
 void ByteStream::append(const uint8_t* bp, uint32_t len)
@@ -547,6 +649,8 @@ void ByteStream::swap(ByteStream& rhs)
   std::swap(fCurOutPtr, rhs.fCurOutPtr);
   std::swap(fMaxLen, rhs.fMaxLen);
   std::swap(longStrings, rhs.longStrings);
+  std::swap(attachments, rhs.attachments);
+  std::swap(fNextAttachment, rhs.fNextAttachment);
 }
 
 ifstream& operator>>(ifstream& ifs, ByteStream& bs)
@@ -590,6 +694,19 @@ bool ByteStream::operator==(const ByteStream& b) const
       return false;
   }
 
+  std::vector<Attachment> left = getAttachments();
+  std::vector<Attachment> right = b.getAttachments();
+
+  if (left.size() != right.size())
+    return false;
+
+  for (uint32_t i = 0; i < left.size(); ++i)
+  {
+    if (left[i].offset != right[i].offset || left[i].length != right[i].length ||
+        memcmp(left[i].data.get() + left[i].start, right[i].data.get() + right[i].start, left[i].length) != 0)
+      return false;
+  }
+
   return true;
 }
 
@@ -601,6 +718,14 @@ bool ByteStream::operator!=(const ByteStream& b) const
 /* Serializeable interface */
 void ByteStream::serialize(ByteStream& bs) const
 {
+  if (hasAttachments())
+  {
+    ByteStream flat(*this);
+    flat.flatten();
+    flat.serialize(bs);
+    return;
+  }
+
   bs << length();
   bs.append(buf(), length());
 }
@@ -628,6 +753,13 @@ void ByteStream::needAtLeast(size_t amount)
 
 ByteStream& ByteStream::operator<<(const ByteStream& bs)
 {
+  if (bs.hasAttachments())
+  {
+    ByteStream flat(bs);
+    flat.flatten();
+    return *this << flat;
+  }
+
   uint32_t len = bs.length();
 
   *this << len;
@@ -432,13 +432,56 @@ class ByteStream : public Serializeable
 
   /** size of the space we want in front of the data */
   EXPORT static const uint32_t ISSOverhead =
-      3 * sizeof(uint32_t);  // space for the BS magic & length & number of long strings.
+      4 * sizeof(uint32_t);  // space for the BS magic & length & number of long strings & attachments.
 
   // Methods to get and set `long strings`.
   EXPORT std::vector<boost::shared_array<uint8_t>>& getLongStrings();
   EXPORT const std::vector<boost::shared_array<uint8_t>>& getLongStrings() const;
   EXPORT void setLongStrings(const std::vector<boost::shared_array<uint8_t>>& other);
 
+  /** The header size, where each column starts in a row and the row size of
+      attached RowGroup data, see compress::RowEncoding */
+  typedef boost::shared_ptr<const std::vector<uint32_t>> RowLayout;
+
+  /** A buffer that is part of the stream without being copied into it */
+  struct Attachment
+  {
+    boost::shared_array<uint8_t> data;
+    uint32_t start;   // the bytes are data[start, start + length)
+    uint32_t length;
+    uint32_t offset;  // where they are in the data of the stream
+    RowLayout rowLayout;  // if the bytes are rows, for the compressed sockets
+  };
+
+  /**
+   * Add len bytes of buf, from buf[start], at the end of the stream by reference.
+   * The sockets send them with the data, the reader gets them back with
+   * takeAttachment() at the same point of the stream, in a buffer with start
+   * bytes of room in front.  The caller must not change them while the stream
+   * is around.  Nesting the stream in another one copies them in, anything else
+   * that uses buf() as the whole stream needs a flatten() first.
+   */
+  EXPORT void attach(const boost::shared_array<uint8_t>& buf, uint32_t len, uint32_t start = 0,
+                     const RowLayout& rowLayout = RowLayout());
+
+  /**
+   * Take the buffer attached at the read position, NULL if there isn't one.
+   * len is the number of bytes, they begin at the start given to attach().
+   */
+  EXPORT boost::shared_array<uint8_t> takeAttachment(uint32_t& len);
+
+  /**
+   * Copy the attachments into the data
+   */
+  EXPORT void flatten();
+
+  /**
+   * The attachments not read yet, the offsets are from the read position
+   */
+  EXPORT std::vector<Attachment> getAttachments() const;
+  EXPORT void setAttachments(const std::vector<Attachment>& other);
+  inline bool hasAttachments() const;
+
   friend class ::ByteStreamTestSuite;
 
  protected:
@@ -470,6 +513,8 @@ class ByteStream : public Serializeable
   uint32_t fMaxLen;     // how big fBuf is currently
   // Stores `long strings`.
   std::vector<boost::shared_array<uint8_t>> longStrings;
+  std::vector<Attachment> attachments;
+  uint32_t fNextAttachment;  // the first attachment not taken
 };
 
 template <int W, typename T = void>
@@ -518,7 +563,7 @@ static const uint8_t BS_BLOB = 9;
 static const uint8_t BS_SERIALIZABLE = 10;
 static const uint8_t BS_UUID = 11;
 
-inline ByteStream::ByteStream(const uint8_t* bp, const uint32_t len) : fBuf(0), fMaxLen(0)
+inline ByteStream::ByteStream(const uint8_t* bp, const uint32_t len) : fBuf(0), fMaxLen(0), fNextAttachment(0)
 {
   load(bp, len);
 }
@@ -545,21 +590,35 @@ inline bool ByteStream::empty() const
 }
 inline uint32_t ByteStream::lengthWithHdrOverhead() const
 {
-  return (length() + ISSOverhead);
+  uint32_t ret = length() + ISSOverhead;
+
+  for (uint32_t i = fNextAttachment; i < attachments.size(); i++)
+    ret += attachments[i].length;
+
+  return ret;
 }
 inline void ByteStream::reset()
 {
   delete[] fBuf;
   fMaxLen = 0;
   fCurInPtr = fCurOutPtr = fBuf = 0;
+  attachments.clear();
+  fNextAttachment = 0;
 }
 inline void ByteStream::restart()
 {
   fCurInPtr = fCurOutPtr = fBuf + ISSOverhead;
+  attachments.clear();
+  fNextAttachment = 0;
 }
 inline void ByteStream::rewind()
 {
   fCurOutPtr = fBuf + ISSOverhead;
+  fNextAttachment = 0;
+}
+inline bool ByteStream::hasAttachments() const
+{
+  return fNextAttachment < attachments.size();
 }
 inline void ByteStream::advance(uint32_t adv)
 {
@@ -586,6 +645,13 @@ inline void ByteStream::peek(uint8_t*& bpr) const
 
 inline ByteStream& ByteStream::operator+=(const ByteStream& rhs)
 {
+  if (rhs.hasAttachments())
+  {
+    ByteStream flat(rhs);
+    flat.flatten();
+    return *this += flat;
+  }
+
   append(rhs.buf(), rhs.length());
   return *this;
 }
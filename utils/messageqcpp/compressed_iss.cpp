@@ -25,6 +25,7 @@
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <chrono>
 #if __FreeBSD__
 #include <sys/types.h>
 #include <netinet/in.h>
@@ -41,14 +42,78 @@
 #include "compressed_iss.h"
 #include "iosocket.h"
 #include "configcpp.h"
+#include "rowencoding.h"
 
 using namespace std;
 using namespace boost;
 using namespace compress;
 
+namespace
+{
+// how an attachment of a COMPRESSED_ATTACHED_BYTESTREAM_MAGIC stream is sent
+const uint8_t ATTACHED_RAW = 0;
+const uint8_t ATTACHED_CODEC = 1;
+const uint8_t ATTACHED_ROWS = 2;  // RowEncoding, then the codec
+
+// the weight of a new measurement in the averages
+const double EWMA_ALPHA = 1.0 / 8;
+
+void average(double& avg, double val)
+{
+  avg = (avg == 0 ? val : avg + EWMA_ALPHA * (val - avg));
+}
+
+uint64_t nsecsSince(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
 namespace messageqcpp
 {
-CompressedInetStreamSocket::CompressedInetStreamSocket()
+CompressionAdvisor::CompressionAdvisor() : fRatio(0), fCodecSpeed(0), fWireSpeed(0), fSinceProbe(0)
+{
+}
+
+bool CompressionAdvisor::compress()
+{
+  std::lock_guard<std::mutex> lk(fMutex);
+
+  // measure both before deciding
+  if (fRatio == 0 || fWireSpeed == 0)
+    return true;
+
+  if (++fSinceProbe >= PROBE_INTERVAL)
+  {
+    fSinceProbe = 0;
+    return true;
+  }
+
+  // ns saved on the wire per raw byte against ns spent in the codec per raw byte
+  return (1 - fRatio) / fWireSpeed > 1 / fCodecSpeed;
+}
+
+void CompressionAdvisor::compressed(size_t in, size_t out, uint64_t nsecs)
+{
+  if (in == 0)
+    return;
+
+  std::lock_guard<std::mutex> lk(fMutex);
+  average(fRatio, std::min(1.0, (double)out / in));
+  average(fCodecSpeed, (double)in / std::max<uint64_t>(nsecs, 1));
+}
+
+void CompressionAdvisor::sent(size_t bytes, uint64_t nsecs)
+{
+  if (bytes < MIN_TIMED_WRITE)
+    return;
+
+  std::lock_guard<std::mutex> lk(fMutex);
+  average(fWireSpeed, (double)bytes / std::max<uint64_t>(nsecs, 1));
+}
+
+CompressedInetStreamSocket::CompressedInetStreamSocket() : adaptive(false)
 {
   config::Config* config = config::Config::makeConfig();
   string val;
@@ -80,6 +145,18 @@ CompressedInetStreamSocket::CompressedInetStreamSocket()
     compressInterface = new compress::CompressInterfaceSnappy();
 
   alg.reset(compressInterface);
+
+  try
+  {
+    val = config->getConfig("NetworkCompression", "Adaptive");
+  }
+  catch (...)
+  {
+    val.clear();
+  }
+
+  adaptive = (val == "Y");
+  advisor.reset(new CompressionAdvisor());
 }
 
 Socket* CompressedInetStreamSocket::clone() const
@@ -98,6 +175,9 @@ const SBS CompressedInetStreamSocket::read(const struct timespec* timeout, bool*
   if (readBS->length() == 0 || fMagicBuffer == BYTESTREAM_MAGIC)
     return readBS;
 
+  if (fMagicBuffer == COMPRESSED_ATTACHED_BYTESTREAM_MAGIC)
+    return uncompressAttached(*readBS);
+
   // Read stored len, first 4 bytes.
   uint32_t storedLen = *(uint32_t*)readBS->buf();
 
@@ -115,21 +195,232 @@ const SBS CompressedInetStreamSocket::read(const struct timespec* timeout, bool*
   return ret;
 }
 
+const SBS CompressedInetStreamSocket::uncompressAttached(ByteStream& msg) const
+{
+  vector<ByteStream::Attachment> payloads = msg.getAttachments();
+  uint32_t mainLen, compressedLen, count;
+  SBS ret;
+
+  msg >> mainLen >> compressedLen;
+
+  if (compressedLen > msg.length())
+    throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+  ret.reset(new ByteStream(mainLen));
+
+  if (compressedLen > 0)
+  {
+    size_t outLen = mainLen;
+
+    if (alg->uncompress((char*)msg.buf(), compressedLen, (char*)ret->getInputPtr(), &outLen) !=
+            CompressInterface::ERR_OK ||
+        outLen != mainLen)
+      throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+    ret->advanceInputPtr(mainLen);
+  }
+
+  msg.advance(compressedLen);
+  msg >> count;
+
+  if (count != payloads.size())
+    throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+  vector<ByteStream::Attachment> attachments(count);
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    ByteStream::Attachment& a = attachments[i];
+    const ByteStream::Attachment& p = payloads[i];
+    const char* in = (const char*)p.data.get() + p.start;
+    uint32_t midLen;
+    uint8_t encoding;
+    vector<uint32_t> layout;
+
+    msg >> a.offset >> a.start >> a.length >> encoding >> midLen;
+
+    if (encoding == ATTACHED_ROWS)
+      deserializeInlineVector(msg, layout);
+
+    if (a.offset > mainLen)
+      throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+    if (encoding == ATTACHED_RAW)
+    {
+      if (p.length != a.length)
+        throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+      // the socket read it with room for start in front
+      a.data = p.data;
+      a.start = p.start;
+      continue;
+    }
+
+    a.data.reset(new uint8_t[(size_t)a.start + a.length]);
+    char* out = (char*)a.data.get() + a.start;
+    size_t outLen = (encoding == ATTACHED_ROWS ? midLen : a.length);
+    vector<char> mid;
+
+    if (encoding == ATTACHED_ROWS)
+      mid.resize(midLen);
+    else if (encoding != ATTACHED_CODEC)
+      throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+    char* codecOut = (encoding == ATTACHED_ROWS ? mid.data() : out);
+    size_t expected = outLen;
+
+    if (alg->uncompress(in, p.length, codecOut, &outLen) != CompressInterface::ERR_OK || outLen != expected)
+      throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+
+    if (encoding == ATTACHED_ROWS && !RowEncoding::decode(mid.data(), mid.size(), layout, out, a.length))
+      throw runtime_error("CompressedInetStreamSocket::read: bad compressed stream");
+  }
+
+  ret->setAttachments(attachments);
+  return ret;
+}
+
+void CompressedInetStreamSocket::compressPlain(const ByteStream& msg, ByteStream& smsg) const
+{
+  size_t len = msg.length();
+  size_t outLen = alg->maxCompressedSize(len) + HEADER_SIZE;
+
+  smsg.needAtLeast(outLen);
+  alg->compress((char*)msg.buf(), len, (char*)smsg.getInputPtr() + HEADER_SIZE, &outLen);
+  // Save original len.
+  *(uint32_t*)smsg.getInputPtr() = len;
+  smsg.advanceInputPtr(outLen + HEADER_SIZE);
+}
+
+void CompressedInetStreamSocket::compressAttached(const ByteStream& msg, ByteStream& smsg) const
+{
+  vector<ByteStream::Attachment> attachments = msg.getAttachments();
+  uint32_t len = msg.length();
+  size_t outLen = 0;
+
+  smsg << len;
+
+  if (len > 0)
+  {
+    outLen = alg->maxCompressedSize(len);
+    smsg.needAtLeast(sizeof(uint32_t) + outLen);
+    alg->compress((char*)msg.buf(), len, (char*)smsg.getInputPtr() + sizeof(uint32_t), &outLen);
+  }
+
+  smsg << (uint32_t)outLen;
+  smsg.advanceInputPtr(outLen);
+  smsg << (uint32_t)attachments.size();
+
+  vector<ByteStream::Attachment> payloads;
+  vector<char> mid;
+
+  for (const ByteStream::Attachment& a : attachments)
+  {
+    const char* in = (const char*)a.data.get() + a.start;
+    uint8_t encoding = ATTACHED_CODEC;
+    uint32_t midLen = a.length;
+
+    if (a.rowLayout && RowEncoding::encode(in, a.length, *a.rowLayout, mid))
+    {
+      encoding = ATTACHED_ROWS;
+      in = mid.data();
+      midLen = mid.size();
+    }
+
+    ByteStream::Attachment p;
+    size_t pLen = alg->maxCompressedSize(midLen);
+    p.data.reset(new uint8_t[pLen]);
+    p.start = 0;
+
+    if (midLen == 0 || alg->compress(in, midLen, (char*)p.data.get(), &pLen) != CompressInterface::ERR_OK ||
+        pLen >= a.length)
+    {
+      // send it as it is
+      encoding = ATTACHED_RAW;
+      p.data = a.data;
+      p.start = a.start;
+      pLen = a.length;
+    }
+
+    p.length = pLen;
+    payloads.push_back(p);
+
+    smsg << a.offset << a.start << a.length << encoding << midLen;
+
+    if (encoding == ATTACHED_ROWS)
+      serializeInlineVector(smsg, *a.rowLayout);
+  }
+
+  for (const ByteStream::Attachment& p : payloads)
+    smsg.attach(p.data, p.length, p.start);
+}
+
+void CompressedInetStreamSocket::timedWrite(const ByteStream& msg, uint32_t magic, size_t len, Stats* stats)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  do_write(msg, magic, stats);
+  advisor->sent(len, nsecsSince(start));
+}
+
+void CompressedInetStreamSocket::writeAdaptive(const ByteStream& msg, Stats* stats)
+{
+  size_t len = msg.lengthWithHdrOverhead() - ByteStream::ISSOverhead;
+
+  if (len <= 512 || !advisor->compress())
+  {
+    timedWrite(msg, BYTESTREAM_MAGIC, len, stats);
+    return;
+  }
+
+  ByteStream smsg;
+  uint32_t magic;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  if (msg.hasAttachments())
+  {
+    compressAttached(msg, smsg);
+    magic = COMPRESSED_ATTACHED_BYTESTREAM_MAGIC;
+  }
+  else
+  {
+    compressPlain(msg, smsg);
+    magic = COMPRESSED_BYTESTREAM_MAGIC;
+  }
+
+  size_t outLen = smsg.lengthWithHdrOverhead() - ByteStream::ISSOverhead;
+  advisor->compressed(len, outLen, nsecsSince(start));
+
+  if (outLen < len)
+    timedWrite(smsg, magic, outLen, stats);
+  else
+    timedWrite(msg, BYTESTREAM_MAGIC, len, stats);
+}
+
 void CompressedInetStreamSocket::write(const ByteStream& msg, Stats* stats)
 {
+  if (useCompression && adaptive)
+  {
+    writeAdaptive(msg, stats);
+    return;
+  }
+
+  // the codec takes the message in one piece
+  if (useCompression && msg.hasAttachments())
+  {
+    ByteStream flat(msg);
+    flat.flatten();
+    write(flat, stats);
+    return;
+  }
+
   size_t len = msg.length();
 
   if (useCompression && (len > 512))
   {
-    size_t outLen = alg->maxCompressedSize(len) + HEADER_SIZE;
-    ByteStream smsg(outLen);
-
-    alg->compress((char*)msg.buf(), len, (char*)smsg.getInputPtr() + HEADER_SIZE, &outLen);
-    // Save original len.
-    *(uint32_t*)smsg.getInputPtr() = len;
-    smsg.advanceInputPtr(outLen + HEADER_SIZE);
+    ByteStream smsg;
+    compressPlain(msg, smsg);
 
-    if (outLen < len)
+    if (smsg.length() - HEADER_SIZE < len)
       do_write(smsg, COMPRESSED_BYTESTREAM_MAGIC, stats);
     else
       InetStreamSocket::write(msg, stats);
@@ -25,6 +25,8 @@
 
 #include <unistd.h>
 #include <netinet/in.h>
+#include <memory>
+#include <mutex>
 
 #include "socket.h"
 #include "iosocket.h"
@@ -32,8 +34,49 @@
 #include "inetstreamsocket.h"
 #include "idbcompress.h"
 
+class CompressedSocketTest;
+
 namespace messageqcpp
 {
+/** @brief Whether compressing the messages of a connection pays off
+ *
+ * Keeps moving averages of the ratio and the speed of the codec, and of the
+ * speed the socket takes bytes at.  Compressing pays off when the time the
+ * saved bytes would take on the wire is more than the time the codec takes:
+ *
+ *   (1 - ratio) / wire speed > 1 / codec speed
+ *
+ * A write that doesn't block measures how fast the kernel copies, not the
+ * network, so a connection that keeps up stops compressing, and one where the
+ * writes wait for the network starts.  One message in PROBE_INTERVAL is
+ * compressed anyway to keep the codec numbers current.
+ */
+class CompressionAdvisor
+{
+ public:
+  CompressionAdvisor();
+
+  /** @brief Whether to compress the next message */
+  bool compress();
+
+  /** @brief The codec made out bytes of in bytes in nsecs */
+  void compressed(size_t in, size_t out, uint64_t nsecs);
+
+  /** @brief The socket took bytes in nsecs */
+  void sent(size_t bytes, uint64_t nsecs);
+
+  static const uint32_t PROBE_INTERVAL = 32;
+  // a shorter write times the system call more than the network
+  static const size_t MIN_TIMED_WRITE = 64 * 1024;
+
+ private:
+  std::mutex fMutex;
+  double fRatio;       // compressed / raw size
+  double fCodecSpeed;  // raw bytes per ns
+  double fWireSpeed;   // bytes per ns
+  uint32_t fSinceProbe;
+};
+
 class CompressedInetStreamSocket : public InetStreamSocket
 {
  public:
@@ -50,9 +93,23 @@ class CompressedInetStreamSocket : public InetStreamSocket
   virtual const IOSocket accept(const struct timespec* timeout);
   virtual void connect(const sockaddr* addr);
 
+  /*
+   * allow the tests to set what Columnstore.xml sets
+   */
+  friend class ::CompressedSocketTest;
+
  private:
+  void compressPlain(const ByteStream& msg, ByteStream& smsg) const;
+  void compressAttached(const ByteStream& msg, ByteStream& smsg) const;
+  const SBS uncompressAttached(ByteStream& msg) const;
+  void writeAdaptive(const ByteStream& msg, Stats* stats);
+  void timedWrite(const ByteStream& msg, uint32_t magic, size_t len, Stats* stats);
+
   std::shared_ptr<compress::CompressInterface> alg;
   bool useCompression;
+  // NetworkCompression/Adaptive, compress what pays off, RowGroups column by column
+  bool adaptive;
+  std::shared_ptr<CompressionAdvisor> advisor;  // shared by the clones, it's per connection
   static const uint32_t HEADER_SIZE = 4;
 };
 
@@ -64,7 +64,9 @@ either expressed or implied, of the FreeBSD Project.
 #include <sys/types.h>
 #include <sys/time.h>
 #include <cstring>
+#include <climits>
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -304,7 +306,8 @@ bool InetStreamSocket::readToMagic(long msecs, bool* isTimeOut, Stats* stats) co
   pfd[0].fd = fSocketParms.sd();
   pfd[0].events = POLLIN;
 
-  while ((fMagicBuffer != BYTESTREAM_MAGIC) && (fMagicBuffer != COMPRESSED_BYTESTREAM_MAGIC))
+  while ((fMagicBuffer != BYTESTREAM_MAGIC) && (fMagicBuffer != COMPRESSED_BYTESTREAM_MAGIC) &&
+         (fMagicBuffer != COMPRESSED_ATTACHED_BYTESTREAM_MAGIC))
   {
     if (msecs >= 0)
     {
@@ -503,12 +506,15 @@ const SBS InetStreamSocket::read(const struct ::timespec* timeout, bool* isTimeO
                          msecs))
     return SBS(new ByteStream(0));
 
-  // Read the number of the `long strings`.
-  uint32_t longStringSize;
-  if (!readFixedSizeData(pfd, reinterpret_cast<uint8_t*>(&longStringSize), sizeof(longStringSize), timeout,
-                         isTimeOut, stats, msecs))
+  // Read the number of the `long strings` and of the attachments.
+  uint32_t counts[2];
+  if (!readFixedSizeData(pfd, reinterpret_cast<uint8_t*>(counts), sizeof(counts), timeout, isTimeOut, stats,
+                         msecs))
     return SBS(new ByteStream(0));
 
+  uint32_t longStringSize = counts[0];
+  uint32_t attachmentCount = counts[1];
+
   // Read the actual data of the `ByteStream`.
   SBS res(new ByteStream(msglen));
   if (!readFixedSizeData(pfd, res->getInputPtr(), msglen, timeout, isTimeOut, stats, msecs))
@@ -518,6 +524,35 @@ const SBS InetStreamSocket::read(const struct ::timespec* timeout, bool* isTimeO
   std::vector<boost::shared_array<uint8_t>> longStrings;
   try
   {
+    // The attachments go straight to buffers of their size, that the reader can keep
+    if (attachmentCount > 0)
+    {
+      // (offset, start, length) of each
+      boost::scoped_array<uint32_t> table(new uint32_t[attachmentCount * 3]);
+      if (!readFixedSizeData(pfd, reinterpret_cast<uint8_t*>(table.get()), attachmentCount * 12, timeout,
+                             isTimeOut, stats, msecs))
+        return SBS(new ByteStream(0));
+
+      std::vector<ByteStream::Attachment> attachments(attachmentCount);
+
+      for (uint32_t i = 0; i < attachmentCount; ++i)
+      {
+        ByteStream::Attachment& a = attachments[i];
+        a.offset = table[i * 3];
+        a.start = table[i * 3 + 1];
+        a.length = table[i * 3 + 2];
+
+        if (a.offset > msglen || (i > 0 && a.offset < attachments[i - 1].offset))
+          throw runtime_error("bad attachment offset");
+
+        a.data.reset(new uint8_t[a.start + a.length]);
+        if (!readFixedSizeData(pfd, a.data.get() + a.start, a.length, timeout, isTimeOut, stats, msecs))
+          return SBS(new ByteStream(0));
+      }
+
+      res->setAttachments(attachments);
+    }
+
     for (uint32_t i = 0; i < longStringSize; ++i)
     {
       // Read `MemChunk`.
@@ -580,29 +615,58 @@ void InetStreamSocket::do_write(const ByteStream& msg, uint32_t whichMagic, Stat
     return;
 
   const auto& longStrings = msg.getLongStrings();
+  const auto attachments = msg.getAttachments();
   /* buf.fCurOutPtr points to the data to send; ByteStream guarantees that there
-     are at least 12 bytes before that for the magic & length fields */
+     are at least 16 bytes before that for the magic & length fields */
   realBuf = (uint32_t*)msg.buf();
-  realBuf -= 3;
+  realBuf -= 4;
   realBuf[0] = magic;
   realBuf[1] = msglen;
   realBuf[2] = longStrings.size();
+  realBuf[3] = attachments.size();
 
   try
   {
-    auto bytesToWrite = sizeof(msglen) + sizeof(magic) + sizeof(uint32_t) + msglen;
-    written(fSocketParms.sd(), (const uint8_t*)realBuf, bytesToWrite);
+    // One writev() for the header, the data, the attachments and the long strings,
+    // none of them gets copied.
+    std::vector<struct iovec> iov;
+    std::vector<uint32_t> table;
+    iov.reserve(2 + attachments.size() + longStrings.size());
+
+    size_t bytesToWrite = ByteStream::ISSOverhead + msglen;
+    iov.push_back({realBuf, bytesToWrite});
+
+    if (!attachments.empty())
+    {
+      for (const auto& a : attachments)
+      {
+        table.push_back(a.offset);
+        table.push_back(a.start);
+        table.push_back(a.length);
+      }
+
+      iov.push_back({table.data(), table.size() * sizeof(uint32_t)});
+      bytesToWrite += table.size() * sizeof(uint32_t);
+
+      for (const auto& a : attachments)
+      {
+        iov.push_back({a.data.get() + a.start, a.length});
+        bytesToWrite += a.length;
+      }
+    }
 
     for (const auto& longString : longStrings)
     {
       const rowgroup::StringStore::MemChunk* memChunk =
           reinterpret_cast<rowgroup::StringStore::MemChunk*>(longString.get());
       const auto writeSize = memChunk->currentSize + sizeof(rowgroup::StringStore::MemChunk);
-      written(fSocketParms.sd(), (const uint8_t*)longString.get(), writeSize);
+      iov.push_back({longString.get(), writeSize});
       // For stats.
       bytesToWrite += writeSize;
     }
 
+    writtenv(fSocketParms.sd(), iov.data(), iov.size());
+
     if (stats)
       stats->dataSent(bytesToWrite);
   }
@@ -953,6 +1017,39 @@ ssize_t InetStreamSocket::written(int fd, const uint8_t* ptr, size_t nbytes) con
   return nbytes;
 }
 
+void InetStreamSocket::writtenv(int fd, struct iovec* iov, size_t iovcnt) const
+{
+  while (iovcnt > 0)
+  {
+    // the O_NONBLOCK flag is not set, this is a blocking I/O.
+    ssize_t nwritten = ::writev(fd, iov, std::min<size_t>(iovcnt, IOV_MAX));
+
+    if (nwritten < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      ostringstream oss;
+      oss << "InetStreamSocket::write error: " << strerror(errno);
+      throw runtime_error(oss.str());
+    }
+
+    // skip what went out, a short write leaves the rest of an iovec
+    while (iovcnt > 0 && static_cast<size_t>(nwritten) >= iov->iov_len)
+    {
+      nwritten -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+
+    if (iovcnt > 0)
+    {
+      iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + nwritten;
+      iov->iov_len -= nwritten;
+    }
+  }
+}
+
 const string InetStreamSocket::addr2String() const
 {
   string s;
@@ -26,6 +26,7 @@
 #include <ctime>
 #include <unistd.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 #include <cstring>
 
 #include "socket.h"
@@ -43,6 +44,8 @@ class IOSocket;
 /// random # marking the beginning of a ByteStream in the stream
 const uint32_t BYTESTREAM_MAGIC = 0x14fbc137;
 const uint32_t COMPRESSED_BYTESTREAM_MAGIC = 0x14fbc138;
+// compressed with its attachments, see CompressedInetStreamSocket
+const uint32_t COMPRESSED_ATTACHED_BYTESTREAM_MAGIC = 0x14fbc139;
 
 /** An Inet Stream Socket
  *
@@ -233,6 +236,8 @@ class InetStreamSocket : public Socket
 
   void do_write(const ByteStream& msg, uint32_t magic, Stats* stats = NULL) const;
   ssize_t written(int fd, const uint8_t* ptr, size_t nbytes) const;
+  // writes all of iov, which it changes on the way
+  void writtenv(int fd, struct iovec* iov, size_t iovcnt) const;
   bool readFixedSizeData(struct pollfd* pfd, uint8_t* buffer, const size_t numberOfBytes,
                          const struct ::timespec* timeout, bool* isTimeOut, Stats* stats, int64_t msec) const;
 
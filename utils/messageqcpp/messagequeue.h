@@ -277,6 +277,12 @@ class MessageQueueClient
     return fClientSock.hasData();
   }
 
+  // the socket descriptor, to wait for data with poll() or epoll
+  int sd() const
+  {
+    return fClientSock.socketParms().sd();
+  }
+
   // This client's flag is set running DEC::Setup() call
   bool atTheSameHost() const
   {
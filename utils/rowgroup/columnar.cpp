@@ -0,0 +1,137 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstring>
+
+#include "columnar.h"
+
+namespace
+{
+inline void copyValue(uint8_t* dst, const uint8_t* src, uint32_t width)
+{
+  switch (width)
+  {
+    case 1: *dst = *src; break;
+    case 2: memcpy(dst, src, 2); break;
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, width); break;
+  }
+}
+
+}  // namespace
+
+namespace rowgroup
+{
+ColumnarRGData::ColumnarRGData() : rowCount(0), baseRid(0)
+{
+}
+
+ColumnarRGData::ColumnarRGData(const RowGroup& rg, const std::vector<uint32_t>* cols)
+{
+  fromRows(rg, cols);
+}
+
+void ColumnarRGData::fromRows(const RowGroup& rg, const std::vector<uint32_t>* cols)
+{
+  rowCount = rg.getRowCount();
+  baseRid = rg.getBaseRid();
+  strings = (rg.getRGData() ? rg.getRGData()->strings : boost::shared_ptr<StringStore>());
+  // the buffers of the previous RowGroup are kept, refilling with the same layout doesn't allocate
+  columns.resize(rg.getColumnCount());
+  rids.resize(rowCount);
+
+  for (Column& column : columns)
+  {
+    column.present = false;
+    column.nullCount = 0;
+  }
+
+  Row row;
+  rg.initRow(&row);
+
+  present.clear();
+
+  if (cols)
+    present.assign(cols->begin(), cols->end());
+  else
+    for (uint32_t i = 0; i < columns.size(); i++)
+      present.push_back(i);
+
+  for (uint32_t col : present)
+  {
+    Column& column = columns[col];
+    column.present = true;
+    column.type = row.getColType(col);
+    // the width in the rows, a string table token for long strings
+    column.width = row.getOffset(col + 1) - row.getOffset(col);
+    column.values.resize((size_t)rowCount * column.width);
+    column.nulls.assign((rowCount + 63) / 64, 0);
+  }
+
+  if (rowCount == 0)
+    return;
+
+  rg.getRow(0, &row);
+
+  for (uint32_t i = 0; i < rowCount; i++, row.nextRow())
+  {
+    rids[i] = row.getRelRid();
+
+    for (uint32_t col : present)
+    {
+      Column& column = columns[col];
+      copyValue(&column.values[(size_t)i * column.width], row.getData() + row.getOffset(col), column.width);
+
+      if (row.isNullValue(col))
+      {
+        column.nulls[i >> 6] |= 1ULL << (i & 63);
+        column.nullCount++;
+      }
+    }
+  }
+}
+
+void ColumnarRGData::toRows(RowGroup& rg) const
+{
+  Row row;
+
+  // detach the strings first, resetRowGroup() clears them and they may be the ones the tokens point to
+  rg.setStringStore(boost::shared_ptr<StringStore>());
+  rg.resetRowGroup(baseRid);
+  rg.setStringStore(strings);
+
+  rg.initRow(&row);
+  rg.getRow(0, &row);
+
+  for (uint32_t i = 0; i < rowCount; i++, row.nextRow())
+  {
+    row.setRid(rids[i]);
+
+    for (uint32_t col = 0; col < columns.size(); col++)
+    {
+      const Column& column = columns[col];
+      idbassert(column.present);
+      copyValue(row.getData() + row.getOffset(col), &column.values[(size_t)i * column.width], column.width);
+    }
+  }
+
+  rg.setRowCount(rowCount);
+}
+
+}  // namespace rowgroup
@@ -0,0 +1,130 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "rowgroup.h"
+
+namespace rowgroup
+{
+/** @brief A column-major (PAX) copy of the rows of a RowGroup
+ *
+ * Every column is a contiguous array of its values, in the width the values
+ * have in the rows, with a bitmap of its NULLs.  Long strings stay in the
+ * StringStore of the rows, their arrays hold the string table tokens the rows
+ * hold.  Work on one column at a time, e.g. aggregation without GROUP BY, reads
+ * the arrays instead of striding across whole rows.  fromRows() and toRows()
+ * convert at the boundaries that need rows.
+ */
+class ColumnarRGData
+{
+ public:
+  ColumnarRGData();
+
+  /** @brief Copies the rows of rg, all the columns or only the ones in columns */
+  explicit ColumnarRGData(const RowGroup& rg, const std::vector<uint32_t>* columns = nullptr);
+
+  /** @brief Copies the rows of rg like the constructor, reusing the buffers of
+   *  the previous copy.
+   */
+  void fromRows(const RowGroup& rg, const std::vector<uint32_t>* columns = nullptr);
+
+  /** @brief Writes the rows to rg, which has the layout the rows were copied
+   *  from and room for them.  All the columns have to be present.
+   */
+  void toRows(RowGroup& rg) const;
+
+  uint32_t getRowCount() const
+  {
+    return rowCount;
+  }
+  uint32_t getColumnCount() const
+  {
+    return columns.size();
+  }
+  uint64_t getBaseRid() const
+  {
+    return baseRid;
+  }
+  bool hasColumn(uint32_t col) const
+  {
+    return columns[col].present;
+  }
+  uint32_t getColumnWidth(uint32_t col) const
+  {
+    return columns[col].width;
+  }
+  execplan::CalpontSystemCatalog::ColDataType getColType(uint32_t col) const
+  {
+    return columns[col].type;
+  }
+  const uint8_t* getColumn(uint32_t col) const
+  {
+    return columns[col].values.data();
+  }
+  template <typename T>
+  const T* getColumn(uint32_t col) const
+  {
+    return reinterpret_cast<const T*>(columns[col].values.data());
+  }
+
+  /** @brief Bit i of the bitmap is set if the value of row i is NULL */
+  const uint64_t* getNulls(uint32_t col) const
+  {
+    return columns[col].nulls.data();
+  }
+  bool isNull(uint32_t col, uint32_t row) const
+  {
+    return (columns[col].nulls[row >> 6] >> (row & 63)) & 1;
+  }
+  uint32_t getNullCount(uint32_t col) const
+  {
+    return columns[col].nullCount;
+  }
+  const uint16_t* getRids() const
+  {
+    return rids.data();
+  }
+  const boost::shared_ptr<StringStore>& getStringStore() const
+  {
+    return strings;
+  }
+
+ private:
+  struct Column
+  {
+    std::vector<uint8_t> values;
+    std::vector<uint64_t> nulls;
+    uint32_t width = 0;
+    uint32_t nullCount = 0;
+    execplan::CalpontSystemCatalog::ColDataType type = execplan::CalpontSystemCatalog::UNDEFINED;
+    bool present = false;
+  };
+
+  uint32_t rowCount;
+  uint64_t baseRid;
+  std::vector<Column> columns;
+  std::vector<uint16_t> rids;
+  std::vector<uint32_t> present;
+  boost::shared_ptr<StringStore> strings;
+};
+
+}  // namespace rowgroup
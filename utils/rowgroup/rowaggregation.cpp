@@ -28,6 +28,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
 #include <typeinfo>
 #include <cassert>
 
@@ -55,6 +56,7 @@
 
 #include "threadnaming.h"
 #include "rowstorage.h"
+#include "columnar.h"
 
 //..comment out NDEBUG to enable assertions, uncomment NDEBUG to disable
 //#define NDEBUG
@@ -225,6 +227,81 @@ inline string getStringNullValue()
   return joblist::CPNULLSTRMARK;
 }
 
+// the signed and unsigned integer types aggregateColumns() takes, 0 for others
+inline int columnarIntType(int colType)
+{
+  switch (colType)
+  {
+    case execplan::CalpontSystemCatalog::TINYINT:
+    case execplan::CalpontSystemCatalog::SMALLINT:
+    case execplan::CalpontSystemCatalog::MEDINT:
+    case execplan::CalpontSystemCatalog::INT:
+    case execplan::CalpontSystemCatalog::BIGINT: return -1;
+
+    case execplan::CalpontSystemCatalog::UTINYINT:
+    case execplan::CalpontSystemCatalog::USMALLINT:
+    case execplan::CalpontSystemCatalog::UMEDINT:
+    case execplan::CalpontSystemCatalog::UINT:
+    case execplan::CalpontSystemCatalog::UBIGINT:
+    case execplan::CalpontSystemCatalog::DATE:
+    case execplan::CalpontSystemCatalog::DATETIME:
+    case execplan::CalpontSystemCatalog::TIMESTAMP:
+    case execplan::CalpontSystemCatalog::TIME: return 1;
+
+    default: return 0;
+  }
+}
+
+// min and max of the values of a column that aren't NULL, false if they all are
+template <typename T, typename R>
+bool columnMinMax(const rowgroup::ColumnarRGData& cols, uint32_t col, R& minOut, R& maxOut)
+{
+  const T* values = cols.getColumn<T>(col);
+  const uint32_t rowCount = cols.getRowCount();
+
+  if (cols.getNullCount(col) == rowCount)
+    return false;
+
+  T minVal = numeric_limits<T>::max();
+  T maxVal = numeric_limits<T>::lowest();
+
+  if (cols.getNullCount(col) == 0)
+  {
+    for (uint32_t i = 0; i < rowCount; i++)
+    {
+      minVal = std::min(minVal, values[i]);
+      maxVal = std::max(maxVal, values[i]);
+    }
+  }
+  else
+  {
+    for (uint32_t i = 0; i < rowCount; i++)
+    {
+      if (cols.isNull(col, i))
+        continue;
+
+      minVal = std::min(minVal, values[i]);
+      maxVal = std::max(maxVal, values[i]);
+    }
+  }
+
+  minOut = minVal;
+  maxOut = maxVal;
+  return true;
+}
+
+template <typename R, typename T1, typename T2, typename T4, typename T8>
+bool columnMinMax(const rowgroup::ColumnarRGData& cols, uint32_t col, R& minOut, R& maxOut)
+{
+  switch (cols.getColumnWidth(col))
+  {
+    case 1: return columnMinMax<T1>(cols, col, minOut, maxOut);
+    case 2: return columnMinMax<T2>(cols, col, minOut, maxOut);
+    case 4: return columnMinMax<T4>(cols, col, minOut, maxOut);
+    default: return columnMinMax<T8>(cols, col, minOut, maxOut);
+  }
+}
+
 }  // namespace
 
 namespace rowgroup
@@ -561,6 +638,12 @@ void RowAggregation::addRowGroup(const RowGroup* pRows)
       if (countSpecial(pRows))
         return;
     }
+
+    if (aggregateColumns(pRows))
+    {
+      fRowGroupOut->setDBRoot(pRows->getDBRoot());
+      return;
+    }
   }
 
   fRowGroupOut->setDBRoot(pRows->getDBRoot());
@@ -577,6 +660,93 @@ void RowAggregation::addRowGroup(const RowGroup* pRows)
   fRowAggStorage->dump();
 }
 
+//------------------------------------------------------------------------------
+// Aggregate pRows a column at a time, without GROUP BY.  The input columns of
+// COUNT, MIN and MAX of integer and date/time columns are copied to
+// fColumnarData, each function folds a whole column into fRow at once.
+// Returns false if a function can't be aggregated this way.
+//------------------------------------------------------------------------------
+bool RowAggregation::aggregateColumns(const RowGroup* pRows)
+{
+  vector<uint32_t>& cols = fColumnarCols;
+  cols.clear();
+
+  for (const auto& func : fFunctionCols)
+  {
+    switch (func->fAggFunction)
+    {
+      case ROWAGG_COUNT_ASTERISK:
+      case ROWAGG_COUNT_NO_OP:
+      case ROWAGG_DUP_FUNCT:
+      case ROWAGG_CONSTANT: break;
+
+      case ROWAGG_COUNT_COL_NAME:
+      case ROWAGG_MIN:
+      case ROWAGG_MAX:
+        if (columnarIntType(fRowGroupIn.getColTypes()[func->fInputColumnIndex]) == 0 ||
+            fRowGroupIn.getColumnWidth(func->fInputColumnIndex) > 8)
+          return false;
+
+        cols.push_back(func->fInputColumnIndex);
+        break;
+
+      default: return false;
+    }
+  }
+
+  sort(cols.begin(), cols.end());
+  cols.erase(unique(cols.begin(), cols.end()), cols.end());
+
+  ColumnarRGData& columns = fColumnarData;
+  columns.fromRows(*pRows, &cols);
+  const uint64_t rowCount = columns.getRowCount();
+
+  if (rowCount == 0)
+    return true;
+
+  for (const auto& func : fFunctionCols)
+  {
+    uint32_t colIn = func->fInputColumnIndex;
+    uint32_t colOut = func->fOutputColumnIndex;
+
+    switch (func->fAggFunction)
+    {
+      case ROWAGG_COUNT_ASTERISK: fRow.setUintField<8>(fRow.getUintField<8>(colOut) + rowCount, colOut); break;
+
+      case ROWAGG_COUNT_COL_NAME:
+        fRow.setUintField<8>(fRow.getUintField<8>(colOut) + rowCount - columns.getNullCount(colIn), colOut);
+        break;
+
+      case ROWAGG_MIN:
+      case ROWAGG_MAX:
+      {
+        if (columnarIntType(columns.getColType(colIn)) < 0)
+        {
+          int64_t minVal, maxVal;
+
+          if (columnMinMax<int64_t, int8_t, int16_t, int32_t, int64_t>(columns, colIn, minVal, maxVal))
+            updateIntMinMax(func->fAggFunction == ROWAGG_MIN ? minVal : maxVal, fRow.getIntField(colOut),
+                            colOut, func->fAggFunction);
+        }
+        else
+        {
+          uint64_t minVal, maxVal;
+
+          if (columnMinMax<uint64_t, uint8_t, uint16_t, uint32_t, uint64_t>(columns, colIn, minVal, maxVal))
+            updateUintMinMax(func->fAggFunction == ROWAGG_MIN ? minVal : maxVal, fRow.getUintField(colOut),
+                             colOut, func->fAggFunction);
+        }
+
+        break;
+      }
+
+      default: break;
+    }
+  }
+
+  return true;
+}
+
 void RowAggregation::addRowGroup(const RowGroup* pRows, vector<std::pair<Row::Pointer, uint64_t>>& inRows)
 {
   // this function is for threaded aggregation, which is for group by and distinct.
@@ -3244,12 +3414,7 @@ void RowAggregationUM::fixDuplicates(RowAggFunctionType funct)
 void RowAggregationUM::evaluateExpression()
 {
   funcexp::FuncExp* fe = funcexp::FuncExp::instance();
-  fRowGroupOut->getRow(0, &fRow);
-
-  for (uint64_t i = 0; i < fRowGroupOut->getRowCount(); i++, fRow.nextRow())
-  {
-    fe->evaluate(fRow, fExpression);
-  }
+  fe->evaluate(*fRowGroupOut, fExpression);
 }
 
 //------------------------------------------------------------------------------
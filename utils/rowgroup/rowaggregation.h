@@ -42,6 +42,7 @@
 #include "serializeable.h"
 #include "bytestream.h"
 #include "rowgroup.h"
+#include "columnar.h"
 #include "hasher.h"
 #include "stlpoolallocator.h"
 #include "returnedcolumn.h"
@@ -515,6 +516,12 @@ class RowAggregation : public messageqcpp::Serializeable
     return &fRGContextColl;
   }
 
+  /** @brief the number of groups aggregated since the last aggReset() */
+  uint64_t getGroupCount() const
+  {
+    return fRowAggStorage ? fRowAggStorage->getGroupCount() : 0;
+  }
+
   void finalAggregation()
   {
     return fRowAggStorage->finalize([this](Row& row) { mergeEntries(row); }, fRow);
@@ -545,6 +552,7 @@ class RowAggregation : public messageqcpp::Serializeable
     fRow.setUintField<8>(fRow.getUintField<8>(0) + pRG->getRowCount(), 0);
     return true;
   }
+  virtual bool aggregateColumns(const RowGroup* pRG);
 
   void resetUDAF(RowUDAFFunctionCol* rowUDAF);
   void resetUDAF(RowUDAFFunctionCol* rowUDAF, uint64_t funcColIdx);
@@ -625,6 +633,10 @@ class RowAggregation : public messageqcpp::Serializeable
   joblist::ResourceManager* fRm = nullptr;
   boost::shared_ptr<int64_t> fSessionMemLimit;
   std::unique_ptr<RGData> fCurRGData;
+
+  // the input columns of aggregateColumns() and their copy, kept across RowGroups
+  std::vector<uint32_t> fColumnarCols;
+  ColumnarRGData fColumnarData;
 };
 
 //------------------------------------------------------------------------------
@@ -832,6 +844,10 @@ class RowAggregationUMP2 : public RowAggregationUM
   {
     return false;
   }
+  bool aggregateColumns(const RowGroup* pRG) override
+  {
+    return false;
+  }
 };
 
 //------------------------------------------------------------------------------
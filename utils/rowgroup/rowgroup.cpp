@@ -155,7 +155,7 @@ uint64_t StringStore::storeString(const uint8_t* data, uint32_t len)
   return ret;
 }
 
-void StringStore::serialize(ByteStream& bs) const
+void StringStore::serialize(ByteStream& bs, bool byRef) const
 {
   uint64_t i;
   MemChunk* mc;
@@ -168,7 +168,12 @@ void StringStore::serialize(ByteStream& bs) const
     mc = (MemChunk*)mem[i].get();
     bs << (uint64_t)mc->currentSize;
     // cout << "serialized " << mc->currentSize << " bytes\n";
-    bs.append(mc->data, mc->currentSize);
+
+    // the reader gets room for the header and keeps the chunk
+    if (byRef)
+      bs.attach(mem[i], mc->currentSize, sizeof(MemChunk));
+    else
+      bs.append(mc->data, mc->currentSize);
   }
 
   bs.setLongStrings(longStrings);
@@ -193,6 +198,22 @@ void StringStore::deserialize(ByteStream& bs)
   {
     bs >> size;
     // cout << "deserializing " << size << " bytes\n";
+    uint32_t attachedLen = 0;
+    shared_array<uint8_t> attached = bs.takeAttachment(attachedLen);
+
+    if (attached)
+    {
+      if (attachedLen != size)
+        throw logic_error("StringStore::deserialize(): bad attachment");
+
+      // full, new strings go to a new chunk
+      mem[i] = attached;
+      mc = (MemChunk*)mem[i].get();
+      mc->currentSize = size;
+      mc->capacity = size;
+      continue;
+    }
+
     buf = bs.buf();
     mem[i].reset(new uint8_t[size + sizeof(MemChunk)]);
     mc = (MemChunk*)mem[i].get();
@@ -396,17 +417,21 @@ RGData::~RGData()
   // cout << "rgdata-- = " << __sync_sub_and_fetch(&rgDataCount, 1) << endl;
 }
 
-void RGData::serialize(ByteStream& bs, uint32_t amount) const
+void RGData::serialize(ByteStream& bs, uint32_t amount, bool byRef, const ByteStream::RowLayout& rowLayout) const
 {
   // cout << "serializing!\n";
   bs << (uint32_t)RGDATA_SIG;
   bs << (uint32_t)amount;
-  bs.append(rowData.get(), amount);
+
+  if (byRef)
+    bs.attach(rowData, amount, 0, rowLayout);
+  else
+    bs.append(rowData.get(), amount);
 
   if (strings)
   {
     bs << (uint8_t)1;
-    strings->serialize(bs);
+    strings->serialize(bs, byRef);
   }
   else
     bs << (uint8_t)0;
@@ -432,10 +457,29 @@ void RGData::deserialize(ByteStream& bs, uint32_t defAmount)
   {
     bs >> sig;
     bs >> amount;
-    rowData.reset(new uint8_t[std::max(amount, defAmount)]);
-    buf = bs.buf();
-    memcpy(rowData.get(), buf, amount);
-    bs.advance(amount);
+    uint32_t attachedLen = 0;
+    shared_array<uint8_t> attached = bs.takeAttachment(attachedLen);
+
+    if (attached && attachedLen != amount)
+      throw logic_error("RGData::deserialize(): bad row data attachment");
+
+    // keep the buffer the socket read into if it's big enough
+    if (attached && defAmount <= amount)
+      rowData = attached;
+    else
+    {
+      rowData.reset(new uint8_t[std::max(amount, defAmount)]);
+
+      if (attached)
+        memcpy(rowData.get(), attached.get(), amount);
+      else
+      {
+        buf = bs.buf();
+        memcpy(rowData.get(), buf, amount);
+        bs.advance(amount);
+      }
+    }
+
     bs >> tmp8;
 
     if (tmp8)
@@ -1271,11 +1315,23 @@ void RowGroup::deserialize(ByteStream& bs)
   charsets.insert(charsets.begin(), charsetNumbers.size(), NULL);
 }
 
-void RowGroup::serializeRGData(ByteStream& bs) const
+void RowGroup::serializeRGData(ByteStream& bs, bool byRef) const
 {
   // cout << "****** serializing\n" << toString() << en
   //	if (useStringTable || !hasLongStringField)
-  rgData->serialize(bs, getDataSize());
+  if (!byRef)
+  {
+    rgData->serialize(bs, getDataSize());
+    return;
+  }
+
+  // the header, then the rows from byte 0, the 2 byte rid is the first column
+  boost::shared_ptr<vector<uint32_t>> rowLayout(new vector<uint32_t>());
+  rowLayout->reserve(columnCount + 3);
+  rowLayout->push_back(getHeaderSize());
+  rowLayout->push_back(0);
+  rowLayout->insert(rowLayout->end(), offsets, offsets + columnCount + 1);
+  rgData->serialize(bs, getDataSize(), true, rowLayout);
   //	else {
   //		uint64_t size;
   //		RGData *compressed = convertToStringTable(&size);
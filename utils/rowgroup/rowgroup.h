@@ -146,7 +146,8 @@ class StringStore
 
   void clear();
 
-  void serialize(messageqcpp::ByteStream&) const;
+  // byRef attaches the chunks to the stream instead of copying them
+  void serialize(messageqcpp::ByteStream&, bool byRef = false) const;
   void deserialize(messageqcpp::ByteStream&);
 
   //@bug6065, make StringStore::storeString() thread safe
@@ -257,7 +258,11 @@ class RGData
   inline RGData& operator=(const RGData&);
 
   // amount should be the # returned by RowGroup::getDataSize()
-  void serialize(messageqcpp::ByteStream&, uint32_t amount) const;
+  // byRef attaches the row data and the strings to the stream instead of copying them,
+  // see ByteStream::attach().  deserialize() keeps the attached buffers.  rowLayout goes
+  // with the row data for the compressed sockets.
+  void serialize(messageqcpp::ByteStream&, uint32_t amount, bool byRef = false,
+                 const messageqcpp::ByteStream::RowLayout& rowLayout = messageqcpp::ByteStream::RowLayout()) const;
 
   // the 'hasLengthField' is there b/c PM aggregation (and possibly others) currently sends
   // inline data with a length field.  Once that's converted to string table format, that
@@ -1481,7 +1486,7 @@ class RowGroup : public messageqcpp::Serializeable
   //	RGData *convertToInlineData(uint64_t *size = NULL) const;  // caller manages the memory returned by
   // this 	void convertToInlineDataInPlace(); 	RGData *convertToStringTable(uint64_t *size = NULL)
   // const; void convertToStringTableInPlace();
-  void serializeRGData(messageqcpp::ByteStream&) const;
+  void serializeRGData(messageqcpp::ByteStream&, bool byRef = false) const;
   inline uint32_t getStringTableThreshold() const;
 
   void append(RGData&);
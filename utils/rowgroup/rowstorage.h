@@ -83,6 +83,13 @@ class RowAggStorage
    */
   void dump();
 
+  /** @brief The number of groups in the current generation.
+   */
+  size_t getGroupCount() const
+  {
+    return fCurData ? fCurData->fSize : 0;
+  }
+
   /** @brief Append RGData from other RowAggStorage and clear it.
    *
    *    NB! Any operation except getNextRGData() or append() is UB!
@@ -3801,6 +3801,48 @@ void DBRM::lockLBIDRange(LBID_t start, uint32_t count)
   }
 }
 
+bool DBRM::tryLockLBIDRange(LBID_t start, uint32_t count)
+{
+  bool locked = false, lockedRange = false;
+  LBIDRange range;
+
+  range.start = start;
+  range.size = count;
+
+  try
+  {
+    copylocks->lock(CopyLocks::WRITE);
+    locked = true;
+
+    if (copylocks->isLocked(range))
+    {
+      copylocks->release(CopyLocks::WRITE);
+      return false;
+    }
+
+    copylocks->lockRange(range, -1);
+    lockedRange = true;
+    copylocks->confirmChanges();
+    copylocks->release(CopyLocks::WRITE);
+    locked = false;
+  }
+  catch (...)
+  {
+    if (lockedRange)
+      copylocks->releaseRange(range);
+
+    if (locked)
+    {
+      copylocks->confirmChanges();
+      copylocks->release(CopyLocks::WRITE);
+    }
+
+    throw;
+  }
+
+  return true;
+}
+
 void DBRM::releaseLBIDRange(LBID_t start, uint32_t count)
 {
   bool locked = false;
@@ -815,6 +815,8 @@ class DBRM
 
   /* read-side interface for locking LBID ranges (used by PrimProc) */
   EXPORT void lockLBIDRange(LBID_t start, uint32_t count);
+  /* lockLBIDRange() that returns false instead of waiting for the range */
+  EXPORT bool tryLockLBIDRange(LBID_t start, uint32_t count);
   EXPORT void releaseLBIDRange(LBID_t start, uint32_t count);
 
   /* write-side interface for locking LBID ranges (used by DML) */
@@ -0,0 +1,360 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cmath>
+#include <sstream>
+#include <boost/scoped_ptr.hpp>
+#include <boost/scoped_array.hpp>
+
+#include "configcpp.h"
+#include "hasher.h"
+#include "IDBDataFile.h"
+#include "IDBPolicy.h"
+#include "extentmap.h"
+#include "extentfilter.h"
+
+using namespace std;
+using namespace messageqcpp;
+using namespace idbdatafile;
+
+namespace
+{
+const uint32_t EF_MAGIC = 0x45465631;  // "EFV1"
+}
+
+namespace BRM
+{
+constexpr uint32_t ExtentFilter::salt[];
+
+ExtentFilter::ExtentFilter()
+ : startLbid(0)
+ , partitionNum(0)
+ , segmentNum(0)
+ , seqNum(0)
+ , loVal(0)
+ , hiVal(0)
+ , fBlockMask(0)
+ , fRegisters(HLL_REGISTERS, 0)
+{
+}
+
+ExtentFilter::ExtentFilter(uint32_t maxBytes) : ExtentFilter()
+{
+  const uint32_t blockBytes = BLOCK_WORDS * sizeof(uint32_t);
+  uint32_t blocks = 1;
+
+  while (blocks * 2 * blockBytes <= maxBytes)
+    blocks <<= 1;
+
+  fBlockMask = blocks - 1;
+  fBlocks.resize(blocks * BLOCK_WORDS, 0);
+}
+
+uint64_t ExtentFilter::hashOf(int64_t value)
+{
+  return utils::fmix((uint64_t)value);
+}
+
+void ExtentFilter::add(int64_t value)
+{
+  uint64_t hash = hashOf(value);
+
+  // the top bits pick the register, the rank is the position of the first 1 in the rest
+  uint8_t& reg = fRegisters[hash >> (64 - HLL_BITS)];
+  uint8_t rank = __builtin_clzll((hash << HLL_BITS) | (1ULL << (HLL_BITS - 1))) + 1;
+
+  if (rank > reg)
+    reg = rank;
+
+  if (fBlocks.empty())
+    return;
+
+  uint32_t* block = &fBlocks[((hash >> 32) & fBlockMask) * BLOCK_WORDS];
+
+  for (uint32_t i = 0; i < BLOCK_WORDS; i++)
+    block[i] |= 1U << (((uint32_t)hash * salt[i]) >> 27);
+}
+
+uint64_t ExtentFilter::estimateDistinct() const
+{
+  const double m = HLL_REGISTERS;
+  double sum = 0;
+  uint32_t zeros = 0;
+
+  for (uint8_t reg : fRegisters)
+  {
+    sum += std::ldexp(1.0, -reg);
+    zeros += (reg == 0);
+  }
+
+  double estimate = (0.7213 / (1 + 1.079 / m)) * m * m / sum;
+
+  // linear counting is more accurate while a lot of registers are unused
+  if (estimate <= 2.5 * m && zeros > 0)
+    estimate = m * std::log(m / zeros);
+
+  return llround(estimate);
+}
+
+void ExtentFilter::finish()
+{
+  if (fBlocks.empty())
+    return;
+
+  const uint64_t wantBits = max<uint64_t>(estimateDistinct() * BITS_PER_KEY, BLOCK_WORDS * 32);
+  uint64_t blocks = fBlockMask + 1;
+
+  // A filter with a lot fewer bits than it needs lets every lookup through
+  if (blocks * BLOCK_WORDS * 32 * 4 < wantBits)
+  {
+    fBlocks.clear();
+    fBlocks.shrink_to_fit();
+    fBlockMask = 0;
+    return;
+  }
+
+  // A block index is the hash masked by fBlockMask, halving the mask maps
+  // block i + blocks / 2 onto block i, so the upper half is OR'ed into the lower one
+  while (blocks > 1 && (blocks / 2) * BLOCK_WORDS * 32 >= wantBits)
+  {
+    blocks /= 2;
+
+    for (uint64_t i = 0; i < blocks * BLOCK_WORDS; i++)
+      fBlocks[i] |= fBlocks[i + blocks * BLOCK_WORDS];
+  }
+
+  fBlockMask = blocks - 1;
+  fBlocks.resize(blocks * BLOCK_WORDS);
+  fBlocks.shrink_to_fit();
+}
+
+void ExtentFilter::setSeqNumAfterUpdate(int32_t current)
+{
+  // the same as every extent map CP update does
+  seqNum = (current + 1 > EM_MAX_SEQNUM ? 0 : current + 1);
+}
+
+bool ExtentFilter::isCurrent(const EMEntry& extent) const
+{
+  const EMCasualPartition_t& cp = extent.partition.cprange;
+
+  return (extent.range.start == startLbid && extent.partitionNum == partitionNum &&
+          extent.segmentNum == segmentNum && cp.isValid == CP_VALID && cp.sequenceNum == seqNum &&
+          cp.loVal == loVal && cp.hiVal == hiVal);
+}
+
+void ExtentFilter::serialize(ByteStream& bs) const
+{
+  bs << (uint64_t)startLbid;
+  bs << partitionNum;
+  bs << segmentNum;
+  bs << (uint32_t)seqNum;
+  bs << (uint64_t)loVal;
+  bs << (uint64_t)hiVal;
+  bs << (uint64_t)fBlockMask;
+  serializeInlineVector<uint32_t>(bs, fBlocks);
+  serializeInlineVector<uint8_t>(bs, fRegisters);
+}
+
+void ExtentFilter::deserialize(ByteStream& bs)
+{
+  uint64_t tmp64;
+  uint32_t tmp32;
+
+  bs >> tmp64;
+  startLbid = (LBID_t)tmp64;
+  bs >> partitionNum;
+  bs >> segmentNum;
+  bs >> tmp32;
+  seqNum = (int32_t)tmp32;
+  bs >> tmp64;
+  loVal = (int64_t)tmp64;
+  bs >> tmp64;
+  hiVal = (int64_t)tmp64;
+  bs >> tmp64;
+  fBlockMask = tmp64;
+  deserializeInlineVector<uint32_t>(bs, fBlocks);
+  deserializeInlineVector<uint8_t>(bs, fRegisters);
+}
+
+string ExtentFilter::toString() const
+{
+  ostringstream os;
+
+  os << "ExtentFilter: lbid " << startLbid << ", seq " << seqNum << ", ~" << estimateDistinct()
+     << " distinct values";
+
+  if (hasBloomFilter())
+    os << ", " << getSize() << " byte Bloom filter";
+
+  return os.str();
+}
+
+string ExtentFilterStore::directory()
+{
+  // DBRMRoot is the prefix of the BRM save files, the filters go in a directory beside them
+  string prefix = config::Config::makeConfig()->getConfig("SystemConfig", "DBRMRoot");
+  string::size_type pos = prefix.rfind('/');
+
+  return (pos == string::npos ? string(".") : prefix.substr(0, pos)) + "/extentfilters";
+}
+
+string ExtentFilterStore::fileName(OID_t oid, uint16_t dbRoot)
+{
+  ostringstream os;
+
+  os << directory() << "/" << oid << "." << dbRoot;
+  return os.str();
+}
+
+bool ExtentFilterStore::read(const string& fileName, vector<ExtentFilter>& filters)
+{
+  const char* filename_p = fileName.c_str();
+
+  if (!IDBPolicy::exists(filename_p))
+    return false;
+
+  boost::scoped_ptr<IDBDataFile> in(
+      IDBDataFile::open(IDBPolicy::getType(filename_p, IDBPolicy::WRITEENG), filename_p, "r", 0));
+
+  if (!in)
+    return false;
+
+  off64_t size = in->size();
+
+  if (size < (off64_t)(2 * sizeof(uint32_t)))
+    return false;
+
+  boost::scoped_array<uint8_t> buf(new uint8_t[size]);
+
+  if (in->read(buf.get(), size) != size)
+    return false;
+
+  ByteStream bs;
+  uint32_t magic, count;
+
+  bs.load(buf.get(), size);
+  bs >> magic;
+
+  if (magic != EF_MAGIC)
+    return false;
+
+  try
+  {
+    bs >> count;
+    filters.resize(count);
+
+    for (uint32_t i = 0; i < count; i++)
+      filters[i].deserialize(bs);
+  }
+  catch (exception&)
+  {
+    // a truncated file
+    filters.clear();
+    return false;
+  }
+
+  return true;
+}
+
+void ExtentFilterStore::load(OID_t oid, const vector<uint16_t>& dbRoots, FilterMap& filters)
+{
+  vector<ExtentFilter> stored;
+
+  for (uint16_t dbRoot : dbRoots)
+  {
+    stored.clear();
+
+    if (!read(fileName(oid, dbRoot), stored))
+      continue;
+
+    for (ExtentFilter& filter : stored)
+      filters[filter.startLbid] = filter;
+  }
+}
+
+int ExtentFilterStore::save(OID_t oid, uint16_t dbRoot, const vector<ExtentFilter>& filters,
+                            const vector<EMEntry>& extents)
+{
+  const string dir = directory();
+  const string name = fileName(oid, dbRoot);
+  const string tmpName = name + ".tmp";
+  vector<ExtentFilter> stored;
+  FilterMap merged;
+
+  if (!IDBPolicy::exists(dir.c_str()) && IDBPolicy::mkdir(dir.c_str()) != 0)
+    return -1;
+
+  read(name, stored);
+
+  // drop the filters of extents that were deleted, truncated or changed since
+  std::tr1::unordered_map<LBID_t, const EMEntry*> live;
+
+  for (const EMEntry& extent : extents)
+    live[extent.range.start] = &extent;
+
+  for (const ExtentFilter& filter : stored)
+  {
+    std::tr1::unordered_map<LBID_t, const EMEntry*>::const_iterator it = live.find(filter.startLbid);
+
+    if (it != live.end() && filter.isCurrent(*it->second))
+      merged[filter.startLbid] = filter;
+  }
+
+  for (const ExtentFilter& filter : filters)
+    merged[filter.startLbid] = filter;
+
+  ByteStream bs;
+
+  bs << EF_MAGIC;
+  bs << (uint32_t)merged.size();
+
+  for (FilterMap::const_iterator it = merged.begin(); it != merged.end(); ++it)
+    it->second.serialize(bs);
+
+  // write a new file and rename it, a query never sees a partly written one
+  {
+    boost::scoped_ptr<IDBDataFile> out(IDBDataFile::open(IDBPolicy::getType(tmpName, IDBPolicy::WRITEENG),
+                                                         tmpName.c_str(), "wb", IDBDataFile::USE_VBUF));
+
+    if (!out || out->write(bs.buf(), bs.length()) != (ssize_t)bs.length())
+    {
+      IDBPolicy::remove(tmpName.c_str());
+      return -1;
+    }
+  }
+
+  return IDBPolicy::rename(tmpName.c_str(), name.c_str());
+}
+
+void ExtentFilterStore::remove(OID_t oid)
+{
+  const string dir = directory();
+  list<string> files;
+  ostringstream prefix;
+
+  prefix << oid << ".";
+
+  if (IDBPolicy::listDirectory(dir.c_str(), files) != 0)
+    return;
+
+  for (const string& file : files)
+    if (file.compare(0, prefix.str().length(), prefix.str()) == 0)
+      IDBPolicy::remove((dir + "/" + file).c_str());
+}
+
+}  // namespace BRM
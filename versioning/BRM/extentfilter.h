@@ -0,0 +1,165 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file
+ * Per extent Bloom filters and distinct value sketches, kept beside the
+ * casual partitioning min/max of the extent map.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <tr1/unordered_map>
+
+#include "brmtypes.h"
+#include "bytestream.h"
+
+#define EXPORT
+
+namespace BRM
+{
+/** @brief A Bloom filter and a HyperLogLog sketch of the values of an extent
+ *
+ * cpimport builds one for every new extent of an integer column, so that an
+ * equality or IN predicate can skip the extents whose min/max covers the value
+ * but that don't hold it.  The values are the int64s the casual partitioning
+ * min/max is kept in.
+ *
+ * A filter describes the extent as it was when the casual partitioning info
+ * reached seqNum.  Every later change to the extent, DML or another import,
+ * changes the sequence number, so a filter that doesn't match the extent map
+ * is out of date and is ignored.
+ */
+class ExtentFilter
+{
+ public:
+  EXPORT ExtentFilter();
+
+  /** @param maxBytes the size of the Bloom filter while the values are added,
+   *         finish() folds it down to what the distinct values need
+   */
+  EXPORT explicit ExtentFilter(uint32_t maxBytes);
+
+  EXPORT void add(int64_t value);
+
+  /** @brief Shrink the Bloom filter to the size the distinct count calls for.
+   *  It is dropped if even maxBytes is too small for it to filter anything.
+   */
+  EXPORT void finish();
+
+  /** @brief False if no value of the extent equals value */
+  inline bool mayContain(int64_t value) const
+  {
+    if (fBlocks.empty())
+      return true;
+
+    uint64_t hash = hashOf(value);
+    const uint32_t* block = &fBlocks[((hash >> 32) & fBlockMask) * BLOCK_WORDS];
+
+    for (uint32_t i = 0; i < BLOCK_WORDS; i++)
+      if (!(block[i] & (1U << (((uint32_t)hash * salt[i]) >> 27))))
+        return false;
+
+    return true;
+  }
+
+  /** @brief The HyperLogLog estimate of the number of distinct values */
+  EXPORT uint64_t estimateDistinct() const;
+
+  bool hasBloomFilter() const
+  {
+    return !fBlocks.empty();
+  }
+  uint64_t getSize() const
+  {
+    return fBlocks.size() * sizeof(uint32_t);
+  }
+
+  /** @brief Set seqNum to the sequence number the extent gets when its CP
+   *  info, now at seqNum current, is next updated
+   */
+  EXPORT void setSeqNumAfterUpdate(int32_t current);
+
+  /** @brief Whether the filter was built for the extent as it is now */
+  EXPORT bool isCurrent(const EMEntry& extent) const;
+
+  EXPORT void serialize(messageqcpp::ByteStream& bs) const;
+  EXPORT void deserialize(messageqcpp::ByteStream& bs);
+
+  EXPORT std::string toString() const;
+
+  // the extent and the casual partitioning state the filter was built for
+  LBID_t startLbid;
+  uint32_t partitionNum;
+  uint16_t segmentNum;
+  int32_t seqNum;
+  int64_t loVal;
+  int64_t hiVal;
+
+ private:
+  static constexpr uint32_t BLOCK_WORDS = 8;
+  static constexpr uint32_t BITS_PER_KEY = 10;  // ~1% false positives
+  static constexpr uint32_t salt[BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+  static constexpr uint32_t HLL_BITS = 8;
+  static constexpr uint32_t HLL_REGISTERS = 1 << HLL_BITS;
+
+  static uint64_t hashOf(int64_t value);
+
+  uint64_t fBlockMask;              // the block count - 1, the count is a power of 2
+  std::vector<uint32_t> fBlocks;    // empty if there's no Bloom filter
+  std::vector<uint8_t> fRegisters;  // the HyperLogLog registers
+};
+
+/** @brief Reads and writes the extent filters of a column
+ *
+ * The filters are stored next to the BRM save files, one file for every
+ * column OID and DBRoot, so the cpimports on different PMs never write the
+ * same file.
+ */
+class ExtentFilterStore
+{
+ public:
+  typedef std::tr1::unordered_map<LBID_t, ExtentFilter> FilterMap;
+
+  /** @brief Add the filters of the column on these DBRoots to filters, keyed
+   *  by the first LBID of the extent.  Missing or unreadable files are skipped.
+   */
+  EXPORT static void load(OID_t oid, const std::vector<uint16_t>& dbRoots, FilterMap& filters);
+
+  /** @brief Store filters for the column on dbRoot, replacing the stored ones
+   *  of the same extents.  The stored filters of extents that aren't in
+   *  extents, the column's live extents on dbRoot, or that they no longer
+   *  match are dropped.  Returns 0 on success.
+   */
+  EXPORT static int save(OID_t oid, uint16_t dbRoot, const std::vector<ExtentFilter>& filters,
+                         const std::vector<EMEntry>& extents);
+
+  /** @brief Drop every filter of the column */
+  EXPORT static void remove(OID_t oid);
+
+ private:
+  static std::string directory();
+  static std::string fileName(OID_t oid, uint16_t dbRoot);
+  static bool read(const std::string& fileName, std::vector<ExtentFilter>& filters);
+};
+
+}  // namespace BRM
+
+#undef EXPORT
@@ -111,6 +111,9 @@ const char CP_INVALID = 0;
 const char CP_UPDATING = 1;
 const char CP_VALID = 2;
 
+// CP sequence numbers wrap to 0 past this
+#define EM_MAX_SEQNUM 2000000000
+
 struct EMCasualPartition_struct_v4
 {
   RangePartitionData_t hi_val;  // This needs to be reinterpreted as unsigned for uint64_t column types.
@@ -85,6 +85,24 @@ inline void resizeRowDataArray(char** pRowData, unsigned int dataLength, unsigne
   *pRowData = tmpRaw;
 }
 
+//------------------------------------------------------------------------------
+// The int64 a converted column value is kept as in the CP min/max and the
+// extent filters
+//------------------------------------------------------------------------------
+inline int64_t extentFilterValue(const unsigned char* val, int width, bool bIsUnsigned)
+{
+  switch (width)
+  {
+    case 1: return (bIsUnsigned ? (int64_t) * (uint8_t*)val : (int64_t) * (int8_t*)val);
+
+    case 2: return (bIsUnsigned ? (int64_t) * (uint16_t*)val : (int64_t) * (int16_t*)val);
+
+    case 4: return (bIsUnsigned ? (int64_t) * (uint32_t*)val : (int64_t) * (int32_t*)val);
+
+    default: return *(int64_t*)val;
+  }
+}
+
 }  // namespace
 
 //#define DEBUG_TOKEN_PARSING 1
@@ -1622,6 +1640,14 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
     BLBufferStats bufStats(columnInfo.column.dataType);
     bool updateCPInfoPendingFlag = false;
 
+    // Values of the current extent, for its extent filter
+    const bool buildFilter = columnInfo.buildsExtentFilter();
+    const bool bIsUnsigned = isUnsigned(columnInfo.column.dataType);
+    std::vector<int64_t> filterValues;
+
+    if (buildFilter)
+      filterValues.reserve(fTotalReadRowsParser);
+
     int tokenLength = 0;
     bool tokenNullFlag = false;
 
@@ -1648,6 +1674,10 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
               bufStats);
       updateCPInfoPendingFlag = true;
 
+      if (buildFilter)
+        filterValues.push_back(
+            extentFilterValue(buf + i * columnInfo.column.width, columnInfo.column.width, bIsUnsigned));
+
       // Update CP min/max if this is last row in this extent
       if ((fStartRowParser + i) == lastInputRowInExtent)
       {
@@ -1662,6 +1692,12 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
                                   columnInfo.column.dataType, columnInfo.column.width);
         }
 
+        if (buildFilter)
+        {
+          columnInfo.updateExtentFilter(lastInputRowInExtent, filterValues);
+          filterValues.clear();
+        }
+
         // TODO MCOL-641 Add support here.
         if (fLog->isDebug(DEBUG_2))
         {
@@ -1719,6 +1755,9 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
         columnInfo.updateCPInfo(lastInputRowInExtent, bufStats.bigMinBufferVal, bufStats.bigMaxBufferVal,
                                 columnInfo.column.dataType, columnInfo.column.width);
       }
+
+      if (buildFilter)
+        columnInfo.updateExtentFilter(lastInputRowInExtent, filterValues);
     }
 
     if (bufStats.satCount)  // @bug 3504: increment row saturation count
@@ -373,7 +373,8 @@ int ColumnBufferCompressed::compressAndFlush(bool bFinishingFile)
 #endif
 
   int rc = compressor->compressBlock(reinterpret_cast<char*>(fToBeCompressedBuffer), fToBeCompressedCapacity,
-                                     compressedOutBuf, outputLen);
+                                     compressedOutBuf, outputLen,
+                                     Config::getChunkEncoding() ? fColInfo->column.width : 0);
 
   if (rc != 0)
   {
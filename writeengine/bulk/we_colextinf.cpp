@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <map>
 
 #include "we_define.h"
 #include "we_brm.h"
@@ -77,6 +78,12 @@ void ColExtInf::addOrUpdateEntryTemplate(RID lastInputRow, T minVal, T maxVal, C
   if (iter == fMap.end())  // Add entry
   {
     ColExtInfEntry entry(minVal, maxVal);
+
+    // Only the extents this import allocates get a filter, the others may
+    // already hold values the filter wouldn't know about.
+    if (fFilterBytes > 0)
+      entry.fFilter.reset(new BRM::ExtentFilter(fFilterBytes));
+
     fMap[lastInputRow] = entry;
 
     fPendingExtentRows.insert(lastInputRow);
@@ -146,6 +153,22 @@ void ColExtInf::addOrUpdateEntryTemplate(RID lastInputRow, T minVal, T maxVal, C
   }
 }
 
+//------------------------------------------------------------------------------
+// Add the values of a Read buffer to the filter of the extent they go into.
+//------------------------------------------------------------------------------
+void ColExtInf::addFilterValues(RID lastInputRow, const std::vector<int64_t>& values)
+{
+  boost::mutex::scoped_lock lock(fMapMutex);
+
+  RowExtMap::iterator iter = fMap.find(lastInputRow);
+
+  if (iter == fMap.end() || !iter->second.fFilter)
+    return;
+
+  for (int64_t value : values)
+    iter->second.fFilter->add(value);
+}
+
 //------------------------------------------------------------------------------
 // After flushing an output buffer and allocating it's extent, this function is
 // called to save the starting LBID back into the corresponding extent entry.
@@ -272,9 +295,75 @@ void ColExtInf::getCPInfoForBRM(JobColumn column, BRMReporter& brmReporter)
     ++iter;
   }
 
+  if (fFilterBytes > 0)
+    saveExtentFilters(column);
+
   fMap.clear();  // don't need map anymore, so release memory
 }
 
+//------------------------------------------------------------------------------
+// Save the filters of the new extents.  A filter is stamped with the CP
+// sequence number the extent will have once the CP update above is merged
+// into the extent map; the table lock keeps anything else from changing it
+// before then.  Expects fMapMutex to be locked.
+//------------------------------------------------------------------------------
+void ColExtInf::saveExtentFilters(const JobColumn& column)
+{
+  std::map<uint16_t, std::vector<BRM::ExtentFilter> > filtersByRoot;
+
+  for (RowExtMap::iterator iter = fMap.begin(); iter != fMap.end(); ++iter)
+  {
+    ColExtInfEntry& entry = iter->second;
+    BRM::CPMaxMin cpMaxMin;
+    uint16_t dbRoot, segment;
+    uint32_t partition;
+    int fbo;
+
+    // min > max if the extent got only NULLs, the CP range isn't set then
+    if (!entry.fFilter || entry.fLbid == (BRM::LBID_t)INVALID_LBID ||
+        (isUnsigned(column.dataType) ? static_cast<uint64_t>(entry.fMinVal) > static_cast<uint64_t>(entry.fMaxVal)
+                                     : entry.fMinVal > entry.fMaxVal))
+      continue;
+
+    if (BRMWrapper::getInstance()->getExtentCPMaxMin(entry.fLbid, cpMaxMin) != NO_ERROR ||
+        BRMWrapper::getInstance()->getFboOffset(entry.fLbid, dbRoot, partition, segment, fbo) != NO_ERROR)
+      continue;
+
+    BRM::ExtentFilter& filter = *entry.fFilter;
+
+    filter.finish();
+    filter.startLbid = entry.fLbid;
+    filter.partitionNum = partition;
+    filter.segmentNum = segment;
+    filter.setSeqNumAfterUpdate(cpMaxMin.seqNum);
+    filter.loVal = entry.fMinVal;
+    filter.hiVal = entry.fMaxVal;
+    filtersByRoot[dbRoot].push_back(filter);
+  }
+
+  for (std::map<uint16_t, std::vector<BRM::ExtentFilter> >::const_iterator it = filtersByRoot.begin();
+       it != filtersByRoot.end(); ++it)
+  {
+    std::vector<BRM::EMEntry> extents;
+
+    // the live extents, the stored filters of the others are dropped
+    if (BRMWrapper::getInstance()->getExtents_dbroot(fColOid, extents, it->first) != NO_ERROR ||
+        BRM::ExtentFilterStore::save(fColOid, it->first, it->second, extents) != 0)
+    {
+      std::ostringstream oss;
+      oss << "Unable to save the extent filters of OID-" << fColOid << "; DBRoot-" << it->first;
+      fLog->logMsg(oss.str(), MSGLVL_WARNING);
+    }
+    else
+    {
+      std::ostringstream oss;
+      oss << "Saved " << it->second.size() << " extent filters for OID-" << fColOid << "; DBRoot-"
+          << it->first;
+      fLog->logMsg(oss.str(), MSGLVL_INFO2);
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 // Print contents of this object to the log file.
 //------------------------------------------------------------------------------
@@ -31,9 +31,12 @@
 #include <stdint.h>
 #include <set>
 #include <tr1/unordered_map>
+#include <vector>
 #include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "brmtypes.h"
+#include "extentfilter.h"
 #include "we_type.h"
 #include "dataconvert.h"
 
@@ -103,6 +106,7 @@ class ColExtInfEntry
   int64_t fMinVal;    // minimum value for extent associated with LBID
   int64_t fMaxVal;    // maximum value for extent associated with LBID
   bool fNewExtent;    // is this a new extent
+  boost::shared_ptr<BRM::ExtentFilter> fFilter;  // values of a new extent
   union
   {
     int128_t fbigMinVal;
@@ -157,6 +161,15 @@ class ColExtInfBase
   {
   }
 
+  virtual bool buildsExtentFilter() const
+  {
+    return false;
+  }
+
+  virtual void addFilterValues(RID lastInputRow, const std::vector<int64_t>& values)
+  {
+  }
+
   virtual void getCPInfoForBRM(JobColumn column, BRMReporter& brmReporter)
   {
   }
@@ -188,8 +201,11 @@ class ColExtInf : public ColExtInfBase
  public:
   /** @brief Constructor
    *  @param logger Log object using for debug logging.
+   *  @param filterBytes Max size of the Bloom filter of a new extent; 0 if
+   *         no extent filters are built for this column.
    */
-  ColExtInf(OID oid, Log* logger) : fColOid(oid), fLog(logger)
+  ColExtInf(OID oid, Log* logger, uint32_t filterBytes = 0)
+   : fColOid(oid), fLog(logger), fFilterBytes(filterBytes)
   {
   }
   virtual ~ColExtInf()
@@ -225,7 +241,20 @@ class ColExtInf : public ColExtInfBase
     addOrUpdateEntryTemplate(lastInputRow, minVal, maxVal, colDataType, width);
   }
 
+  virtual bool buildsExtentFilter() const
+  {
+    return fFilterBytes > 0;
+  }
+
+  /** @brief Add the values of a parsed buffer to the filter of the extent
+   *         ending at lastInputRow.  Must follow the addOrUpdateEntry() call
+   *         for the same buffer.  Extents that held rows before the import
+   *         get no filter.
+   */
+  virtual void addFilterValues(RID lastInputRow, const std::vector<int64_t>& values);
+
   /** @brief Send updated Casual Partition (CP) info to BRM.
+   *         The extent filters are saved here as well.
    */
   virtual void getCPInfoForBRM(JobColumn column, BRMReporter& brmReporter);
 
@@ -242,6 +271,7 @@ class ColExtInf : public ColExtInfBase
  private:
   OID fColOid;                       // Column OID for the relevant extents
   Log* fLog;                         // Log used for debug logging
+  uint32_t fFilterBytes;             // Bloom filter size; 0 if none
   boost::mutex fMapMutex;            // protects unordered map access
   std::set<RID> fPendingExtentRows;  // list of lastInputRow entries that
   // are awaiting an LBID assignment.
@@ -249,6 +279,8 @@ class ColExtInf : public ColExtInfBase
   // unordered map where we collect the min/max values per extent
   std::tr1::unordered_map<RID, ColExtInfEntry, uint64Hasher> fMap;
 
+  void saveExtentFilters(const JobColumn& column);
+
   // disable copy constructor and assignment operator
   ColExtInf(const ColExtInf&);
   ColExtInf& operator=(const ColExtInf&);
@@ -202,6 +202,11 @@ ColumnInfo::ColumnInfo(Log* logger, int idIn, const JobColumn& columnIn, DBRootE
     case WriteEngine::WR_ULONGLONG:
     case WriteEngine::WR_UMEDINT:
     case WriteEngine::WR_UINT:
+    {
+      fColExtInf = new ColExtInf(column.mapOid, logger, Config::getExtentFilterMaxBytes());
+      break;
+    }
+
     case WriteEngine::WR_BINARY:
     default:
     {
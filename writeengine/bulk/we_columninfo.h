@@ -295,6 +295,14 @@ class ColumnInfo : public WeUIDGID
   template <typename T>
   void updateCPInfo(RID lastInputRow, T minVal, T maxVal, ColDataType colDataType, int width);
 
+  /** @brief Whether the values of new extents go into extent filters
+   */
+  bool buildsExtentFilter() const;
+
+  /** @brief Add parsed values to the filter of their extent
+   */
+  void updateExtentFilter(RID lastInputRow, const std::vector<int64_t>& values);
+
   /** @brief Setup initial extent we will begin loading at start of import.
    *  @param dbRoot    DBRoot of starting extent
    *  @param partition Partition number of starting extent
@@ -556,4 +564,14 @@ inline void ColumnInfo::updateCPInfo(RID lastInputRow, T minVal, T maxVal, ColDa
   fColExtInf->addOrUpdateEntry(lastInputRow, minVal, maxVal, colDataType, width);
 }
 
+inline bool ColumnInfo::buildsExtentFilter() const
+{
+  return fColExtInf->buildsExtentFilter();
+}
+
+inline void ColumnInfo::updateExtentFilter(RID lastInputRow, const std::vector<int64_t>& values)
+{
+  fColExtInf->addFilterValues(lastInputRow, values);
+}
+
 }  // namespace WriteEngine
@@ -78,7 +78,8 @@ int NUM_BLOCKS_PER_INITIAL_EXTENT = ((INITIAL_EXTENT_ROWS_TO_DISK / BYTE_PER_BLO
  * Dctnry constructor
  ******************************************************************************/
 Dctnry::Dctnry()
- : m_nextPtr(NOT_USED_PTR)
+ : m_indexLoaded(false)
+ , m_nextPtr(NOT_USED_PTR)
  , m_partition(0)
  , m_segment(0)
  , m_dbRoot(1)
@@ -136,6 +137,19 @@ void Dctnry::freeStringCache()
   m_sigArray.clear();
 }
 
+/*******************************************************************************
+ * Description:
+ * Load the string index of the current store file.  The index is only used
+ * if the file still ends where it did when the index was saved, so this has
+ * to be called before any string is added.
+ ******************************************************************************/
+void Dctnry::loadIndex()
+{
+  m_index.setMaxStrings(Config::getDictionaryIndexMaxStrings());
+  m_index.load(m_segFileName, m_curLbid, m_curOp, m_freeSpace);
+  m_indexLoaded = true;
+}
+
 /*******************************************************************************
  * Description:
  * Create a dictionary file and initialize the header
@@ -219,6 +233,11 @@ int Dctnry::createDctnry(const OID& dctnryOID, int colWidth, const uint16_t dbRo
     RETURN_ON_ERROR((rc = oid2FileName(m_dctnryOID, fileName, true, m_dbRoot, m_partition, m_segment)));
     m_segFileName = fileName;
 
+    // drop the index of an obsolete file
+    DctnryIndex::remove(m_segFileName);
+    m_index.clear();
+    m_indexLoaded = false;
+
     // if obsolete file exists, "w+b" will truncate and write over
     m_dFile = createDctnryFile(fileName, colWidth, "w+b", DEFAULT_BUFSIZ, startLbid);
 
@@ -418,6 +437,23 @@ int Dctnry::closeDctnry(bool realClose)
   if (rc != NO_ERROR)
     return rc;
 
+  // Save the index for the next bulk load, at the end of the store it covers.
+  // Failing to save it only costs the next load some dedups.
+  if (m_index.isDirty() && m_index.save(m_segFileName, m_curLbid, m_curOp, m_freeSpace) != 0)
+  {
+    DctnryIndex::remove(m_segFileName);
+
+    if (m_logger)
+    {
+      std::ostringstream oss;
+      oss << "Unable to save dictionary index for OID-" << m_dctnryOID << "; file-" << m_segFileName;
+      m_logger->logMsg(oss.str(), MSGLVL_INFO2);
+    }
+  }
+
+  m_index.clear();
+  m_indexLoaded = false;
+
   // cout <<"Init called! m_dctnryOID ="  << m_dctnryOID << endl;
   freeStringCache();
 
@@ -445,6 +481,8 @@ int Dctnry::closeDctnryOnly()
   closeDctnryFile(false, oids);
 
   freeStringCache();
+  m_index.clear();
+  m_indexLoaded = false;
 
   return NO_ERROR;
 }
@@ -587,6 +625,8 @@ int Dctnry::openDctnry(const OID& dctnryOID, const uint16_t dbRoot, const uint32
   // Get new free space (m_freeSpace) from header too! Here!!!!!!!!!!!!!!!
   getBlockOpCount(m_curBlock, opCnt);
   m_curOp = opCnt;
+  m_index.clear();
+  m_indexLoaded = false;
 
   // "If" this store file contains no more than 1 block, then we preload
   // the string cache used to recognize duplicates during row insertion.
@@ -783,6 +823,10 @@ int Dctnry::insertDctnry(const char* buf, ColPosPair** pos, const int totalRow,
   cb.file.pFile = m_dFile;
   WriteEngine::Token nullToken;
 
+  //...Bulk loads dedup against the strings of the earlier ones in this file
+  if (!m_indexLoaded)
+    loadIndex();
+
   //...Loop through all the rows for the specified column
   while (startPos < totalRow)
   {
@@ -862,6 +906,15 @@ int Dctnry::insertDctnry(const char* buf, ColPosPair** pos, const int totalRow,
       }
 
       // Stats::stopParseEvent("getTokenFromArray");
+
+      //...Then in the strings of this file the cache doesn't hold
+      if (m_index.enabled() && m_index.find(curSig.signature, curSig.size, curSig.token))
+      {
+        memcpy(pOut + outOffset, &curSig.token, 8);
+        outOffset += 8;
+        startPos++;
+        continue;
+      }
     }
 
     totalUseSize = m_totalHdrBytes + curSig.size;
@@ -899,6 +952,9 @@ int Dctnry::insertDctnry(const char* buf, ColPosPair** pos, const int totalRow,
       {
         addToStringCache(curSig);
       }
+
+      if (m_index.enabled() && (curSig.size <= MAX_SIGNATURE_SIZE))
+        m_index.insert(curSig.signature, curSig.size, curSig.token);
     }
     else  //...No room for this string in current block, so we write
           //   out the current block, so we can start another block
@@ -999,6 +1055,9 @@ int Dctnry::insertDctnry(const char* buf, ColPosPair** pos, const int totalRow,
         {
           addToStringCache(curSig);
         }
+
+        if (m_index.enabled() && (curSig.size <= MAX_SIGNATURE_SIZE))
+          m_index.insert(curSig.signature, curSig.size, curSig.token);
       }
     }  // if next
   }    // end while
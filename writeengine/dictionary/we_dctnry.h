@@ -34,6 +34,7 @@
 #include "we_dbfileop.h"
 #include "we_type.h"
 #include "we_brm.h"
+#include "we_dctnryindex.h"
 #include "bytestream.h"
 
 #define EXPORT
@@ -260,6 +261,9 @@ class Dctnry : public DbFileOp
   // Free memory consumed by strings in the string cache
   void freeStringCache();
 
+  // Load the string index of the store file, saved by an earlier bulk load
+  void loadIndex();
+
   //
   // Functions to read data:
   //   getBlockOpCount - get the ordinal position (OP) count from the header
@@ -299,6 +303,9 @@ class Dctnry : public DbFileOp
   std::set<Signature, sig_compare> m_sigArray;
   int m_arraySize;  // num strings in m_sigArray
 
+  DctnryIndex m_index;  // strings of earlier bulk loads into this store file
+  bool m_indexLoaded;   // m_index was loaded for the open store file
+
   // m_dctnryHeader  used for hdr when readSubBlockEntry is used to read a blk
   // m_dctnryHeader2 contains filled in template used to initialize new blocks
   unsigned char m_dctnryHeader[DCTNRY_HEADER_SIZE];   // first 14 bytes of hdr
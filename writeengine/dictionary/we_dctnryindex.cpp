@@ -0,0 +1,181 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @we_dctnryindex.cpp
+ *  Implements the DctnryIndex class.
+ */
+#include <cstring>
+#include <exception>
+#include <boost/scoped_ptr.hpp>
+#include <boost/scoped_array.hpp>
+using namespace std;
+
+#include "bytestream.h"
+#include "IDBDataFile.h"
+#include "IDBPolicy.h"
+#include "we_dctnryindex.h"
+using namespace messageqcpp;
+using namespace idbdatafile;
+
+namespace
+{
+const uint32_t DI_MAGIC = 0x44495631;  // "DIV1"
+}
+
+namespace WriteEngine
+{
+DctnryIndex::DctnryIndex() : fMaxStrings(0), fDirty(false)
+{
+}
+
+void DctnryIndex::insert(const unsigned char* sig, int size, const Token& token)
+{
+  if (fTokens.size() >= fMaxStrings)
+    return;
+
+  if (fTokens.insert(make_pair(string((const char*)sig, size), token)).second)
+    fDirty = true;
+}
+
+void DctnryIndex::clear()
+{
+  fTokens.clear();
+  fDirty = false;
+}
+
+string DctnryIndex::fileName(const string& storeFile)
+{
+  return storeFile + ".idx";
+}
+
+bool DctnryIndex::load(const string& storeFile, int64_t lbid, int op, int freeSpace)
+{
+  const string name = fileName(storeFile);
+  const char* filename_p = name.c_str();
+
+  clear();
+
+  if (!enabled() || !IDBPolicy::exists(filename_p))
+    return false;
+
+  boost::scoped_ptr<IDBDataFile> in(
+      IDBDataFile::open(IDBPolicy::getType(filename_p, IDBPolicy::WRITEENG), filename_p, "r", 0));
+
+  if (!in)
+    return false;
+
+  off64_t size = in->size();
+
+  if (size < (off64_t)(2 * sizeof(uint32_t)))
+    return false;
+
+  boost::scoped_array<uint8_t> buf(new uint8_t[size]);
+
+  if (in->read(buf.get(), size) != size)
+    return false;
+
+  ByteStream bs;
+  uint32_t magic, savedOp, savedFreeSpace, count;
+  uint64_t savedLbid;
+
+  bs.load(buf.get(), size);
+
+  try
+  {
+    bs >> magic;
+    bs >> savedLbid;
+    bs >> savedOp;
+    bs >> savedFreeSpace;
+
+    // strings were added or taken away since the index was saved
+    if (magic != DI_MAGIC || (int64_t)savedLbid != lbid || (int)savedOp != op ||
+        (int)savedFreeSpace != freeSpace)
+      return false;
+
+    bs >> count;
+
+    for (uint32_t i = 0; i < count && fTokens.size() < fMaxStrings; i++)
+    {
+      uint64_t tmp;
+      Token token;
+      string sig;
+
+      bs >> tmp;
+      bs >> sig;
+      memcpy(static_cast<void*>(&token), &tmp, sizeof(token));
+      fTokens.insert(make_pair(sig, token));
+    }
+  }
+  catch (exception&)
+  {
+    // a truncated file
+    clear();
+    return false;
+  }
+
+  return true;
+}
+
+int DctnryIndex::save(const string& storeFile, int64_t lbid, int op, int freeSpace)
+{
+  const string name = fileName(storeFile);
+  const string tmpName = name + ".tmp";
+  ByteStream bs;
+
+  bs << DI_MAGIC;
+  bs << (uint64_t)lbid;
+  bs << (uint32_t)op;
+  bs << (uint32_t)freeSpace;
+  bs << (uint32_t)fTokens.size();
+
+  for (TokenMap::const_iterator it = fTokens.begin(); it != fTokens.end(); ++it)
+  {
+    uint64_t token;
+
+    memcpy(&token, &it->second, sizeof(token));
+    bs << token;
+    bs << it->first;
+  }
+
+  // write a new file and rename it, the next import never sees a partly written one
+  {
+    boost::scoped_ptr<IDBDataFile> out(IDBDataFile::open(IDBPolicy::getType(tmpName, IDBPolicy::WRITEENG),
+                                                         tmpName.c_str(), "wb", IDBDataFile::USE_VBUF));
+
+    if (!out || out->write(bs.buf(), bs.length()) != (ssize_t)bs.length())
+    {
+      IDBPolicy::remove(tmpName.c_str());
+      return -1;
+    }
+  }
+
+  if (IDBPolicy::rename(tmpName.c_str(), name.c_str()) != 0)
+    return -1;
+
+  fDirty = false;
+  return 0;
+}
+
+void DctnryIndex::remove(const string& storeFile)
+{
+  const string name = fileName(storeFile);
+
+  if (IDBPolicy::exists(name.c_str()))
+    IDBPolicy::remove(name.c_str());
+}
+
+}  // namespace WriteEngine
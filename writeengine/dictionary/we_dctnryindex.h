@@ -0,0 +1,116 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @we_dctnryindex.h
+ *  Defines the DctnryIndex class, a persisted string to token index of a
+ *  dictionary store file.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <tr1/unordered_map>
+
+#include "we_typeext.h"
+
+#define EXPORT
+
+/** Namespace WriteEngine */
+namespace WriteEngine
+{
+/**
+ * @brief String to token index of the strings of a dictionary store file
+ *
+ * The string cache of Dctnry only holds the strings of the current import
+ * and the first block of a file, so every import adds the strings it shares
+ * with the earlier ones again.  The index remembers the tokens of up to
+ * maxStrings strings of the store file, and is kept in a file beside it
+ * between imports.
+ *
+ * Strings are only ever appended to a store file.  The saved index records
+ * where the end of the store was (the LBID, string count and free space of
+ * the last block) when it was written, and is only used if the store still
+ * ends there, which rules out an index that misses strings or points to
+ * strings a rollback took away.
+ */
+class DctnryIndex
+{
+ public:
+  EXPORT DctnryIndex();
+
+  /** @brief Max number of strings, 0 disables the index */
+  void setMaxStrings(uint32_t maxStrings)
+  {
+    fMaxStrings = maxStrings;
+  }
+  bool enabled() const
+  {
+    return fMaxStrings > 0;
+  }
+  size_t size() const
+  {
+    return fTokens.size();
+  }
+  bool isDirty() const
+  {
+    return fDirty;
+  }
+
+  /** @brief Set token to the token of the string, false if it isn't indexed */
+  inline bool find(const unsigned char* sig, int size, Token& token) const
+  {
+    TokenMap::const_iterator it = fTokens.find(std::string((const char*)sig, size));
+
+    if (it == fTokens.end())
+      return false;
+
+    token = it->second;
+    return true;
+  }
+
+  /** @brief Add a string, ignored once the index holds maxStrings strings */
+  EXPORT void insert(const unsigned char* sig, int size, const Token& token);
+
+  EXPORT void clear();
+
+  /** @brief Load the index of storeFile if it was saved at the given end of
+   *  the store, the index is left empty otherwise.  Returns true if loaded.
+   */
+  EXPORT bool load(const std::string& storeFile, int64_t lbid, int op, int freeSpace);
+
+  /** @brief Save the index of storeFile for the given end of the store.
+   *  Returns 0 on success.
+   */
+  EXPORT int save(const std::string& storeFile, int64_t lbid, int op, int freeSpace);
+
+  /** @brief Drop the saved index of storeFile */
+  EXPORT static void remove(const std::string& storeFile);
+
+  EXPORT static std::string fileName(const std::string& storeFile);
+
+ private:
+  typedef std::tr1::unordered_map<std::string, Token> TokenMap;
+
+  TokenMap fTokens;
+  uint32_t fMaxStrings;
+  bool fDirty;  // strings were added since the last load or save
+};
+
+}  // namespace WriteEngine
+
+#undef EXPORT
@@ -28,6 +28,7 @@
 #include "we_fileop.h"
 #include "messageids.h"
 #include "IDBDataFile.h"
+#include "../dictionary/we_dctnryindex.h"
 using namespace idbdatafile;
 
 using namespace execplan;
@@ -108,6 +109,9 @@ void BulkRollbackFile::deleteSegmentFile(OID columnOID, bool fileTypeFlag, uint3
           << "; part#-" << partNum << "; seg#-" << segNum;
   fMgr->logAMessage(logging::LOG_TYPE_INFO, logging::M0075, columnOID, msgText.str());
 
+  if (!fileTypeFlag)
+    DctnryIndex::remove(segFileName);
+
   // delete the db segment file if it exists
   int rc = fDbFile.deleteFile(segFileName.c_str());
 
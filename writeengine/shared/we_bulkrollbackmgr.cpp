@@ -45,6 +45,7 @@
 #include "we_rbmetawriter.h"
 #include "messageids.h"
 #include "cacheutils.h"
+#include "../dictionary/we_dctnryindex.h"
 
 using namespace execplan;
 
@@ -1358,6 +1359,14 @@ void BulkRollbackMgr::deleteDctnryExtentsV4()
         // starting with the next block following the HWM block.
         fileRestorer->reInitTruncDctnryExtent(fPendingDctnryStoreOID, dbRoot, partNum, segNum, (hwm + 1),
                                               (lastBlkOfCurrStripe - hwm));
+
+        // The strings the import added to the HWM block stay there, but
+        // the index may hold tokens of the truncated blocks
+        std::string segFileName;
+        fileRestorer->buildSegmentFileName(fPendingDctnryStoreOID,
+                                           false,  // not a column segment file
+                                           dbRoot, partNum, segNum, segFileName);
+        DctnryIndex::remove(segFileName);
       }
       else  // don't keep this segment file
       {
@@ -916,7 +916,8 @@ int ChunkManager::writeChunkToFile(CompFileData* fileData, ChunkData* chunkData)
     }
 
     if (fCompressor->compressBlock((char*)chunkData->fBufUnCompressed, chunkData->fLenUnCompressed,
-                                   (unsigned char*)fBufCompressed, fLenCompressed) != 0)
+                                   (unsigned char*)fBufCompressed, fLenCompressed,
+                                   encodingWidth(fileData)) != 0)
     {
       logMessage(ERR_COMP_COMPRESS, logging::LOG_TYPE_ERROR, __LINE__);
       return ERR_COMP_COMPRESS;
@@ -1688,6 +1689,18 @@ void ChunkManager::fileOp(FileOp* fileOp)
   }
 }
 
+//------------------------------------------------------------------------------
+// Return the column width the chunks of the file are encoded by, or 0 if they
+// are only compressed, as the chunks of a dictionary store are.
+//------------------------------------------------------------------------------
+uint32_t ChunkManager::encodingWidth(const CompFileData* fileData) const
+{
+  if (fileData->fDctnryCol || !Config::getChunkEncoding())
+    return 0;
+
+  return fileData->fColWidth;
+}
+
 //------------------------------------------------------------------------------
 // Calculate and return the size of the chunk pointer header for a column of the
 // specified width.
@@ -1865,7 +1878,8 @@ int ChunkManager::reallocateChunks(CompFileData* fileData)
       }
 
       if ((rc = fCompressor->compressBlock((char*)chunkData->fBufUnCompressed, chunkData->fLenUnCompressed,
-                                           (unsigned char*)fBufCompressed, fLenCompressed)) != 0)
+                                           (unsigned char*)fBufCompressed, fLenCompressed,
+                                           encodingWidth(fileData))) != 0)
       {
         ostringstream oss;
         oss << "Compress data failed @line:" << __LINE__ << "with retCode:" << rc
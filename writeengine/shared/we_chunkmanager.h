@@ -317,6 +317,9 @@ class ChunkManager
   // @brief Calculate the header size based on column width.
   int calculateHeaderSize(int width);
 
+  // @brief The width of the values a chunk is encoded by, 0 if it is only compressed.
+  uint32_t encodingWidth(const CompFileData* fileData) const;
+
   // @brief Moving chunks as a result of expanding a chunk.
   int reallocateChunks(CompFileData* fileData);
 
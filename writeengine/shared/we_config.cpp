@@ -47,6 +47,8 @@ const unsigned DEFAULT_EXTENTS_PER_SEGMENT_FILE = 2;
 const int DEFAULT_BULK_PROCESS_PRIORITY = -1;
 const unsigned DEFAULT_MAX_FILESYSTEM_DISK_USAGE = 98;  // allow 98% full
 const unsigned DEFAULT_COMPRESSED_PADDING_BLKS = 1;
+const unsigned DEFAULT_EXTENT_FILTER_MAX_BYTES = 0;  // no extent filters
+const unsigned DEFAULT_DICT_INDEX_MAX_STRINGS = 0;    // no store indexes
 const int DEFAULT_LOCAL_MODULE_ID = 1;
 const bool DEFAULT_PARENT_OAM = true;
 const char* DEFAULT_LOCAL_MODULE_TYPE = "pm";
@@ -71,6 +73,9 @@ string Config::m_BulkRollbackDir;
 bool Config::m_FastDelete;
 unsigned Config::m_MaxFileSystemDiskUsage = DEFAULT_MAX_FILESYSTEM_DISK_USAGE;
 unsigned Config::m_NumCompressedPadBlks = DEFAULT_COMPRESSED_PADDING_BLKS;
+unsigned Config::m_ExtentFilterMaxBytes = DEFAULT_EXTENT_FILTER_MAX_BYTES;
+unsigned Config::m_DictIndexMaxStrings = DEFAULT_DICT_INDEX_MAX_STRINGS;
+bool Config::m_ChunkEncoding = false;
 bool Config::m_ParentOAMModuleFlag = DEFAULT_PARENT_OAM;
 string Config::m_LocalModuleType;
 int Config::m_LocalModuleID = DEFAULT_LOCAL_MODULE_ID;
@@ -217,6 +222,30 @@ void Config::checkReload()
   if (ncpb.length() != 0)
     m_NumCompressedPadBlks = cf->uFromText(ncpb);
 
+  //--------------------------------------------------------------------------
+  // Size of the per extent Bloom filters cpimport builds
+  //--------------------------------------------------------------------------
+  m_ExtentFilterMaxBytes = DEFAULT_EXTENT_FILTER_MAX_BYTES;
+  string efmb = cf->getConfig("WriteEngine", "ExtentFilterMaxBytes");
+
+  if (efmb.length() != 0)
+    m_ExtentFilterMaxBytes = cf->uFromText(efmb);
+
+  //--------------------------------------------------------------------------
+  // Size of the string index kept beside each dictionary store file
+  //--------------------------------------------------------------------------
+  m_DictIndexMaxStrings = DEFAULT_DICT_INDEX_MAX_STRINGS;
+  string dims = cf->getConfig("WriteEngine", "DictionaryIndexMaxStrings");
+
+  if (dims.length() != 0)
+    m_DictIndexMaxStrings = cf->uFromText(dims);
+
+  //--------------------------------------------------------------------------
+  // Lightweight encoding of column chunks
+  //--------------------------------------------------------------------------
+  const std::string chunkEncoding = cf->getConfig("WriteEngine", "ChunkEncoding");
+  m_ChunkEncoding = (chunkEncoding == "y" || chunkEncoding == "Y");
+
   IDBPolicy::configIDBPolicy();
 
   //--------------------------------------------------------------------------
@@ -570,6 +599,52 @@ unsigned Config::getNumCompressedPadBlks()
   return m_NumCompressedPadBlks;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the max size of the Bloom filter built for each new extent of an
+ *    integer column.  0 means no filters are built.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+unsigned Config::getExtentFilterMaxBytes()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return m_ExtentFilterMaxBytes;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the max number of strings kept in the index of a dictionary store
+ *    file.  0 means the store files aren't indexed.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+unsigned Config::getDictionaryIndexMaxStrings()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return m_DictIndexMaxStrings;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the option to store column chunks with a lightweight encoding when
+ *    it is smaller than the compressed chunk.  Older versions can't read such
+ *    chunks, so it is off unless configured.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+bool Config::getChunkEncoding()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return m_ChunkEncoding;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *    Get Parent OAM Module flag; are we running on active parent OAM node.
@@ -136,6 +136,23 @@ class Config
    */
   EXPORT static unsigned getNumCompressedPadBlks();
 
+  /**
+   * @brief Max size of the Bloom filter of a new extent, 0 if none are built
+   */
+  EXPORT static unsigned getExtentFilterMaxBytes();
+
+  /**
+   * @brief Max number of strings in the index of a dictionary store file,
+   * 0 if the stores aren't indexed
+   */
+  EXPORT static unsigned getDictionaryIndexMaxStrings();
+
+  /**
+   * @brief Store column chunks with a lightweight encoding (FOR, delta, RLE)
+   * when it is smaller than the compressed chunk
+   */
+  EXPORT static bool getChunkEncoding();
+
   /**
    * @brief Parent OAM Module flag (is this the parent OAM node, ex: pm1)
    */
@@ -194,6 +211,9 @@ class Config
   static bool m_FastDelete;                   // fast delete option
   static unsigned m_MaxFileSystemDiskUsage;   // max file system % disk usage
   static unsigned m_NumCompressedPadBlks;     // num blks to pad comp chunks
+  static unsigned m_ExtentFilterMaxBytes;     // max extent Bloom filter size
+  static unsigned m_DictIndexMaxStrings;      // max strings in a store index
+  static bool m_ChunkEncoding;                // encode column chunks
   static bool m_ParentOAMModuleFlag;          // are we running on parent PM
   static std::string m_LocalModuleType;       // local node type (ex: "pm")
   static int m_LocalModuleID;                 // local node id   (ex: 1   )
@@ -54,6 +54,8 @@ using namespace logging;
 #include "IDBDataFile.h"
 #include "IDBFileSystem.h"
 #include "IDBPolicy.h"
+#include "extentfilter.h"
+#include "../dictionary/we_dctnryindex.h"
 using namespace idbdatafile;
 
 namespace WriteEngine
@@ -302,6 +304,7 @@ int FileOp::deleteFile(FID fid) const
   //             "; dirpath: " << oidDirName << std::endl;
   // need check return code.
   RETURN_ON_ERROR(BRMWrapper::getInstance()->deleteOid(fid));
+  BRM::ExtentFilterStore::remove(fid);
 
   std::vector<std::string> dbRootPathList;
   Config::getDBRootPathList(dbRootPathList);
@@ -349,6 +352,7 @@ int FileOp::deleteFiles(const std::vector<int32_t>& fids) const
     sprintf(oidDirName, "%s/%s/%s/%s", dbDir[0], dbDir[1], dbDir[2], dbDir[3]);
     // std::cout << "Deleting files for OID " << fid <<
     //             "; dirpath: " << oidDirName << std::endl;
+    BRM::ExtentFilterStore::remove(fids[n]);
 
     for (unsigned i = 0; i < dbRootPathList.size(); i++)
     {
@@ -405,6 +409,8 @@ int FileOp::deletePartitions(const std::vector<OID>& fids,
       throw std::runtime_error(oss.str());
     }
 
+    DctnryIndex::remove(rootOidDirName);
+
     list<string> dircontents;
 
     if (IDBPolicy::listDirectory(partitionDirName, dircontents) == 0)
@@ -442,6 +448,7 @@ int FileOp::deleteFile(FID fid, uint16_t dbRoot, uint32_t partition, uint16_t se
   char fileName[FILE_NAME_SIZE];
 
   RETURN_ON_ERROR(getFileName(fid, fileName, dbRoot, partition, segment));
+  DctnryIndex::remove(fileName);
 
   return (deleteFile(fileName));
 }
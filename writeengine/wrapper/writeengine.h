@@ -50,7 +50,8 @@ namespace WriteEngine
 const int UN_COMPRESSED_OP = 0;
 const int COMPRESSED_OP_1 = 1;
 const int COMPRESSED_OP_2 = 2;
-const int TOTAL_COMPRESS_OP = 3;
+const int COMPRESSED_OP_3 = 3;
+const int TOTAL_COMPRESS_OP = 4;
 
 //...Forward class declarations
 class Log;
@@ -421,6 +422,8 @@ class WriteEngineWrapper : public WEObj
     m_dctnry[COMPRESSED_OP_1]->chunkManager()->setIsInsert(true);
     m_colOp[COMPRESSED_OP_2]->chunkManager()->setIsInsert(bIsInsert);
     m_dctnry[COMPRESSED_OP_2]->chunkManager()->setIsInsert(true);
+    m_colOp[COMPRESSED_OP_3]->chunkManager()->setIsInsert(bIsInsert);
+    m_dctnry[COMPRESSED_OP_3]->chunkManager()->setIsInsert(true);
   }
 
   /**
@@ -447,7 +450,7 @@ class WriteEngineWrapper : public WEObj
    */
   int flushChunks(int rc, const std::map<FID, FID>& columOids)
   {
-    std::vector<int32_t> compressedOpIds = {COMPRESSED_OP_1, COMPRESSED_OP_2};
+    std::vector<int32_t> compressedOpIds = {COMPRESSED_OP_1, COMPRESSED_OP_2, COMPRESSED_OP_3};
 
     for (const auto compressedOpId : compressedOpIds)
     {
@@ -759,6 +762,7 @@ class WriteEngineWrapper : public WEObj
       case 1:
       case 2: return COMPRESSED_OP_1;
       case 3: return COMPRESSED_OP_2;
+      case 4: return COMPRESSED_OP_3;
     }
 
     return 0;